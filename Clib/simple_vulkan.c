@@ -5,87 +5,412 @@
  * Handles device selection, memory management, shader loading, and dispatch.
  */
 
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L  /* mmap, fstat, recursive mutexes */
+#endif
+
+#ifdef _WIN32
 #define VK_USE_PLATFORM_WIN32_KHR
+#endif
 #include <vulkan/vulkan.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <stddef.h>
 #include "simple_vulkan.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+/* ============================================================================
+ * Threads
+ *
+ * A context may be used from several threads. Its state is guarded by one
+ * recursive mutex, released while a thread waits for the GPU.
+ * ============================================================================ */
+
+#ifdef _WIN32
+typedef CRITICAL_SECTION svk_mutex;  /* Recursive */
+typedef DWORD svk_thread_id;
+
+static int mutex_init(svk_mutex* m) { InitializeCriticalSection(m); return 1; }
+static void mutex_destroy(svk_mutex* m) { DeleteCriticalSection(m); }
+static void mutex_lock(svk_mutex* m) { EnterCriticalSection(m); }
+static void mutex_unlock(svk_mutex* m) { LeaveCriticalSection(m); }
+static svk_thread_id current_thread(void) { return GetCurrentThreadId(); }
+static int same_thread(svk_thread_id a, svk_thread_id b) { return a == b; }
+
+typedef INIT_ONCE svk_once;
+#define SVK_ONCE_INIT INIT_ONCE_STATIC_INIT
+static BOOL CALLBACK once_callback(PINIT_ONCE once, PVOID fn, PVOID* result) {
+    (void)once;
+    (void)result;
+    ((void (*)(void))fn)();
+    return TRUE;
+}
+static void run_once(svk_once* once, void (*fn)(void)) { InitOnceExecuteOnce(once, once_callback, (PVOID)fn, NULL); }
+#else
+typedef pthread_mutex_t svk_mutex;
+typedef pthread_t svk_thread_id;
+
+static int mutex_init(svk_mutex* m) {
+    pthread_mutexattr_t attr;
+    if (pthread_mutexattr_init(&attr) != 0) return 0;
+    int ok = pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE) == 0 &&
+             pthread_mutex_init(m, &attr) == 0;
+    pthread_mutexattr_destroy(&attr);
+    return ok;
+}
+static void mutex_destroy(svk_mutex* m) { pthread_mutex_destroy(m); }
+static void mutex_lock(svk_mutex* m) { pthread_mutex_lock(m); }
+static void mutex_unlock(svk_mutex* m) { pthread_mutex_unlock(m); }
+static svk_thread_id current_thread(void) { return pthread_self(); }
+static int same_thread(svk_thread_id a, svk_thread_id b) { return pthread_equal(a, b); }
+
+typedef pthread_once_t svk_once;
+#define SVK_ONCE_INIT PTHREAD_ONCE_INIT
+static void run_once(svk_once* once, void (*fn)(void)) { pthread_once(once, fn); }
+#endif
+
 /* ============================================================================
  * Internal Structures
  * ============================================================================ */
 
+/* Number of reusable command buffer/fence pairs per queue and thread */
+#define SVK_RING_SIZE 8
+
+/* Queue roles (SVK_QUEUE_*) */
+#define SVK_QUEUE_COUNT 3
+
+struct svk_queue;
+
+/* One slot of a queue's submission ring */
+typedef struct {
+    VkCommandBuffer cmd;
+    VkFence fence;
+    struct svk_queue* queue;            /* Queue the slot submits to */
+    svk_ticket ticket;                  /* Ticket of the last submission from this slot */
+    svk_ticket waits[SVK_QUEUE_COUNT];  /* Submissions on other queues to wait for */
+    int pending;                        /* Submitted and fence not yet observed signaled */
+    int recording;                      /* Command buffer is being recorded (not reusable) */
+    uint32_t waiters;                   /* Threads waiting on the fence (not reusable) */
+} svk_submit_slot;
+
+/* A device queue. With more than one queue, each signals a timeline
+   semaphore with the ticket of every submission, and cross-queue
+   dependencies wait on it. Submission rings are per thread (svk_lane). */
+typedef struct svk_queue {
+    VkQueue queue;
+    uint32_t family;
+    uint32_t role;                   /* Index in svk_context_t.queue_storage */
+    VkCommandPool command_pool;      /* Graph batches; VK_NULL_HANDLE if the queue is unused */
+    VkSemaphore timeline;            /* VK_NULL_HANDLE with a single queue */
+    VkPipelineStageFlags stages;     /* Stages the queue supports, for barriers */
+    VkAccessFlags write_access;
+    VkAccessFlags access;
+    uint32_t timestamp_bits;         /* 0 = commands on this queue are not profiled */
+} svk_queue;
+
+/* Timestamp pair around one recorded command (svk_enable_profiling) */
+typedef struct {
+    svk_submit_slot* slot;   /* Slot the command was recorded into */
+    svk_ticket ticket;       /* 0 until the slot is submitted */
+    uint32_t query;          /* First of the two queries */
+    uint32_t tag;            /* Profile tag when recorded */
+    uint32_t kind;           /* SVK_SAMPLE_* */
+} svk_timing;
+
+/* Free byte range inside a memory block (list sorted by offset) */
+typedef struct svk_free_range {
+    uint64_t offset;
+    uint64_t size;
+    struct svk_free_range* next;
+} svk_free_range;
+
+/* One VkDeviceMemory allocation that buffers/images are carved from */
+typedef struct svk_mem_block {
+    VkDeviceMemory memory;
+    uint64_t size;
+    uint64_t used;
+    uint32_t type_index;
+    int kind;                 /* SVK_ALLOC_LINEAR or SVK_ALLOC_OPTIMAL */
+    int dedicated;            /* Holds exactly one large resource */
+    void* mapped;             /* Persistent mapping of host-visible blocks */
+    uint32_t allocation_count;
+    svk_free_range* free_list;
+    struct svk_mem_block* next;
+} svk_mem_block;
+
+/* A sub-allocation handed to a buffer or image */
+typedef struct {
+    svk_mem_block* block;
+    uint64_t offset;
+    uint64_t size;
+} svk_allocation;
+
+/* Staging buffers for transfers to/from device-local memory */
+#define SVK_STAGING_SLOTS 4
+#define SVK_STAGING_SLOT_SIZE (4ull * 1024 * 1024)
+
+typedef struct {
+    svk_buffer slots[SVK_STAGING_SLOTS];
+    uint32_t next;
+} svk_staging_ring;
+
+/* What one thread records and stages with: a command pool and submission
+   ring per queue, and its own staging rings, so threads never wait for each
+   other's slots. Lanes of released threads are reused by new threads. */
+typedef struct svk_lane {
+    svk_thread_id thread;
+    int released;                     /* svk_release_thread; free for another thread */
+    VkCommandPool pools[SVK_QUEUE_COUNT];
+    svk_submit_slot ring[SVK_QUEUE_COUNT][SVK_RING_SIZE];
+    uint32_t ring_next[SVK_QUEUE_COUNT];
+    svk_staging_ring upload_ring;
+    svk_staging_ring readback_ring;
+    struct svk_lane* next;
+} svk_lane;
+
+/* Host copy of an image, filled by svk_begin_image_download */
+typedef struct {
+    svk_buffer staging;   /* Host-readback buffer, grown to the largest download */
+    uint64_t size;        /* Bytes of the pending download */
+    svk_ticket ticket;    /* Copy not yet collected, 0 = slot free */
+    int claimed;          /* Held by a thread until its copy is submitted */
+} svk_readback_slot;
+
+/* Descriptor pools, chained as earlier pools run out. Sets are returned
+   individually (FREE_DESCRIPTOR_SET) when pipelines are freed. */
+#define SVK_DESC_POOL_SETS     64   /* Sets in the first pool */
+#define SVK_DESC_POOL_MAX_SETS 1024 /* Growth cap for later pools */
+
+typedef struct svk_desc_pool {
+    VkDescriptorPool pool;
+    uint32_t capacity;        /* maxSets */
+    uint32_t in_use;
+    int exhausted;            /* Last allocation failed for lack of descriptors */
+    struct svk_desc_pool* next;
+} svk_desc_pool;
+
 struct svk_context_t {
     VkInstance instance;
     VkPhysicalDevice physical_device;
     VkDevice device;
-    VkQueue compute_queue;
-    uint32_t compute_queue_family;
-    VkCommandPool command_pool;
-    VkDescriptorPool descriptor_pool;
+
+    /* Held by svk_ calls that touch context state (see "Threads") */
+    svk_mutex lock;
+    uint32_t lock_depth;            /* Recursion depth of the holding thread */
+    svk_lane* lanes;
+
+    svk_desc_pool* desc_pools;
+    uint64_t desc_sets_allocated;   /* Lifetime totals for svk_get_descriptor_stats */
+    uint64_t desc_sets_freed;
+
+    /* Device queues by role; roles without their own queue point at the
+       compute queue. Tickets are numbered across all queues. */
+    svk_queue queue_storage[SVK_QUEUE_COUNT];
+    svk_queue* queues[SVK_QUEUE_COUNT];
+    uint32_t queue_families[SVK_QUEUE_COUNT];  /* Distinct families, for concurrent sharing */
+    uint32_t queue_family_count;
+    svk_ticket last_ticket;
+
+    /* Device memory blocks shared by buffers and images */
+    VkPhysicalDeviceMemoryProperties memory_properties;
+    uint64_t non_coherent_atom_size;
+    uint64_t buffer_image_granularity;
+    svk_mem_block* blocks;
+
+    /* Unique ids for buffers/images (never reused, unlike pointers) */
+    uint64_t next_resource_id;
 
     /* Device info */
+    uint32_t device_index;      /* In vkEnumeratePhysicalDevices order */
     char device_name[256];
     uint32_t vendor_id;
     int is_discrete;
     uint32_t max_workgroup_size;
-
-    /* Staging buffer for transfers */
-    VkBuffer staging_buffer;
-    VkDeviceMemory staging_memory;
-    uint64_t staging_size;
+    uint32_t device_id;
+    uint32_t driver_version;
+    uint32_t api_version;
+    uint8_t pipeline_cache_uuid[VK_UUID_SIZE];
+
+    /* Loaded shader modules, keyed by content hash */
+    svk_shader shaders;
+
+    /* Compiled pipeline variants, keyed by shader, layout and constants */
+    struct svk_pipeline_variant* variants;
+
+    /* Compiled pipelines, persisted with svk_save_pipeline_cache */
+    VkPipelineCache pipeline_cache;
+
+    /* GPU timestamps (svk_enable_profiling) */
+    VkQueryPool timestamp_pool;
+    uint32_t timestamp_valid_bits;  /* Of the compute queue; 0 = unsupported */
+    double timestamp_period;        /* Nanoseconds per tick */
+    svk_timing* timings;            /* Unread stamps, in recording order */
+    uint32_t timing_count;
+    uint32_t* free_queries;         /* First query of each unused pair */
+    uint32_t free_query_count;
+    uint32_t profile_tag;
+    uint64_t dropped_timings;
+
+    /* Image downloads in flight (svk_begin_image_download) */
+    svk_readback_slot image_readback[SVK_READBACK_SLOTS];
 };
 
 struct svk_buffer_t {
     VkBuffer buffer;
-    VkDeviceMemory memory;
+    svk_allocation alloc;
+    uint64_t id;
     uint64_t size;
     uint32_t usage;
+    svk_ticket last_ticket;  /* Last submission that referenced this buffer */
+    uint32_t pins;           /* Unsubmitted command lists that recorded it */
 };
 
 struct svk_image_t {
     VkImage image;
-    VkDeviceMemory memory;
+    svk_allocation alloc;
     VkImageView view;
+    uint64_t id;
     uint32_t width;
     uint32_t height;
     uint32_t format;
+    VkImageLayout layout;    /* Layout as of the last recorded command */
+    svk_ticket last_ticket;  /* Last submission that referenced this image */
+    uint32_t pins;           /* Unsubmitted command lists that recorded it */
 };
 
+/* Interface of a shader module, filled in by SPIR-V reflection */
+typedef struct {
+    int reflected;                            /* 0: unsupported module, use generic layout */
+    uint32_t binding_types[SVK_MAX_BINDINGS]; /* SVK_BINDING_* per binding, 0 = unused */
+    uint32_t readonly_mask;                   /* Bit per binding the shader never writes */
+    uint32_t push_size;                       /* Push-constant block size in bytes */
+    uint32_t local_size[3];
+    uint32_t local_size_spec[3];              /* SpecId + 1 driving each dimension, 0 = fixed */
+    uint32_t image_format;                    /* SVK_FORMAT_* of the first image type, 0 = none */
+} svk_shader_layout;
+
+/* Shader modules are shared: loading identical SPIR-V returns the same
+   handle with its reference count raised */
 struct svk_shader_t {
     VkShaderModule module;
+    svk_shader_layout layout;
+
+    uint64_t hash;          /* FNV-1a of the code */
+    uint64_t digest;        /* word_digest64 of the code, confirms a hash match */
+    uint64_t size;
+    uint32_t refcount;
+    svk_shader next;
 };
 
-struct svk_pipeline_t {
+/* Push-constant range of pipelines built without reflection */
+#define SVK_GENERIC_PUSH_SIZE 128
+
+/* Descriptor sets cached per pipeline, keyed by the ids of the bound resources */
+#define SVK_SET_CACHE_SIZE 4
+
+typedef struct {
+    VkDescriptorSet set;            /* VK_NULL_HANDLE until first needed */
+    svk_desc_pool* pool;            /* Pool the set came from */
+    uint64_t ids[SVK_MAX_BINDINGS]; /* Resource ids written into the set */
+    svk_ticket last_ticket;         /* Last submission that used the set */
+    uint64_t last_used;             /* Use stamp for LRU replacement */
+    uint32_t pins;                  /* Unsubmitted command lists that recorded the set */
+} svk_set_entry;
+
+/* Compiled pipeline shared by every svk_pipeline with the same shader,
+   layout and specialization constants */
+#define SVK_MAX_SPEC_CONSTANTS 64
+
+typedef struct svk_pipeline_variant {
+    svk_shader shader;                        /* Holds a shader reference */
+    uint32_t binding_types[SVK_MAX_BINDINGS];
+    uint32_t readonly_mask;
+    uint32_t push_size;
+    svk_spec_constant* constants;             /* Sorted by id */
+    uint32_t constant_count;
+    int dispatch_base;                        /* Created with DISPATCH_BASE */
+
     VkPipeline pipeline;
     VkPipelineLayout layout;
     VkDescriptorSetLayout desc_layout;
-    VkDescriptorSet desc_set;
+    uint32_t local_size[3];                   /* After specialization */
+
+    uint32_t refcount;
+    struct svk_pipeline_variant* next;
+} svk_pipeline_variant;
+
+/* Render targets and frame ring of an SDF pipeline (svk_create_sdf_pipeline) */
+typedef struct {
+    svk_image images[SVK_SDF_MAX_FRAMES];   /* One output image per frame in flight */
+    svk_ticket frames[SVK_SDF_MAX_FRAMES];  /* Uncollected frame per image, 0 = none */
+    uint32_t frame_count;
+    uint32_t next;                          /* Image the next frame renders into */
+    uint32_t groups_x, groups_y;            /* Workgroups covering the image */
+} svk_sdf_engine;
+
+struct svk_pipeline_t {
+    svk_pipeline_variant* variant;
+    svk_pipeline_variant* base_variant;       /* With DISPATCH_BASE, made by the first offset region */
+    VkPipeline pipeline;                      /* Copies of the variant's handles */
+    VkPipelineLayout layout;
+    VkDescriptorSetLayout desc_layout;
+
+    /* Descriptor type of each binding (SVK_BINDING_*, 0 = not in the layout) */
+    uint32_t binding_types[SVK_MAX_BINDINGS];
+    uint32_t readonly_mask;     /* Bindings the shader only reads */
+    uint32_t local_size[3];     /* Workgroup size, 0 if unknown */
+
+    /* Generic layout (shader not reflected): binding types follow what is
+       bound, and `relayout` is set until the variant matches them */
+    int generic;
+    int relayout;
 
     /* Bound resources */
     svk_buffer buffers[SVK_MAX_BINDINGS];
     svk_image images[SVK_MAX_BINDINGS];
+    uint64_t bound_ids[SVK_MAX_BINDINGS];
+
+    /* Descriptor set cache; `current` matches the bindings unless `dirty` */
+    svk_set_entry sets[SVK_SET_CACHE_SIZE];
+    svk_set_entry* current;
+    uint64_t use_clock;
+    int dirty;
 
     /* Push constants */
-    uint8_t push_data[128];
+    uint8_t push_data[256];
     uint32_t push_size;
+    uint32_t push_capacity;     /* Size of the layout's push-constant range */
+
+    /* Last submission that used the pipeline */
+    svk_ticket last_ticket;
+
+    /* Set for SDF pipelines only */
+    svk_sdf_engine* sdf;
 
-    /* For SDF helper */
-    svk_image output_image;
-    uint32_t workgroup_x, workgroup_y;
+    /* Image format a pack pipeline reads (svk_create_pack_pipeline), 0 otherwise */
+    uint32_t pack_source;
 };
 
 /* ============================================================================
  * Helper Functions
  * ============================================================================ */
 
-static uint32_t find_memory_type(VkPhysicalDevice physical_device, uint32_t type_filter, VkMemoryPropertyFlags properties) {
-    VkPhysicalDeviceMemoryProperties mem_props;
-    vkGetPhysicalDeviceMemoryProperties(physical_device, &mem_props);
+static uint32_t find_memory_type(svk_context ctx, uint32_t type_filter, VkMemoryPropertyFlags properties) {
+    const VkPhysicalDeviceMemoryProperties* mem_props = &ctx->memory_properties;
 
-    for (uint32_t i = 0; i < mem_props.memoryTypeCount; i++) {
-        if ((type_filter & (1 << i)) && (mem_props.memoryTypes[i].propertyFlags & properties) == properties) {
+    for (uint32_t i = 0; i < mem_props->memoryTypeCount; i++) {
+        if ((type_filter & (1u << i)) && (mem_props->memoryTypes[i].propertyFlags & properties) == properties) {
             return i;
         }
     }
@@ -110,693 +435,5594 @@ static int find_compute_queue_family(VkPhysicalDevice device, uint32_t* family)
     return 0;
 }
 
-/* ============================================================================
- * Initialization
- * ============================================================================ */
-
-svk_context svk_init(void) {
-    svk_context ctx = (svk_context)calloc(1, sizeof(struct svk_context_t));
-    if (!ctx) return NULL;
-
-    /* Create Vulkan instance */
-    VkApplicationInfo app_info = {
-        .sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
-        .pApplicationName = "simple_vulkan",
-        .applicationVersion = VK_MAKE_VERSION(1, 0, 0),
-        .pEngineName = "simple_vulkan",
-        .engineVersion = VK_MAKE_VERSION(1, 0, 0),
-        .apiVersion = VK_API_VERSION_1_2
-    };
-
-    VkInstanceCreateInfo create_info = {
-        .sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
-        .pApplicationInfo = &app_info
-    };
+/* Choose a family and queue index for each role. The async-compute queue is
+   a compute family without graphics, or else a second queue of the compute
+   family; the transfer queue is a family with neither compute nor graphics.
+   Without timeline semaphores every role shares the compute queue. */
+static void select_queues(const VkQueueFamilyProperties* families, uint32_t count, uint32_t compute_family,
+                          int has_timeline, uint32_t* family, uint32_t* index, int* dedicated) {
+    for (int r = 0; r < SVK_QUEUE_COUNT; r++) family[r] = compute_family;
+    if (!has_timeline) return;
 
-    if (vkCreateInstance(&create_info, NULL, &ctx->instance) != VK_SUCCESS) {
-        free(ctx);
-        return NULL;
+    const VkQueueFlags shader_flags = VK_QUEUE_COMPUTE_BIT | VK_QUEUE_GRAPHICS_BIT;
+    for (uint32_t i = 0; i < count; i++) {
+        if (i == compute_family || families[i].queueCount == 0) continue;
+        VkQueueFlags flags = families[i].queueFlags;
+        if (!dedicated[SVK_QUEUE_ASYNC_COMPUTE] && (flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT)) {
+            family[SVK_QUEUE_ASYNC_COMPUTE] = i;
+            dedicated[SVK_QUEUE_ASYNC_COMPUTE] = 1;
+        }
+        if (!dedicated[SVK_QUEUE_TRANSFER] && (flags & VK_QUEUE_TRANSFER_BIT) && !(flags & shader_flags)) {
+            family[SVK_QUEUE_TRANSFER] = i;
+            dedicated[SVK_QUEUE_TRANSFER] = 1;
+        }
     }
 
-    /* Enumerate physical devices */
-    uint32_t device_count = 0;
-    vkEnumeratePhysicalDevices(ctx->instance, &device_count, NULL);
-    if (device_count == 0) {
-        vkDestroyInstance(ctx->instance, NULL);
-        free(ctx);
-        return NULL;
+    if (!dedicated[SVK_QUEUE_ASYNC_COMPUTE] && families[compute_family].queueCount >= 2) {
+        index[SVK_QUEUE_ASYNC_COMPUTE] = 1;
+        dedicated[SVK_QUEUE_ASYNC_COMPUTE] = 1;
     }
+}
 
-    VkPhysicalDevice* devices = (VkPhysicalDevice*)malloc(device_count * sizeof(VkPhysicalDevice));
-    vkEnumeratePhysicalDevices(ctx->instance, &device_count, devices);
+/* Take the context lock; calls may nest on one thread */
+static void context_lock(svk_context ctx) {
+    mutex_lock(&ctx->lock);
+    ctx->lock_depth++;
+}
 
-    /* Select best device (prefer discrete GPU) */
-    int best_score = -1;
-    for (uint32_t i = 0; i < device_count; i++) {
-        VkPhysicalDeviceProperties props;
-        vkGetPhysicalDeviceProperties(devices[i], &props);
+static void context_unlock(svk_context ctx) {
+    ctx->lock_depth--;
+    mutex_unlock(&ctx->lock);
+}
 
-        int score = 0;
-        if (props.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) score += 1000;
-        else if (props.deviceType == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU) score += 100;
+/* Release the lock however deeply it is held, e.g. around a fence wait.
+   Returns the depth for context_relock. */
+static uint32_t context_unlock_all(svk_context ctx) {
+    uint32_t depth = ctx->lock_depth;
+    ctx->lock_depth = 0;
+    for (uint32_t i = 0; i < depth; i++) mutex_unlock(&ctx->lock);
+    return depth;
+}
 
-        uint32_t family;
-        if (!find_compute_queue_family(devices[i], &family)) continue;
+static void context_relock(svk_context ctx, uint32_t depth) {
+    for (uint32_t i = 0; i < depth; i++) mutex_lock(&ctx->lock);
+    ctx->lock_depth = depth;
+}
 
-        if (score > best_score) {
-            best_score = score;
-            ctx->physical_device = devices[i];
-            ctx->compute_queue_family = family;
-            strncpy(ctx->device_name, props.deviceName, sizeof(ctx->device_name) - 1);
-            ctx->vendor_id = props.vendorID;
-            ctx->is_discrete = (props.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU);
-            ctx->max_workgroup_size = props.limits.maxComputeWorkGroupInvocations;
-        }
+/* 64-bit FNV-1a content hash */
+static uint64_t fnv1a64(const void* data, size_t size) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
     }
-    free(devices);
+    return hash;
+}
 
-    if (best_score < 0) {
-        vkDestroyInstance(ctx->instance, NULL);
-        free(ctx);
-        return NULL;
+/* Second 64-bit digest of whole words, unrelated to FNV-1a (splitmix64
+   mixing), so two different inputs must collide in both to be confused */
+static uint64_t word_digest64(const uint32_t* words, size_t count) {
+    uint64_t digest = 0x9e3779b97f4a7c15ull ^ (uint64_t)count;
+    for (size_t i = 0; i < count; i++) {
+        digest = (digest ^ words[i]) * 0xbf58476d1ce4e5b9ull;
+        digest ^= digest >> 29;
     }
+    digest ^= digest >> 30;
+    digest *= 0xbf58476d1ce4e5b9ull;
+    digest ^= digest >> 27;
+    digest *= 0x94d049bb133111ebull;
+    return digest ^ (digest >> 31);
+}
 
-    /* Create logical device */
-    float queue_priority = 1.0f;
-    VkDeviceQueueCreateInfo queue_info = {
-        .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
-        .queueFamilyIndex = ctx->compute_queue_family,
-        .queueCount = 1,
-        .pQueuePriorities = &queue_priority
-    };
+/* ============================================================================
+ * Memory Allocator
+ *
+ * Buffers and images are sub-allocated from large per-memory-type blocks
+ * instead of one vkAllocateMemory each. Free space is an offset-sorted list
+ * of ranges that is searched first-fit and coalesced on free. Linear
+ * (buffer) and optimally tiled (image) resources never share a block, so
+ * bufferImageGranularity can never be violated. Aliased heaps of transient
+ * resources hold both, so they get blocks of their own and pad every
+ * resource to the granularity. Host-visible blocks stay mapped for their
+ * whole lifetime.
+ * ============================================================================ */
 
-    VkDeviceCreateInfo device_info = {
-        .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
-        .queueCreateInfoCount = 1,
-        .pQueueCreateInfos = &queue_info
-    };
+#define SVK_ALLOC_LINEAR   0
+#define SVK_ALLOC_OPTIMAL  1
+#define SVK_ALLOC_ALIASED  2
 
-    if (vkCreateDevice(ctx->physical_device, &device_info, NULL, &ctx->device) != VK_SUCCESS) {
-        vkDestroyInstance(ctx->instance, NULL);
-        free(ctx);
-        return NULL;
-    }
+/* Default block size; smaller heaps use an eighth of the heap */
+#define SVK_BLOCK_SIZE (64ull * 1024 * 1024)
 
-    vkGetDeviceQueue(ctx->device, ctx->compute_queue_family, 0, &ctx->compute_queue);
+static uint64_t align_up(uint64_t value, uint64_t alignment) {
+    return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+}
 
-    /* Create command pool */
-    VkCommandPoolCreateInfo pool_info = {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
-        .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
-        .queueFamilyIndex = ctx->compute_queue_family
-    };
+static uint64_t block_size_for_type(svk_context ctx, uint32_t type_index) {
+    uint32_t heap = ctx->memory_properties.memoryTypes[type_index].heapIndex;
+    uint64_t heap_size = ctx->memory_properties.memoryHeaps[heap].size;
+    uint64_t size = SVK_BLOCK_SIZE;
+    if (heap_size / 8 < size) size = align_up(heap_size / 8, 4096);
+    return size;
+}
 
-    if (vkCreateCommandPool(ctx->device, &pool_info, NULL, &ctx->command_pool) != VK_SUCCESS) {
-        vkDestroyDevice(ctx->device, NULL);
-        vkDestroyInstance(ctx->instance, NULL);
-        free(ctx);
+static svk_mem_block* create_block(svk_context ctx, uint32_t type_index, uint64_t size, int kind, int dedicated) {
+    svk_mem_block* block = (svk_mem_block*)calloc(1, sizeof(svk_mem_block));
+    svk_free_range* range = (svk_free_range*)calloc(1, sizeof(svk_free_range));
+    if (!block || !range) {
+        free(block);
+        free(range);
         return NULL;
     }
 
-    /* Create descriptor pool */
-    VkDescriptorPoolSize pool_sizes[] = {
-        { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 32 },
-        { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 16 },
-        { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 16 }
+    VkMemoryAllocateInfo alloc_info = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .allocationSize = size,
+        .memoryTypeIndex = type_index
     };
 
-    VkDescriptorPoolCreateInfo desc_pool_info = {
-        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
-        .maxSets = 32,
-        .poolSizeCount = 3,
-        .pPoolSizes = pool_sizes
-    };
+    if (vkAllocateMemory(ctx->device, &alloc_info, NULL, &block->memory) != VK_SUCCESS) {
+        free(block);
+        free(range);
+        return NULL;
+    }
 
-    vkCreateDescriptorPool(ctx->device, &desc_pool_info, NULL, &ctx->descriptor_pool);
+    if (ctx->memory_properties.memoryTypes[type_index].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        if (vkMapMemory(ctx->device, block->memory, 0, VK_WHOLE_SIZE, 0, &block->mapped) != VK_SUCCESS) {
+            vkFreeMemory(ctx->device, block->memory, NULL);
+            free(block);
+            free(range);
+            return NULL;
+        }
+    }
 
-    return ctx;
-}
+    block->size = size;
+    block->type_index = type_index;
+    block->kind = kind;
+    block->dedicated = dedicated;
+    range->size = size;
+    block->free_list = range;
 
-const char* svk_get_device_name(svk_context ctx) {
-    return ctx ? ctx->device_name : "Unknown";
+    block->next = ctx->blocks;
+    ctx->blocks = block;
+    return block;
 }
 
-uint32_t svk_get_vendor_id(svk_context ctx) {
-    return ctx ? ctx->vendor_id : 0;
+static void destroy_block(svk_context ctx, svk_mem_block* block) {
+    svk_mem_block** link = &ctx->blocks;
+    while (*link && *link != block) link = &(*link)->next;
+    if (*link) *link = block->next;
+
+    if (block->mapped) vkUnmapMemory(ctx->device, block->memory);
+    vkFreeMemory(ctx->device, block->memory, NULL);
+
+    while (block->free_list) {
+        svk_free_range* next = block->free_list->next;
+        free(block->free_list);
+        block->free_list = next;
+    }
+    free(block);
 }
 
-int svk_is_discrete_gpu(svk_context ctx) {
-    return ctx ? ctx->is_discrete : 0;
+/* First-fit search of one block. Returns 1 and fills offset on success. */
+static int block_take(svk_mem_block* block, uint64_t size, uint64_t alignment, uint64_t* offset) {
+    svk_free_range** link = &block->free_list;
+
+    while (*link) {
+        svk_free_range* range = *link;
+        uint64_t start = align_up(range->offset, alignment);
+        uint64_t end = range->offset + range->size;
+
+        if (start + size <= end) {
+            uint64_t tail = end - (start + size);
+
+            if (start > range->offset) {
+                /* Keep the alignment padding as a free range */
+                range->size = start - range->offset;
+                if (tail > 0) {
+                    svk_free_range* rest = (svk_free_range*)malloc(sizeof(svk_free_range));
+                    if (!rest) {
+                        range->size = end - range->offset;
+                        return 0;
+                    }
+                    rest->offset = start + size;
+                    rest->size = tail;
+                    rest->next = range->next;
+                    range->next = rest;
+                }
+            } else if (tail > 0) {
+                range->offset = start + size;
+                range->size = tail;
+            } else {
+                *link = range->next;
+                free(range);
+            }
+
+            block->used += size;
+            block->allocation_count++;
+            *offset = start;
+            return 1;
+        }
+        link = &range->next;
+    }
+    return 0;
 }
 
-uint32_t svk_get_max_workgroup_size(svk_context ctx) {
-    return ctx ? ctx->max_workgroup_size : 0;
+/* Return a range to the block, merging with its neighbours */
+static int block_release(svk_mem_block* block, uint64_t offset, uint64_t size) {
+    svk_free_range* prev = NULL;
+    svk_free_range* next = block->free_list;
+    while (next && next->offset < offset) {
+        prev = next;
+        next = next->next;
+    }
+
+    block->used -= size;
+    block->allocation_count--;
+
+    int joins_prev = prev && prev->offset + prev->size == offset;
+    int joins_next = next && offset + size == next->offset;
+
+    if (joins_prev && joins_next) {
+        prev->size += size + next->size;
+        prev->next = next->next;
+        free(next);
+    } else if (joins_prev) {
+        prev->size += size;
+    } else if (joins_next) {
+        next->offset = offset;
+        next->size += size;
+    } else {
+        svk_free_range* range = (svk_free_range*)malloc(sizeof(svk_free_range));
+        if (!range) return 0;   /* Range is leaked until the block is freed */
+        range->offset = offset;
+        range->size = size;
+        range->next = next;
+        if (prev) prev->next = range;
+        else block->free_list = range;
+    }
+    return 1;
 }
 
-void svk_cleanup(svk_context ctx) {
-    if (!ctx) return;
+/* Allocate from a type with all required flags, preferring one that also has preferred */
+static int allocate_memory(svk_context ctx, const VkMemoryRequirements* mem_reqs, VkMemoryPropertyFlags required,
+                           VkMemoryPropertyFlags preferred, int kind, svk_allocation* out) {
+    uint32_t type_index = find_memory_type(ctx, mem_reqs->memoryTypeBits, required | preferred);
+    if (type_index == UINT32_MAX) type_index = find_memory_type(ctx, mem_reqs->memoryTypeBits, required);
+    if (type_index == UINT32_MAX) return 0;
+
+    /* Non-coherent ranges are flushed in whole atoms, so keep neighbours out of them */
+    VkMemoryRequirements adjusted = *mem_reqs;
+    const VkMemoryRequirements* reqs = &adjusted;
+    VkMemoryPropertyFlags flags = ctx->memory_properties.memoryTypes[type_index].propertyFlags;
+    if ((flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) && !(flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+        if (adjusted.alignment < ctx->non_coherent_atom_size) adjusted.alignment = ctx->non_coherent_atom_size;
+        adjusted.size = align_up(adjusted.size, ctx->non_coherent_atom_size);
+    }
 
-    vkDeviceWaitIdle(ctx->device);
+    uint64_t block_size = block_size_for_type(ctx, type_index);
+    uint64_t offset = 0;
 
-    if (ctx->staging_buffer) {
-        vkDestroyBuffer(ctx->device, ctx->staging_buffer, NULL);
-        vkFreeMemory(ctx->device, ctx->staging_memory, NULL);
+    /* Large resources get their own block */
+    if (reqs->size > block_size / 2) {
+        svk_mem_block* block = create_block(ctx, type_index, reqs->size, kind, 1);
+        if (!block) return 0;
+        if (!block_take(block, reqs->size, reqs->alignment, &offset)) {
+            destroy_block(ctx, block);
+            return 0;
+        }
+        out->block = block;
+        out->offset = offset;
+        out->size = reqs->size;
+        return 1;
     }
 
-    if (ctx->descriptor_pool) vkDestroyDescriptorPool(ctx->device, ctx->descriptor_pool, NULL);
-    if (ctx->command_pool) vkDestroyCommandPool(ctx->device, ctx->command_pool, NULL);
-    if (ctx->device) vkDestroyDevice(ctx->device, NULL);
-    if (ctx->instance) vkDestroyInstance(ctx->instance, NULL);
+    for (svk_mem_block* block = ctx->blocks; block; block = block->next) {
+        if (block->dedicated || block->type_index != type_index || block->kind != kind) continue;
+        if (block->size - block->used < reqs->size) continue;
+        if (block_take(block, reqs->size, reqs->alignment, &offset)) {
+            out->block = block;
+            out->offset = offset;
+            out->size = reqs->size;
+            return 1;
+        }
+    }
 
-    free(ctx);
+    svk_mem_block* block = create_block(ctx, type_index, block_size, kind, 0);
+    if (!block) return 0;
+    if (!block_take(block, reqs->size, reqs->alignment, &offset)) {
+        destroy_block(ctx, block);
+        return 0;
+    }
+    out->block = block;
+    out->offset = offset;
+    out->size = reqs->size;
+    return 1;
 }
 
-/* ============================================================================
- * Buffer Management
- * ============================================================================ */
-
-svk_buffer svk_create_buffer(svk_context ctx, uint64_t size, uint32_t usage) {
-    if (!ctx || size == 0) return NULL;
+/* Flush host writes to, or invalidate host caches of, a non-coherent mapped range */
+static int sync_mapped_range(svk_context ctx, const svk_allocation* alloc, uint64_t offset, uint64_t size, int flush) {
+    svk_mem_block* block = alloc->block;
+    VkMemoryPropertyFlags flags = ctx->memory_properties.memoryTypes[block->type_index].propertyFlags;
+    if (flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) return 1;
+
+    uint64_t atom = ctx->non_coherent_atom_size;
+    uint64_t start = (alloc->offset + offset) / atom * atom;
+    uint64_t end = align_up(alloc->offset + offset + size, atom);
+    if (end > block->size) end = block->size;
+
+    VkMappedMemoryRange range = {
+        .sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+        .memory = block->memory,
+        .offset = start,
+        .size = end - start
+    };
 
-    svk_buffer buf = (svk_buffer)calloc(1, sizeof(struct svk_buffer_t));
-    if (!buf) return NULL;
+    if (flush) return vkFlushMappedMemoryRanges(ctx->device, 1, &range) == VK_SUCCESS;
+    return vkInvalidateMappedMemoryRanges(ctx->device, 1, &range) == VK_SUCCESS;
+}
 
-    buf->size = size;
-    buf->usage = usage;
+static void free_memory(svk_context ctx, svk_allocation* alloc) {
+    svk_mem_block* block = alloc->block;
+    if (!block) return;
 
-    VkBufferUsageFlags vk_usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-    if (usage & SVK_BUFFER_STORAGE) vk_usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
-    if (usage & SVK_BUFFER_UNIFORM) vk_usage |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    block_release(block, alloc->offset, alloc->size);
+    alloc->block = NULL;
 
-    VkBufferCreateInfo buffer_info = {
-        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-        .size = size,
-        .usage = vk_usage,
-        .sharingMode = VK_SHARING_MODE_EXCLUSIVE
-    };
+    if (block->allocation_count > 0) return;
 
-    if (vkCreateBuffer(ctx->device, &buffer_info, NULL, &buf->buffer) != VK_SUCCESS) {
-        free(buf);
-        return NULL;
+    /* Keep one empty block per memory type and kind to absorb churn */
+    if (!block->dedicated) {
+        for (svk_mem_block* other = ctx->blocks; other; other = other->next) {
+            if (other != block && !other->dedicated && other->allocation_count == 0 &&
+                other->type_index == block->type_index && other->kind == block->kind) {
+                destroy_block(ctx, block);
+                return;
+            }
+        }
+        return;
     }
+    destroy_block(ctx, block);
+}
 
-    VkMemoryRequirements mem_reqs;
-    vkGetBufferMemoryRequirements(ctx->device, buf->buffer, &mem_reqs);
+/* ============================================================================
+ * Submission Ring
+ *
+ * Each slot owns a command buffer and a fence. A slot is reused only after
+ * its fence has signaled, so recording never waits unless all slots are busy.
+ * Every thread records into the slots of its own lane; submission to the
+ * shared queues happens under the context lock.
+ * ============================================================================ */
 
-    VkMemoryAllocateInfo alloc_info = {
-        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize = mem_reqs.size,
-        .memoryTypeIndex = find_memory_type(ctx->physical_device, mem_reqs.memoryTypeBits,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+/* Command pool for graph batches, shared under the context lock */
+static int create_queue(svk_context ctx, svk_queue* q) {
+    VkCommandPoolCreateInfo pool_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        .queueFamilyIndex = q->family
     };
 
-    if (vkAllocateMemory(ctx->device, &alloc_info, NULL, &buf->memory) != VK_SUCCESS) {
-        vkDestroyBuffer(ctx->device, buf->buffer, NULL);
-        free(buf);
-        return NULL;
+    if (vkCreateCommandPool(ctx->device, &pool_info, NULL, &q->command_pool) != VK_SUCCESS) {
+        q->command_pool = VK_NULL_HANDLE;
+        return 0;
     }
+    return 1;
+}
 
-    vkBindBufferMemory(ctx->device, buf->buffer, buf->memory, 0);
+static void destroy_queue(svk_context ctx, svk_queue* q) {
+    if (q->command_pool) vkDestroyCommandPool(ctx->device, q->command_pool, NULL);
+    if (q->timeline) vkDestroySemaphore(ctx->device, q->timeline, NULL);
+    q->command_pool = VK_NULL_HANDLE;
+}
 
-    return buf;
+static int free_buffer(svk_context ctx, svk_buffer buf);
+static void drop_unsubmitted_timings(svk_context ctx, svk_submit_slot* slot);
+
+static void destroy_lane(svk_context ctx, svk_lane* lane) {
+    /* Before the fences, which freeing a buffer may wait on */
+    for (int i = 0; i < SVK_STAGING_SLOTS; i++) {
+        free_buffer(ctx, lane->upload_ring.slots[i]);
+        free_buffer(ctx, lane->readback_ring.slots[i]);
+    }
+    for (int q = 0; q < SVK_QUEUE_COUNT; q++) {
+        if (!lane->pools[q]) continue;
+        for (int i = 0; i < SVK_RING_SIZE; i++) {
+            svk_submit_slot* slot = &lane->ring[q][i];
+            drop_unsubmitted_timings(ctx, slot);
+            if (slot->fence) vkDestroyFence(ctx->device, slot->fence, NULL);
+            if (slot->cmd) vkFreeCommandBuffers(ctx->device, lane->pools[q], 1, &slot->cmd);
+        }
+        vkDestroyCommandPool(ctx->device, lane->pools[q], NULL);
+    }
+    free(lane);
 }
 
-int svk_upload_buffer(svk_context ctx, svk_buffer buf, const void* data, uint64_t size, uint64_t offset) {
-    if (!ctx || !buf || !data) return 0;
-    if (offset + size > buf->size) return 0;
+/* Command pools and rings for each queue the context uses */
+static svk_lane* create_lane(svk_context ctx) {
+    svk_lane* lane = (svk_lane*)calloc(1, sizeof(svk_lane));
+    if (!lane) return NULL;
+
+    VkFenceCreateInfo fence_info = {
+        .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO
+    };
 
-    void* mapped;
-    if (vkMapMemory(ctx->device, buf->memory, offset, size, 0, &mapped) != VK_SUCCESS) return 0;
-    memcpy(mapped, data, size);
-    vkUnmapMemory(ctx->device, buf->memory);
+    for (int q = 0; q < SVK_QUEUE_COUNT; q++) {
+        svk_queue* queue = &ctx->queue_storage[q];
+        if (!queue->command_pool) continue;
 
-    return 1;
+        VkCommandPoolCreateInfo pool_info = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+            .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+            .queueFamilyIndex = queue->family
+        };
+
+        if (vkCreateCommandPool(ctx->device, &pool_info, NULL, &lane->pools[q]) != VK_SUCCESS) {
+            lane->pools[q] = VK_NULL_HANDLE;
+            destroy_lane(ctx, lane);
+            return NULL;
+        }
+
+        VkCommandBufferAllocateInfo alloc_info = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = lane->pools[q],
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = 1
+        };
+
+        for (int i = 0; i < SVK_RING_SIZE; i++) {
+            svk_submit_slot* slot = &lane->ring[q][i];
+            slot->queue = queue;
+            if (vkAllocateCommandBuffers(ctx->device, &alloc_info, &slot->cmd) != VK_SUCCESS ||
+                vkCreateFence(ctx->device, &fence_info, NULL, &slot->fence) != VK_SUCCESS) {
+                destroy_lane(ctx, lane);
+                return NULL;
+            }
+        }
+    }
+    return lane;
 }
 
-int svk_download_buffer(svk_context ctx, svk_buffer buf, void* data, uint64_t size, uint64_t offset) {
-    if (!ctx || !buf || !data) return 0;
-    if (offset + size > buf->size) return 0;
+/* The calling thread's lane, adopting a released one or creating it */
+static svk_lane* thread_lane(svk_context ctx) {
+    svk_thread_id self = current_thread();
+    svk_lane* spare = NULL;
+    for (svk_lane* lane = ctx->lanes; lane; lane = lane->next) {
+        if (!lane->released && same_thread(lane->thread, self)) return lane;
+        if (lane->released && !spare) spare = lane;
+    }
 
-    void* mapped;
-    if (vkMapMemory(ctx->device, buf->memory, offset, size, 0, &mapped) != VK_SUCCESS) return 0;
-    memcpy(data, mapped, size);
-    vkUnmapMemory(ctx->device, buf->memory);
+    svk_lane* lane = spare;
+    if (!lane) {
+        lane = create_lane(ctx);
+        if (!lane) return NULL;
+        lane->next = ctx->lanes;
+        ctx->lanes = lane;
+    }
+    lane->thread = self;
+    lane->released = 0;
+    return lane;
+}
 
+/* Hand the calling thread's lane to the next thread that needs one. Its
+   submissions may still be in flight; the next owner retires them as usual. */
+static int release_thread(svk_context ctx) {
+    svk_thread_id self = current_thread();
+    for (svk_lane* lane = ctx->lanes; lane; lane = lane->next) {
+        if (lane->released || !same_thread(lane->thread, self)) continue;
+
+        /* Not while a command list is recording into (or holding) a slot */
+        for (int q = 0; q < SVK_QUEUE_COUNT; q++) {
+            for (int i = 0; i < SVK_RING_SIZE; i++) {
+                if (lane->ring[q][i].recording) return 0;
+            }
+        }
+        lane->released = 1;
+    }
     return 1;
 }
 
-uint64_t svk_buffer_size(svk_buffer buf) {
-    return buf ? buf->size : 0;
+/* Wait for a slot's submission (if any) to finish. The context lock is
+   released meanwhile, and the slot is not reused until the wait is over.
+   Other state may change during the wait: callers finish their updates
+   before it, or look again once it returns. */
+static int retire_slot(svk_context ctx, svk_submit_slot* slot) {
+    if (!slot->pending) return 1;
+    svk_ticket ticket = slot->ticket;
+    VkFence fence = slot->fence;
+
+    slot->waiters++;
+    uint32_t depth = context_unlock_all(ctx);
+    VkResult result = vkWaitForFences(ctx->device, 1, &fence, VK_TRUE, UINT64_MAX);
+    context_relock(ctx, depth);
+    slot->waiters--;
+
+    if (result != VK_SUCCESS) return 0;
+    if (slot->ticket == ticket) slot->pending = 0;
+    return 1;
 }
 
-void svk_free_buffer(svk_context ctx, svk_buffer buf) {
-    if (!ctx || !buf) return;
-    vkDestroyBuffer(ctx->device, buf->buffer, NULL);
-    vkFreeMemory(ctx->device, buf->memory, NULL);
-    free(buf);
+/* Find the slot, on any queue and lane, still holding an unretired submission for ticket */
+static svk_submit_slot* find_ticket_slot(svk_context ctx, svk_ticket ticket) {
+    if (ticket == 0) return NULL;
+    for (svk_lane* lane = ctx->lanes; lane; lane = lane->next) {
+        for (int q = 0; q < SVK_QUEUE_COUNT; q++) {
+            if (!lane->pools[q]) continue;
+            for (int i = 0; i < SVK_RING_SIZE; i++) {
+                svk_submit_slot* slot = &lane->ring[q][i];
+                if (slot->pending && slot->ticket == ticket) return slot;
+            }
+        }
+    }
+    return NULL;
 }
 
-/* ============================================================================
- * Image Management
- * ============================================================================ */
+/* Wait until the submission recorded in `*last_ticket` is done. Waiting
+   releases the lock, so a newer submission may have been stored there
+   meanwhile; wait again until the field is unchanged across a wait. */
+static int wait_last_ticket(svk_context ctx, const svk_ticket* last_ticket) {
+    for (;;) {
+        svk_ticket ticket = *last_ticket;
+        if (!svk_wait_ticket(ctx, ticket)) return 0;
+        if (*last_ticket == ticket) return 1;
+    }
+}
 
-svk_image svk_create_image(svk_context ctx, uint32_t width, uint32_t height, uint32_t format) {
-    if (!ctx || width == 0 || height == 0) return NULL;
+/* Make the slot's submission wait for `ticket` when that runs on another queue.
+   Work on the same queue is already ordered by the barrier in begin_slot. */
+static void slot_depend(svk_context ctx, svk_submit_slot* slot, svk_ticket ticket) {
+    svk_submit_slot* other = find_ticket_slot(ctx, ticket);
+    if (!other || other->queue == slot->queue) return;
+    svk_ticket* wait = &slot->waits[other->queue->role];
+    if (*wait < ticket) *wait = ticket;
+}
 
-    svk_image img = (svk_image)calloc(1, sizeof(struct svk_image_t));
-    if (!img) return NULL;
+/* Forget stamps recorded into a slot that was never submitted */
+static void drop_unsubmitted_timings(svk_context ctx, svk_submit_slot* slot) {
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < ctx->timing_count; i++) {
+        svk_timing* t = &ctx->timings[i];
+        if (t->slot == slot && t->ticket == 0) {
+            ctx->free_queries[ctx->free_query_count++] = t->query;
+        } else {
+            ctx->timings[kept++] = *t;
+        }
+    }
+    ctx->timing_count = kept;
+}
 
-    img->width = width;
-    img->height = height;
-    img->format = format;
+/* Take the next idle slot of the role's queue in the calling thread's lane
+   and start recording into it */
+static svk_submit_slot* begin_slot(svk_context ctx, uint32_t role) {
+    svk_queue* q = ctx->queues[role];
+    svk_lane* lane = thread_lane(ctx);
+    if (!lane) return NULL;
+    svk_submit_slot* ring = lane->ring[q->role];
+    uint32_t* next = &lane->ring_next[q->role];
+    svk_submit_slot* slot = NULL;
+
+    /* Skip slots held open by command lists or waited on by other threads */
+    for (int i = 0; i < SVK_RING_SIZE && !slot; i++) {
+        svk_submit_slot* candidate = &ring[*next];
+        *next = (*next + 1) % SVK_RING_SIZE;
+        if (candidate->recording || candidate->waiters) continue;
+        if (!retire_slot(ctx, candidate)) return NULL;
+        /* Another thread may have started waiting while the lock was released */
+        if (!candidate->waiters) slot = candidate;
+    }
+    if (!slot) return NULL;
+    drop_unsubmitted_timings(ctx, slot);
+    memset(slot->waits, 0, sizeof(slot->waits));
 
-    VkFormat vk_format = (format == SVK_FORMAT_RGBA32F) ? VK_FORMAT_R32G32B32A32_SFLOAT : VK_FORMAT_R8G8B8A8_UNORM;
+    vkResetCommandBuffer(slot->cmd, 0);
 
-    VkImageCreateInfo image_info = {
-        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
-        .imageType = VK_IMAGE_TYPE_2D,
-        .format = vk_format,
-        .extent = { width, height, 1 },
-        .mipLevels = 1,
-        .arrayLayers = 1,
-        .samples = VK_SAMPLE_COUNT_1_BIT,
-        .tiling = VK_IMAGE_TILING_OPTIMAL,
-        .usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
-        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
-        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+    VkCommandBufferBeginInfo begin_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
     };
 
-    if (vkCreateImage(ctx->device, &image_info, NULL, &img->image) != VK_SUCCESS) {
-        free(img);
+    if (vkBeginCommandBuffer(slot->cmd, &begin_info) != VK_SUCCESS) return NULL;
+
+    /* Make writes from earlier submissions on this queue visible */
+    VkMemoryBarrier barrier = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = q->write_access,
+        .dstAccessMask = q->access
+    };
+
+    vkCmdPipelineBarrier(slot->cmd, q->stages, q->stages, 0, 1, &barrier, 0, NULL, 0, NULL);
+
+    slot->recording = 1;
+    return slot;
+}
+
+/* Finish recording into the slot's command buffer */
+static int end_slot(svk_submit_slot* slot) {
+    /* Make device writes visible to host reads after the fence signals */
+    VkMemoryBarrier barrier = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = slot->queue->write_access,
+        .dstAccessMask = VK_ACCESS_HOST_READ_BIT
+    };
+
+    vkCmdPipelineBarrier(slot->cmd, slot->queue->stages, VK_PIPELINE_STAGE_HOST_BIT,
+        0, 1, &barrier, 0, NULL, 0, NULL);
+
+    return vkEndCommandBuffer(slot->cmd) == VK_SUCCESS;
+}
+
+/* Submit an ended slot. Returns its ticket, or 0 on failure. */
+static svk_ticket queue_slot(svk_context ctx, svk_submit_slot* slot) {
+    svk_queue* q = slot->queue;
+    svk_ticket ticket = ctx->last_ticket + 1;
+    slot->recording = 0;
+
+    vkResetFences(ctx->device, 1, &slot->fence);
+
+    /* Cross-queue dependencies wait on the other queues' timelines */
+    VkSemaphore wait_semaphores[SVK_QUEUE_COUNT];
+    uint64_t wait_values[SVK_QUEUE_COUNT];
+    VkPipelineStageFlags wait_stages[SVK_QUEUE_COUNT];
+    uint32_t wait_count = 0;
+    for (int i = 0; i < SVK_QUEUE_COUNT; i++) {
+        if (slot->waits[i] == 0) continue;
+        wait_semaphores[wait_count] = ctx->queue_storage[i].timeline;
+        wait_values[wait_count] = slot->waits[i];
+        wait_stages[wait_count] = q->stages;
+        wait_count++;
+    }
+
+    VkTimelineSemaphoreSubmitInfo timeline_info = {
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .waitSemaphoreValueCount = wait_count,
+        .pWaitSemaphoreValues = wait_values,
+        .signalSemaphoreValueCount = 1,
+        .pSignalSemaphoreValues = &ticket
+    };
+
+    VkSubmitInfo submit_info = {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = q->timeline ? &timeline_info : NULL,
+        .waitSemaphoreCount = wait_count,
+        .pWaitSemaphores = wait_semaphores,
+        .pWaitDstStageMask = wait_stages,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &slot->cmd,
+        .signalSemaphoreCount = q->timeline ? 1 : 0,
+        .pSignalSemaphores = &q->timeline
+    };
+
+    if (vkQueueSubmit(q->queue, 1, &submit_info, slot->fence) != VK_SUCCESS) return 0;
+
+    ctx->last_ticket = ticket;
+    slot->ticket = ticket;
+    slot->pending = 1;
+
+    for (uint32_t i = 0; i < ctx->timing_count; i++) {
+        if (ctx->timings[i].slot == slot && ctx->timings[i].ticket == 0) ctx->timings[i].ticket = slot->ticket;
+    }
+    return slot->ticket;
+}
+
+/* Finish recording and submit the slot. Returns its ticket, or 0 on failure. */
+static svk_ticket submit_slot(svk_context ctx, svk_submit_slot* slot) {
+    if (!end_slot(slot)) {
+        slot->recording = 0;
+        return 0;
+    }
+    return queue_slot(ctx, slot);
+}
+
+/* ============================================================================
+ * GPU Timestamps
+ *
+ * Each profiled command is bracketed by two timestamps written at
+ * BOTTOM_OF_PIPE: the first once all earlier commands have finished, the
+ * second once the command itself has. The difference is the command's own
+ * execution time, excluding submission and queue overhead.
+ * ============================================================================ */
+
+/* Reset and write the opening stamp. Returns the timing index, or -1 when
+   profiling is off, the queue has no timestamps, or every query pair is
+   awaiting collection. */
+static int timing_begin(svk_context ctx, svk_submit_slot* slot, uint32_t kind) {
+    if (!ctx->timestamp_pool || slot->queue->timestamp_bits == 0) return -1;
+    if (ctx->free_query_count == 0) {
+        ctx->dropped_timings++;
+        return -1;
+    }
+
+    svk_timing* t = &ctx->timings[ctx->timing_count];
+    t->slot = slot;
+    t->ticket = 0;
+    t->query = ctx->free_queries[--ctx->free_query_count];
+    t->tag = ctx->profile_tag;
+    t->kind = kind;
+
+    vkCmdResetQueryPool(slot->cmd, ctx->timestamp_pool, t->query, 2);
+    vkCmdWriteTimestamp(slot->cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, ctx->timestamp_pool, t->query);
+    return (int)ctx->timing_count++;
+}
+
+static void timing_end(svk_context ctx, svk_submit_slot* slot, int index) {
+    if (index < 0) return;
+    vkCmdWriteTimestamp(slot->cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, ctx->timestamp_pool,
+                        ctx->timings[index].query + 1);
+}
+
+static void destroy_timestamps(svk_context ctx) {
+    if (ctx->timestamp_pool) vkDestroyQueryPool(ctx->device, ctx->timestamp_pool, NULL);
+    free(ctx->timings);
+    free(ctx->free_queries);
+    ctx->timestamp_pool = VK_NULL_HANDLE;
+    ctx->timings = NULL;
+    ctx->free_queries = NULL;
+    ctx->timing_count = 0;
+    ctx->free_query_count = 0;
+}
+
+static int enable_profiling(svk_context ctx, uint32_t max_pending) {
+    if (!ctx || max_pending == 0) return 0;
+    if (ctx->timestamp_valid_bits == 0 || ctx->timestamp_period <= 0.0) return 0;
+
+    svk_disable_profiling(ctx);
+
+    VkQueryPoolCreateInfo pool_info = {
+        .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+        .queryType = VK_QUERY_TYPE_TIMESTAMP,
+        .queryCount = max_pending * 2
+    };
+
+    ctx->timings = (svk_timing*)malloc(max_pending * sizeof(svk_timing));
+    ctx->free_queries = (uint32_t*)malloc(max_pending * sizeof(uint32_t));
+    if (!ctx->timings || !ctx->free_queries ||
+        vkCreateQueryPool(ctx->device, &pool_info, NULL, &ctx->timestamp_pool) != VK_SUCCESS) {
+        ctx->timestamp_pool = VK_NULL_HANDLE;
+        destroy_timestamps(ctx);
+        return 0;
+    }
+
+    /* Hand out low pairs first */
+    for (uint32_t i = 0; i < max_pending; i++) ctx->free_queries[i] = (max_pending - 1 - i) * 2;
+    ctx->free_query_count = max_pending;
+    ctx->dropped_timings = 0;
+    return 1;
+}
+
+static void disable_profiling(svk_context ctx) {
+    if (!ctx || !ctx->timestamp_pool) return;
+    vkDeviceWaitIdle(ctx->device);
+    destroy_timestamps(ctx);
+}
+
+static void set_profile_tag(svk_context ctx, uint32_t tag) {
+    if (ctx) ctx->profile_tag = tag;
+}
+
+static uint32_t collect_gpu_samples(svk_context ctx, svk_gpu_sample* samples, uint32_t max_samples) {
+    if (!ctx || !samples || !ctx->timestamp_pool) return 0;
+
+    uint32_t count = 0;
+    uint32_t kept = 0;
+
+    for (uint32_t i = 0; i < ctx->timing_count; i++) {
+        svk_timing* t = &ctx->timings[i];
+        svk_submit_slot* slot = find_ticket_slot(ctx, t->ticket);
+        int done = t->ticket != 0 &&
+                   (!slot || vkGetFenceStatus(ctx->device, slot->fence) == VK_SUCCESS);
+        uint64_t stamps[2];
+
+        if (!done || count >= max_samples) {
+            ctx->timings[kept++] = *t;
+            continue;
+        }
+
+        if (vkGetQueryPoolResults(ctx->device, ctx->timestamp_pool, t->query, 2, sizeof(stamps), stamps,
+                                  sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS) {
+            uint32_t bits = t->slot->queue->timestamp_bits;
+            uint64_t mask = bits >= 64 ? UINT64_MAX : (1ull << bits) - 1;
+            uint64_t ticks = (stamps[1] - stamps[0]) & mask;
+            samples[count++] = (svk_gpu_sample){
+                .tag = t->tag,
+                .kind = t->kind,
+                .ticket = t->ticket,
+                .gpu_ns = (uint64_t)((double)ticks * ctx->timestamp_period + 0.5)
+            };
+        }
+        ctx->free_queries[ctx->free_query_count++] = t->query;
+    }
+
+    ctx->timing_count = kept;
+    return count;
+}
+
+uint64_t svk_dropped_gpu_samples(svk_context ctx) {
+    return ctx ? ctx->dropped_timings : 0;
+}
+
+uint64_t svk_time_ns(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER now;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&now);
+    return (uint64_t)((double)now.QuadPart * 1e9 / (double)frequency.QuadPart);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+#endif
+}
+
+/* ============================================================================
+ * Initialization
+ * ============================================================================ */
+
+static int create_instance(VkInstance* instance) {
+    VkApplicationInfo app_info = {
+        .sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+        .pApplicationName = "simple_vulkan",
+        .applicationVersion = VK_MAKE_VERSION(1, 0, 0),
+        .pEngineName = "simple_vulkan",
+        .engineVersion = VK_MAKE_VERSION(1, 0, 0),
+        .apiVersion = VK_API_VERSION_1_2
+    };
+
+    VkInstanceCreateInfo create_info = {
+        .sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
+        .pApplicationInfo = &app_info
+    };
+
+    return vkCreateInstance(&create_info, NULL, instance) == VK_SUCCESS;
+}
+
+/* Physical devices in enumeration order (caller frees); NULL if there are none */
+static VkPhysicalDevice* enumerate_devices(VkInstance instance, uint32_t* count) {
+    *count = 0;
+    vkEnumeratePhysicalDevices(instance, count, NULL);
+    if (*count == 0) return NULL;
+
+    VkPhysicalDevice* devices = (VkPhysicalDevice*)malloc(*count * sizeof(VkPhysicalDevice));
+    if (!devices || vkEnumeratePhysicalDevices(instance, count, devices) < 0 || *count == 0) {
+        free(devices);
         return NULL;
     }
+    return devices;
+}
 
-    VkMemoryRequirements mem_reqs;
-    vkGetImageMemoryRequirements(ctx->device, img->image, &mem_reqs);
+static uint64_t device_local_bytes(const VkPhysicalDeviceMemoryProperties* mem) {
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < mem->memoryHeapCount; i++) {
+        if (mem->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) total += mem->memoryHeaps[i].size;
+    }
+    return total;
+}
 
-    VkMemoryAllocateInfo alloc_info = {
-        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize = mem_reqs.size,
-        .memoryTypeIndex = find_memory_type(ctx->physical_device, mem_reqs.memoryTypeBits,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+static void describe_device(VkPhysicalDevice device, svk_device_info* info) {
+    VkPhysicalDeviceProperties props;
+    VkPhysicalDeviceMemoryProperties mem;
+    uint32_t family;
+    vkGetPhysicalDeviceProperties(device, &props);
+    vkGetPhysicalDeviceMemoryProperties(device, &mem);
+
+    memset(info, 0, sizeof(*info));
+    strncpy(info->name, props.deviceName, sizeof(info->name) - 1);
+    info->type = (uint32_t)props.deviceType;
+    info->vendor_id = props.vendorID;
+    info->device_id = props.deviceID;
+    info->api_version = props.apiVersion;
+    info->has_compute = find_compute_queue_family(device, &family);
+    info->max_workgroup_size = props.limits.maxComputeWorkGroupInvocations;
+    memcpy(info->max_workgroup_count, props.limits.maxComputeWorkGroupCount, sizeof(info->max_workgroup_count));
+    info->max_push_constants_size = props.limits.maxPushConstantsSize;
+    info->max_storage_buffer_range = props.limits.maxStorageBufferRange;
+    info->max_image_dimension = props.limits.maxImageDimension2D;
+
+    info->heap_count = mem.memoryHeapCount < SVK_MAX_HEAPS ? mem.memoryHeapCount : SVK_MAX_HEAPS;
+    for (uint32_t i = 0; i < info->heap_count; i++) {
+        info->heap_size[i] = mem.memoryHeaps[i].size;
+        if (mem.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) info->device_local_heaps |= 1u << i;
+    }
+    info->device_local_bytes = device_local_bytes(&mem);
+}
+
+/* The device list does not change within a process, so it is described once,
+   from one instance, and kept */
+static svk_device_info* device_list;
+static uint32_t device_list_count;
+static svk_once device_list_once = SVK_ONCE_INIT;
+
+static void describe_devices(void) {
+    VkInstance instance;
+    if (!create_instance(&instance)) return;
+
+    uint32_t count;
+    VkPhysicalDevice* devices = enumerate_devices(instance, &count);
+    svk_device_info* infos = devices ? (svk_device_info*)malloc(count * sizeof(svk_device_info)) : NULL;
+    if (infos) {
+        for (uint32_t i = 0; i < count; i++) describe_device(devices[i], &infos[i]);
+        device_list = infos;
+        device_list_count = count;
+    }
+
+    free(devices);
+    vkDestroyInstance(instance, NULL);
+}
+
+uint32_t svk_get_device_count(void) {
+    run_once(&device_list_once, describe_devices);
+    return device_list_count;
+}
+
+int svk_get_device_info(uint32_t index, svk_device_info* info) {
+    if (!info) return 0;
+    run_once(&device_list_once, describe_devices);
+    if (index >= device_list_count) return 0;
+    *info = device_list[index];
+    return 1;
+}
+
+/* Create a context on physical device `device_index`, or on the best device
+   for SVK_ANY_DEVICE */
+static svk_context init_context(uint32_t device_index) {
+    svk_context ctx = (svk_context)calloc(1, sizeof(struct svk_context_t));
+    if (!ctx) return NULL;
+
+    if (!create_instance(&ctx->instance)) {
+        free(ctx);
+        return NULL;
+    }
+
+    uint32_t device_count;
+    VkPhysicalDevice* devices = enumerate_devices(ctx->instance, &device_count);
+    if (!devices) {
+        vkDestroyInstance(ctx->instance, NULL);
+        free(ctx);
+        return NULL;
+    }
+
+    /* Select best device: discrete over integrated over the rest, then the
+       most device-local memory, so ties do not follow enumeration order */
+    int best_score = -1;
+    uint64_t best_memory = 0;
+    uint32_t compute_family = 0;
+    for (uint32_t i = 0; i < device_count; i++) {
+        if (device_index != SVK_ANY_DEVICE && i != device_index) continue;
+
+        VkPhysicalDeviceProperties props;
+        VkPhysicalDeviceMemoryProperties mem;
+        vkGetPhysicalDeviceProperties(devices[i], &props);
+        vkGetPhysicalDeviceMemoryProperties(devices[i], &mem);
+
+        int score = 0;
+        if (props.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) score += 1000;
+        else if (props.deviceType == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU) score += 100;
+        uint64_t memory = device_local_bytes(&mem);
+
+        uint32_t family;
+        if (!find_compute_queue_family(devices[i], &family)) continue;
+
+        if (score > best_score || (score == best_score && memory > best_memory)) {
+            best_score = score;
+            best_memory = memory;
+            ctx->physical_device = devices[i];
+            ctx->device_index = i;
+            compute_family = family;
+            strncpy(ctx->device_name, props.deviceName, sizeof(ctx->device_name) - 1);
+            ctx->vendor_id = props.vendorID;
+            ctx->device_id = props.deviceID;
+            ctx->driver_version = props.driverVersion;
+            memcpy(ctx->pipeline_cache_uuid, props.pipelineCacheUUID, VK_UUID_SIZE);
+            ctx->is_discrete = (props.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU);
+            ctx->max_workgroup_size = props.limits.maxComputeWorkGroupInvocations;
+            ctx->api_version = props.apiVersion;
+            ctx->non_coherent_atom_size = props.limits.nonCoherentAtomSize ? props.limits.nonCoherentAtomSize : 1;
+        }
+    }
+    free(devices);
+
+    if (best_score < 0) {
+        vkDestroyInstance(ctx->instance, NULL);
+        free(ctx);
+        return NULL;
+    }
+
+    vkGetPhysicalDeviceMemoryProperties(ctx->physical_device, &ctx->memory_properties);
+
+    VkPhysicalDeviceProperties device_props;
+    vkGetPhysicalDeviceProperties(ctx->physical_device, &device_props);
+    ctx->timestamp_period = device_props.limits.timestampPeriod;
+    ctx->buffer_image_granularity = device_props.limits.bufferImageGranularity ? device_props.limits.bufferImageGranularity : 1;
+
+    uint32_t family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(ctx->physical_device, &family_count, NULL);
+    VkQueueFamilyProperties* families = (VkQueueFamilyProperties*)malloc(family_count * sizeof(VkQueueFamilyProperties));
+    if (!families) {
+        vkDestroyInstance(ctx->instance, NULL);
+        free(ctx);
+        return NULL;
+    }
+    vkGetPhysicalDeviceQueueFamilyProperties(ctx->physical_device, &family_count, families);
+
+    /* Extra queues need timeline semaphores for cross-queue ordering */
+    VkPhysicalDeviceTimelineSemaphoreFeatures timeline_features = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES
     };
+    if (device_props.apiVersion >= VK_API_VERSION_1_2) {
+        VkPhysicalDeviceFeatures2 features = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+            .pNext = &timeline_features
+        };
+        vkGetPhysicalDeviceFeatures2(ctx->physical_device, &features);
+    }
 
-    if (vkAllocateMemory(ctx->device, &alloc_info, NULL, &img->memory) != VK_SUCCESS) {
-        vkDestroyImage(ctx->device, img->image, NULL);
-        free(img);
+    uint32_t roles_family[SVK_QUEUE_COUNT];
+    uint32_t roles_index[SVK_QUEUE_COUNT] = { 0, 0, 0 };
+    int dedicated[SVK_QUEUE_COUNT] = { 1, 0, 0 };
+    select_queues(families, family_count, compute_family, timeline_features.timelineSemaphore,
+                  roles_family, roles_index, dedicated);
+
+    /* One create-info per family, with as many queues as the roles use */
+    float priorities[SVK_QUEUE_COUNT] = { 1.0f, 1.0f, 1.0f };
+    VkDeviceQueueCreateInfo queue_infos[SVK_QUEUE_COUNT];
+    uint32_t queue_info_count = 0;
+    for (int r = 0; r < SVK_QUEUE_COUNT; r++) {
+        if (!dedicated[r]) continue;
+        VkDeviceQueueCreateInfo* info = NULL;
+        for (uint32_t i = 0; i < queue_info_count; i++) {
+            if (queue_infos[i].queueFamilyIndex == roles_family[r]) info = &queue_infos[i];
+        }
+        if (!info) {
+            info = &queue_infos[queue_info_count++];
+            *info = (VkDeviceQueueCreateInfo){
+                .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+                .queueFamilyIndex = roles_family[r],
+                .queueCount = 0,
+                .pQueuePriorities = priorities
+            };
+            ctx->queue_families[ctx->queue_family_count++] = roles_family[r];
+        }
+        info->queueCount++;
+    }
+
+    int multi_queue = dedicated[SVK_QUEUE_ASYNC_COMPUTE] || dedicated[SVK_QUEUE_TRANSFER];
+    VkPhysicalDeviceTimelineSemaphoreFeatures enable_timeline = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES,
+        .timelineSemaphore = VK_TRUE
+    };
+
+    /* Create logical device */
+    VkDeviceCreateInfo device_info = {
+        .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+        .pNext = multi_queue ? &enable_timeline : NULL,
+        .queueCreateInfoCount = queue_info_count,
+        .pQueueCreateInfos = queue_infos
+    };
+
+    if (vkCreateDevice(ctx->physical_device, &device_info, NULL, &ctx->device) != VK_SUCCESS) {
+        free(families);
+        vkDestroyInstance(ctx->instance, NULL);
+        free(ctx);
         return NULL;
     }
 
-    vkBindImageMemory(ctx->device, img->image, img->memory, 0);
+    if (!mutex_init(&ctx->lock)) {
+        free(families);
+        vkDestroyDevice(ctx->device, NULL);
+        vkDestroyInstance(ctx->instance, NULL);
+        free(ctx);
+        return NULL;
+    }
 
-    /* Create image view */
-    VkImageViewCreateInfo view_info = {
-        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
-        .image = img->image,
-        .viewType = VK_IMAGE_VIEW_TYPE_2D,
-        .format = vk_format,
-        .subresourceRange = {
-            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-            .baseMipLevel = 0,
-            .levelCount = 1,
-            .baseArrayLayer = 0,
-            .layerCount = 1
+    VkSemaphoreTypeCreateInfo timeline_type = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue = 0
+    };
+    VkSemaphoreCreateInfo semaphore_info = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &timeline_type
+    };
+
+    for (int r = 0; r < SVK_QUEUE_COUNT; r++) {
+        if (!dedicated[r]) {
+            ctx->queues[r] = &ctx->queue_storage[SVK_QUEUE_COMPUTE];
+            continue;
         }
+
+        svk_queue* q = &ctx->queue_storage[r];
+        VkQueueFlags flags = families[roles_family[r]].queueFlags;
+        q->family = roles_family[r];
+        q->role = (uint32_t)r;
+        vkGetDeviceQueue(ctx->device, q->family, roles_index[r], &q->queue);
+        ctx->queues[r] = q;
+
+        if (flags & (VK_QUEUE_COMPUTE_BIT | VK_QUEUE_GRAPHICS_BIT)) {
+            q->stages = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                        VK_PIPELINE_STAGE_TRANSFER_BIT;
+            q->write_access = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+            q->access = q->write_access | VK_ACCESS_INDIRECT_COMMAND_READ_BIT |
+                        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+            q->timestamp_bits = families[q->family].timestampValidBits;
+        } else {
+            /* Transfer-only: no shader stages, and no vkCmdResetQueryPool for profiling */
+            q->stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            q->write_access = VK_ACCESS_TRANSFER_WRITE_BIT;
+            q->access = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+        }
+
+        if (multi_queue &&
+            vkCreateSemaphore(ctx->device, &semaphore_info, NULL, &q->timeline) != VK_SUCCESS) {
+            q->timeline = VK_NULL_HANDLE;
+            free(families);
+            svk_cleanup(ctx);
+            return NULL;
+        }
+
+        if (!create_queue(ctx, q)) {
+            free(families);
+            svk_cleanup(ctx);
+            return NULL;
+        }
+    }
+    free(families);
+
+    /* Timestamp support of the compute queue, for svk_enable_profiling */
+    ctx->timestamp_valid_bits = ctx->queues[SVK_QUEUE_COMPUTE]->timestamp_bits;
+
+    /* Descriptor pools are created on first use */
+
+    /* Empty pipeline cache; svk_load_pipeline_cache merges saved data into it */
+    VkPipelineCacheCreateInfo cache_info = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO
     };
 
-    if (vkCreateImageView(ctx->device, &view_info, NULL, &img->view) != VK_SUCCESS) {
-        vkFreeMemory(ctx->device, img->memory, NULL);
-        vkDestroyImage(ctx->device, img->image, NULL);
-        free(img);
-        return NULL;
-    }
+    if (vkCreatePipelineCache(ctx->device, &cache_info, NULL, &ctx->pipeline_cache) != VK_SUCCESS) {
+        ctx->pipeline_cache = VK_NULL_HANDLE;
+    }
+
+    return ctx;
+}
+
+svk_context svk_init(void) {
+    return init_context(SVK_ANY_DEVICE);
+}
+
+svk_context svk_init_device(uint32_t index) {
+    if (index == SVK_ANY_DEVICE) return NULL;
+    return init_context(index);
+}
+
+uint32_t svk_get_device_index(svk_context ctx) {
+    return ctx ? ctx->device_index : SVK_ANY_DEVICE;
+}
+
+const char* svk_get_device_name(svk_context ctx) {
+    return ctx ? ctx->device_name : "Unknown";
+}
+
+uint32_t svk_get_vendor_id(svk_context ctx) {
+    return ctx ? ctx->vendor_id : 0;
+}
+
+int svk_is_discrete_gpu(svk_context ctx) {
+    return ctx ? ctx->is_discrete : 0;
+}
+
+uint32_t svk_get_max_workgroup_size(svk_context ctx) {
+    return ctx ? ctx->max_workgroup_size : 0;
+}
+
+int svk_has_dedicated_queue(svk_context ctx, uint32_t role) {
+    if (!ctx || role >= SVK_QUEUE_COUNT) return 0;
+    return role == SVK_QUEUE_COMPUTE || ctx->queues[role] != ctx->queues[SVK_QUEUE_COMPUTE];
+}
+
+uint32_t svk_get_queue_family(svk_context ctx, uint32_t role) {
+    if (!ctx || role >= SVK_QUEUE_COUNT) return UINT32_MAX;
+    return ctx->queues[role]->family;
+}
+
+static int get_memory_stats(svk_context ctx, svk_memory_stats* stats) {
+    if (!ctx || !stats) return 0;
+    memset(stats, 0, sizeof(*stats));
+
+    uint64_t total_free = 0;
+    for (svk_mem_block* block = ctx->blocks; block; block = block->next) {
+        stats->block_count++;
+        if (block->dedicated) stats->dedicated_count++;
+        stats->allocation_count += block->allocation_count;
+        stats->bytes_reserved += block->size;
+        stats->bytes_used += block->used;
+
+        for (svk_free_range* range = block->free_list; range; range = range->next) {
+            stats->free_range_count++;
+            total_free += range->size;
+            if (range->size > stats->largest_free_range) stats->largest_free_range = range->size;
+        }
+    }
+
+    /* 0 = all free space is one range, approaching 1 = scattered */
+    if (total_free > 0) {
+        stats->fragmentation = 1.0 - (double)stats->largest_free_range / (double)total_free;
+    }
+    return 1;
+}
+
+void svk_cleanup(svk_context ctx) {
+    if (!ctx) return;
+
+    vkDeviceWaitIdle(ctx->device);
+
+    while (ctx->lanes) {
+        svk_lane* next = ctx->lanes->next;
+        destroy_lane(ctx, ctx->lanes);
+        ctx->lanes = next;
+    }
+
+    for (int i = 0; i < SVK_READBACK_SLOTS; i++) {
+        free_buffer(ctx, ctx->image_readback[i].staging);
+    }
+
+    while (ctx->blocks) destroy_block(ctx, ctx->blocks);
+
+    while (ctx->desc_pools) {
+        svk_desc_pool* next = ctx->desc_pools->next;
+        vkDestroyDescriptorPool(ctx->device, ctx->desc_pools->pool, NULL);
+        free(ctx->desc_pools);
+        ctx->desc_pools = next;
+    }
+    /* Pipelines and modules whose handles were never freed */
+    while (ctx->variants) {
+        struct svk_pipeline_variant* v = ctx->variants;
+        ctx->variants = v->next;
+        vkDestroyPipeline(ctx->device, v->pipeline, NULL);
+        vkDestroyPipelineLayout(ctx->device, v->layout, NULL);
+        vkDestroyDescriptorSetLayout(ctx->device, v->desc_layout, NULL);
+        free(v->constants);
+        free(v);
+    }
+    while (ctx->shaders) {
+        svk_shader shader = ctx->shaders;
+        ctx->shaders = shader->next;
+        vkDestroyShaderModule(ctx->device, shader->module, NULL);
+        free(shader);
+    }
+    if (ctx->pipeline_cache) vkDestroyPipelineCache(ctx->device, ctx->pipeline_cache, NULL);
+    destroy_timestamps(ctx);
+    for (int i = 0; i < SVK_QUEUE_COUNT; i++) destroy_queue(ctx, &ctx->queue_storage[i]);
+    if (ctx->device) vkDestroyDevice(ctx->device, NULL);
+    if (ctx->instance) vkDestroyInstance(ctx->instance, NULL);
+
+    mutex_destroy(&ctx->lock);
+    free(ctx);
+}
+
+/* ============================================================================
+ * Buffer Management
+ * ============================================================================ */
+
+/* Buffer object without memory */
+static svk_buffer create_buffer_object(svk_context ctx, uint64_t size, uint32_t usage) {
+    svk_buffer buf = (svk_buffer)calloc(1, sizeof(struct svk_buffer_t));
+    if (!buf) return NULL;
+
+    buf->id = ++ctx->next_resource_id;
+    buf->size = size;
+    buf->usage = usage;
+
+    VkBufferUsageFlags vk_usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    if (usage & SVK_BUFFER_STORAGE) vk_usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    if (usage & SVK_BUFFER_UNIFORM) vk_usage |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    if (usage & SVK_BUFFER_INDIRECT) vk_usage |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+
+    VkBufferCreateInfo buffer_info = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = size,
+        .usage = vk_usage,
+        .sharingMode = ctx->queue_family_count > 1 ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = ctx->queue_family_count > 1 ? ctx->queue_family_count : 0,
+        .pQueueFamilyIndices = ctx->queue_families
+    };
+
+    if (vkCreateBuffer(ctx->device, &buffer_info, NULL, &buf->buffer) != VK_SUCCESS) {
+        free(buf);
+        return NULL;
+    }
+
+    return buf;
+}
+
+static svk_buffer create_buffer(svk_context ctx, uint64_t size, uint32_t usage) {
+    if (!ctx || size == 0) return NULL;
+
+    /* At most one placement mode */
+    uint32_t placement = usage & SVK_BUFFER_PLACEMENT_MASK;
+    if (placement & (placement - 1)) return NULL;
+
+    VkMemoryPropertyFlags required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    VkMemoryPropertyFlags preferred = 0;
+    if (placement == SVK_BUFFER_DEVICE_LOCAL) {
+        required = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    } else if (placement == SVK_BUFFER_HOST_READBACK) {
+        required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        preferred = VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+    }
+
+    svk_buffer buf = create_buffer_object(ctx, size, usage);
+    if (!buf) return NULL;
+
+    VkMemoryRequirements mem_reqs;
+    vkGetBufferMemoryRequirements(ctx->device, buf->buffer, &mem_reqs);
+
+    if (!allocate_memory(ctx, &mem_reqs, required, preferred, SVK_ALLOC_LINEAR, &buf->alloc)) {
+        vkDestroyBuffer(ctx->device, buf->buffer, NULL);
+        free(buf);
+        return NULL;
+    }
+
+    vkBindBufferMemory(ctx->device, buf->buffer, buf->alloc.block->memory, buf->alloc.offset);
+
+    return buf;
+}
+
+/* Next staging buffer of a ring, once the GPU is done with its previous use */
+static svk_buffer staging_acquire(svk_context ctx, svk_staging_ring* ring, uint32_t placement) {
+    uint32_t index = ring->next;
+    ring->next = (index + 1) % SVK_STAGING_SLOTS;
+
+    if (!ring->slots[index]) {
+        ring->slots[index] = svk_create_buffer(ctx, SVK_STAGING_SLOT_SIZE, SVK_BUFFER_TRANSFER | placement);
+    }
+
+    svk_buffer staging = ring->slots[index];
+    if (!staging || !wait_last_ticket(ctx, &staging->last_ticket)) return NULL;
+    return staging;
+}
+
+static svk_ticket submit_copy(svk_context ctx, svk_buffer src, svk_buffer dst,
+                              uint64_t src_offset, uint64_t dst_offset, uint64_t size) {
+    svk_submit_slot* slot = begin_slot(ctx, SVK_QUEUE_TRANSFER);
+    if (!slot) return 0;
+    slot_depend(ctx, slot, src->last_ticket);
+    slot_depend(ctx, slot, dst->last_ticket);
+
+    VkBufferCopy region = {
+        .srcOffset = src_offset,
+        .dstOffset = dst_offset,
+        .size = size
+    };
+
+    int timing = timing_begin(ctx, slot, SVK_SAMPLE_COPY);
+    vkCmdCopyBuffer(slot->cmd, src->buffer, dst->buffer, 1, &region);
+    timing_end(ctx, slot, timing);
+
+    svk_ticket ticket = submit_slot(ctx, slot);
+    if (ticket) {
+        src->last_ticket = ticket;
+        dst->last_ticket = ticket;
+    }
+    return ticket;
+}
+
+static int upload_buffer(svk_context ctx, svk_buffer buf, const void* data, uint64_t size, uint64_t offset) {
+    if (!ctx || !buf || !data) return 0;
+    if (offset + size > buf->size) return 0;
+
+    uint8_t* mapped = (uint8_t*)buf->alloc.block->mapped;
+    if (mapped) {
+        if (!wait_last_ticket(ctx, &buf->last_ticket)) return 0;
+        memcpy(mapped + buf->alloc.offset + offset, data, size);
+        return sync_mapped_range(ctx, &buf->alloc, offset, size, 1);
+    }
+
+    /* Device-local: stream through the thread's upload ring. Returns once queued. */
+    svk_lane* lane = thread_lane(ctx);
+    if (!lane) return 0;
+    const uint8_t* src = (const uint8_t*)data;
+    while (size > 0) {
+        uint64_t chunk = size < SVK_STAGING_SLOT_SIZE ? size : SVK_STAGING_SLOT_SIZE;
+
+        svk_buffer staging = staging_acquire(ctx, &lane->upload_ring, SVK_BUFFER_HOST_UPLOAD);
+        if (!staging) return 0;
+
+        memcpy((uint8_t*)staging->alloc.block->mapped + staging->alloc.offset, src, chunk);
+        if (!sync_mapped_range(ctx, &staging->alloc, 0, chunk, 1)) return 0;
+        if (!submit_copy(ctx, staging, buf, 0, offset, chunk)) return 0;
+
+        src += chunk;
+        offset += chunk;
+        size -= chunk;
+    }
+
+    return 1;
+}
+
+static int download_buffer(svk_context ctx, svk_buffer buf, void* data, uint64_t size, uint64_t offset) {
+    if (!ctx || !buf || !data) return 0;
+    if (offset + size > buf->size) return 0;
+
+    const uint8_t* mapped = (const uint8_t*)buf->alloc.block->mapped;
+    if (mapped) {
+        if (!wait_last_ticket(ctx, &buf->last_ticket)) return 0;
+        if (!sync_mapped_range(ctx, &buf->alloc, offset, size, 0)) return 0;
+        memcpy(data, mapped + buf->alloc.offset + offset, size);
+        return 1;
+    }
+
+    /* Device-local: keep up to SVK_STAGING_SLOTS chunk copies in flight */
+    svk_lane* lane = thread_lane(ctx);
+    if (!lane) return 0;
+    uint8_t* dst = (uint8_t*)data;
+    svk_buffer in_flight[SVK_STAGING_SLOTS];
+    uint64_t chunk_size[SVK_STAGING_SLOTS];
+    uint32_t head = 0, count = 0;
+    uint64_t issued = 0, done = 0;
+
+    while (done < size) {
+        while (issued < size && count < SVK_STAGING_SLOTS) {
+            uint64_t chunk = size - issued < SVK_STAGING_SLOT_SIZE ? size - issued : SVK_STAGING_SLOT_SIZE;
+
+            svk_buffer staging = staging_acquire(ctx, &lane->readback_ring, SVK_BUFFER_HOST_READBACK);
+            if (!staging || !submit_copy(ctx, buf, staging, offset + issued, 0, chunk)) return 0;
+
+            uint32_t tail = (head + count) % SVK_STAGING_SLOTS;
+            in_flight[tail] = staging;
+            chunk_size[tail] = chunk;
+            count++;
+            issued += chunk;
+        }
+
+        svk_buffer staging = in_flight[head];
+        uint64_t chunk = chunk_size[head];
+        if (!svk_wait_ticket(ctx, staging->last_ticket)) return 0;
+        if (!sync_mapped_range(ctx, &staging->alloc, 0, chunk, 0)) return 0;
+        memcpy(dst + done, (const uint8_t*)staging->alloc.block->mapped + staging->alloc.offset, chunk);
+
+        head = (head + 1) % SVK_STAGING_SLOTS;
+        count--;
+        done += chunk;
+    }
+
+    return 1;
+}
+
+uint64_t svk_buffer_size(svk_buffer buf) {
+    return buf ? buf->size : 0;
+}
+
+void* svk_buffer_mapped_pointer(svk_buffer buf) {
+    if (!buf || !buf->alloc.block->mapped) return NULL;
+    return (uint8_t*)buf->alloc.block->mapped + buf->alloc.offset;
+}
+
+int svk_buffer_is_coherent(svk_context ctx, svk_buffer buf) {
+    if (!ctx || !buf) return 0;
+    VkMemoryPropertyFlags flags = ctx->memory_properties.memoryTypes[buf->alloc.block->type_index].propertyFlags;
+    return (flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+}
+
+int svk_flush_buffer(svk_context ctx, svk_buffer buf, uint64_t offset, uint64_t size) {
+    if (!ctx || !buf || !buf->alloc.block->mapped) return 0;
+    if (offset + size > buf->size) return 0;
+    return sync_mapped_range(ctx, &buf->alloc, offset, size, 1);
+}
+
+int svk_invalidate_buffer(svk_context ctx, svk_buffer buf, uint64_t offset, uint64_t size) {
+    if (!ctx || !buf || !buf->alloc.block->mapped) return 0;
+    if (offset + size > buf->size) return 0;
+    return sync_mapped_range(ctx, &buf->alloc, offset, size, 0);
+}
+
+int svk_wait_buffer(svk_context ctx, svk_buffer buf) {
+    if (!ctx || !buf) return 0;
+    return svk_wait_ticket(ctx, buf->last_ticket);
+}
+
+/* An unsubmitted command list will stamp its ticket into the buffer, so
+   the buffer outlives it */
+static int free_buffer(svk_context ctx, svk_buffer buf) {
+    if (!ctx || !buf) return 1;
+    wait_last_ticket(ctx, &buf->last_ticket);
+    if (buf->pins > 0) return 0;
+    vkDestroyBuffer(ctx->device, buf->buffer, NULL);
+    free_memory(ctx, &buf->alloc);
+    free(buf);
+    return 1;
+}
+
+/* ============================================================================
+ * Image Management
+ * ============================================================================ */
+
+static VkFormat image_vk_format(uint32_t format) {
+    return (format == SVK_FORMAT_RGBA32F) ? VK_FORMAT_R32G32B32A32_SFLOAT : VK_FORMAT_R8G8B8A8_UNORM;
+}
+
+/* Size of the image's pixels when copied tightly packed into a buffer */
+static uint64_t image_bytes(svk_image img) {
+    uint64_t pixel_size = (img->format == SVK_FORMAT_RGBA32F) ? 16 : 4;
+    return (uint64_t)img->width * img->height * pixel_size;
+}
+
+/* Record a layout transition if the image is not already in `layout`.
+   Leaving UNDEFINED discards contents, so nothing needs to be waited on. */
+static void record_image_layout(VkCommandBuffer cmd, svk_image img, VkImageLayout layout) {
+    if (img->layout == layout) return;
+
+    int from_undefined = img->layout == VK_IMAGE_LAYOUT_UNDEFINED;
+    VkImageMemoryBarrier barrier = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask = from_undefined ? 0 : VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+                         VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+        .oldLayout = img->layout,
+        .newLayout = layout,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = img->image,
+        .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 }
+    };
+
+    vkCmdPipelineBarrier(cmd,
+        from_undefined ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT
+                       : VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 0, NULL, 0, NULL, 1, &barrier);
+
+    img->layout = layout;
+}
+
+/* Image object without memory or view */
+static svk_image create_image_object(svk_context ctx, uint32_t width, uint32_t height, uint32_t format) {
+    svk_image img = (svk_image)calloc(1, sizeof(struct svk_image_t));
+    if (!img) return NULL;
+
+    img->id = ++ctx->next_resource_id;
+    img->width = width;
+    img->height = height;
+    img->format = format;
+
+    VkImageCreateInfo image_info = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .imageType = VK_IMAGE_TYPE_2D,
+        .format = image_vk_format(format),
+        .extent = { width, height, 1 },
+        .mipLevels = 1,
+        .arrayLayers = 1,
+        .samples = VK_SAMPLE_COUNT_1_BIT,
+        .tiling = VK_IMAGE_TILING_OPTIMAL,
+        .usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+        .sharingMode = ctx->queue_family_count > 1 ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = ctx->queue_family_count > 1 ? ctx->queue_family_count : 0,
+        .pQueueFamilyIndices = ctx->queue_families,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+    };
+
+    if (vkCreateImage(ctx->device, &image_info, NULL, &img->image) != VK_SUCCESS) {
+        free(img);
+        return NULL;
+    }
+
+    return img;
+}
+
+/* View of an image bound to memory */
+static int create_image_view(svk_context ctx, svk_image img) {
+    VkImageViewCreateInfo view_info = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .image = img->image,
+        .viewType = VK_IMAGE_VIEW_TYPE_2D,
+        .format = image_vk_format(img->format),
+        .subresourceRange = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel = 0,
+            .levelCount = 1,
+            .baseArrayLayer = 0,
+            .layerCount = 1
+        }
+    };
+
+    return vkCreateImageView(ctx->device, &view_info, NULL, &img->view) == VK_SUCCESS;
+}
+
+static svk_image create_image(svk_context ctx, uint32_t width, uint32_t height, uint32_t format) {
+    if (!ctx || width == 0 || height == 0) return NULL;
+
+    svk_image img = create_image_object(ctx, width, height, format);
+    if (!img) return NULL;
+
+    VkMemoryRequirements mem_reqs;
+    vkGetImageMemoryRequirements(ctx->device, img->image, &mem_reqs);
+
+    if (!allocate_memory(ctx, &mem_reqs, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, SVK_ALLOC_OPTIMAL, &img->alloc)) {
+        vkDestroyImage(ctx->device, img->image, NULL);
+        free(img);
+        return NULL;
+    }
+
+    vkBindImageMemory(ctx->device, img->image, img->alloc.block->memory, img->alloc.offset);
+
+    if (!create_image_view(ctx, img)) {
+        vkDestroyImage(ctx->device, img->image, NULL);
+        free_memory(ctx, &img->alloc);
+        free(img);
+        return NULL;
+    }
+
+    /* GENERAL serves both storage access and copies, so images move there
+       once and stay; the transition is queued, not waited on */
+    svk_submit_slot* slot = begin_slot(ctx, SVK_QUEUE_COMPUTE);
+    if (slot) {
+        record_image_layout(slot->cmd, img, VK_IMAGE_LAYOUT_GENERAL);
+        img->last_ticket = submit_slot(ctx, slot);
+    }
+    if (img->last_ticket == 0) {
+        svk_free_image(ctx, img);
+        return NULL;
+    }
+
+    return img;
+}
+
+void svk_image_size(svk_image img, uint32_t* width, uint32_t* height) {
+    if (img) {
+        if (width) *width = img->width;
+        if (height) *height = img->height;
+    }
+}
+
+static int free_image(svk_context ctx, svk_image img) {
+    if (!ctx || !img) return 1;
+    wait_last_ticket(ctx, &img->last_ticket);
+    if (img->pins > 0) return 0;
+    if (img->view) vkDestroyImageView(ctx->device, img->view, NULL);
+    vkDestroyImage(ctx->device, img->image, NULL);
+    free_memory(ctx, &img->alloc);
+    free(img);
+    return 1;
+}
+
+/* ============================================================================
+ * SPIR-V Reflection
+ *
+ * Reads the descriptor bindings (set 0), push-constant block size and local
+ * workgroup size straight from the module so pipelines get an exact layout.
+ * Modules using anything the binding model cannot express (other sets,
+ * descriptor arrays, samplers, texel buffers) are left unreflected and get
+ * the generic layout instead.
+ * ============================================================================ */
+
+#define SPV_MAGIC                  0x07230203u
+#define SPV_OP_ENTRY_POINT         15
+#define SPV_OP_EXECUTION_MODE      16
+#define SPV_OP_TYPE_BOOL           20
+#define SPV_OP_TYPE_INT            21
+#define SPV_OP_TYPE_FLOAT          22
+#define SPV_OP_TYPE_VECTOR         23
+#define SPV_OP_TYPE_MATRIX         24
+#define SPV_OP_TYPE_IMAGE          25
+#define SPV_OP_TYPE_ARRAY          28
+#define SPV_OP_TYPE_STRUCT         30
+#define SPV_OP_TYPE_POINTER        32
+#define SPV_OP_CONSTANT            43
+#define SPV_OP_CONSTANT_COMPOSITE  44
+#define SPV_OP_SPEC_CONSTANT       50
+#define SPV_OP_SPEC_CONSTANT_COMPOSITE 51
+#define SPV_OP_VARIABLE            59
+#define SPV_OP_DECORATE            71
+#define SPV_OP_MEMBER_DECORATE     72
+#define SPV_OP_EXECUTION_MODE_ID   331
+
+#define SPV_DEC_SPEC_ID            1
+#define SPV_DEC_BLOCK              2
+#define SPV_DEC_BUFFER_BLOCK       3
+#define SPV_DEC_ARRAY_STRIDE       6
+#define SPV_DEC_MATRIX_STRIDE      7
+#define SPV_DEC_BUILTIN            11
+#define SPV_DEC_NON_WRITABLE       24
+#define SPV_DEC_BINDING            33
+#define SPV_DEC_DESCRIPTOR_SET     34
+#define SPV_DEC_OFFSET             35
+
+#define SPV_BUILTIN_WORKGROUP_SIZE 25
+#define SPV_IMAGE_FORMAT_RGBA32F   1
+#define SPV_IMAGE_FORMAT_RGBA8     4
+#define SPV_MODE_LOCAL_SIZE        17
+#define SPV_MODE_LOCAL_SIZE_ID     38
+#define SPV_MODEL_GL_COMPUTE       5
+
+#define SPV_STORAGE_UNIFORM_CONSTANT 0
+#define SPV_STORAGE_UNIFORM        2
+#define SPV_STORAGE_PUSH_CONSTANT  9
+#define SPV_STORAGE_STORAGE_BUFFER 12
+
+#define SPV_ID_BINDING      0x01
+#define SPV_ID_SET          0x02
+#define SPV_ID_NON_WRITABLE 0x04
+#define SPV_ID_BLOCK        0x08
+#define SPV_ID_BUFFER_BLOCK 0x10
+#define SPV_ID_SPEC         0x20
+#define SPV_ID_WORKGROUP    0x40
+
+/* What the module says about one result id */
+typedef struct {
+    const uint32_t* inst;   /* Defining instruction, NULL if not a type/constant/variable */
+    uint32_t flags;         /* SPV_ID_* */
+    uint32_t binding;
+    uint32_t set;
+    uint32_t spec_id;
+    uint32_t array_stride;
+} svk_spirv_id;
+
+typedef struct {
+    const uint32_t* code;
+    uint32_t word_count;
+    uint32_t bound;
+    svk_spirv_id* ids;
+} svk_spirv;
+
+static int spirv_result_word(uint32_t op) {
+    if (op >= 19 && op <= 39) return 1;  /* OpType* */
+    switch (op) {
+        case SPV_OP_CONSTANT: case SPV_OP_CONSTANT_COMPOSITE:
+        case SPV_OP_SPEC_CONSTANT: case SPV_OP_SPEC_CONSTANT_COMPOSITE:
+        case SPV_OP_VARIABLE:
+        case 41: case 42: case 48: case 49:  /* Op(Spec)ConstantTrue/False */
+            return 2;
+    }
+    return 0;
+}
+
+static const uint32_t* spirv_def(const svk_spirv* m, uint32_t id, uint32_t op) {
+    if (id >= m->bound || !m->ids[id].inst) return NULL;
+    return ((m->ids[id].inst[0] & 0xFFFF) == op) ? m->ids[id].inst : NULL;
+}
+
+/* Value of a scalar (spec) constant, as declared in the module */
+static int spirv_constant(const svk_spirv* m, uint32_t id, uint32_t* value) {
+    const uint32_t* inst = spirv_def(m, id, SPV_OP_CONSTANT);
+    if (!inst) inst = spirv_def(m, id, SPV_OP_SPEC_CONSTANT);
+    if (!inst || (inst[0] >> 16) < 4) return 0;
+    *value = inst[3];
+    return 1;
+}
+
+/* Find a member decoration of a struct; returns 0 if absent */
+static int spirv_member_decoration(const svk_spirv* m, uint32_t struct_id, uint32_t member,
+                                   uint32_t decoration, uint32_t* value) {
+    for (uint32_t i = 5; i < m->word_count; ) {
+        const uint32_t* inst = m->code + i;
+        uint32_t len = inst[0] >> 16;
+        if ((inst[0] & 0xFFFF) == SPV_OP_MEMBER_DECORATE && len >= 4 &&
+            inst[1] == struct_id && inst[2] == member && inst[3] == decoration) {
+            if (value) *value = len >= 5 ? inst[4] : 0;
+            return 1;
+        }
+        i += len;
+    }
+    return 0;
+}
+
+/* Byte size of a type laid out with explicit offsets/strides (0 if unknown) */
+static uint64_t spirv_type_size(const svk_spirv* m, uint32_t id, int depth) {
+    if (depth > 16 || id >= m->bound || !m->ids[id].inst) return 0;
+    const uint32_t* inst = m->ids[id].inst;
+    uint32_t len = inst[0] >> 16;
+
+    switch (inst[0] & 0xFFFF) {
+        case SPV_OP_TYPE_BOOL:
+            return 4;
+        case SPV_OP_TYPE_INT:
+        case SPV_OP_TYPE_FLOAT:
+            return inst[2] / 8;
+        case SPV_OP_TYPE_VECTOR:
+        case SPV_OP_TYPE_MATRIX:
+            return inst[3] * spirv_type_size(m, inst[2], depth + 1);
+        case SPV_OP_TYPE_ARRAY: {
+            uint32_t length = 0;
+            if (!spirv_constant(m, inst[3], &length)) return 0;
+            uint64_t stride = m->ids[id].array_stride ? m->ids[id].array_stride
+                                                      : spirv_type_size(m, inst[2], depth + 1);
+            return length * stride;
+        }
+        case SPV_OP_TYPE_STRUCT: {
+            uint64_t size = 0;
+            for (uint32_t k = 2; k < len; k++) {
+                uint32_t member = k - 2, offset = 0, stride = 0;
+                if (!spirv_member_decoration(m, id, member, SPV_DEC_OFFSET, &offset)) return 0;
+                uint64_t member_size = spirv_type_size(m, inst[k], depth + 1);
+                const uint32_t* matrix = spirv_def(m, inst[k], SPV_OP_TYPE_MATRIX);
+                if (matrix && spirv_member_decoration(m, id, member, SPV_DEC_MATRIX_STRIDE, &stride)) {
+                    member_size = (uint64_t)matrix[3] * stride;
+                }
+                if (offset + member_size > size) size = offset + member_size;
+            }
+            return size;
+        }
+    }
+    return 0;
+}
+
+/* Does every member of the block carry NonWritable (GLSL `readonly buffer`)? */
+static int spirv_block_readonly(const svk_spirv* m, uint32_t struct_id) {
+    const uint32_t* inst = spirv_def(m, struct_id, SPV_OP_TYPE_STRUCT);
+    if (!inst || (inst[0] >> 16) <= 2) return 0;
+    for (uint32_t k = 2; k < (inst[0] >> 16); k++) {
+        if (!spirv_member_decoration(m, struct_id, k - 2, SPV_DEC_NON_WRITABLE, NULL)) return 0;
+    }
+    return 1;
+}
+
+/* Resolve one local-size dimension from a (spec) constant id */
+static void spirv_local_dim(const svk_spirv* m, uint32_t id, svk_shader_layout* out, int dim) {
+    uint32_t value;
+    if (spirv_constant(m, id, &value)) out->local_size[dim] = value;
+    if (id < m->bound && (m->ids[id].flags & SPV_ID_SPEC)) out->local_size_spec[dim] = m->ids[id].spec_id + 1;
+}
+
+static int reflect_variable(const svk_spirv* m, uint32_t var_id, const uint32_t* var, svk_shader_layout* out) {
+    const uint32_t* ptr = spirv_def(m, var[1], SPV_OP_TYPE_POINTER);
+    if (!ptr) return 0;
+    uint32_t storage = var[3];
+    uint32_t pointee = ptr[3];
+    const svk_spirv_id* info = &m->ids[var_id];
+
+    if (storage == SPV_STORAGE_PUSH_CONSTANT) {
+        uint64_t size = spirv_type_size(m, pointee, 0);
+        if (size == 0 || size > 256) return 0;
+        out->push_size = (uint32_t)((size + 3) & ~3ull);
+        return 1;
+    }
+
+    if (storage != SPV_STORAGE_UNIFORM && storage != SPV_STORAGE_UNIFORM_CONSTANT &&
+        storage != SPV_STORAGE_STORAGE_BUFFER) {
+        return 1;  /* Input/Workgroup/Private etc. need no descriptors */
+    }
+
+    /* Only set 0, single descriptors, within SVK_MAX_BINDINGS */
+    if (!(info->flags & SPV_ID_BINDING) || info->binding >= SVK_MAX_BINDINGS) return 0;
+    if ((info->flags & SPV_ID_SET) && info->set != 0) return 0;
+    if (out->binding_types[info->binding] != 0) return 0;
+
+    uint32_t type = 0;
+    int readonly = (info->flags & SPV_ID_NON_WRITABLE) != 0;
+
+    if (storage == SPV_STORAGE_STORAGE_BUFFER && spirv_def(m, pointee, SPV_OP_TYPE_STRUCT)) {
+        type = SVK_BINDING_BUFFER;
+        readonly = readonly || spirv_block_readonly(m, pointee);
+    } else if (storage == SPV_STORAGE_UNIFORM && spirv_def(m, pointee, SPV_OP_TYPE_STRUCT)) {
+        if (m->ids[pointee].flags & SPV_ID_BUFFER_BLOCK) {
+            type = SVK_BINDING_BUFFER;
+            readonly = readonly || spirv_block_readonly(m, pointee);
+        } else {
+            type = SVK_BINDING_UNIFORM;
+            readonly = 1;
+        }
+    } else if (storage == SPV_STORAGE_UNIFORM_CONSTANT) {
+        const uint32_t* image = spirv_def(m, pointee, SPV_OP_TYPE_IMAGE);
+        /* Sampled == 2 means storage image; Dim 5 is a texel buffer */
+        if (image && (image[0] >> 16) >= 9 && image[7] == 2 && image[3] != 5) type = SVK_BINDING_IMAGE;
+    }
+
+    if (type == 0) return 0;
+    out->binding_types[info->binding] = type;
+    if (readonly) out->readonly_mask |= 1u << info->binding;
+    return 1;
+}
+
+/* Fill `out` from the module. Returns 0 (out->reflected == 0) when the
+   module is malformed or uses features the binding model lacks. */
+static int reflect_spirv(const uint32_t* code, uint64_t size, svk_shader_layout* out) {
+    memset(out, 0, sizeof(*out));
+    out->local_size[0] = out->local_size[1] = out->local_size[2] = 1;
+
+    if (size < 20 || (size % 4) != 0 || code[0] != SPV_MAGIC) return 0;
+
+    svk_spirv m = { code, (uint32_t)(size / 4), code[3], NULL };
+    if (m.bound == 0 || m.bound > (1u << 22)) return 0;
+    m.ids = (svk_spirv_id*)calloc(m.bound, sizeof(svk_spirv_id));
+    if (!m.ids) return 0;
+
+    int ok = 1;
+    int seen_image = 0;
+    uint32_t main_id = 0;
+
+    /* Pass 1: definitions, decorations and the entry point */
+    for (uint32_t i = 5; i < m.word_count && ok; ) {
+        const uint32_t* inst = code + i;
+        uint32_t op = inst[0] & 0xFFFF;
+        uint32_t len = inst[0] >> 16;
+        if (len == 0 || i + len > m.word_count) { ok = 0; break; }
+
+        int rw = spirv_result_word(op);
+        if (rw && (uint32_t)rw < len && inst[rw] < m.bound) m.ids[inst[rw]].inst = inst;
+
+        if (op == SPV_OP_TYPE_IMAGE && len >= 9 && !seen_image) {
+            seen_image = 1;
+            switch (inst[8]) {
+                case SPV_IMAGE_FORMAT_RGBA32F: out->image_format = SVK_FORMAT_RGBA32F; break;
+                case SPV_IMAGE_FORMAT_RGBA8:   out->image_format = SVK_FORMAT_RGBA8; break;
+            }
+        }
+
+        if (op == SPV_OP_ENTRY_POINT && len >= 4 && inst[1] == SPV_MODEL_GL_COMPUTE &&
+            strncmp((const char*)&inst[3], "main", (len - 3) * 4) == 0) {
+            main_id = inst[2];
+        } else if (op == SPV_OP_DECORATE && len >= 3 && inst[1] < m.bound) {
+            svk_spirv_id* d = &m.ids[inst[1]];
+            uint32_t literal = len >= 4 ? inst[3] : 0;
+            switch (inst[2]) {
+                case SPV_DEC_BINDING:        d->flags |= SPV_ID_BINDING; d->binding = literal; break;
+                case SPV_DEC_DESCRIPTOR_SET: d->flags |= SPV_ID_SET; d->set = literal; break;
+                case SPV_DEC_NON_WRITABLE:   d->flags |= SPV_ID_NON_WRITABLE; break;
+                case SPV_DEC_BLOCK:          d->flags |= SPV_ID_BLOCK; break;
+                case SPV_DEC_BUFFER_BLOCK:   d->flags |= SPV_ID_BUFFER_BLOCK; break;
+                case SPV_DEC_SPEC_ID:        d->flags |= SPV_ID_SPEC; d->spec_id = literal; break;
+                case SPV_DEC_ARRAY_STRIDE:   d->array_stride = literal; break;
+                case SPV_DEC_BUILTIN:
+                    if (literal == SPV_BUILTIN_WORKGROUP_SIZE) d->flags |= SPV_ID_WORKGROUP;
+                    break;
+            }
+        }
+        i += len;
+    }
+
+    /* Pass 2: local size, then resource variables */
+    for (uint32_t i = 5; i < m.word_count && ok; ) {
+        const uint32_t* inst = code + i;
+        uint32_t op = inst[0] & 0xFFFF;
+        uint32_t len = inst[0] >> 16;
+
+        if (op == SPV_OP_EXECUTION_MODE && len >= 6 && inst[1] == main_id && inst[2] == SPV_MODE_LOCAL_SIZE) {
+            for (int d = 0; d < 3; d++) out->local_size[d] = inst[3 + d];
+        } else if (op == SPV_OP_EXECUTION_MODE_ID && len >= 6 && inst[1] == main_id && inst[2] == SPV_MODE_LOCAL_SIZE_ID) {
+            for (int d = 0; d < 3; d++) spirv_local_dim(&m, inst[3 + d], out, d);
+        } else if ((op == SPV_OP_CONSTANT_COMPOSITE || op == SPV_OP_SPEC_CONSTANT_COMPOSITE) && len >= 6 &&
+                   inst[2] < m.bound && (m.ids[inst[2]].flags & SPV_ID_WORKGROUP)) {
+            /* The WorkgroupSize built-in overrides LocalSize */
+            for (int d = 0; d < 3; d++) spirv_local_dim(&m, inst[3 + d], out, d);
+        } else if (op == SPV_OP_VARIABLE && len >= 4 && inst[2] < m.bound) {
+            ok = reflect_variable(&m, inst[2], inst, out);
+        }
+        i += len;
+    }
+
+    free(m.ids);
+    out->reflected = ok && main_id != 0;
+    if (!out->reflected) {
+        memset(out->binding_types, 0, sizeof(out->binding_types));
+        out->readonly_mask = 0;
+    }
+    return out->reflected;
+}
+
+/* ============================================================================
+ * Shader Management
+ * ============================================================================ */
+
+/* Map a whole file read-only. Returns NULL on failure or for empty files. */
+static const void* map_file(const char* path, uint64_t* size) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) return NULL;
+
+    LARGE_INTEGER file_size;
+    const void* view = NULL;
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping) {
+            view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);  /* The view keeps the mapping alive */
+        }
+        *size = (uint64_t)file_size.QuadPart;
+    }
+    CloseHandle(file);
+    return view;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    void* view = NULL;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        view = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view == MAP_FAILED) view = NULL;
+        *size = (uint64_t)st.st_size;
+    }
+    close(fd);  /* The mapping stays valid after close */
+    return view;
+#endif
+}
+
+static void unmap_file(const void* view, uint64_t size) {
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(view);
+#else
+    munmap((void*)view, (size_t)size);
+#endif
+}
+
+svk_shader svk_load_shader(svk_context ctx, const char* spv_path) {
+    if (!ctx || !spv_path) return NULL;
+
+    uint64_t size = 0;
+    const void* code = map_file(spv_path, &size);
+    if (!code) return NULL;
+
+    svk_shader shader = svk_load_shader_memory(ctx, (const uint32_t*)code, size);
+    unmap_file(code, size);
+
+    return shader;
+}
+
+static svk_shader load_shader_memory(svk_context ctx, const uint32_t* spirv, uint64_t size) {
+    if (!ctx || !spirv) return NULL;
+
+    /* A SPIR-V module is whole words, starting with the magic number */
+    if (size < 20 || (size % 4) != 0 || spirv[0] != SPV_MAGIC) return NULL;
+
+    /* No copy of the code is kept, so a match must agree on two
+       independent 64-bit digests as well as the size */
+    uint64_t hash = fnv1a64(spirv, (size_t)size);
+    uint64_t digest = word_digest64(spirv, (size_t)(size / 4));
+    for (svk_shader cached = ctx->shaders; cached; cached = cached->next) {
+        if (cached->hash == hash && cached->size == size && cached->digest == digest) {
+            cached->refcount++;
+            return cached;
+        }
+    }
+
+    svk_shader shader = (svk_shader)calloc(1, sizeof(struct svk_shader_t));
+    if (!shader) return NULL;
+
+    /* The driver copies the code and reflection reads it in place, so
+       nothing is kept: a mapped file can be released on return */
+    VkShaderModuleCreateInfo create_info = {
+        .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+        .codeSize = size,
+        .pCode = spirv
+    };
+
+    if (vkCreateShaderModule(ctx->device, &create_info, NULL, &shader->module) != VK_SUCCESS) {
+        free(shader);
+        return NULL;
+    }
+
+    reflect_spirv(spirv, size, &shader->layout);
+
+    shader->hash = hash;
+    shader->digest = digest;
+    shader->size = size;
+    shader->refcount = 1;
+    shader->next = ctx->shaders;
+    ctx->shaders = shader;
+
+    return shader;
+}
+
+static uint32_t shader_module_count(svk_context ctx) {
+    uint32_t count = 0;
+    if (ctx) {
+        for (svk_shader shader = ctx->shaders; shader; shader = shader->next) count++;
+    }
+    return count;
+}
+
+int svk_shader_local_size(svk_shader shader, uint32_t* x, uint32_t* y, uint32_t* z) {
+    if (!shader || !shader->layout.reflected) return 0;
+    if (x) *x = shader->layout.local_size[0];
+    if (y) *y = shader->layout.local_size[1];
+    if (z) *z = shader->layout.local_size[2];
+    return 1;
+}
+
+uint32_t svk_shader_binding_type(svk_shader shader, uint32_t binding) {
+    if (!shader || !shader->layout.reflected || binding >= SVK_MAX_BINDINGS) return 0;
+    return shader->layout.binding_types[binding];
+}
+
+uint32_t svk_shader_push_size(svk_shader shader) {
+    if (!shader) return 0;
+    return shader->layout.reflected ? shader->layout.push_size : SVK_GENERIC_PUSH_SIZE;
+}
+
+static void free_shader(svk_context ctx, svk_shader shader) {
+    if (!ctx || !shader || shader->refcount == 0) return;
+    if (--shader->refcount > 0) return;
+
+    for (svk_shader* link = &ctx->shaders; *link; link = &(*link)->next) {
+        if (*link == shader) {
+            *link = shader->next;
+            break;
+        }
+    }
+    vkDestroyShaderModule(ctx->device, shader->module, NULL);
+    free(shader);
+}
+
+/* ============================================================================
+ * Compute Pipeline
+ * ============================================================================ */
+
+/* Sort constants by id; fails on duplicate ids */
+static int normalize_constants(svk_spec_constant* constants, uint32_t count) {
+    for (uint32_t i = 1; i < count; i++) {
+        svk_spec_constant c = constants[i];
+        uint32_t j = i;
+        while (j > 0 && constants[j - 1].id > c.id) {
+            constants[j] = constants[j - 1];
+            j--;
+        }
+        constants[j] = c;
+    }
+    for (uint32_t i = 1; i < count; i++) {
+        if (constants[i].id == constants[i - 1].id) return 0;
+    }
+    return 1;
+}
+
+static int variant_matches(const svk_pipeline_variant* v, svk_shader shader, const uint32_t* binding_types,
+                           uint32_t readonly_mask, uint32_t push_size,
+                           const svk_spec_constant* constants, uint32_t count, int dispatch_base) {
+    return v->shader == shader && v->readonly_mask == readonly_mask && v->push_size == push_size &&
+           v->constant_count == count && v->dispatch_base == dispatch_base &&
+           memcmp(v->binding_types, binding_types, sizeof(v->binding_types)) == 0 &&
+           (count == 0 || memcmp(v->constants, constants, count * sizeof(svk_spec_constant)) == 0);
+}
+
+static void destroy_variant(svk_context ctx, svk_pipeline_variant* v) {
+    vkDestroyPipeline(ctx->device, v->pipeline, NULL);
+    vkDestroyPipelineLayout(ctx->device, v->layout, NULL);
+    vkDestroyDescriptorSetLayout(ctx->device, v->desc_layout, NULL);
+    free(v->constants);
+    free(v);
+}
+
+/* Compile the VkPipeline for a variant whose key fields are filled in */
+static int compile_variant(svk_context ctx, svk_pipeline_variant* v) {
+    /* Create descriptor set layout holding exactly the typed bindings */
+    VkDescriptorSetLayoutBinding bindings[SVK_MAX_BINDINGS];
+    uint32_t binding_count = 0;
+    for (int i = 0; i < SVK_MAX_BINDINGS; i++) {
+        VkDescriptorType type;
+        switch (v->binding_types[i]) {
+            case SVK_BINDING_BUFFER:  type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER; break;
+            case SVK_BINDING_IMAGE:   type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE; break;
+            case SVK_BINDING_UNIFORM: type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER; break;
+            default: continue;
+        }
+        bindings[binding_count++] = (VkDescriptorSetLayoutBinding){
+            .binding = i,
+            .descriptorType = type,
+            .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT
+        };
+    }
+
+    VkDescriptorSetLayoutCreateInfo layout_info = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .bindingCount = binding_count,
+        .pBindings = bindings
+    };
+
+    if (vkCreateDescriptorSetLayout(ctx->device, &layout_info, NULL, &v->desc_layout) != VK_SUCCESS) return 0;
+
+    /* Create pipeline layout with push constants */
+    VkPushConstantRange push_range = {
+        .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+        .offset = 0,
+        .size = v->push_size
+    };
+
+    VkPipelineLayoutCreateInfo pipeline_layout_info = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount = 1,
+        .pSetLayouts = &v->desc_layout,
+        .pushConstantRangeCount = v->push_size > 0 ? 1 : 0,
+        .pPushConstantRanges = v->push_size > 0 ? &push_range : NULL
+    };
+
+    if (vkCreatePipelineLayout(ctx->device, &pipeline_layout_info, NULL, &v->layout) != VK_SUCCESS) {
+        vkDestroyDescriptorSetLayout(ctx->device, v->desc_layout, NULL);
+        return 0;
+    }
+
+    /* Every constant is a 32-bit value packed in id order */
+    VkSpecializationMapEntry entries[SVK_MAX_SPEC_CONSTANTS];
+    uint32_t values[SVK_MAX_SPEC_CONSTANTS];
+    for (uint32_t i = 0; i < v->constant_count; i++) {
+        entries[i] = (VkSpecializationMapEntry){
+            .constantID = v->constants[i].id,
+            .offset = i * sizeof(uint32_t),
+            .size = sizeof(uint32_t)
+        };
+        values[i] = v->constants[i].value;
+    }
+
+    VkSpecializationInfo spec_info = {
+        .mapEntryCount = v->constant_count,
+        .pMapEntries = entries,
+        .dataSize = v->constant_count * sizeof(uint32_t),
+        .pData = values
+    };
+
+    /* Create compute pipeline */
+    VkComputePipelineCreateInfo pipeline_info = {
+        .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+        .flags = v->dispatch_base ? VK_PIPELINE_CREATE_DISPATCH_BASE_BIT : 0,
+        .stage = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+            .module = v->shader->module,
+            .pName = "main",
+            .pSpecializationInfo = v->constant_count > 0 ? &spec_info : NULL
+        },
+        .layout = v->layout
+    };
+
+    if (vkCreateComputePipelines(ctx->device, ctx->pipeline_cache, 1, &pipeline_info, NULL, &v->pipeline) != VK_SUCCESS) {
+        vkDestroyPipelineLayout(ctx->device, v->layout, NULL);
+        vkDestroyDescriptorSetLayout(ctx->device, v->desc_layout, NULL);
+        return 0;
+    }
+
+    return 1;
+}
+
+/* Find or compile the shared VkPipeline for this shader/layout/constant set */
+static svk_pipeline_variant* acquire_variant(svk_context ctx, svk_shader shader, const uint32_t* binding_types,
+                                             uint32_t readonly_mask, uint32_t push_size,
+                                             const svk_spec_constant* constants, uint32_t count,
+                                             int dispatch_base) {
+    svk_spec_constant sorted[SVK_MAX_SPEC_CONSTANTS];
+    if (count > SVK_MAX_SPEC_CONSTANTS) return NULL;
+    if (count > 0) memcpy(sorted, constants, count * sizeof(svk_spec_constant));
+    if (!normalize_constants(sorted, count)) return NULL;
+
+    for (svk_pipeline_variant* v = ctx->variants; v; v = v->next) {
+        if (variant_matches(v, shader, binding_types, readonly_mask, push_size, sorted, count, dispatch_base)) {
+            v->refcount++;
+            return v;
+        }
+    }
+
+    svk_pipeline_variant* v = (svk_pipeline_variant*)calloc(1, sizeof(svk_pipeline_variant));
+    if (!v) return NULL;
+
+    v->shader = shader;
+    memcpy(v->binding_types, binding_types, sizeof(v->binding_types));
+    v->readonly_mask = readonly_mask;
+    v->push_size = push_size;
+    v->constant_count = count;
+    v->dispatch_base = dispatch_base;
+    if (count > 0) {
+        v->constants = (svk_spec_constant*)malloc(count * sizeof(svk_spec_constant));
+        if (!v->constants) {
+            free(v);
+            return NULL;
+        }
+        memcpy(v->constants, sorted, count * sizeof(svk_spec_constant));
+    }
+
+    /* Local size, with dimensions driven by specialization constants replaced */
+    if (shader->layout.reflected) {
+        for (int d = 0; d < 3; d++) {
+            v->local_size[d] = shader->layout.local_size[d];
+            for (uint32_t i = 0; i < count; i++) {
+                if (shader->layout.local_size_spec[d] == sorted[i].id + 1) v->local_size[d] = sorted[i].value;
+            }
+        }
+    }
+
+    if (!compile_variant(ctx, v)) {
+        free(v->constants);
+        free(v);
+        return NULL;
+    }
+
+    shader->refcount++;  /* The module must outlive the variant */
+    v->refcount = 1;
+    v->next = ctx->variants;
+    ctx->variants = v;
+    return v;
+}
+
+static void release_variant(svk_context ctx, svk_pipeline_variant* v) {
+    if (--v->refcount > 0) return;
+
+    for (svk_pipeline_variant** link = &ctx->variants; *link; link = &(*link)->next) {
+        if (*link == v) {
+            *link = v->next;
+            break;
+        }
+    }
+    svk_shader shader = v->shader;
+    destroy_variant(ctx, v);
+    svk_free_shader(ctx, shader);
+}
+
+/* Create a pipeline object (own bindings and push constants) on a shared variant */
+static svk_pipeline build_pipeline(svk_context ctx, svk_shader shader, const uint32_t* binding_types,
+                                   uint32_t readonly_mask, uint32_t push_size,
+                                   const svk_spec_constant* constants, uint32_t count) {
+    svk_pipeline pipe = (svk_pipeline)calloc(1, sizeof(struct svk_pipeline_t));
+    if (!pipe) return NULL;
+
+    context_lock(ctx);
+    svk_pipeline_variant* v = acquire_variant(ctx, shader, binding_types, readonly_mask, push_size,
+                                              constants, count, 0);
+    context_unlock(ctx);
+    if (!v) {
+        free(pipe);
+        return NULL;
+    }
+
+    pipe->variant = v;
+    pipe->pipeline = v->pipeline;
+    pipe->layout = v->layout;
+    pipe->desc_layout = v->desc_layout;
+    memcpy(pipe->binding_types, v->binding_types, sizeof(pipe->binding_types));
+    pipe->readonly_mask = v->readonly_mask;
+    pipe->push_capacity = v->push_size;
+    memcpy(pipe->local_size, v->local_size, sizeof(pipe->local_size));
+
+    return pipe;
+}
+
+svk_pipeline svk_create_pipeline(svk_context ctx, svk_shader shader) {
+    if (!ctx || !shader) return NULL;
+
+    const svk_shader_layout* reflected = &shader->layout;
+    if (reflected->reflected) {
+        return build_pipeline(ctx, shader, reflected->binding_types,
+                              reflected->readonly_mask, reflected->push_size, NULL, 0);
+    }
+
+    /* Generic layout for modules reflection cannot describe */
+    uint32_t types[SVK_MAX_BINDINGS];
+    for (int i = 0; i < SVK_MAX_BINDINGS; i++) types[i] = SVK_BINDING_BUFFER;
+    svk_pipeline pipe = build_pipeline(ctx, shader, types, 0, SVK_GENERIC_PUSH_SIZE, NULL, 0);
+    if (pipe) pipe->generic = 1;
+    return pipe;
+}
+
+svk_pipeline svk_create_pipeline_specialized(svk_context ctx, svk_shader shader,
+                                             const svk_spec_constant* constants, uint32_t count) {
+    if (!ctx || !shader || (count > 0 && !constants)) return NULL;
+
+    const svk_shader_layout* reflected = &shader->layout;
+    if (reflected->reflected) {
+        return build_pipeline(ctx, shader, reflected->binding_types,
+                              reflected->readonly_mask, reflected->push_size, constants, count);
+    }
+
+    uint32_t types[SVK_MAX_BINDINGS];
+    for (int i = 0; i < SVK_MAX_BINDINGS; i++) types[i] = SVK_BINDING_BUFFER;
+    svk_pipeline pipe = build_pipeline(ctx, shader, types, 0, SVK_GENERIC_PUSH_SIZE, constants, count);
+    if (pipe) pipe->generic = 1;
+    return pipe;
+}
+
+static uint32_t pipeline_variant_count(svk_context ctx) {
+    uint32_t count = 0;
+    if (ctx) {
+        for (svk_pipeline_variant* v = ctx->variants; v; v = v->next) count++;
+    }
+    return count;
+}
+
+svk_pipeline svk_create_pipeline_with_bindings(svk_context ctx, svk_shader shader,
+                                               const uint32_t* binding_types, uint32_t count) {
+    if (!ctx || !shader || count > SVK_MAX_BINDINGS || (count > 0 && !binding_types)) return NULL;
+
+    const svk_shader_layout* reflected = &shader->layout;
+    uint32_t types[SVK_MAX_BINDINGS];
+    uint32_t readonly_mask = 0;
+
+    for (uint32_t i = 0; i < SVK_MAX_BINDINGS; i++) {
+        types[i] = i < count ? binding_types[i] : SVK_BINDING_BUFFER;
+        if (types[i] != SVK_BINDING_BUFFER && types[i] != SVK_BINDING_IMAGE && types[i] != SVK_BINDING_UNIFORM) {
+            return NULL;
+        }
+        /* Trust reflected read-only access only where the types agree */
+        if (reflected->reflected && reflected->binding_types[i] == types[i]) {
+            readonly_mask |= reflected->readonly_mask & (1u << i);
+        }
+    }
+
+    return build_pipeline(ctx, shader, types, readonly_mask,
+                          reflected->reflected ? reflected->push_size : SVK_GENERIC_PUSH_SIZE, NULL, 0);
+}
+
+/* Can `binding` take a resource of `type`? A generic layout switches the
+   binding's type (storage buffer or image) to match. */
+static int binding_accepts(svk_pipeline pipe, uint32_t binding, uint32_t type) {
+    if (pipe->binding_types[binding] == type) return 1;
+    if (!pipe->generic) return 0;
+    pipe->binding_types[binding] = type;
+    pipe->relayout = 1;
+    pipe->dirty = 1;
+    return 1;
+}
+
+/* Slots the shader does not declare accept any resource and ignore it */
+int svk_bind_buffer(svk_pipeline pipe, uint32_t binding, svk_buffer buf) {
+    if (!pipe || !buf || binding >= SVK_MAX_BINDINGS) return 0;
+    if (pipe->binding_types[binding] == 0) return 1;
+
+    /* The buffer must have been created for the binding's descriptor type */
+    if (pipe->binding_types[binding] == SVK_BINDING_UNIFORM) {
+        if (!(buf->usage & SVK_BUFFER_UNIFORM)) return 0;
+    } else if (!(buf->usage & SVK_BUFFER_STORAGE) || !binding_accepts(pipe, binding, SVK_BINDING_BUFFER)) {
+        return 0;
+    }
+
+    if (pipe->bound_ids[binding] != buf->id) pipe->dirty = 1;
+    pipe->buffers[binding] = buf;
+    pipe->images[binding] = NULL;
+    pipe->bound_ids[binding] = buf->id;
+    return 1;
+}
+
+int svk_bind_image(svk_pipeline pipe, uint32_t binding, svk_image img) {
+    if (!pipe || !img || binding >= SVK_MAX_BINDINGS) return 0;
+    if (pipe->binding_types[binding] == 0) return 1;
+    if (!binding_accepts(pipe, binding, SVK_BINDING_IMAGE)) return 0;
+    if (pipe->bound_ids[binding] != img->id) pipe->dirty = 1;
+    pipe->images[binding] = img;
+    pipe->buffers[binding] = NULL;
+    pipe->bound_ids[binding] = img->id;
+    return 1;
+}
+
+int svk_set_push_constants(svk_pipeline pipe, const void* data, uint32_t size) {
+    if (!pipe || !data || size > pipe->push_capacity) return 0;
+    memcpy(pipe->push_data, data, size);
+    pipe->push_size = size;
+    return 1;
+}
+
+/* ============================================================================
+ * Descriptor Pools
+ * ============================================================================ */
+
+static svk_desc_pool* create_desc_pool(svk_context ctx, uint32_t sets) {
+    /* Room for every set to use all bindings as storage buffers, and half
+       of them as images or uniform buffers */
+    VkDescriptorPoolSize pool_sizes[] = {
+        { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, sets * SVK_MAX_BINDINGS },
+        { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, sets * SVK_MAX_BINDINGS / 2 },
+        { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, sets * SVK_MAX_BINDINGS / 2 }
+    };
+
+    VkDescriptorPoolCreateInfo pool_info = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT,
+        .maxSets = sets,
+        .poolSizeCount = 3,
+        .pPoolSizes = pool_sizes
+    };
+
+    svk_desc_pool* pool = calloc(1, sizeof(struct svk_desc_pool));
+    if (!pool) return NULL;
+    if (vkCreateDescriptorPool(ctx->device, &pool_info, NULL, &pool->pool) != VK_SUCCESS) {
+        free(pool);
+        return NULL;
+    }
+    pool->capacity = sets;
+    return pool;
+}
+
+/* Allocate a set from the first pool with room, adding a larger pool when
+   all are exhausted */
+static int allocate_descriptor_set(svk_context ctx, VkDescriptorSetLayout layout,
+                                   VkDescriptorSet* set, svk_desc_pool** from) {
+    VkDescriptorSetAllocateInfo alloc_info = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &layout
+    };
+    svk_desc_pool* last = NULL;
+    uint32_t total = 0;
+
+    for (svk_desc_pool* pool = ctx->desc_pools; pool; pool = pool->next) {
+        last = pool;
+        total += pool->capacity;
+        if (pool->in_use >= pool->capacity || pool->exhausted) continue;
+
+        alloc_info.descriptorPool = pool->pool;
+        VkResult result = vkAllocateDescriptorSets(ctx->device, &alloc_info, set);
+        if (result == VK_SUCCESS) {
+            pool->in_use++;
+            ctx->desc_sets_allocated++;
+            *from = pool;
+            return 1;
+        }
+        if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL) return 0;
+        pool->exhausted = 1;
+    }
+
+    /* Each new pool matches the combined size of the existing ones */
+    uint32_t sets = total ? total : SVK_DESC_POOL_SETS;
+    if (sets > SVK_DESC_POOL_MAX_SETS) sets = SVK_DESC_POOL_MAX_SETS;
+    svk_desc_pool* pool = create_desc_pool(ctx, sets);
+    if (!pool) return 0;
+    if (last) last->next = pool;
+    else ctx->desc_pools = pool;
+
+    alloc_info.descriptorPool = pool->pool;
+    if (vkAllocateDescriptorSets(ctx->device, &alloc_info, set) != VK_SUCCESS) return 0;
+    pool->in_use++;
+    ctx->desc_sets_allocated++;
+    *from = pool;
+    return 1;
+}
+
+/* Return a set to its pool. Empty pools beyond the first are released
+   while another empty pool remains as a spare. */
+static void free_descriptor_set(svk_context ctx, svk_desc_pool* pool, VkDescriptorSet set) {
+    vkFreeDescriptorSets(ctx->device, pool->pool, 1, &set);
+    pool->in_use--;
+    pool->exhausted = 0;
+    ctx->desc_sets_freed++;
+    if (pool->in_use > 0 || pool == ctx->desc_pools) return;
+
+    svk_desc_pool* spare = NULL;
+    for (svk_desc_pool* p = ctx->desc_pools; p; p = p->next) {
+        if (p != pool && p->in_use == 0) spare = p;
+    }
+    if (!spare) return;
+
+    svk_desc_pool** link = &ctx->desc_pools;
+    while (*link != pool) link = &(*link)->next;
+    *link = pool->next;
+    vkDestroyDescriptorPool(ctx->device, pool->pool, NULL);
+    free(pool);
+}
+
+static int get_descriptor_stats(svk_context ctx, svk_descriptor_stats* stats) {
+    if (!ctx || !stats) return 0;
+    memset(stats, 0, sizeof(*stats));
+
+    for (svk_desc_pool* pool = ctx->desc_pools; pool; pool = pool->next) {
+        stats->pool_count++;
+        stats->set_capacity += pool->capacity;
+        stats->sets_in_use += pool->in_use;
+    }
+    stats->sets_allocated = ctx->desc_sets_allocated;
+    stats->sets_freed = ctx->desc_sets_freed;
+    return 1;
+}
+
+/* Pick a cache entry to hold a new binding combination: an unallocated
+   entry first, otherwise the least recently used one not pinned by a list */
+static svk_set_entry* claim_set_entry(svk_context ctx, svk_pipeline pipe) {
+    for (;;) {
+        svk_set_entry* victim = NULL;
+
+        for (int i = 0; i < SVK_SET_CACHE_SIZE; i++) {
+            svk_set_entry* e = &pipe->sets[i];
+            if (e->set == VK_NULL_HANDLE) {
+                if (allocate_descriptor_set(ctx, pipe->desc_layout, &e->set, &e->pool)) return e;
+                e->set = VK_NULL_HANDLE;
+                break;
+            }
+        }
+
+        for (int i = 0; i < SVK_SET_CACHE_SIZE; i++) {
+            svk_set_entry* e = &pipe->sets[i];
+            if (e->set == VK_NULL_HANDLE || e->pins > 0) continue;
+            if (!victim || e->last_used < victim->last_used) victim = e;
+        }
+        if (!victim) return NULL;
+
+        /* The set must not be in use by a pending submission. Waiting
+           releases the lock, and the entry may be pinned, resubmitted or
+           freed meanwhile, so choose again once the wait is over. */
+        svk_ticket ticket = victim->last_ticket;
+        if (!find_ticket_slot(ctx, ticket)) return victim;
+        if (!svk_wait_ticket(ctx, ticket)) return NULL;
+    }
+}
+
+/* Cached descriptor set for the resources `ids`, written only when no cached
+   set already holds this combination. NULL when every cached set is pinned. */
+static svk_set_entry* acquire_set(svk_context ctx, svk_pipeline pipe, const svk_buffer* buffers,
+                                  const svk_image* images, const uint64_t* ids) {
+    VkWriteDescriptorSet writes[SVK_MAX_BINDINGS];
+    VkDescriptorBufferInfo buffer_infos[SVK_MAX_BINDINGS];
+    VkDescriptorImageInfo image_infos[SVK_MAX_BINDINGS];
+    int write_count = 0;
+
+    for (int i = 0; i < SVK_SET_CACHE_SIZE; i++) {
+        svk_set_entry* e = &pipe->sets[i];
+        if (e->set != VK_NULL_HANDLE && memcmp(e->ids, ids, sizeof(e->ids)) == 0) {
+            e->last_used = ++pipe->use_clock;
+            return e;
+        }
+    }
+
+    svk_set_entry* entry = claim_set_entry(ctx, pipe);
+    if (!entry) return NULL;
+
+    for (int i = 0; i < SVK_MAX_BINDINGS; i++) {
+        if (buffers[i]) {
+            buffer_infos[write_count] = (VkDescriptorBufferInfo){
+                .buffer = buffers[i]->buffer,
+                .offset = 0,
+                .range = buffers[i]->size
+            };
+
+            writes[write_count] = (VkWriteDescriptorSet){
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet = entry->set,
+                .dstBinding = i,
+                .descriptorCount = 1,
+                .descriptorType = pipe->binding_types[i] == SVK_BINDING_UNIFORM
+                    ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                .pBufferInfo = &buffer_infos[write_count]
+            };
+            write_count++;
+        } else if (images[i]) {
+            image_infos[write_count] = (VkDescriptorImageInfo){
+                .imageView = images[i]->view,
+                .imageLayout = VK_IMAGE_LAYOUT_GENERAL
+            };
+
+            writes[write_count] = (VkWriteDescriptorSet){
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet = entry->set,
+                .dstBinding = i,
+                .descriptorCount = 1,
+                .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                .pImageInfo = &image_infos[write_count]
+            };
+            write_count++;
+        }
+    }
+
+    if (write_count > 0) {
+        vkUpdateDescriptorSets(ctx->device, write_count, writes, 0, NULL);
+    }
+    memcpy(entry->ids, ids, sizeof(entry->ids));
+    entry->last_used = ++pipe->use_clock;
+    return entry;
+}
+
+/* Unbind every resource; the next dispatch binds a fresh set */
+static void clear_bindings(svk_pipeline pipe) {
+    memset(pipe->buffers, 0, sizeof(pipe->buffers));
+    memset(pipe->images, 0, sizeof(pipe->images));
+    memset(pipe->bound_ids, 0, sizeof(pipe->bound_ids));
+    pipe->dirty = 1;
+}
+
+/* Move a generic-layout pipeline to the variant for its current binding
+   types. The cached sets have the old layout, so they are freed once the
+   last submission using them is done. */
+static int relayout_pipeline(svk_context ctx, svk_pipeline pipe) {
+    if (!wait_last_ticket(ctx, &pipe->last_ticket)) return 0;
+    for (int i = 0; i < SVK_SET_CACHE_SIZE; i++) {
+        if (pipe->sets[i].pins > 0) return 0;
+    }
+
+    svk_pipeline_variant* old = pipe->variant;
+    svk_pipeline_variant* v = acquire_variant(ctx, old->shader, pipe->binding_types, old->readonly_mask,
+                                              old->push_size, old->constants, old->constant_count, 0);
+    if (!v) return 0;
+    if (pipe->base_variant) release_variant(ctx, pipe->base_variant);
+    pipe->base_variant = NULL;
+
+    for (int i = 0; i < SVK_SET_CACHE_SIZE; i++) {
+        if (pipe->sets[i].set != VK_NULL_HANDLE) free_descriptor_set(ctx, pipe->sets[i].pool, pipe->sets[i].set);
+    }
+    memset(pipe->sets, 0, sizeof(pipe->sets));
+    pipe->current = NULL;
+    release_variant(ctx, old);
+
+    pipe->variant = v;
+    pipe->pipeline = v->pipeline;
+    pipe->layout = v->layout;
+    pipe->desc_layout = v->desc_layout;
+    pipe->relayout = 0;
+    return 1;
+}
+
+/* Select a descriptor set matching the current bindings */
+static int prepare_descriptors(svk_context ctx, svk_pipeline pipe) {
+    if (pipe->relayout && !relayout_pipeline(ctx, pipe)) return 0;
+    if (pipe->current && !pipe->dirty) {
+        pipe->current->last_used = ++pipe->use_clock;
+        return 1;
+    }
+
+    svk_set_entry* entry = acquire_set(ctx, pipe, pipe->buffers, pipe->images, pipe->bound_ids);
+    if (!entry) return 0;
+
+    pipe->current = entry;
+    pipe->dirty = 0;
+    return 1;
+}
+
+/* Bind `pipeline` (the pipeline's own, or its DISPATCH_BASE twin with the
+   same layout) with an explicit descriptor set and push constants */
+static void record_bind(VkCommandBuffer cmd, svk_pipeline pipe, VkPipeline pipeline, svk_set_entry* set,
+                        const uint8_t* push_data, uint32_t push_size) {
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipe->layout, 0, 1, &set->set, 0, NULL);
+
+    if (push_size > 0) {
+        vkCmdPushConstants(cmd, pipe->layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, push_size, push_data);
+    }
+}
+
+static int is_offset_region(const uint32_t* base) {
+    return base && (base[0] | base[1] | base[2]);
+}
+
+/* Record a dispatch with an explicit descriptor set and push constants.
+   `base` (NULL = origin) is the first workgroup of a region of a larger
+   grid; an offset region needs prepare_dispatch_base first. */
+static void record_bound_dispatch(VkCommandBuffer cmd, svk_pipeline pipe, svk_set_entry* set,
+                                  const uint8_t* push_data, uint32_t push_size, const uint32_t* base,
+                                  uint32_t x, uint32_t y, uint32_t z) {
+    if (is_offset_region(base)) {
+        record_bind(cmd, pipe, pipe->base_variant->pipeline, set, push_data, push_size);
+        vkCmdDispatchBase(cmd, base[0], base[1], base[2], x, y, z);
+    } else {
+        record_bind(cmd, pipe, pipe->pipeline, set, push_data, push_size);
+        vkCmdDispatch(cmd, x, y, z);
+    }
+}
+
+static void record_dispatch(VkCommandBuffer cmd, svk_pipeline pipe, const uint32_t* base,
+                            uint32_t x, uint32_t y, uint32_t z) {
+    for (int i = 0; i < SVK_MAX_BINDINGS; i++) {
+        if (pipe->images[i]) record_image_layout(cmd, pipe->images[i], VK_IMAGE_LAYOUT_GENERAL);
+    }
+
+    record_bound_dispatch(cmd, pipe, pipe->current, pipe->push_data, pipe->push_size, base, x, y, z);
+}
+
+/* Can `args` supply workgroup counts (three uint32) at `offset`? */
+static int valid_indirect(svk_buffer args, uint64_t offset) {
+    return args && (args->usage & SVK_BUFFER_INDIRECT) && (offset % 4) == 0 &&
+           offset + 3 * sizeof(uint32_t) <= args->size;
+}
+
+/* Record a dispatch whose workgroup counts the GPU reads from `args` */
+static void record_indirect_dispatch(VkCommandBuffer cmd, svk_pipeline pipe, svk_buffer args, uint64_t offset) {
+    for (int i = 0; i < SVK_MAX_BINDINGS; i++) {
+        if (pipe->images[i]) record_image_layout(cmd, pipe->images[i], VK_IMAGE_LAYOUT_GENERAL);
+    }
+
+    record_bind(cmd, pipe, pipe->pipeline, pipe->current, pipe->push_data, pipe->push_size);
+    vkCmdDispatchIndirect(cmd, args->buffer, offset);
+}
+
+/* Remember the submission so the pipeline and its resources outlive it */
+static void mark_pipeline_submitted(svk_pipeline pipe, svk_ticket ticket) {
+    pipe->last_ticket = ticket;
+    pipe->current->last_ticket = ticket;
+    for (int i = 0; i < SVK_MAX_BINDINGS; i++) {
+        if (pipe->buffers[i]) pipe->buffers[i]->last_ticket = ticket;
+        if (pipe->images[i]) pipe->images[i]->last_ticket = ticket;
+    }
+}
+
+/* Wait on other queues for the last users of the bound resources */
+static void depend_on_bindings(svk_context ctx, svk_submit_slot* slot, svk_pipeline pipe) {
+    for (int i = 0; i < SVK_MAX_BINDINGS; i++) {
+        if (pipe->buffers[i]) slot_depend(ctx, slot, pipe->buffers[i]->last_ticket);
+        if (pipe->images[i]) slot_depend(ctx, slot, pipe->images[i]->last_ticket);
+    }
+}
+
+svk_ticket svk_dispatch_async(svk_context ctx, svk_pipeline pipe, uint32_t x, uint32_t y, uint32_t z) {
+    return svk_dispatch_async_on(ctx, pipe, SVK_QUEUE_COMPUTE, x, y, z);
+}
+
+/* DISPATCH_BASE needs Vulkan 1.1 and may cost performance, so pipelines get
+   it only when first dispatched as an offset region: the twin variant has
+   the same key and layouts, so descriptor sets work with both */
+static int prepare_dispatch_base(svk_context ctx, svk_pipeline pipe) {
+    if (pipe->base_variant) return 1;
+    if (ctx->api_version < VK_API_VERSION_1_1) return 0;
+
+    svk_pipeline_variant* v = pipe->variant;
+    pipe->base_variant = acquire_variant(ctx, v->shader, v->binding_types, v->readonly_mask, v->push_size,
+                                         v->constants, v->constant_count, 1);
+    return pipe->base_variant != NULL;
+}
+
+static svk_ticket dispatch_on(svk_context ctx, svk_pipeline pipe, uint32_t role, const uint32_t* base,
+                              uint32_t x, uint32_t y, uint32_t z) {
+    if (!ctx || !pipe) return 0;
+    if (role != SVK_QUEUE_COMPUTE && role != SVK_QUEUE_ASYNC_COMPUTE) return 0;
+
+    if (!prepare_descriptors(ctx, pipe)) return 0;
+    if (is_offset_region(base) && !prepare_dispatch_base(ctx, pipe)) return 0;
+
+    svk_submit_slot* slot = begin_slot(ctx, role);
+    if (!slot) return 0;
+    depend_on_bindings(ctx, slot, pipe);
+
+    int timing = timing_begin(ctx, slot, SVK_SAMPLE_DISPATCH);
+    record_dispatch(slot->cmd, pipe, base, x, y, z);
+    timing_end(ctx, slot, timing);
+
+    svk_ticket ticket = submit_slot(ctx, slot);
+    if (ticket) mark_pipeline_submitted(pipe, ticket);
+
+    return ticket;
+}
+
+int svk_dispatch(svk_context ctx, svk_pipeline pipe, uint32_t x, uint32_t y, uint32_t z) {
+    svk_ticket ticket = svk_dispatch_async(ctx, pipe, x, y, z);
+    if (ticket == 0) return 0;
+    return svk_wait_ticket(ctx, ticket);
+}
+
+static svk_ticket dispatch_indirect_on(svk_context ctx, svk_pipeline pipe, uint32_t role,
+                                       svk_buffer args, uint64_t offset) {
+    if (!ctx || !pipe || !valid_indirect(args, offset)) return 0;
+    if (role != SVK_QUEUE_COMPUTE && role != SVK_QUEUE_ASYNC_COMPUTE) return 0;
+
+    if (!prepare_descriptors(ctx, pipe)) return 0;
+
+    svk_submit_slot* slot = begin_slot(ctx, role);
+    if (!slot) return 0;
+    depend_on_bindings(ctx, slot, pipe);
+    slot_depend(ctx, slot, args->last_ticket);
+
+    int timing = timing_begin(ctx, slot, SVK_SAMPLE_DISPATCH);
+    record_indirect_dispatch(slot->cmd, pipe, args, offset);
+    timing_end(ctx, slot, timing);
+
+    svk_ticket ticket = submit_slot(ctx, slot);
+    if (ticket) {
+        mark_pipeline_submitted(pipe, ticket);
+        args->last_ticket = ticket;
+    }
+
+    return ticket;
+}
+
+svk_ticket svk_dispatch_indirect_async(svk_context ctx, svk_pipeline pipe, svk_buffer args, uint64_t offset) {
+    return svk_dispatch_indirect_async_on(ctx, pipe, SVK_QUEUE_COMPUTE, args, offset);
+}
+
+int svk_dispatch_indirect(svk_context ctx, svk_pipeline pipe, svk_buffer args, uint64_t offset) {
+    svk_ticket ticket = svk_dispatch_indirect_async(ctx, pipe, args, offset);
+    if (ticket == 0) return 0;
+    return svk_wait_ticket(ctx, ticket);
+}
+
+int svk_dispatch_threads(svk_context ctx, svk_pipeline pipe, uint32_t nx, uint32_t ny, uint32_t nz) {
+    if (!pipe || pipe->local_size[0] == 0 || nx == 0 || ny == 0 || nz == 0) return 0;
+    return svk_dispatch(ctx, pipe,
+        (nx + pipe->local_size[0] - 1) / pipe->local_size[0],
+        (ny + pipe->local_size[1] - 1) / pipe->local_size[1],
+        (nz + pipe->local_size[2] - 1) / pipe->local_size[2]);
+}
+
+int svk_pipeline_local_size(svk_pipeline pipe, uint32_t* x, uint32_t* y, uint32_t* z) {
+    if (!pipe || pipe->local_size[0] == 0) return 0;
+    if (x) *x = pipe->local_size[0];
+    if (y) *y = pipe->local_size[1];
+    if (z) *z = pipe->local_size[2];
+    return 1;
+}
+
+static int wait_ticket(svk_context ctx, svk_ticket ticket) {
+    if (!ctx) return 0;
+    svk_submit_slot* slot = find_ticket_slot(ctx, ticket);
+    if (!slot) return 1;
+    return retire_slot(ctx, slot);
+}
+
+static int poll_ticket(svk_context ctx, svk_ticket ticket) {
+    if (!ctx) return 0;
+    svk_submit_slot* slot = find_ticket_slot(ctx, ticket);
+    if (!slot) return 1;
+    if (vkGetFenceStatus(ctx->device, slot->fence) != VK_SUCCESS) return 0;
+    slot->pending = 0;
+    return 1;
+}
+
+static void wait_idle(svk_context ctx) {
+    if (ctx) vkDeviceWaitIdle(ctx->device);
+}
+
+static void free_pipeline(svk_context ctx, svk_pipeline pipe) {
+    if (!ctx || !pipe) return;
+    wait_last_ticket(ctx, &pipe->last_ticket);
+    for (int i = 0; i < SVK_SET_CACHE_SIZE; i++) {
+        if (pipe->sets[i].set != VK_NULL_HANDLE) {
+            free_descriptor_set(ctx, pipe->sets[i].pool, pipe->sets[i].set);
+        }
+    }
+    if (pipe->sdf) {
+        for (uint32_t i = 0; i < pipe->sdf->frame_count; i++) {
+            svk_finish_image_download(ctx, pipe->sdf->frames[i], NULL);
+            svk_free_image(ctx, pipe->sdf->images[i]);
+        }
+        free(pipe->sdf);
+    }
+    if (pipe->base_variant) release_variant(ctx, pipe->base_variant);
+    release_variant(ctx, pipe->variant);
+    free(pipe);
+}
+
+/* ============================================================================
+ * Pipeline Cache Persistence
+ *
+ * The file is a small header followed by the driver's cache blob. The header
+ * ties the blob to one device and driver build; anything that does not match
+ * exactly is ignored, so a stale or foreign file only costs a cold start.
+ * ============================================================================ */
+
+#define SVK_CACHE_MAGIC   "SVKPCACH"
+#define SVK_CACHE_VERSION 1
+#define SVK_CACHE_MAX_SIZE (256ull * 1024 * 1024)
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t vendor_id;
+    uint32_t device_id;
+    uint32_t driver_version;
+    uint8_t uuid[VK_UUID_SIZE];
+    uint64_t data_size;
+    uint64_t checksum;      /* FNV-1a of the blob */
+} svk_cache_file_header;
+
+static void cache_header_for(svk_context ctx, svk_cache_file_header* header) {
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, SVK_CACHE_MAGIC, sizeof(header->magic));
+    header->version = SVK_CACHE_VERSION;
+    header->vendor_id = ctx->vendor_id;
+    header->device_id = ctx->device_id;
+    header->driver_version = ctx->driver_version;
+    memcpy(header->uuid, ctx->pipeline_cache_uuid, VK_UUID_SIZE);
+}
+
+/* Vulkan's own blob header: length, version, vendorID, deviceID, UUID */
+static int cache_blob_matches(svk_context ctx, const uint8_t* blob, uint64_t size) {
+    uint32_t words[4];
+    if (size < 16 + VK_UUID_SIZE) return 0;
+    memcpy(words, blob, sizeof(words));
+    return words[0] >= 16 + VK_UUID_SIZE && words[0] <= size &&
+           words[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           words[2] == ctx->vendor_id && words[3] == ctx->device_id &&
+           memcmp(blob + 16, ctx->pipeline_cache_uuid, VK_UUID_SIZE) == 0;
+}
+
+static int load_pipeline_cache(svk_context ctx, const char* path) {
+    if (!ctx || !path || !ctx->pipeline_cache) return 0;
+
+    FILE* file = fopen(path, "rb");
+    if (!file) return 0;
+
+    svk_cache_file_header expected, header;
+    cache_header_for(ctx, &expected);
+
+    int ok = fread(&header, sizeof(header), 1, file) == 1 &&
+             memcmp(&header, &expected, offsetof(svk_cache_file_header, data_size)) == 0 &&
+             header.data_size > 0 && header.data_size <= SVK_CACHE_MAX_SIZE;
+
+    uint8_t* blob = NULL;
+    if (ok) {
+        blob = (uint8_t*)malloc((size_t)header.data_size);
+        ok = blob && fread(blob, 1, (size_t)header.data_size, file) == header.data_size &&
+             fnv1a64(blob, (size_t)header.data_size) == header.checksum &&
+             cache_blob_matches(ctx, blob, header.data_size);
+    }
+    fclose(file);
+
+    if (ok) {
+        VkPipelineCacheCreateInfo cache_info = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+            .initialDataSize = (size_t)header.data_size,
+            .pInitialData = blob
+        };
+
+        VkPipelineCache loaded;
+        ok = vkCreatePipelineCache(ctx->device, &cache_info, NULL, &loaded) == VK_SUCCESS;
+        if (ok) {
+            ok = vkMergePipelineCaches(ctx->device, ctx->pipeline_cache, 1, &loaded) == VK_SUCCESS;
+            vkDestroyPipelineCache(ctx->device, loaded, NULL);
+        }
+    }
+
+    free(blob);
+    return ok;
+}
+
+static int save_pipeline_cache(svk_context ctx, const char* path) {
+    if (!ctx || !path || !ctx->pipeline_cache) return 0;
+
+    size_t size = 0;
+    if (vkGetPipelineCacheData(ctx->device, ctx->pipeline_cache, &size, NULL) != VK_SUCCESS || size == 0) return 0;
+
+    uint8_t* blob = (uint8_t*)malloc(size);
+    if (!blob) return 0;
+    if (vkGetPipelineCacheData(ctx->device, ctx->pipeline_cache, &size, blob) != VK_SUCCESS) {
+        free(blob);
+        return 0;
+    }
+
+    svk_cache_file_header header;
+    cache_header_for(ctx, &header);
+    header.data_size = size;
+    header.checksum = fnv1a64(blob, size);
+
+    /* Write beside the target and swap in, so readers never see a torn file */
+    size_t path_len = strlen(path);
+    char* temp_path = (char*)malloc(path_len + 5);
+    if (!temp_path) {
+        free(blob);
+        return 0;
+    }
+    memcpy(temp_path, path, path_len);
+    memcpy(temp_path + path_len, ".tmp", 5);
+
+    int ok = 0;
+    FILE* file = fopen(temp_path, "wb");
+    if (file) {
+        ok = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(blob, 1, size, file) == size;
+        ok = (fclose(file) == 0) && ok;
+        /* Replace in one step: a crash leaves either the old or the new cache */
+#ifdef _WIN32
+        if (ok) ok = MoveFileExA(temp_path, path, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        if (ok) ok = rename(temp_path, path) == 0;
+#endif
+        if (!ok) remove(temp_path);
+    }
+
+    free(temp_path);
+    free(blob);
+    return ok;
+}
+
+/* ============================================================================
+ * Image Download (for getting compute results)
+ * ============================================================================ */
+
+/* Free readback slot whose staging buffer can hold `size` bytes, or NULL.
+   The slot stays claimed until release_readback. Pack pipelines write the
+   staging buffer directly, so it is also a storage buffer. */
+static svk_readback_slot* acquire_readback(svk_context ctx, uint64_t size) {
+    /* Uncollected downloads are never overwritten */
+    svk_readback_slot* rb = NULL;
+    for (int i = 0; i < SVK_READBACK_SLOTS && !rb; i++) {
+        svk_readback_slot* candidate = &ctx->image_readback[i];
+        if (candidate->ticket == 0 && !candidate->claimed) rb = candidate;
+    }
+    if (!rb) return NULL;
+
+    /* Freeing the old buffer may wait with the lock released */
+    rb->claimed = 1;
+    if (!rb->staging || rb->staging->size < size) {
+        free_buffer(ctx, rb->staging);
+        rb->staging = create_buffer(ctx, size, SVK_BUFFER_STORAGE | SVK_BUFFER_TRANSFER | SVK_BUFFER_HOST_READBACK);
+        if (!rb->staging) {
+            rb->claimed = 0;
+            return NULL;
+        }
+    }
+
+    rb->size = size;
+    return rb;
+}
+
+static void release_readback(svk_readback_slot* rb) {
+    rb->claimed = 0;
+}
+
+static void record_image_download(svk_context ctx, svk_submit_slot* slot, svk_image img, svk_readback_slot* rb) {
+    /* Copy straight from the tracked layout; GENERAL needs no transition */
+    VkBufferImageCopy region = {
+        .bufferOffset = 0,
+        .bufferRowLength = 0,
+        .bufferImageHeight = 0,
+        .imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 },
+        .imageOffset = { 0, 0, 0 },
+        .imageExtent = { img->width, img->height, 1 }
+    };
+
+    slot_depend(ctx, slot, img->last_ticket);
+    slot_depend(ctx, slot, rb->staging->last_ticket);
+
+    int timing = timing_begin(ctx, slot, SVK_SAMPLE_COPY);
+    vkCmdCopyImageToBuffer(slot->cmd, img->image, img->layout, rb->staging->buffer, 1, &region);
+    timing_end(ctx, slot, timing);
+}
+
+/* Hold the slot until svk_finish_image_download collects `ticket` */
+static void mark_readback_submitted(svk_readback_slot* rb, svk_image img, svk_ticket ticket) {
+    img->last_ticket = ticket;
+    rb->staging->last_ticket = ticket;
+    rb->ticket = ticket;
+}
+
+static svk_ticket begin_image_download(svk_context ctx, svk_image img) {
+    if (!ctx || !img) return 0;
+
+    svk_readback_slot* rb = acquire_readback(ctx, image_bytes(img));
+    if (!rb) return 0;
+
+    svk_submit_slot* slot = begin_slot(ctx, SVK_QUEUE_COMPUTE);
+    if (!slot) {
+        release_readback(rb);
+        return 0;
+    }
+
+    record_image_download(ctx, slot, img, rb);
+
+    svk_ticket ticket = submit_slot(ctx, slot);
+    if (ticket) mark_readback_submitted(rb, img, ticket);
+    release_readback(rb);
+    return ticket;
+}
+
+static int finish_image_download(svk_context ctx, svk_ticket ticket, void* data) {
+    if (!ctx || ticket == 0) return 0;
+
+    svk_readback_slot* rb = NULL;
+    for (int i = 0; i < SVK_READBACK_SLOTS && !rb; i++) {
+        if (ctx->image_readback[i].ticket == ticket) rb = &ctx->image_readback[i];
+    }
+    if (!rb) return 0;
+
+    /* Held until the copy is out, as the download may release the lock.
+       The slot is freed even if the copy failed, so it cannot leak. */
+    int ok = !data || download_buffer(ctx, rb->staging, data, rb->size, 0);
+    rb->ticket = 0;
+    return ok;
+}
+
+int svk_download_image(svk_context ctx, svk_image img, void* data) {
+    if (!ctx || !img || !data) return 0;
+    return svk_finish_image_download(ctx, svk_begin_image_download(ctx, img), data);
+}
+
+/* ============================================================================
+ * Packed Image Download
+ *
+ * A pack pipeline converts an image into a compact layout on the GPU,
+ * writing straight into a readback slot's staging buffer, so only the
+ * packed bytes cross the bus. The shader (shaders/pack_image.comp) reads
+ * one image format, recorded by reflection; the layout is a push constant.
+ * ============================================================================ */
+
+svk_pipeline svk_create_pack_pipeline(svk_context ctx, svk_shader shader) {
+    if (!ctx || !shader) return NULL;
+
+    uint32_t source = shader->layout.image_format;
+    if (source == 0) return NULL;
+
+    svk_pipeline pipe = svk_create_pipeline(ctx, shader);
+    if (!pipe) return NULL;
+
+    if (pipe->binding_types[0] != SVK_BINDING_IMAGE || pipe->binding_types[1] != SVK_BINDING_BUFFER ||
+        pipe->push_capacity < 3 * sizeof(uint32_t) || pipe->local_size[0] == 0) {
+        svk_free_pipeline(ctx, pipe);
+        return NULL;
+    }
+    pipe->pack_source = source;
+    return pipe;
+}
+
+uint64_t svk_packed_image_size(svk_image img, uint32_t pack) {
+    if (!img) return 0;
+    uint64_t pixels = (uint64_t)img->width * img->height;
+    switch (pack) {
+        case SVK_PACK_RGBA8:
+        case SVK_PACK_RGB10A2: return pixels * 4;
+        case SVK_PACK_RGBA16F: return pixels * 8;
+        case SVK_PACK_YUV420:  return (img->width % 8 == 0 && img->height % 2 == 0) ? pixels * 3 / 2 : 0;
+    }
+    return 0;
+}
+
+static svk_ticket begin_packed_download(svk_context ctx, svk_pipeline pipe, svk_image img, uint32_t pack) {
+    if (!ctx || !pipe || !img || pipe->pack_source != img->format) return 0;
+
+    uint64_t size = svk_packed_image_size(img, pack);
+    if (size == 0) return 0;
+
+    svk_readback_slot* rb = acquire_readback(ctx, size);
+    if (!rb) return 0;
+
+    uint32_t params[3] = { pack, img->width, img->height };
+    if (!svk_bind_image(pipe, 0, img) || !svk_bind_buffer(pipe, 1, rb->staging) ||
+        !svk_set_push_constants(pipe, params, sizeof(params)) || !prepare_descriptors(ctx, pipe)) {
+        release_readback(rb);
+        clear_bindings(pipe);
+        return 0;
+    }
+
+    svk_submit_slot* slot = begin_slot(ctx, SVK_QUEUE_COMPUTE);
+    if (!slot) {
+        release_readback(rb);
+        clear_bindings(pipe);
+        return 0;
+    }
+    depend_on_bindings(ctx, slot, pipe);
+
+    /* YUV420 packs one 8x2 block per invocation */
+    uint32_t nx = (pack == SVK_PACK_YUV420) ? img->width / 8 : img->width;
+    uint32_t ny = (pack == SVK_PACK_YUV420) ? img->height / 2 : img->height;
+    const uint32_t* local = pipe->local_size;
+
+    int timing = timing_begin(ctx, slot, SVK_SAMPLE_COPY);
+    record_dispatch(slot->cmd, pipe, NULL, (nx + local[0] - 1) / local[0], (ny + local[1] - 1) / local[1], 1);
+    timing_end(ctx, slot, timing);
+
+    svk_ticket ticket = submit_slot(ctx, slot);
+    release_readback(rb);
+    if (ticket != 0) {
+        mark_pipeline_submitted(pipe, ticket);
+        mark_readback_submitted(rb, img, ticket);
+    }
+
+    /* The staging buffer is regrown or freed with its readback slot, and the
+       image by the caller, so neither stays bound */
+    clear_bindings(pipe);
+    return ticket;
+}
+
+int svk_download_image_packed(svk_context ctx, svk_pipeline pipe, svk_image img, uint32_t pack, void* data) {
+    if (!ctx || !data) return 0;
+    return svk_finish_image_download(ctx, svk_begin_packed_download(ctx, pipe, img, pack), data);
+}
+
+/* ============================================================================
+ * SDF Render Engine
+ *
+ * An SDF pipeline owns one RGBA8 output image per frame in flight. Each frame
+ * is a single submission: the ray-marching dispatch, then a copy of the image
+ * into a readback slot. The host only waits when every image still holds a
+ * frame the GPU has not finished.
+ * ============================================================================ */
+
+svk_pipeline svk_create_sdf_pipeline(svk_context ctx, const char* shader_path,
+                                     uint32_t width, uint32_t height) {
+    return svk_create_sdf_pipeline_frames(ctx, shader_path, width, height, SVK_SDF_DEFAULT_FRAMES);
+}
+
+svk_pipeline svk_create_sdf_pipeline_frames(svk_context ctx, const char* shader_path,
+                                            uint32_t width, uint32_t height, uint32_t frames_in_flight) {
+    if (!ctx || !shader_path || width == 0 || height == 0) return NULL;
+    if (frames_in_flight == 0 || frames_in_flight > SVK_SDF_MAX_FRAMES) return NULL;
+
+    svk_shader shader = svk_load_shader(ctx, shader_path);
+    if (!shader) return NULL;
+
+    uint32_t types[] = { SVK_BINDING_IMAGE };
+    svk_pipeline pipe = svk_create_pipeline_with_bindings(ctx, shader, types, 1);
+    svk_free_shader(ctx, shader);  /* The pipeline variant keeps the module */
+    if (!pipe) return NULL;
+
+    if (pipe->push_capacity < sizeof(svk_sdf_push_constants)) {
+        svk_free_pipeline(ctx, pipe);
+        return NULL;
+    }
+
+    svk_sdf_engine* sdf = (svk_sdf_engine*)calloc(1, sizeof(svk_sdf_engine));
+    if (!sdf) {
+        svk_free_pipeline(ctx, pipe);
+        return NULL;
+    }
+    pipe->sdf = sdf;
+
+    /* Shaders without reflected local size are assumed to use 16x16 */
+    uint32_t local_x = pipe->local_size[0] ? pipe->local_size[0] : 16;
+    uint32_t local_y = pipe->local_size[1] ? pipe->local_size[1] : 16;
+    sdf->groups_x = (width + local_x - 1) / local_x;
+    sdf->groups_y = (height + local_y - 1) / local_y;
+
+    for (uint32_t i = 0; i < frames_in_flight; i++) {
+        sdf->images[i] = svk_create_image(ctx, width, height, SVK_FORMAT_RGBA8);
+        if (!sdf->images[i]) {
+            svk_free_pipeline(ctx, pipe);
+            return NULL;
+        }
+        sdf->frame_count++;
+    }
+
+    return pipe;
+}
+
+static svk_ticket render_sdf(svk_context ctx, svk_pipeline pipe,
+                             float cam_x, float cam_y, float cam_z,
+                             float cam_yaw, float cam_pitch, float time) {
+    if (!ctx || !pipe || !pipe->sdf) return 0;
+
+    svk_sdf_engine* sdf = pipe->sdf;
+    uint32_t index = sdf->next;
+    svk_image img = sdf->images[index];
+
+    /* Reusing the image of the oldest frame: wait for it, dropping it if unread */
+    if (sdf->frames[index]) {
+        if (!svk_wait_ticket(ctx, sdf->frames[index])) return 0;
+        svk_finish_image_download(ctx, sdf->frames[index], NULL);
+        sdf->frames[index] = 0;
+    }
+
+    svk_sdf_push_constants pc = {
+        .camera_pos = { cam_x, cam_y, cam_z },
+        .camera_yaw = cam_yaw,
+        .camera_pitch = cam_pitch,
+        .time = time
+    };
+    if (!svk_bind_image(pipe, 0, img) || !svk_set_push_constants(pipe, &pc, sizeof(pc))) return 0;
+    if (!prepare_descriptors(ctx, pipe)) return 0;
+
+    svk_readback_slot* rb = acquire_readback(ctx, image_bytes(img));
+    if (!rb) return 0;
+
+    svk_submit_slot* slot = begin_slot(ctx, SVK_QUEUE_COMPUTE);
+    if (!slot) {
+        release_readback(rb);
+        return 0;
+    }
+    depend_on_bindings(ctx, slot, pipe);
+
+    int timing = timing_begin(ctx, slot, SVK_SAMPLE_DISPATCH);
+    record_dispatch(slot->cmd, pipe, NULL, sdf->groups_x, sdf->groups_y, 1);
+    timing_end(ctx, slot, timing);
+
+    /* Shader writes must land before the copy reads the image */
+    VkMemoryBarrier barrier = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT
+    };
+    vkCmdPipelineBarrier(slot->cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 1, &barrier, 0, NULL, 0, NULL);
+
+    record_image_download(ctx, slot, img, rb);
+
+    svk_ticket ticket = submit_slot(ctx, slot);
+    release_readback(rb);
+    if (ticket == 0) return 0;
+
+    mark_pipeline_submitted(pipe, ticket);
+    mark_readback_submitted(rb, img, ticket);
+    sdf->frames[index] = ticket;
+    sdf->next = (index + 1) % sdf->frame_count;
+    return ticket;
+}
+
+int svk_read_sdf_frame(svk_context ctx, svk_pipeline pipe, svk_ticket frame, void* data) {
+    if (!ctx || !pipe || !pipe->sdf || frame == 0 || !data) return 0;
+
+    svk_sdf_engine* sdf = pipe->sdf;
+    for (uint32_t i = 0; i < sdf->frame_count; i++) {
+        if (sdf->frames[i] == frame) {
+            sdf->frames[i] = 0;
+            return svk_finish_image_download(ctx, frame, data);
+        }
+    }
+    return 0;
+}
+
+svk_image svk_sdf_output_image(svk_pipeline pipe, svk_ticket frame) {
+    if (!pipe || !pipe->sdf) return NULL;
+
+    svk_sdf_engine* sdf = pipe->sdf;
+    for (uint32_t i = 0; i < sdf->frame_count; i++) {
+        if (sdf->frames[i] == frame) return sdf->images[i];
+    }
+    return NULL;
+}
+
+/* ============================================================================
+ * Tile-Culled SDF Rendering
+ *
+ * Two pipelines of one buffer-output SDF shader, told apart by the TILE_PASS
+ * specialization constant. The classify pass runs one invocation per tile:
+ * it marches a cone holding the tile's pixel rays and stores, after the
+ * pixels, the depth up to which the cone is empty. The march pass starts
+ * each pixel from its tile's depth and skips tiles the cone left empty.
+ * Both passes are one submission with a barrier between them.
+ * ============================================================================ */
+
+struct svk_tiled_sdf_t {
+    svk_context ctx;
+    svk_pipeline classify;
+    svk_pipeline march;
+    uint32_t tile_size;
+};
+
+static svk_pipeline create_tile_pass(svk_context ctx, svk_shader shader, const svk_spec_constant* constants,
+                                     uint32_t count, uint32_t pass, uint32_t tile_size) {
+    svk_spec_constant spec[SVK_MAX_SPEC_CONSTANTS];
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (constants[i].id == SVK_SDF_TILE_PASS_ID || constants[i].id == SVK_SDF_TILE_SIZE_ID) continue;
+        if (n == SVK_MAX_SPEC_CONSTANTS - 2) return NULL;
+        spec[n++] = constants[i];
+    }
+    spec[n++] = (svk_spec_constant){ SVK_SDF_TILE_PASS_ID, pass };
+    spec[n++] = (svk_spec_constant){ SVK_SDF_TILE_SIZE_ID, tile_size };
+    return svk_create_pipeline_specialized(ctx, shader, spec, n);
+}
+
+svk_tiled_sdf svk_create_tiled_sdf(svk_context ctx, svk_shader shader, const svk_spec_constant* constants,
+                                   uint32_t count, uint32_t tile_size) {
+    if (!ctx || !shader || (count > 0 && !constants) || tile_size == 0) return NULL;
+
+    svk_tiled_sdf sdf = (svk_tiled_sdf)calloc(1, sizeof(struct svk_tiled_sdf_t));
+    if (!sdf) return NULL;
+
+    sdf->ctx = ctx;
+    sdf->tile_size = tile_size;
+    sdf->classify = create_tile_pass(ctx, shader, constants, count, 1, tile_size);
+    sdf->march = create_tile_pass(ctx, shader, constants, count, 2, tile_size);
+    if (!sdf->classify || !sdf->march || sdf->classify->local_size[0] == 0 ||
+        sdf->march->local_size[0] == 0 || sdf->march->binding_types[0] != SVK_BINDING_BUFFER) {
+        svk_free_tiled_sdf(sdf);
+        return NULL;
+    }
+    return sdf;
+}
+
+uint64_t svk_tiled_sdf_buffer_size(uint32_t width, uint32_t height, uint32_t tile_size) {
+    if (tile_size == 0) return 0;
+    uint64_t tiles = (uint64_t)((width + tile_size - 1) / tile_size) * ((height + tile_size - 1) / tile_size);
+    return ((uint64_t)width * height + tiles) * sizeof(uint32_t);
+}
+
+int svk_tiled_sdf_bind(svk_tiled_sdf sdf, svk_buffer pixels, svk_buffer params) {
+    if (!sdf || !pixels || !params) return 0;
+    return svk_bind_buffer(sdf->classify, 0, pixels) && svk_bind_buffer(sdf->classify, 1, params) &&
+           svk_bind_buffer(sdf->march, 0, pixels) && svk_bind_buffer(sdf->march, 1, params);
+}
+
+static svk_ticket tiled_sdf_render(svk_tiled_sdf sdf, uint32_t width, uint32_t height) {
+    if (!sdf || width == 0 || height == 0) return 0;
+
+    svk_context ctx = sdf->ctx;
+    svk_pipeline classify = sdf->classify;
+    svk_pipeline march = sdf->march;
+    svk_buffer pixels = march->buffers[0];
+    if (!pixels || !march->buffers[1]) return 0;
+    if (pixels->size < svk_tiled_sdf_buffer_size(width, height, sdf->tile_size)) return 0;
+
+    if (!prepare_descriptors(ctx, classify) || !prepare_descriptors(ctx, march)) return 0;
+
+    svk_submit_slot* slot = begin_slot(ctx, SVK_QUEUE_COMPUTE);
+    if (!slot) return 0;
+    depend_on_bindings(ctx, slot, classify);
+    depend_on_bindings(ctx, slot, march);
+
+    uint32_t tiles_x = (width + sdf->tile_size - 1) / sdf->tile_size;
+    uint32_t tiles_y = (height + sdf->tile_size - 1) / sdf->tile_size;
+    const uint32_t* cl = classify->local_size;
+    const uint32_t* ml = march->local_size;
+
+    int timing = timing_begin(ctx, slot, SVK_SAMPLE_DISPATCH);
+    record_dispatch(slot->cmd, classify, NULL, (tiles_x + cl[0] - 1) / cl[0], (tiles_y + cl[1] - 1) / cl[1], 1);
+    timing_end(ctx, slot, timing);
+
+    /* Tile depths must land before the march pass reads them */
+    VkMemoryBarrier barrier = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
+    };
+    vkCmdPipelineBarrier(slot->cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 1, &barrier, 0, NULL, 0, NULL);
+
+    timing = timing_begin(ctx, slot, SVK_SAMPLE_DISPATCH);
+    record_dispatch(slot->cmd, march, NULL, (width + ml[0] - 1) / ml[0], (height + ml[1] - 1) / ml[1], 1);
+    timing_end(ctx, slot, timing);
+
+    svk_ticket ticket = submit_slot(ctx, slot);
+    if (ticket) {
+        mark_pipeline_submitted(classify, ticket);
+        mark_pipeline_submitted(march, ticket);
+    }
+    return ticket;
+}
+
+int svk_tiled_sdf_render(svk_tiled_sdf sdf, uint32_t width, uint32_t height) {
+    svk_ticket ticket = svk_tiled_sdf_render_async(sdf, width, height);
+    if (ticket == 0) return 0;
+    return svk_wait_ticket(sdf->ctx, ticket);
+}
+
+void svk_free_tiled_sdf(svk_tiled_sdf sdf) {
+    if (!sdf) return;
+    svk_free_pipeline(sdf->ctx, sdf->classify);
+    svk_free_pipeline(sdf->ctx, sdf->march);
+    free(sdf);
+}
+
+/* ============================================================================
+ * Command Lists (batched recording)
+ *
+ * Each recorded step declares the resources it touches. The list keeps the
+ * last access per resource and emits one global memory barrier before a step
+ * only when it depends on an earlier step (read-after-write, write-after-read
+ * or write-after-write).
+ * ============================================================================ */
+
+#define SVK_LIST_IDLE       0
+#define SVK_LIST_RECORDING  1
+#define SVK_LIST_ENDED      2
+
+/* Access history of one resource within a command list or graph batch */
+typedef struct {
+    uint64_t id;
+    svk_ticket* last_ticket;
+    uint32_t* pins;                      /* Pin count held by a command list, else NULL */
+    VkPipelineStageFlags write_stages;   /* Stage of the last write (0 = none) */
+    VkAccessFlags write_access;
+    VkPipelineStageFlags visible_stages; /* Stages the last write is visible to */
+    VkPipelineStageFlags read_stages;    /* Stages that read since the last write */
+} svk_access_state;
+
+/* Resources touched by a run of recorded steps, and the barrier the next
+   step needs */
+typedef struct {
+    svk_access_state* access;
+    uint32_t access_count;
+    uint32_t access_capacity;
+
+    /* Barrier accumulated for the next step */
+    VkPipelineStageFlags src_stages;
+    VkPipelineStageFlags dst_stages;
+    VkAccessFlags src_access;
+    VkAccessFlags dst_access;
+} svk_access_tracker;
+
+/* Descriptor set recorded by a command list */
+typedef struct {
+    svk_pipeline pipe;
+    svk_set_entry* entry;
+} svk_list_set;
+
+struct svk_cmdlist_t {
+    svk_context ctx;
+    svk_submit_slot* slot;
+    int state;
+
+    svk_access_tracker tracker;
+
+    svk_list_set* sets;
+    uint32_t set_count;
+    uint32_t set_capacity;
+};
+
+static int grow_array(void** items, uint32_t* capacity, uint32_t count, size_t item_size) {
+    if (count < *capacity) return 1;
+    uint32_t new_capacity = *capacity ? *capacity * 2 : 16;
+    void* grown = realloc(*items, new_capacity * item_size);
+    if (!grown) return 0;
+    *items = grown;
+    *capacity = new_capacity;
+    return 1;
+}
+
+/* Record an access and accumulate the barrier it needs. The first access to
+   a resource makes `slot`, if given, wait for its last user on other queues. */
+static int track_access(svk_context ctx, svk_submit_slot* slot, svk_access_tracker* t,
+                        uint64_t id, svk_ticket* last_ticket,
+                        VkPipelineStageFlags stage, VkAccessFlags access, int is_write) {
+    svk_access_state* st = NULL;
+    for (uint32_t i = 0; i < t->access_count; i++) {
+        if (t->access[i].id == id) {
+            st = &t->access[i];
+            break;
+        }
+    }
+
+    if (!st) {
+        if (!grow_array((void**)&t->access, &t->access_capacity, t->access_count, sizeof(svk_access_state))) return 0;
+        st = &t->access[t->access_count++];
+        memset(st, 0, sizeof(*st));
+        st->id = id;
+        st->last_ticket = last_ticket;
+        if (slot) slot_depend(ctx, slot, *last_ticket);
+    }
+
+    /* Read/write after write: make the write visible to this stage */
+    if (st->write_stages && !(st->visible_stages & stage)) {
+        t->src_stages |= st->write_stages;
+        t->src_access |= st->write_access;
+        t->dst_stages |= stage;
+        t->dst_access |= access;
+        st->visible_stages |= stage;
+    }
+
+    /* Write after read: execution dependency on the readers */
+    if (is_write && st->read_stages) {
+        t->src_stages |= st->read_stages;
+        t->dst_stages |= stage;
+    }
+
+    if (is_write) {
+        st->write_stages = stage;
+        st->write_access = access & (VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT);
+        st->visible_stages = 0;
+        st->read_stages = 0;
+    } else {
+        st->read_stages |= stage;
+    }
+
+    return 1;
+}
+
+static void flush_barrier(svk_access_tracker* t, VkCommandBuffer cmd) {
+    if (!t->src_stages) return;
+
+    VkMemoryBarrier barrier = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = t->src_access,
+        .dstAccessMask = t->dst_access
+    };
+
+    vkCmdPipelineBarrier(cmd, t->src_stages, t->dst_stages, 0, 1, &barrier, 0, NULL, 0, NULL);
+
+    t->src_stages = 0;
+    t->dst_stages = 0;
+    t->src_access = 0;
+    t->dst_access = 0;
+}
+
+static void reset_tracker(svk_access_tracker* t) {
+    t->access_count = 0;
+    t->src_stages = 0;
+    t->dst_stages = 0;
+    t->src_access = 0;
+    t->dst_access = 0;
+}
+
+/* Track an access of the list. The resource stays pinned, and cannot be
+   freed, until the list is submitted or discarded. */
+static int list_access(svk_cmdlist list, uint64_t id, svk_ticket* last_ticket, uint32_t* pins,
+                       VkPipelineStageFlags stage, VkAccessFlags access, int is_write) {
+    uint32_t count = list->tracker.access_count;
+    if (!track_access(list->ctx, list->slot, &list->tracker, id, last_ticket, stage, access, is_write)) return 0;
+    if (list->tracker.access_count > count) {
+        list->tracker.access[count].pins = pins;
+        (*pins)++;
+    }
+    return 1;
+}
+
+static void list_flush_barrier(svk_cmdlist list) {
+    flush_barrier(&list->tracker, list->slot->cmd);
+}
+
+/* Pin the pipeline's current descriptor set until the list is submitted */
+static int list_add_set(svk_cmdlist list, svk_pipeline pipe) {
+    for (uint32_t i = 0; i < list->set_count; i++) {
+        if (list->sets[i].entry == pipe->current) return 1;
+    }
+    if (!grow_array((void**)&list->sets, &list->set_capacity, list->set_count, sizeof(svk_list_set))) return 0;
+    list->sets[list->set_count++] = (svk_list_set){ pipe, pipe->current };
+    pipe->current->pins++;
+    return 1;
+}
+
+/* Drop the slot and descriptor set references of a begun list */
+static void list_release(svk_cmdlist list, svk_ticket ticket) {
+    for (uint32_t i = 0; i < list->set_count; i++) {
+        list->sets[i].entry->pins--;
+        if (ticket) {
+            list->sets[i].entry->last_ticket = ticket;
+            list->sets[i].pipe->last_ticket = ticket;
+        }
+    }
+    for (uint32_t i = 0; i < list->tracker.access_count; i++) {
+        if (ticket) *list->tracker.access[i].last_ticket = ticket;
+        (*list->tracker.access[i].pins)--;
+    }
+    if (list->slot) list->slot->recording = 0;
+
+    list->slot = NULL;
+    list->state = SVK_LIST_IDLE;
+    list->set_count = 0;
+    reset_tracker(&list->tracker);
+}
+
+svk_cmdlist svk_create_cmdlist(svk_context ctx) {
+    if (!ctx) return NULL;
+
+    svk_cmdlist list = (svk_cmdlist)calloc(1, sizeof(struct svk_cmdlist_t));
+    if (!list) return NULL;
+
+    list->ctx = ctx;
+    return list;
+}
+
+/* Drop a begun list without submitting it. An open command buffer is ended
+   first, so its slot is reused from the executable state. */
+static void list_discard(svk_cmdlist list) {
+    if (list->state == SVK_LIST_RECORDING) vkEndCommandBuffer(list->slot->cmd);
+    list_release(list, 0);
+}
+
+static int cmdlist_begin(svk_cmdlist list) {
+    if (!list) return 0;
+    if (list->state != SVK_LIST_IDLE) list_discard(list);
+
+    list->slot = begin_slot(list->ctx, SVK_QUEUE_COMPUTE);
+    if (!list->slot) return 0;
+
+    list->state = SVK_LIST_RECORDING;
+    return 1;
+}
+
+/* Pin the pipeline's descriptor set and declare the accesses of its bindings */
+static int list_dispatch_access(svk_cmdlist list, svk_pipeline pipe) {
+    if (!prepare_descriptors(list->ctx, pipe)) return 0;
+    if (!list_add_set(list, pipe)) return 0;
+
+    /* Bindings are read and written unless reflection showed them read-only */
+    for (int i = 0; i < SVK_MAX_BINDINGS; i++) {
+        svk_buffer buf = pipe->buffers[i];
+        svk_image img = pipe->images[i];
+        int writes = !(pipe->readonly_mask & (1u << i));
+        VkAccessFlags access = VK_ACCESS_SHADER_READ_BIT | (writes ? VK_ACCESS_SHADER_WRITE_BIT : 0);
+        if (buf && !list_access(list, buf->id, &buf->last_ticket, &buf->pins,
+                                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, access, writes)) return 0;
+        if (img && !list_access(list, img->id, &img->last_ticket, &img->pins,
+                                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, access, writes)) return 0;
+    }
+    return 1;
+}
+
+static int cmd_dispatch(svk_cmdlist list, svk_pipeline pipe, uint32_t x, uint32_t y, uint32_t z) {
+    if (!list || !pipe || list->state != SVK_LIST_RECORDING) return 0;
+    if (!list_dispatch_access(list, pipe)) return 0;
+
+    list_flush_barrier(list);
+    int timing = timing_begin(list->ctx, list->slot, SVK_SAMPLE_DISPATCH);
+    record_dispatch(list->slot->cmd, pipe, NULL, x, y, z);
+    timing_end(list->ctx, list->slot, timing);
+    return 1;
+}
+
+static int cmd_dispatch_indirect(svk_cmdlist list, svk_pipeline pipe, svk_buffer args, uint64_t offset) {
+    if (!list || !pipe || !valid_indirect(args, offset) || list->state != SVK_LIST_RECORDING) return 0;
+
+    /* The arguments are read before the shader runs */
+    if (!list_access(list, args->id, &args->last_ticket, &args->pins, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                     VK_ACCESS_INDIRECT_COMMAND_READ_BIT, 0)) return 0;
+    if (!list_dispatch_access(list, pipe)) return 0;
+
+    list_flush_barrier(list);
+    int timing = timing_begin(list->ctx, list->slot, SVK_SAMPLE_DISPATCH);
+    record_indirect_dispatch(list->slot->cmd, pipe, args, offset);
+    timing_end(list->ctx, list->slot, timing);
+    return 1;
+}
+
+static int cmd_copy_buffer(svk_cmdlist list, svk_buffer src, svk_buffer dst,
+                           uint64_t src_offset, uint64_t dst_offset, uint64_t size) {
+    if (!list || !src || !dst || size == 0 || list->state != SVK_LIST_RECORDING) return 0;
+    if (src_offset + size > src->size || dst_offset + size > dst->size) return 0;
+
+    if (!list_access(list, src->id, &src->last_ticket, &src->pins, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                     VK_ACCESS_TRANSFER_READ_BIT, 0)) return 0;
+    if (!list_access(list, dst->id, &dst->last_ticket, &dst->pins, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                     VK_ACCESS_TRANSFER_WRITE_BIT, 1)) return 0;
+
+    list_flush_barrier(list);
+
+    VkBufferCopy region = {
+        .srcOffset = src_offset,
+        .dstOffset = dst_offset,
+        .size = size
+    };
+
+    int timing = timing_begin(list->ctx, list->slot, SVK_SAMPLE_COPY);
+    vkCmdCopyBuffer(list->slot->cmd, src->buffer, dst->buffer, 1, &region);
+    timing_end(list->ctx, list->slot, timing);
+    return 1;
+}
+
+static int cmd_fill_buffer(svk_cmdlist list, svk_buffer buf, uint64_t offset, uint64_t size, uint32_t value) {
+    if (!list || !buf || size == 0 || list->state != SVK_LIST_RECORDING) return 0;
+    if ((offset % 4) != 0 || (size % 4) != 0 || offset + size > buf->size) return 0;
+
+    if (!list_access(list, buf->id, &buf->last_ticket, &buf->pins, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                     VK_ACCESS_TRANSFER_WRITE_BIT, 1)) return 0;
+
+    list_flush_barrier(list);
+
+    int timing = timing_begin(list->ctx, list->slot, SVK_SAMPLE_FILL);
+    vkCmdFillBuffer(list->slot->cmd, buf->buffer, offset, size, value);
+    timing_end(list->ctx, list->slot, timing);
+    return 1;
+}
+
+static int cmdlist_end(svk_cmdlist list) {
+    if (!list || list->state != SVK_LIST_RECORDING) return 0;
+
+    if (!end_slot(list->slot)) {
+        list_release(list, 0);
+        return 0;
+    }
+
+    list->state = SVK_LIST_ENDED;
+    return 1;
+}
+
+static svk_ticket cmdlist_submit(svk_cmdlist list) {
+    if (!list || list->state != SVK_LIST_ENDED) return 0;
+
+    svk_ticket ticket = queue_slot(list->ctx, list->slot);
+    list_release(list, ticket);
+    return ticket;
+}
+
+static void free_cmdlist(svk_cmdlist list) {
+    if (!list) return;
+    if (list->state != SVK_LIST_IDLE) list_discard(list);
+    free(list->tracker.access);
+    free(list->sets);
+    free(list);
+}
+
+/* ============================================================================
+ * Task Graphs
+ *
+ * Nodes are added in execution order and declare what they read and write.
+ * Compiling groups consecutive nodes on the same queue into batches and
+ * records each batch once into a secondary command buffer, with barriers
+ * only between dependent nodes. A run executes each batch from a ring slot,
+ * so it gets a ticket and waits on other queues' timelines only for the
+ * resources it shares with them; independent batches overlap. A batch whose
+ * parameters changed is re-recorded into its spare command buffer first.
+ *
+ * Transient buffers and images belong to the graph and get memory only when
+ * it is compiled. Each lives from the first to the last node that uses it;
+ * transients whose lifetimes do not overlap are placed at overlapping
+ * offsets of one aliased heap. A transient's first use in a run waits for
+ * every alias that shares its memory (across queues too) and discards its
+ * old contents, so it must be written before it is read.
+ * ============================================================================ */
+
+#define SVK_GRAPH_DISPATCH 0
+#define SVK_GRAPH_COPY     1
+#define SVK_GRAPH_READBACK 2
+
+typedef struct {
+    uint32_t kind;                          /* SVK_GRAPH_* */
+    uint32_t role;                          /* Queue role the node runs on */
+    uint32_t batch;                         /* Set by svk_graph_compile */
+
+    /* Dispatch: bindings and push constants as of svk_graph_dispatch */
+    svk_pipeline pipe;
+    svk_set_entry* set;                     /* Written at compile, pinned while the graph lives */
+    svk_buffer buffers[SVK_MAX_BINDINGS];
+    svk_image images[SVK_MAX_BINDINGS];
+    uint64_t ids[SVK_MAX_BINDINGS];
+    uint32_t readonly_mask;
+    uint8_t push_data[256];
+    uint32_t push_size;
+    uint32_t groups[3];
+    svk_buffer args;                        /* Indirect dispatch: counts read from args at args_offset */
+    uint64_t args_offset;
+
+    /* Copy and readback; a readback's target is a graph-owned staging buffer */
+    svk_buffer src;
+    svk_image src_image;
+    svk_buffer dst;
+    uint64_t src_offset;
+    uint64_t dst_offset;
+    uint64_t size;
+} svk_graph_node;
+
+/* Consecutive nodes on one queue, submitted together */
+typedef struct {
+    uint32_t role;
+    uint32_t first;
+    uint32_t count;
+    VkCommandBuffer cmd[2];      /* Secondary command buffers; one is spare */
+    svk_ticket tickets[2];       /* Last submission that executed each */
+    uint32_t current;            /* Command buffer runs execute */
+    int dirty;                   /* Parameters changed since `current` was recorded */
+    svk_access_tracker tracker;  /* Resources the batch touches */
+} svk_graph_batch;
+
+/* Graph-owned buffer or image whose memory may alias others' */
+typedef struct {
+    svk_buffer buffer;           /* Exactly one of buffer and image is set */
+    svk_image image;
+    VkMemoryRequirements reqs;
+    uint32_t first;              /* Nodes using it; first > last when unused */
+    uint32_t last;
+    uint64_t offset;             /* Placement in the graph's heap */
+    uint64_t size;               /* Footprint, padded to the heap alignment */
+    int aliased;                 /* Bound into the heap rather than its own allocation */
+} svk_graph_transient;
+
+struct svk_graph_t {
+    svk_context ctx;
+
+    svk_graph_node* nodes;
+    uint32_t node_count;
+    uint32_t node_capacity;
+
+    svk_graph_batch* batches;
+    uint32_t batch_count;
+    int compiled;
+
+    svk_graph_transient* transients;
+    uint32_t transient_count;
+    uint32_t transient_capacity;
+    svk_allocation heap;         /* Shared by the aliased transients */
+    int placed;                  /* Transients have memory */
+    uint64_t transient_bytes;    /* Memory the transients occupy */
+    uint64_t unaliased_bytes;    /* Memory they would need without aliasing */
+};
+
+/* Next node slot, zeroed; the caller commits it by bumping node_count */
+static svk_graph_node* graph_add(svk_graph graph, uint32_t kind, uint32_t role) {
+    if (graph->compiled || role >= SVK_QUEUE_COUNT) return NULL;
+    if (!grow_array((void**)&graph->nodes, &graph->node_capacity, graph->node_count, sizeof(svk_graph_node))) return NULL;
+
+    svk_graph_node* node = &graph->nodes[graph->node_count];
+    memset(node, 0, sizeof(*node));
+    node->kind = kind;
+    node->role = role;
+    return node;
+}
+
+static svk_graph_node* graph_dispatch_node(svk_graph graph, int index) {
+    if (!graph || index < 0 || (uint32_t)index >= graph->node_count) return NULL;
+    svk_graph_node* node = &graph->nodes[index];
+    return node->kind == SVK_GRAPH_DISPATCH ? node : NULL;
+}
+
+/* Declare the node's reads and writes */
+static int graph_node_access(svk_context ctx, svk_access_tracker* t, svk_graph_node* node) {
+    if (node->kind == SVK_GRAPH_DISPATCH) {
+        if (node->args && !track_access(ctx, NULL, t, node->args->id, &node->args->last_ticket,
+                                        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                                        VK_ACCESS_INDIRECT_COMMAND_READ_BIT, 0)) return 0;
+        for (int i = 0; i < SVK_MAX_BINDINGS; i++) {
+            svk_buffer buf = node->buffers[i];
+            svk_image img = node->images[i];
+            int writes = !(node->readonly_mask & (1u << i));
+            VkAccessFlags access = VK_ACCESS_SHADER_READ_BIT | (writes ? VK_ACCESS_SHADER_WRITE_BIT : 0);
+            if (buf && !track_access(ctx, NULL, t, buf->id, &buf->last_ticket,
+                                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, access, writes)) return 0;
+            if (img && !track_access(ctx, NULL, t, img->id, &img->last_ticket,
+                                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, access, writes)) return 0;
+        }
+        return 1;
+    }
+
+    if (node->src && !track_access(ctx, NULL, t, node->src->id, &node->src->last_ticket,
+                                   VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, 0)) return 0;
+    if (node->src_image && !track_access(ctx, NULL, t, node->src_image->id, &node->src_image->last_ticket,
+                                         VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, 0)) return 0;
+    return track_access(ctx, NULL, t, node->dst->id, &node->dst->last_ticket,
+                        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, 1);
+}
+
+static void record_graph_node(VkCommandBuffer cmd, svk_graph_node* node) {
+    if (node->kind == SVK_GRAPH_DISPATCH && node->args) {
+        record_bind(cmd, node->pipe, node->pipe->pipeline, node->set, node->push_data, node->push_size);
+        vkCmdDispatchIndirect(cmd, node->args->buffer, node->args_offset);
+    } else if (node->kind == SVK_GRAPH_DISPATCH) {
+        record_bound_dispatch(cmd, node->pipe, node->set, node->push_data, node->push_size, NULL,
+                              node->groups[0], node->groups[1], node->groups[2]);
+    } else if (node->src_image) {
+        /* Images stay in GENERAL once created, so the recording stays valid */
+        VkBufferImageCopy region = {
+            .bufferOffset = 0,
+            .bufferRowLength = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 },
+            .imageOffset = { 0, 0, 0 },
+            .imageExtent = { node->src_image->width, node->src_image->height, 1 }
+        };
+        vkCmdCopyImageToBuffer(cmd, node->src_image->image, node->src_image->layout, node->dst->buffer, 1, &region);
+    } else {
+        VkBufferCopy region = {
+            .srcOffset = node->src_offset,
+            .dstOffset = node->dst_offset,
+            .size = node->size
+        };
+        vkCmdCopyBuffer(cmd, node->src->buffer, node->dst->buffer, 1, &region);
+    }
+}
+
+static uint64_t transient_id(const svk_graph_transient* t) {
+    return t->buffer ? t->buffer->id : t->image->id;
+}
+
+static svk_ticket* transient_last_ticket(svk_graph_transient* t) {
+    return t->buffer ? &t->buffer->last_ticket : &t->image->last_ticket;
+}
+
+static int node_uses(const svk_graph_node* node, uint64_t id) {
+    if (node->kind == SVK_GRAPH_DISPATCH) {
+        for (int i = 0; i < SVK_MAX_BINDINGS; i++) {
+            if (node->ids[i] == id) return 1;
+        }
+        return node->args && node->args->id == id;
+    }
+    return (node->src && node->src->id == id) || (node->src_image && node->src_image->id == id) ||
+           node->dst->id == id;
+}
+
+/* Before the first node using a transient: wait for the aliases that last
+   used its memory, and discard an image's contents */
+static int begin_transients(svk_graph graph, svk_access_tracker* t, uint32_t index, VkCommandBuffer cmd) {
+    svk_graph_node* node = &graph->nodes[index];
+    VkPipelineStageFlags stage = node->kind == SVK_GRAPH_DISPATCH
+        ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT : VK_PIPELINE_STAGE_TRANSFER_BIT;
+    VkAccessFlags access = node->kind == SVK_GRAPH_DISPATCH
+        ? VK_ACCESS_SHADER_WRITE_BIT : VK_ACCESS_TRANSFER_WRITE_BIT;
+
+    for (uint32_t i = 0; i < graph->transient_count; i++) {
+        svk_graph_transient* tr = &graph->transients[i];
+        if (tr->first != index) continue;
+
+        if (tr->aliased) {
+            for (uint32_t j = 0; j < graph->transient_count; j++) {
+                svk_graph_transient* other = &graph->transients[j];
+                if (other == tr || !other->aliased) continue;
+                if (other->offset >= tr->offset + tr->size || tr->offset >= other->offset + other->size) continue;
+                if (!track_access(graph->ctx, NULL, t, transient_id(other), transient_last_ticket(other),
+                                  stage, access, 1)) return 0;
+            }
+        }
+
+        if (tr->image) {
+            VkImageMemoryBarrier barrier = {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+                .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+                                 VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+                .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                .newLayout = VK_IMAGE_LAYOUT_GENERAL,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = tr->image->image,
+                .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 }
+            };
+            VkPipelineStageFlags stages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+            vkCmdPipelineBarrier(cmd, stages, stages, 0, 0, NULL, 0, NULL, 1, &barrier);
+        }
+    }
+    return 1;
+}
+
+/* Record the batch's nodes into `cmd`, rebuilding its resource list */
+static int record_batch(svk_graph graph, svk_graph_batch* batch, VkCommandBuffer cmd) {
+    VkCommandBufferInheritanceInfo inheritance = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO
+    };
+
+    /* Every run executes the same recording, possibly while the last is pending */
+    VkCommandBufferBeginInfo begin_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT,
+        .pInheritanceInfo = &inheritance
+    };
+
+    vkResetCommandBuffer(cmd, 0);
+    if (vkBeginCommandBuffer(cmd, &begin_info) != VK_SUCCESS) return 0;
+
+    /* Re-recording touches the same resources, so the list never needs to grow */
+    reset_tracker(&batch->tracker);
+    for (uint32_t i = 0; i < batch->count; i++) {
+        svk_graph_node* node = &graph->nodes[batch->first + i];
+        if (!begin_transients(graph, &batch->tracker, batch->first + i, cmd) ||
+            !graph_node_access(graph->ctx, &batch->tracker, node)) {
+            vkEndCommandBuffer(cmd);
+            return 0;
+        }
+        flush_barrier(&batch->tracker, cmd);
+        record_graph_node(cmd, node);
+    }
+
+    return vkEndCommandBuffer(cmd) == VK_SUCCESS;
+}
+
+static void free_graph_batches(svk_graph graph) {
+    svk_context ctx = graph->ctx;
+    for (uint32_t b = 0; b < graph->batch_count; b++) {
+        svk_graph_batch* batch = &graph->batches[b];
+        if (batch->cmd[0]) vkFreeCommandBuffers(ctx->device, ctx->queues[batch->role]->command_pool, 2, batch->cmd);
+        free(batch->tracker.access);
+    }
+    free(graph->batches);
+    graph->batches = NULL;
+    graph->batch_count = 0;
+}
+
+svk_graph svk_create_graph(svk_context ctx) {
+    if (!ctx) return NULL;
+
+    svk_graph graph = (svk_graph)calloc(1, sizeof(struct svk_graph_t));
+    if (!graph) return NULL;
+
+    graph->ctx = ctx;
+    return graph;
+}
+
+/* Dispatch node with the pipeline's current bindings and push constants */
+static svk_graph_node* graph_add_dispatch(svk_graph graph, svk_pipeline pipe, uint32_t role) {
+    if (role != SVK_QUEUE_COMPUTE && role != SVK_QUEUE_ASYNC_COMPUTE) return NULL;
+
+    svk_graph_node* node = graph_add(graph, SVK_GRAPH_DISPATCH, role);
+    if (!node) return NULL;
+
+    node->pipe = pipe;
+    memcpy(node->buffers, pipe->buffers, sizeof(node->buffers));
+    memcpy(node->images, pipe->images, sizeof(node->images));
+    memcpy(node->ids, pipe->bound_ids, sizeof(node->ids));
+    node->readonly_mask = pipe->readonly_mask;
+    memcpy(node->push_data, pipe->push_data, pipe->push_size);
+    node->push_size = pipe->push_size;
+    return node;
+}
+
+int svk_graph_dispatch(svk_graph graph, svk_pipeline pipe, uint32_t role, uint32_t x, uint32_t y, uint32_t z) {
+    if (!graph || !pipe || x == 0 || y == 0 || z == 0) return -1;
+
+    svk_graph_node* node = graph_add_dispatch(graph, pipe, role);
+    if (!node) return -1;
+
+    node->groups[0] = x;
+    node->groups[1] = y;
+    node->groups[2] = z;
+    return (int)graph->node_count++;
+}
+
+int svk_graph_dispatch_indirect(svk_graph graph, svk_pipeline pipe, uint32_t role, svk_buffer args, uint64_t offset) {
+    if (!graph || !pipe || !valid_indirect(args, offset)) return -1;
+
+    svk_graph_node* node = graph_add_dispatch(graph, pipe, role);
+    if (!node) return -1;
+
+    node->args = args;
+    node->args_offset = offset;
+    return (int)graph->node_count++;
+}
+
+int svk_graph_copy_buffer(svk_graph graph, uint32_t role, svk_buffer src, svk_buffer dst,
+                          uint64_t src_offset, uint64_t dst_offset, uint64_t size) {
+    if (!graph || !src || !dst || size == 0) return -1;
+    if (src_offset + size > src->size || dst_offset + size > dst->size) return -1;
+
+    svk_graph_node* node = graph_add(graph, SVK_GRAPH_COPY, role);
+    if (!node) return -1;
+
+    node->src = src;
+    node->dst = dst;
+    node->src_offset = src_offset;
+    node->dst_offset = dst_offset;
+    node->size = size;
+    return (int)graph->node_count++;
+}
+
+int svk_graph_readback_buffer(svk_graph graph, uint32_t role, svk_buffer buf, uint64_t offset, uint64_t size) {
+    if (!graph || !buf || size == 0 || offset + size > buf->size) return -1;
+
+    svk_graph_node* node = graph_add(graph, SVK_GRAPH_READBACK, role);
+    if (!node) return -1;
+
+    node->dst = svk_create_buffer(graph->ctx, size, SVK_BUFFER_TRANSFER | SVK_BUFFER_HOST_READBACK);
+    if (!node->dst) return -1;
+
+    node->src = buf;
+    node->src_offset = offset;
+    node->size = size;
+    return (int)graph->node_count++;
+}
+
+int svk_graph_readback_image(svk_graph graph, uint32_t role, svk_image img) {
+    if (!graph || !img) return -1;
+
+    svk_graph_node* node = graph_add(graph, SVK_GRAPH_READBACK, role);
+    if (!node) return -1;
+
+    node->size = image_bytes(img);
+    node->dst = svk_create_buffer(graph->ctx, node->size, SVK_BUFFER_TRANSFER | SVK_BUFFER_HOST_READBACK);
+    if (!node->dst) return -1;
+
+    node->src_image = img;
+    return (int)graph->node_count++;
+}
+
+static svk_graph_transient* graph_add_transient(svk_graph graph) {
+    if (graph->placed) return NULL;
+    if (!grow_array((void**)&graph->transients, &graph->transient_capacity, graph->transient_count,
+                    sizeof(svk_graph_transient))) return NULL;
+
+    svk_graph_transient* t = &graph->transients[graph->transient_count];
+    memset(t, 0, sizeof(*t));
+    return t;
+}
+
+static svk_buffer graph_transient_buffer(svk_graph graph, uint64_t size, uint32_t usage) {
+    if (!graph || size == 0) return NULL;
+
+    uint32_t placement = usage & SVK_BUFFER_PLACEMENT_MASK;
+    if (placement != 0 && placement != SVK_BUFFER_DEVICE_LOCAL) return NULL;
+
+    svk_graph_transient* t = graph_add_transient(graph);
+    if (!t) return NULL;
+
+    t->buffer = create_buffer_object(graph->ctx, size, usage | SVK_BUFFER_DEVICE_LOCAL);
+    if (!t->buffer) return NULL;
+
+    vkGetBufferMemoryRequirements(graph->ctx->device, t->buffer->buffer, &t->reqs);
+    graph->transient_count++;
+    return t->buffer;
+}
+
+static svk_image graph_transient_image(svk_graph graph, uint32_t width, uint32_t height, uint32_t format) {
+    if (!graph || width == 0 || height == 0) return NULL;
+
+    svk_graph_transient* t = graph_add_transient(graph);
+    if (!t) return NULL;
+
+    t->image = create_image_object(graph->ctx, width, height, format);
+    if (!t->image) return NULL;
+
+    vkGetImageMemoryRequirements(graph->ctx->device, t->image->image, &t->reqs);
+    graph->transient_count++;
+    return t->image;
+}
+
+/* Lowest aligned offset where `t` overlaps no placed transient that is alive
+   at the same time */
+static uint64_t place_transient(svk_graph graph, const svk_graph_transient* t, uint64_t alignment) {
+    uint64_t offset = 0;
+    int moved = 1;
+    while (moved) {
+        moved = 0;
+        for (uint32_t i = 0; i < graph->transient_count; i++) {
+            const svk_graph_transient* other = &graph->transients[i];
+            if (other == t || !other->aliased) continue;
+            if (other->last < t->first || t->last < other->first) continue;
+            if (offset < other->offset + other->size && other->offset < offset + t->size) {
+                offset = align_up(other->offset + other->size, alignment);
+                moved = 1;
+            }
+        }
+    }
+    return offset;
+}
+
+static int bind_transient(svk_context ctx, svk_graph_transient* t, VkDeviceMemory memory, uint64_t offset) {
+    if (t->buffer) return vkBindBufferMemory(ctx->device, t->buffer->buffer, memory, offset) == VK_SUCCESS;
+
+    if (vkBindImageMemory(ctx->device, t->image->image, memory, offset) != VK_SUCCESS) return 0;
+    if (!create_image_view(ctx, t->image)) return 0;
+    t->image->layout = VK_IMAGE_LAYOUT_GENERAL;
+    return 1;
+}
+
+/* Compute lifetimes and give every used transient memory: one aliased heap,
+   filled largest first, or separate allocations when no memory type suits
+   them all */
+static int place_transients(svk_graph graph) {
+    svk_context ctx = graph->ctx;
+    uint64_t alignment = ctx->buffer_image_granularity;
+    uint32_t type_bits = UINT32_MAX;
+    uint32_t used = 0;
+
+    for (uint32_t i = 0; i < graph->transient_count; i++) {
+        svk_graph_transient* t = &graph->transients[i];
+        uint64_t id = transient_id(t);
+        t->first = UINT32_MAX;
+        t->last = 0;
+        for (uint32_t n = 0; n < graph->node_count; n++) {
+            if (!node_uses(&graph->nodes[n], id)) continue;
+            if (t->first == UINT32_MAX) t->first = n;
+            t->last = n;
+        }
+        if (t->first == UINT32_MAX) continue;
+
+        used++;
+        type_bits &= t->reqs.memoryTypeBits;
+        if (t->reqs.alignment > alignment) alignment = t->reqs.alignment;
+    }
+
+    /* Padding every footprint to the granularity keeps buffers and images
+       that share the heap on separate pages */
+    graph->unaliased_bytes = 0;
+    for (uint32_t i = 0; i < graph->transient_count; i++) {
+        svk_graph_transient* t = &graph->transients[i];
+        if (t->first > t->last) continue;
+        t->size = align_up(t->reqs.size, alignment);
+        graph->unaliased_bytes += t->size;
+    }
+
+    uint64_t heap_size = 0;
+    if (used > 1 && type_bits != 0) {
+        for (uint32_t placed = 0; placed < used; placed++) {
+            svk_graph_transient* largest = NULL;
+            for (uint32_t i = 0; i < graph->transient_count; i++) {
+                svk_graph_transient* t = &graph->transients[i];
+                if (t->first > t->last || t->aliased) continue;
+                if (!largest || t->size > largest->size) largest = t;
+            }
+            largest->offset = place_transient(graph, largest, alignment);
+            largest->aliased = 1;
+            if (largest->offset + largest->size > heap_size) heap_size = largest->offset + largest->size;
+        }
+
+        VkMemoryRequirements heap_reqs = {
+            .size = heap_size,
+            .alignment = alignment,
+            .memoryTypeBits = type_bits
+        };
+        if (!allocate_memory(ctx, &heap_reqs, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0,
+                             SVK_ALLOC_ALIASED, &graph->heap)) {
+            for (uint32_t i = 0; i < graph->transient_count; i++) graph->transients[i].aliased = 0;
+            heap_size = 0;
+        }
+    }
+
+    for (uint32_t i = 0; i < graph->transient_count; i++) {
+        svk_graph_transient* t = &graph->transients[i];
+        if (t->first > t->last) continue;
+
+        if (t->aliased) {
+            if (!bind_transient(ctx, t, graph->heap.block->memory, graph->heap.offset + t->offset)) return 0;
+            continue;
+        }
+
+        svk_allocation* alloc = t->buffer ? &t->buffer->alloc : &t->image->alloc;
+        if (!allocate_memory(ctx, &t->reqs, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0,
+                             t->buffer ? SVK_ALLOC_LINEAR : SVK_ALLOC_OPTIMAL, alloc)) return 0;
+        if (!bind_transient(ctx, t, alloc->block->memory, alloc->offset)) return 0;
+        heap_size += t->size;
+    }
+
+    graph->transient_bytes = heap_size;
+    graph->placed = 1;
+    return 1;
+}
+
+static int graph_compile(svk_graph graph) {
+    if (!graph || graph->compiled || graph->node_count == 0) return 0;
+    svk_context ctx = graph->ctx;
+
+    /* Descriptor sets can only be written once the transients have memory */
+    if (!graph->placed && !place_transients(graph)) return 0;
+
+    for (uint32_t i = 0; i < graph->node_count; i++) {
+        svk_graph_node* node = &graph->nodes[i];
+        if (node->kind != SVK_GRAPH_DISPATCH || node->set) continue;
+        node->set = acquire_set(ctx, node->pipe, node->buffers, node->images, node->ids);
+        if (!node->set) return 0;
+        node->set->pins++;
+    }
+
+    graph->batches = (svk_graph_batch*)calloc(graph->node_count, sizeof(svk_graph_batch));
+    if (!graph->batches) return 0;
+
+    /* Roles sharing a queue (no dedicated queue for them) share batches too */
+    for (uint32_t i = 0; i < graph->node_count; i++) {
+        svk_graph_node* node = &graph->nodes[i];
+        svk_graph_batch* batch = graph->batch_count ? &graph->batches[graph->batch_count - 1] : NULL;
+        if (!batch || ctx->queues[batch->role] != ctx->queues[node->role]) {
+            batch = &graph->batches[graph->batch_count++];
+            batch->role = node->role;
+            batch->first = i;
+        }
+        node->batch = (uint32_t)(batch - graph->batches);
+        batch->count++;
+    }
+
+    for (uint32_t b = 0; b < graph->batch_count; b++) {
+        svk_graph_batch* batch = &graph->batches[b];
+        VkCommandBufferAllocateInfo alloc_info = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = ctx->queues[batch->role]->command_pool,
+            .level = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+            .commandBufferCount = 2
+        };
+
+        if (vkAllocateCommandBuffers(ctx->device, &alloc_info, batch->cmd) != VK_SUCCESS) {
+            batch->cmd[0] = batch->cmd[1] = VK_NULL_HANDLE;
+            free_graph_batches(graph);
+            return 0;
+        }
+        if (!record_batch(graph, batch, batch->cmd[0])) {
+            free_graph_batches(graph);
+            return 0;
+        }
+    }
+
+    graph->compiled = 1;
+    return 1;
+}
+
+uint32_t svk_graph_batch_count(svk_graph graph) {
+    return graph ? graph->batch_count : 0;
+}
+
+uint64_t svk_graph_transient_bytes(svk_graph graph) {
+    return graph ? graph->transient_bytes : 0;
+}
+
+uint64_t svk_graph_unaliased_bytes(svk_graph graph) {
+    return graph ? graph->unaliased_bytes : 0;
+}
+
+int svk_graph_set_push_constants(svk_graph graph, int node, const void* data, uint32_t size) {
+    svk_graph_node* n = graph_dispatch_node(graph, node);
+    if (!n || !data || size > n->pipe->push_capacity) return 0;
+    if (n->push_size == size && memcmp(n->push_data, data, size) == 0) return 1;
+
+    memcpy(n->push_data, data, size);
+    n->push_size = size;
+    if (graph->compiled) graph->batches[n->batch].dirty = 1;
+    return 1;
+}
+
+int svk_graph_set_groups(svk_graph graph, int node, uint32_t x, uint32_t y, uint32_t z) {
+    svk_graph_node* n = graph_dispatch_node(graph, node);
+    if (!n || n->args || x == 0 || y == 0 || z == 0) return 0;
+    if (n->groups[0] == x && n->groups[1] == y && n->groups[2] == z) return 1;
+
+    n->groups[0] = x;
+    n->groups[1] = y;
+    n->groups[2] = z;
+    if (graph->compiled) graph->batches[n->batch].dirty = 1;
+    return 1;
+}
+
+static int graph_run(svk_graph graph) {
+    if (!graph || !graph->compiled) return 0;
+    svk_context ctx = graph->ctx;
+
+    for (uint32_t b = 0; b < graph->batch_count; b++) {
+        svk_graph_batch* batch = &graph->batches[b];
+
+        /* The spare may still be executing from the run before last */
+        if (batch->dirty) {
+            uint32_t spare = 1 - batch->current;
+            if (!svk_wait_ticket(ctx, batch->tickets[spare])) return 0;
+            if (!record_batch(graph, batch, batch->cmd[spare])) return 0;
+            batch->current = spare;
+            batch->dirty = 0;
+        }
+
+        svk_submit_slot* slot = begin_slot(ctx, batch->role);
+        if (!slot) return 0;
+
+        /* Earlier batches of this run count as last users too */
+        for (uint32_t i = 0; i < batch->tracker.access_count; i++) {
+            slot_depend(ctx, slot, *batch->tracker.access[i].last_ticket);
+        }
+
+        int timing = timing_begin(ctx, slot, SVK_SAMPLE_GRAPH);
+        vkCmdExecuteCommands(slot->cmd, 1, &batch->cmd[batch->current]);
+        timing_end(ctx, slot, timing);
+
+        svk_ticket ticket = submit_slot(ctx, slot);
+        if (ticket == 0) return 0;
+
+        batch->tickets[batch->current] = ticket;
+        for (uint32_t i = 0; i < batch->tracker.access_count; i++) {
+            *batch->tracker.access[i].last_ticket = ticket;
+        }
+        for (uint32_t i = 0; i < batch->count; i++) {
+            svk_graph_node* node = &graph->nodes[batch->first + i];
+            if (node->kind != SVK_GRAPH_DISPATCH) continue;
+            node->set->last_ticket = ticket;
+            node->pipe->last_ticket = ticket;
+        }
+    }
+
+    return 1;
+}
+
+int svk_graph_poll(svk_graph graph) {
+    if (!graph) return 0;
+    for (uint32_t b = 0; b < graph->batch_count; b++) {
+        for (int i = 0; i < 2; i++) {
+            if (!svk_poll_ticket(graph->ctx, graph->batches[b].tickets[i])) return 0;
+        }
+    }
+    return 1;
+}
+
+int svk_graph_wait(svk_graph graph) {
+    if (!graph) return 0;
+    for (uint32_t b = 0; b < graph->batch_count; b++) {
+        for (int i = 0; i < 2; i++) {
+            if (!svk_wait_ticket(graph->ctx, graph->batches[b].tickets[i])) return 0;
+        }
+    }
+    return 1;
+}
+
+int svk_graph_read(svk_graph graph, int node, void* data) {
+    if (!graph || !data || node < 0 || (uint32_t)node >= graph->node_count) return 0;
+
+    svk_graph_node* n = &graph->nodes[node];
+    if (n->kind != SVK_GRAPH_READBACK) return 0;
+
+    /* Waits for the latest run that wrote the staging buffer */
+    return svk_download_buffer(graph->ctx, n->dst, data, n->size, 0);
+}
+
+static void free_graph(svk_graph graph) {
+    if (!graph) return;
+
+    svk_graph_wait(graph);
+    free_graph_batches(graph);
+
+    for (uint32_t i = 0; i < graph->node_count; i++) {
+        svk_graph_node* node = &graph->nodes[i];
+        if (node->set) node->set->pins--;
+        if (node->kind == SVK_GRAPH_READBACK) svk_free_buffer(graph->ctx, node->dst);
+    }
+
+    /* Aliased transients have no allocation of their own; the heap goes last */
+    for (uint32_t i = 0; i < graph->transient_count; i++) {
+        svk_graph_transient* t = &graph->transients[i];
+        if (t->buffer) svk_free_buffer(graph->ctx, t->buffer);
+        else svk_free_image(graph->ctx, t->image);
+    }
+    free_memory(graph->ctx, &graph->heap);
+
+    free(graph->transients);
+    free(graph->nodes);
+    free(graph);
+}
+
+/* ============================================================================
+ * Multi-Context Splitting
+ *
+ * A width x height dispatch is cut into horizontal bands, one per target
+ * context, sized by the targets' weights and aligned to whole workgroup
+ * rows. Each target runs only its band, offset with vkCmdDispatchBase so the
+ * shader sees frame coordinates, into its own full-frame output buffer. All
+ * bands are submitted before any is read back, so the devices overlap; each
+ * band is then copied into its rows of the merged frame.
+ * ============================================================================ */
+
+typedef struct {
+    svk_context ctx;
+    svk_pipeline pipe;
+    svk_buffer output;
+    float weight;
+    uint32_t first_row;          /* Band of the latest run */
+    uint32_t rows;
+} svk_split_target;
+
+struct svk_splitter_t {
+    uint32_t width;
+    uint32_t height;
+    uint32_t pixel_size;
+
+    svk_split_target* targets;
+    uint32_t target_count;
+    uint32_t target_capacity;
+};
+
+static uint32_t gcd_u32(uint32_t a, uint32_t b) {
+    while (b) {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/* Cut the rows into bands proportional to the weights, on boundaries that
+   are whole workgroup rows of every target's pipeline */
+static void split_bands(svk_splitter splitter) {
+    uint32_t unit = 1;
+    float total = 0.0f;
+    for (uint32_t i = 0; i < splitter->target_count; i++) {
+        uint32_t ly = splitter->targets[i].pipe->local_size[1];
+        unit = unit / gcd_u32(unit, ly) * ly;
+        total += splitter->targets[i].weight;
+    }
+
+    uint32_t units = (splitter->height + unit - 1) / unit;
+    uint32_t start = 0;
+    float sum = 0.0f;
+    for (uint32_t i = 0; i < splitter->target_count; i++) {
+        svk_split_target* t = &splitter->targets[i];
+        sum += t->weight;
+
+        uint32_t end = (i + 1 == splitter->target_count) ? units : (uint32_t)(units * sum / total + 0.5f);
+        if (end < start) end = start;
+        if (end > units) end = units;
+
+        uint32_t end_row = end * unit < splitter->height ? end * unit : splitter->height;
+        t->first_row = start * unit < splitter->height ? start * unit : splitter->height;
+        t->rows = end_row - t->first_row;
+        start = end;
+    }
+}
+
+svk_splitter svk_create_splitter(uint32_t width, uint32_t height, uint32_t pixel_size) {
+    if (width == 0 || height == 0 || pixel_size == 0) return NULL;
+
+    svk_splitter splitter = (svk_splitter)calloc(1, sizeof(struct svk_splitter_t));
+    if (!splitter) return NULL;
+
+    splitter->width = width;
+    splitter->height = height;
+    splitter->pixel_size = pixel_size;
+    return splitter;
+}
+
+int svk_splitter_add(svk_splitter splitter, svk_context ctx, svk_pipeline pipe, svk_buffer output, float weight) {
+    if (!splitter || !ctx || !pipe || !output || !(weight > 0.0f)) return -1;
+    if (pipe->local_size[0] == 0 || pipe->local_size[1] == 0) return -1;
+    if (output->size < (uint64_t)splitter->width * splitter->height * splitter->pixel_size) return -1;
+    if (!grow_array((void**)&splitter->targets, &splitter->target_capacity, splitter->target_count,
+                    sizeof(svk_split_target))) return -1;
+
+    svk_split_target* t = &splitter->targets[splitter->target_count];
+    memset(t, 0, sizeof(*t));
+    t->ctx = ctx;
+    t->pipe = pipe;
+    t->output = output;
+    t->weight = weight;
+    return (int)splitter->target_count++;
+}
+
+int svk_splitter_set_weight(svk_splitter splitter, int target, float weight) {
+    if (!splitter || target < 0 || (uint32_t)target >= splitter->target_count || !(weight > 0.0f)) return 0;
+    splitter->targets[target].weight = weight;
+    return 1;
+}
+
+int svk_splitter_run(svk_splitter splitter, void* merged) {
+    if (!splitter || !merged || splitter->target_count == 0) return 0;
+
+    split_bands(splitter);
+
+    int ok = 1;
+    for (uint32_t i = 0; i < splitter->target_count; i++) {
+        svk_split_target* t = &splitter->targets[i];
+        if (t->rows == 0) continue;
+
+        /* The last band may overshoot the frame; shaders bounds-check */
+        uint32_t lx = t->pipe->local_size[0];
+        uint32_t ly = t->pipe->local_size[1];
+        if (!svk_dispatch_region_async(t->ctx, t->pipe, 0, t->first_row / ly, 0,
+                                       (splitter->width + lx - 1) / lx, (t->rows + ly - 1) / ly, 1)) {
+            ok = 0;
+            t->rows = 0;
+        }
+    }
+
+    uint64_t row_bytes = (uint64_t)splitter->width * splitter->pixel_size;
+    for (uint32_t i = 0; i < splitter->target_count; i++) {
+        svk_split_target* t = &splitter->targets[i];
+        if (t->rows == 0) continue;
+
+        uint64_t offset = t->first_row * row_bytes;
+        if (!svk_download_buffer(t->ctx, t->output, (uint8_t*)merged + offset, t->rows * row_bytes, offset)) ok = 0;
+    }
+
+    return ok;
+}
+
+int svk_splitter_band(svk_splitter splitter, int target, uint32_t* first_row, uint32_t* rows) {
+    if (!splitter || target < 0 || (uint32_t)target >= splitter->target_count) return 0;
+    if (first_row) *first_row = splitter->targets[target].first_row;
+    if (rows) *rows = splitter->targets[target].rows;
+    return 1;
+}
+
+void svk_free_splitter(svk_splitter splitter) {
+    if (!splitter) return;
+    free(splitter->targets);
+    free(splitter);
+}
+
+/* ============================================================================
+ * Parallel Primitives
+ *
+ * Reduce, scan, radix sort and histogram over 32-bit elements, each recorded
+ * into one command list and submitted once. The kernels (shaders/reduce,
+ * scan, radix_sort and histogram.comp) work on tiles of 2048 elements and
+ * take buffer offsets as push constants, so recursive passes over the
+ * partial results reuse a few descriptor sets. Subgroup arithmetic does the
+ * in-workgroup work; the histogram counts in shared memory.
+ * ============================================================================ */
+
+#define SVK_ALGO_TILE         2048u   /* Elements per workgroup (256 x 8) */
+#define SVK_ALGO_MAX_GROUPS_X 65535u
+#define SVK_REDUCE_MAX_GROUPS 1024u   /* One workgroup combines them all */
+#define SVK_HISTOGRAM_GROUPS  512u
+#define SVK_SCAN_INCLUSIVE    0x01u
+#define SVK_SCAN_WRITE_SUMS   0x02u
+#define SVK_SORT_PASSES       8u      /* 4-bit digits */
+
+struct svk_algorithms_t {
+    svk_context ctx;
+    svk_pipeline reduce;
+    svk_pipeline scan;
+    svk_pipeline sort;
+    svk_pipeline histogram;
+    svk_cmdlist list;
+
+    /* Scratch, grown on demand */
+    svk_buffer partials;
+    svk_buffer temp_keys;
+    svk_buffer temp_values;
+};
+
+static int valid_element(uint32_t type) {
+    return type >= SVK_ELEMENT_UINT32 && type <= SVK_ELEMENT_FLOAT32;
+}
+
+static int valid_reduce_op(uint32_t op) {
+    return op >= SVK_REDUCE_SUM && op <= SVK_REDUCE_MAX;
+}
+
+static uint32_t tile_count(uint64_t count) {
+    return (uint32_t)((count + SVK_ALGO_TILE - 1) / SVK_ALGO_TILE);
+}
+
+/* Bit pattern of the value that leaves any element unchanged under `op` */
+static uint32_t reduce_identity(uint32_t type, uint32_t op) {
+    if (op == SVK_REDUCE_MIN) {
+        if (type == SVK_ELEMENT_INT32) return 0x7FFFFFFFu;
+        if (type == SVK_ELEMENT_FLOAT32) return 0x7F800000u;   /* +inf */
+        return 0xFFFFFFFFu;
+    }
+    if (op == SVK_REDUCE_MAX) {
+        if (type == SVK_ELEMENT_INT32) return 0x80000000u;
+        if (type == SVK_ELEMENT_FLOAT32) return 0xFF800000u;   /* -inf */
+        return 0;
+    }
+    return 0;
+}
+
+/* Partial results a scan of `count` elements keeps, over all levels */
+static uint64_t scan_scratch_count(uint64_t count) {
+    uint64_t total = 0;
+    for (uint64_t tiles = tile_count(count); tiles > 1; tiles = tile_count(tiles)) total += tiles;
+    return total;
+}
+
+/* Histogram push constants: float elements map (x - lo) * scale to a bin,
+   integers (x - lo) / scale, with scale the whole-number bin width */
+static int histogram_params(uint32_t type, double lo, double hi, uint32_t bins,
+                            uint32_t* lo_bits, uint32_t* scale) {
+    if (bins == 0 || !(hi > lo)) return 0;
+
+    if (type == SVK_ELEMENT_FLOAT32) {
+        float lo_f = (float)lo;
+        float scale_f = (float)(bins / (hi - lo));
+        memcpy(lo_bits, &lo_f, sizeof(float));
+        memcpy(scale, &scale_f, sizeof(float));
+        return 1;
+    }
+
+    if (type == SVK_ELEMENT_INT32) {
+        if (lo < -2147483648.0 || lo > 2147483647.0) return 0;
+        *lo_bits = (uint32_t)(int32_t)lo;
+    } else if (type == SVK_ELEMENT_UINT32) {
+        if (lo < 0.0 || lo > 4294967295.0) return 0;
+        *lo_bits = (uint32_t)lo;
+    } else {
+        return 0;
+    }
+
+    double width = (hi - lo) / bins;
+    if (width >= 4294967295.0) {
+        *scale = 0xFFFFFFFFu;
+    } else {
+        *scale = (uint32_t)width;
+        if (*scale < width) (*scale)++;
+        if (*scale == 0) *scale = 1;
+    }
+    return 1;
+}
+
+/* Make `*buf` a device-local storage buffer of at least `size` bytes */
+static int ensure_scratch(svk_context ctx, svk_buffer* buf, uint64_t size) {
+    if (*buf && (*buf)->size >= size) return 1;
+    free_buffer(ctx, *buf);
+    *buf = create_buffer(ctx, size, SVK_BUFFER_STORAGE | SVK_BUFFER_DEVICE_LOCAL);
+    return *buf != NULL;
+}
+
+/* Has the device the subgroup operations the kernels use? */
+static int supports_algorithm_subgroups(svk_context ctx) {
+    VkPhysicalDeviceSubgroupProperties subgroup = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES
+    };
+    VkPhysicalDeviceProperties2 props = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+        .pNext = &subgroup
+    };
+    vkGetPhysicalDeviceProperties2(ctx->physical_device, &props);
+
+    VkSubgroupFeatureFlags needed = VK_SUBGROUP_FEATURE_BASIC_BIT | VK_SUBGROUP_FEATURE_ARITHMETIC_BIT;
+    return subgroup.subgroupSize >= 4 && (subgroup.supportedStages & VK_SHADER_STAGE_COMPUTE_BIT) &&
+           (subgroup.supportedOperations & needed) == needed;
+}
+
+static int algorithm_pipeline_ok(svk_pipeline pipe, uint32_t bindings, uint32_t push_size) {
+    if (!pipe || pipe->local_size[0] != 256 || pipe->push_capacity < push_size) return 0;
+    for (uint32_t i = 0; i < bindings; i++) {
+        if (pipe->binding_types[i] != SVK_BINDING_BUFFER) return 0;
+    }
+    return 1;
+}
+
+svk_algorithms svk_create_algorithms(svk_context ctx, svk_shader reduce, svk_shader scan,
+                                     svk_shader sort, svk_shader histogram) {
+    if (!ctx || !reduce || !scan || !sort || !histogram) return NULL;
+    if (!supports_algorithm_subgroups(ctx)) return NULL;
+
+    svk_algorithms algos = (svk_algorithms)calloc(1, sizeof(struct svk_algorithms_t));
+    if (!algos) return NULL;
+
+    algos->ctx = ctx;
+    algos->reduce = svk_create_pipeline(ctx, reduce);
+    algos->scan = svk_create_pipeline(ctx, scan);
+    algos->sort = svk_create_pipeline(ctx, sort);
+    algos->histogram = svk_create_pipeline(ctx, histogram);
+    algos->list = svk_create_cmdlist(ctx);
+
+    if (!algorithm_pipeline_ok(algos->reduce, 2, 6 * sizeof(uint32_t)) ||
+        !algorithm_pipeline_ok(algos->scan, 3, 9 * sizeof(uint32_t)) ||
+        !algorithm_pipeline_ok(algos->sort, 5, 7 * sizeof(uint32_t)) ||
+        !algorithm_pipeline_ok(algos->histogram, 2, 5 * sizeof(uint32_t)) || !algos->list) {
+        svk_free_algorithms(algos);
+        return NULL;
+    }
+    return algos;
+}
+
+/* Dispatch one workgroup per tile, folding counts past the x limit into y.
+   The kernels number tiles x + y * width and skip those past the end. */
+static int cmd_dispatch_tiles(svk_cmdlist list, svk_pipeline pipe, uint32_t tiles) {
+    uint32_t x = tiles < SVK_ALGO_MAX_GROUPS_X ? tiles : SVK_ALGO_MAX_GROUPS_X;
+    return cmd_dispatch(list, pipe, x, (tiles + x - 1) / x, 1);
+}
+
+static int cmd_algorithm(svk_cmdlist list, svk_pipeline pipe, const uint32_t* params, uint32_t param_count,
+                         uint32_t tiles) {
+    return svk_set_push_constants(pipe, params, param_count * sizeof(uint32_t)) &&
+           cmd_dispatch_tiles(list, pipe, tiles);
+}
+
+/* Scan `count` elements of `input` from `in_base` into `output` from
+   `out_base`. Larger inputs write tile totals to partials at `level`, scan
+   those in place (their own totals going after them) and add them back. */
+static int record_scan(svk_algorithms algos, svk_buffer input, svk_buffer output, uint32_t in_base,
+                       uint32_t out_base, uint32_t count, uint32_t type, uint32_t op, uint32_t flags,
+                       uint32_t level) {
+    svk_pipeline pipe = algos->scan;
+    svk_buffer partials = algos->partials;
+    uint32_t tiles = tile_count(count);
+
+    /* count, op, type, identity, pass, flags, in_base, out_base, sums_base */
+    uint32_t params[9] = { count, op, type, reduce_identity(type, op), 0, flags, in_base, out_base, level };
+
+    if (!svk_bind_buffer(pipe, 0, input) || !svk_bind_buffer(pipe, 1, output) ||
+        !svk_bind_buffer(pipe, 2, partials)) return 0;
+    if (tiles == 1) return cmd_algorithm(algos->list, pipe, params, 9, 1);
+
+    params[5] = flags | SVK_SCAN_WRITE_SUMS;
+    if (!cmd_algorithm(algos->list, pipe, params, 9, tiles)) return 0;
 
-    return img;
+    if (!record_scan(algos, partials, partials, level, level, tiles, type, op, 0, level + tiles)) return 0;
+
+    params[4] = 1;
+    params[5] = flags;
+    return svk_bind_buffer(pipe, 0, input) && svk_bind_buffer(pipe, 1, output) &&
+           svk_bind_buffer(pipe, 2, partials) && cmd_algorithm(algos->list, pipe, params, 9, tiles);
 }
 
-void svk_image_size(svk_image img, uint32_t* width, uint32_t* height) {
-    if (img) {
-        if (width) *width = img->width;
-        if (height) *height = img->height;
+static svk_ticket finish_algorithm(svk_algorithms algos, int recorded) {
+    if (!recorded) {
+        list_discard(algos->list);
+        return 0;
     }
+    if (!cmdlist_end(algos->list)) return 0;
+    return cmdlist_submit(algos->list);
 }
 
-void svk_free_image(svk_context ctx, svk_image img) {
-    if (!ctx || !img) return;
-    if (img->view) vkDestroyImageView(ctx->device, img->view, NULL);
-    vkFreeMemory(ctx->device, img->memory, NULL);
-    vkDestroyImage(ctx->device, img->image, NULL);
-    free(img);
+static svk_ticket reduce_buffer(svk_algorithms algos, svk_buffer input, uint32_t count,
+                                uint32_t type, uint32_t op, svk_buffer output) {
+    if (!algos || !input || !output || count == 0 || !valid_element(type) || !valid_reduce_op(op)) return 0;
+    if (input->size < (uint64_t)count * sizeof(uint32_t) || output->size < sizeof(uint32_t)) return 0;
+
+    uint32_t groups = tile_count(count);
+    if (groups > SVK_REDUCE_MAX_GROUPS) groups = SVK_REDUCE_MAX_GROUPS;
+    if (groups > 1 && !ensure_scratch(algos->ctx, &algos->partials, groups * sizeof(uint32_t))) return 0;
+    if (!cmdlist_begin(algos->list)) return 0;
+
+    svk_pipeline pipe = algos->reduce;
+    uint32_t identity = reduce_identity(type, op);
+
+    /* count, op, type, identity, in_base, out_base */
+    uint32_t params[6] = { count, op, type, identity, 0, 0 };
+
+    /* Each workgroup folds a strided slice into one partial, then a single
+       workgroup folds the partials */
+    int ok = svk_bind_buffer(pipe, 0, input) && svk_bind_buffer(pipe, 1, groups > 1 ? algos->partials : output) &&
+             cmd_algorithm(algos->list, pipe, params, 6, groups);
+    if (ok && groups > 1) {
+        params[0] = groups;
+        ok = svk_bind_buffer(pipe, 0, algos->partials) && svk_bind_buffer(pipe, 1, output) &&
+             cmd_algorithm(algos->list, pipe, params, 6, 1);
+    }
+    return finish_algorithm(algos, ok);
 }
 
-/* ============================================================================
- * Shader Management
- * ============================================================================ */
-
-svk_shader svk_load_shader(svk_context ctx, const char* spv_path) {
-    if (!ctx || !spv_path) return NULL;
+static svk_ticket scan_buffer(svk_algorithms algos, svk_buffer input, svk_buffer output, uint32_t count,
+                              uint32_t type, uint32_t op, int inclusive) {
+    if (!algos || !input || !output || count == 0 || !valid_element(type) || !valid_reduce_op(op)) return 0;
+    uint64_t bytes = (uint64_t)count * sizeof(uint32_t);
+    if (input->size < bytes || output->size < bytes) return 0;
 
-    FILE* file = fopen(spv_path, "rb");
-    if (!file) return NULL;
+    /* Small scans still bind the partials, so keep at least one */
+    uint64_t scratch = scan_scratch_count(count);
+    if (!ensure_scratch(algos->ctx, &algos->partials, (scratch ? scratch : 1) * sizeof(uint32_t))) return 0;
+    if (!cmdlist_begin(algos->list)) return 0;
 
-    fseek(file, 0, SEEK_END);
-    long size = ftell(file);
-    fseek(file, 0, SEEK_SET);
+    int ok = record_scan(algos, input, output, 0, 0, count, type, op, inclusive ? SVK_SCAN_INCLUSIVE : 0, 0);
+    return finish_algorithm(algos, ok);
+}
 
-    uint32_t* code = (uint32_t*)malloc(size);
-    if (!code) {
-        fclose(file);
-        return NULL;
+static svk_ticket sort_buffer(svk_algorithms algos, svk_buffer keys, svk_buffer values,
+                              uint32_t count, uint32_t type) {
+    if (!algos || !keys || count == 0 || !valid_element(type)) return 0;
+    uint64_t bytes = (uint64_t)count * sizeof(uint32_t);
+    if (keys->size < bytes || (values && values->size < bytes)) return 0;
+
+    svk_context ctx = algos->ctx;
+    uint32_t tiles = tile_count(count);
+    uint64_t digit_counts = (uint64_t)tiles * 16;
+    if (!ensure_scratch(ctx, &algos->partials, (digit_counts + scan_scratch_count(digit_counts)) * sizeof(uint32_t)) ||
+        !ensure_scratch(ctx, &algos->temp_keys, bytes) ||
+        (values && !ensure_scratch(ctx, &algos->temp_values, bytes))) return 0;
+    if (!cmdlist_begin(algos->list)) return 0;
+
+    svk_pipeline pipe = algos->sort;
+    svk_buffer src = keys, dst = algos->temp_keys;
+    svk_buffer value_src = values, value_dst = algos->temp_values;
+
+    /* count, type, shift, pass, has_values, tiles, counts_base */
+    uint32_t params[7] = { count, type, 0, 0, values != NULL, tiles, 0 };
+
+    /* Count digits per tile, scan the counts into output offsets, scatter;
+       an even number of passes leaves the result back in `keys` */
+    int ok = 1;
+    for (uint32_t pass = 0; ok && pass < SVK_SORT_PASSES; pass++) {
+        /* Without values the key buffers stand in for the value bindings */
+        ok = svk_bind_buffer(pipe, 0, src) && svk_bind_buffer(pipe, 1, dst) &&
+             svk_bind_buffer(pipe, 2, algos->partials) &&
+             svk_bind_buffer(pipe, 3, values ? value_src : src) && svk_bind_buffer(pipe, 4, values ? value_dst : dst);
+
+        params[2] = pass * 4;
+        params[3] = 0;
+        ok = ok && cmd_algorithm(algos->list, pipe, params, 7, tiles);
+        ok = ok && record_scan(algos, algos->partials, algos->partials, 0, 0, (uint32_t)digit_counts,
+                               SVK_ELEMENT_UINT32, SVK_REDUCE_SUM, 0, (uint32_t)digit_counts);
+        params[3] = 1;
+        ok = ok && cmd_algorithm(algos->list, pipe, params, 7, tiles);
+
+        svk_buffer t = src; src = dst; dst = t;
+        t = value_src; value_src = value_dst; value_dst = t;
     }
+    return finish_algorithm(algos, ok);
+}
 
-    fread(code, 1, size, file);
-    fclose(file);
+static svk_ticket histogram_buffer(svk_algorithms algos, svk_buffer input, uint32_t count, uint32_t type,
+                                   double lo, double hi, uint32_t bins, svk_buffer output) {
+    if (!algos || !input || !output || count == 0) return 0;
+    uint64_t bin_bytes = (uint64_t)bins * sizeof(uint32_t);
+    if (input->size < (uint64_t)count * sizeof(uint32_t) || output->size < bin_bytes) return 0;
 
-    svk_shader shader = svk_load_shader_memory(ctx, code, size);
-    free(code);
+    uint32_t lo_bits, scale;
+    if (!histogram_params(type, lo, hi, bins, &lo_bits, &scale)) return 0;
+    if (!cmdlist_begin(algos->list)) return 0;
 
-    return shader;
-}
+    svk_pipeline pipe = algos->histogram;
+    uint32_t groups = tile_count(count);
+    if (groups > SVK_HISTOGRAM_GROUPS) groups = SVK_HISTOGRAM_GROUPS;
 
-svk_shader svk_load_shader_memory(svk_context ctx, const uint32_t* spirv, uint64_t size) {
-    if (!ctx || !spirv || size == 0) return NULL;
+    /* count, type, bins, lo, scale */
+    uint32_t params[5] = { count, type, bins, lo_bits, scale };
 
-    svk_shader shader = (svk_shader)calloc(1, sizeof(struct svk_shader_t));
-    if (!shader) return NULL;
+    int ok = cmd_fill_buffer(algos->list, output, 0, bin_bytes, 0) &&
+             svk_bind_buffer(pipe, 0, input) && svk_bind_buffer(pipe, 1, output) &&
+             cmd_algorithm(algos->list, pipe, params, 5, groups);
+    return finish_algorithm(algos, ok);
+}
 
-    VkShaderModuleCreateInfo create_info = {
-        .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-        .codeSize = size,
-        .pCode = spirv
-    };
+int svk_reduce(svk_algorithms algos, svk_buffer input, uint32_t count, uint32_t type, uint32_t op,
+               svk_buffer output) {
+    svk_ticket ticket = svk_reduce_async(algos, input, count, type, op, output);
+    if (ticket == 0) return 0;
+    return svk_wait_ticket(algos->ctx, ticket);
+}
 
-    if (vkCreateShaderModule(ctx->device, &create_info, NULL, &shader->module) != VK_SUCCESS) {
-        free(shader);
-        return NULL;
-    }
+int svk_scan(svk_algorithms algos, svk_buffer input, svk_buffer output, uint32_t count,
+             uint32_t type, uint32_t op, int inclusive) {
+    svk_ticket ticket = svk_scan_async(algos, input, output, count, type, op, inclusive);
+    if (ticket == 0) return 0;
+    return svk_wait_ticket(algos->ctx, ticket);
+}
 
-    return shader;
+int svk_sort(svk_algorithms algos, svk_buffer keys, svk_buffer values, uint32_t count, uint32_t type) {
+    svk_ticket ticket = svk_sort_async(algos, keys, values, count, type);
+    if (ticket == 0) return 0;
+    return svk_wait_ticket(algos->ctx, ticket);
 }
 
-void svk_free_shader(svk_context ctx, svk_shader shader) {
-    if (!ctx || !shader) return;
-    vkDestroyShaderModule(ctx->device, shader->module, NULL);
-    free(shader);
+int svk_histogram(svk_algorithms algos, svk_buffer input, uint32_t count, uint32_t type,
+                  double lo, double hi, uint32_t bins, svk_buffer output) {
+    svk_ticket ticket = svk_histogram_async(algos, input, count, type, lo, hi, bins, output);
+    if (ticket == 0) return 0;
+    return svk_wait_ticket(algos->ctx, ticket);
 }
 
-/* ============================================================================
- * Compute Pipeline
- * ============================================================================ */
+void svk_free_algorithms(svk_algorithms algos) {
+    if (!algos) return;
+    svk_context ctx = algos->ctx;
+    svk_free_cmdlist(algos->list);
+    svk_free_pipeline(ctx, algos->reduce);
+    svk_free_pipeline(ctx, algos->scan);
+    svk_free_pipeline(ctx, algos->sort);
+    svk_free_pipeline(ctx, algos->histogram);
+    svk_free_buffer(ctx, algos->partials);
+    svk_free_buffer(ctx, algos->temp_keys);
+    svk_free_buffer(ctx, algos->temp_values);
+    free(algos);
+}
 
-svk_pipeline svk_create_pipeline(svk_context ctx, svk_shader shader) {
-    if (!ctx || !shader) return NULL;
+/* CPU references. Float sums add in index order, so their last bits can
+   differ from the GPU's, which adds in a tree. */
+
+static uint32_t combine_element(uint32_t type, uint32_t op, uint32_t a, uint32_t b) {
+    if (type == SVK_ELEMENT_FLOAT32) {
+        float fa, fb, r;
+        memcpy(&fa, &a, sizeof(float));
+        memcpy(&fb, &b, sizeof(float));
+        if (op == SVK_REDUCE_SUM) r = fa + fb;
+        else if (op == SVK_REDUCE_MIN) r = fb < fa ? fb : fa;
+        else r = fb > fa ? fb : fa;
+        memcpy(&a, &r, sizeof(float));
+        return a;
+    }
+    if (op == SVK_REDUCE_SUM) return a + b;
+    if (type == SVK_ELEMENT_INT32) {
+        if (op == SVK_REDUCE_MIN) return (int32_t)b < (int32_t)a ? b : a;
+        return (int32_t)b > (int32_t)a ? b : a;
+    }
+    if (op == SVK_REDUCE_MIN) return b < a ? b : a;
+    return b > a ? b : a;
+}
 
-    svk_pipeline pipe = (svk_pipeline)calloc(1, sizeof(struct svk_pipeline_t));
-    if (!pipe) return NULL;
+/* Key bits that order int and float keys like unsigned ones */
+static uint32_t sort_key_bits(uint32_t type, uint32_t key) {
+    if (type == SVK_ELEMENT_FLOAT32) return key ^ ((key >> 31) ? 0xFFFFFFFFu : 0x80000000u);
+    if (type == SVK_ELEMENT_INT32) return key ^ 0x80000000u;
+    return key;
+}
 
-    /* Create descriptor set layout */
-    VkDescriptorSetLayoutBinding bindings[SVK_MAX_BINDINGS];
-    for (int i = 0; i < SVK_MAX_BINDINGS; i++) {
-        bindings[i] = (VkDescriptorSetLayoutBinding){
-            .binding = i,
-            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-            .descriptorCount = 1,
-            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT
-        };
+int svk_reference_reduce(const void* input, uint32_t count, uint32_t type, uint32_t op, void* result) {
+    if (!input || !result || !valid_element(type) || !valid_reduce_op(op)) return 0;
+    const uint32_t* in = (const uint32_t*)input;
+    uint32_t acc = reduce_identity(type, op);
+    for (uint32_t i = 0; i < count; i++) acc = combine_element(type, op, acc, in[i]);
+    memcpy(result, &acc, sizeof(uint32_t));
+    return 1;
+}
+
+int svk_reference_scan(const void* input, void* output, uint32_t count, uint32_t type, uint32_t op,
+                       int inclusive) {
+    if (!input || !output || !valid_element(type) || !valid_reduce_op(op)) return 0;
+    const uint32_t* in = (const uint32_t*)input;
+    uint32_t* out = (uint32_t*)output;
+    uint32_t acc = reduce_identity(type, op);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t x = in[i];
+        if (!inclusive) out[i] = acc;
+        acc = combine_element(type, op, acc, x);
+        if (inclusive) out[i] = acc;
     }
+    return 1;
+}
 
-    VkDescriptorSetLayoutCreateInfo layout_info = {
-        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
-        .bindingCount = SVK_MAX_BINDINGS,
-        .pBindings = bindings
-    };
+int svk_reference_sort(void* keys, void* values, uint32_t count, uint32_t type) {
+    if (!keys || !valid_element(type)) return 0;
+    if (count < 2) return 1;
+
+    uint32_t* k = (uint32_t*)keys;
+    uint32_t* v = (uint32_t*)values;
+    uint32_t* temp_k = (uint32_t*)malloc(count * sizeof(uint32_t));
+    uint32_t* temp_v = v ? (uint32_t*)malloc(count * sizeof(uint32_t)) : NULL;
+    if (!temp_k || (v && !temp_v)) {
+        free(temp_k);
+        free(temp_v);
+        return 0;
+    }
 
-    vkCreateDescriptorSetLayout(ctx->device, &layout_info, NULL, &pipe->desc_layout);
+    /* Stable LSD passes with the GPU's 4-bit digits */
+    for (uint32_t shift = 0; shift < 32; shift += 4) {
+        uint32_t offsets[16] = { 0 };
+        for (uint32_t i = 0; i < count; i++) offsets[(sort_key_bits(type, k[i]) >> shift) & 15]++;
+        for (uint32_t d = 0, sum = 0; d < 16; d++) {
+            uint32_t n = offsets[d];
+            offsets[d] = sum;
+            sum += n;
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t at = offsets[(sort_key_bits(type, k[i]) >> shift) & 15]++;
+            temp_k[at] = k[i];
+            if (v) temp_v[at] = v[i];
+        }
+        memcpy(k, temp_k, count * sizeof(uint32_t));
+        if (v) memcpy(v, temp_v, count * sizeof(uint32_t));
+    }
 
-    /* Allocate descriptor set */
-    VkDescriptorSetAllocateInfo alloc_info = {
-        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
-        .descriptorPool = ctx->descriptor_pool,
-        .descriptorSetCount = 1,
-        .pSetLayouts = &pipe->desc_layout
-    };
+    free(temp_k);
+    free(temp_v);
+    return 1;
+}
 
-    vkAllocateDescriptorSets(ctx->device, &alloc_info, &pipe->desc_set);
+int svk_reference_histogram(const void* input, uint32_t count, uint32_t type, double lo, double hi,
+                            uint32_t bins, uint32_t* output) {
+    uint32_t lo_bits, scale;
+    if (!input || !output || !histogram_params(type, lo, hi, bins, &lo_bits, &scale)) return 0;
 
-    /* Create pipeline layout with push constants */
-    VkPushConstantRange push_range = {
-        .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
-        .offset = 0,
-        .size = 128
-    };
+    const uint32_t* in = (const uint32_t*)input;
+    memset(output, 0, bins * sizeof(uint32_t));
 
-    VkPipelineLayoutCreateInfo pipeline_layout_info = {
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-        .setLayoutCount = 1,
-        .pSetLayouts = &pipe->desc_layout,
-        .pushConstantRangeCount = 1,
-        .pPushConstantRanges = &push_range
-    };
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t x = in[i];
+        if (type == SVK_ELEMENT_FLOAT32) {
+            float xf, lo_f, scale_f;
+            memcpy(&xf, &x, sizeof(float));
+            memcpy(&lo_f, &lo_bits, sizeof(float));
+            memcpy(&scale_f, &scale, sizeof(float));
+            float shifted = xf - lo_f;
+            float t = shifted * scale_f;
+            if (t >= 0.0f && t < (float)bins) output[(uint32_t)t]++;
+        } else {
+            int above = type == SVK_ELEMENT_INT32 ? (int32_t)x >= (int32_t)lo_bits : x >= lo_bits;
+            uint32_t bin = (x - lo_bits) / scale;
+            if (above && bin < bins) output[bin]++;
+        }
+    }
+    return 1;
+}
 
-    vkCreatePipelineLayout(ctx->device, &pipeline_layout_info, NULL, &pipe->layout);
+/* ============================================================================
+ * Locked Entry Points
+ *
+ * Calls that touch shared context state run under the context lock. It is
+ * recursive, so these may call each other, and retire_slot releases it while
+ * waiting for the GPU. Pipelines, command lists and graphs are not shared:
+ * each is used by one thread at a time.
+ * ============================================================================ */
 
-    /* Create compute pipeline */
-    VkComputePipelineCreateInfo pipeline_info = {
-        .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
-        .stage = {
-            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-            .stage = VK_SHADER_STAGE_COMPUTE_BIT,
-            .module = shader->module,
-            .pName = "main"
-        },
-        .layout = pipe->layout
-    };
+int svk_release_thread(svk_context ctx) {
+    if (!ctx) return 0;
+    context_lock(ctx);
+    int result = release_thread(ctx);
+    context_unlock(ctx);
+    return result;
+}
 
-    if (vkCreateComputePipelines(ctx->device, VK_NULL_HANDLE, 1, &pipeline_info, NULL, &pipe->pipeline) != VK_SUCCESS) {
-        vkDestroyPipelineLayout(ctx->device, pipe->layout, NULL);
-        vkDestroyDescriptorSetLayout(ctx->device, pipe->desc_layout, NULL);
-        free(pipe);
-        return NULL;
-    }
+int svk_load_pipeline_cache(svk_context ctx, const char* path) {
+    if (!ctx) return 0;
+    context_lock(ctx);
+    int result = load_pipeline_cache(ctx, path);
+    context_unlock(ctx);
+    return result;
+}
 
-    return pipe;
+int svk_save_pipeline_cache(svk_context ctx, const char* path) {
+    if (!ctx) return 0;
+    context_lock(ctx);
+    int result = save_pipeline_cache(ctx, path);
+    context_unlock(ctx);
+    return result;
 }
 
-int svk_bind_buffer(svk_pipeline pipe, uint32_t binding, svk_buffer buf) {
-    if (!pipe || !buf || binding >= SVK_MAX_BINDINGS) return 0;
-    pipe->buffers[binding] = buf;
-    return 1;
+int svk_get_memory_stats(svk_context ctx, svk_memory_stats* stats) {
+    if (!ctx) return 0;
+    context_lock(ctx);
+    int result = get_memory_stats(ctx, stats);
+    context_unlock(ctx);
+    return result;
 }
 
-int svk_bind_image(svk_pipeline pipe, uint32_t binding, svk_image img) {
-    if (!pipe || !img || binding >= SVK_MAX_BINDINGS) return 0;
-    pipe->images[binding] = img;
-    return 1;
+int svk_get_descriptor_stats(svk_context ctx, svk_descriptor_stats* stats) {
+    if (!ctx) return 0;
+    context_lock(ctx);
+    int result = get_descriptor_stats(ctx, stats);
+    context_unlock(ctx);
+    return result;
 }
 
-int svk_set_push_constants(svk_pipeline pipe, const void* data, uint32_t size) {
-    if (!pipe || !data || size > 128) return 0;
-    memcpy(pipe->push_data, data, size);
-    pipe->push_size = size;
-    return 1;
+int svk_enable_profiling(svk_context ctx, uint32_t max_pending) {
+    if (!ctx) return 0;
+    context_lock(ctx);
+    int result = enable_profiling(ctx, max_pending);
+    context_unlock(ctx);
+    return result;
 }
 
-int svk_dispatch(svk_context ctx, svk_pipeline pipe, uint32_t x, uint32_t y, uint32_t z) {
-    if (!ctx || !pipe) return 0;
+void svk_disable_profiling(svk_context ctx) {
+    if (!ctx) return;
+    context_lock(ctx);
+    disable_profiling(ctx);
+    context_unlock(ctx);
+}
 
-    /* Allocate command buffer */
-    VkCommandBufferAllocateInfo alloc_info = {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-        .commandPool = ctx->command_pool,
-        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-        .commandBufferCount = 1
-    };
+void svk_set_profile_tag(svk_context ctx, uint32_t tag) {
+    if (!ctx) return;
+    context_lock(ctx);
+    set_profile_tag(ctx, tag);
+    context_unlock(ctx);
+}
 
-    VkCommandBuffer cmd;
-    vkAllocateCommandBuffers(ctx->device, &alloc_info, &cmd);
+uint32_t svk_collect_gpu_samples(svk_context ctx, svk_gpu_sample* samples, uint32_t max_samples) {
+    if (!ctx) return 0;
+    context_lock(ctx);
+    uint32_t result = collect_gpu_samples(ctx, samples, max_samples);
+    context_unlock(ctx);
+    return result;
+}
 
-    VkCommandBufferBeginInfo begin_info = {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
-    };
+svk_buffer svk_create_buffer(svk_context ctx, uint64_t size, uint32_t usage) {
+    if (!ctx) return NULL;
+    context_lock(ctx);
+    svk_buffer result = create_buffer(ctx, size, usage);
+    context_unlock(ctx);
+    return result;
+}
 
-    vkBeginCommandBuffer(cmd, &begin_info);
+int svk_upload_buffer(svk_context ctx, svk_buffer buf, const void* data, uint64_t size, uint64_t offset) {
+    if (!ctx) return 0;
+    context_lock(ctx);
+    int result = upload_buffer(ctx, buf, data, size, offset);
+    context_unlock(ctx);
+    return result;
+}
 
-    /* Bind pipeline */
-    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipe->pipeline);
+int svk_download_buffer(svk_context ctx, svk_buffer buf, void* data, uint64_t size, uint64_t offset) {
+    if (!ctx) return 0;
+    context_lock(ctx);
+    int result = download_buffer(ctx, buf, data, size, offset);
+    context_unlock(ctx);
+    return result;
+}
 
-    /* Update and bind descriptor set */
-    VkWriteDescriptorSet writes[SVK_MAX_BINDINGS];
-    VkDescriptorBufferInfo buffer_infos[SVK_MAX_BINDINGS];
-    int write_count = 0;
+int svk_free_buffer(svk_context ctx, svk_buffer buf) {
+    if (!ctx) return 0;
+    context_lock(ctx);
+    int result = free_buffer(ctx, buf);
+    context_unlock(ctx);
+    return result;
+}
 
-    for (int i = 0; i < SVK_MAX_BINDINGS; i++) {
-        if (pipe->buffers[i]) {
-            buffer_infos[write_count] = (VkDescriptorBufferInfo){
-                .buffer = pipe->buffers[i]->buffer,
-                .offset = 0,
-                .range = pipe->buffers[i]->size
-            };
+svk_image svk_create_image(svk_context ctx, uint32_t width, uint32_t height, uint32_t format) {
+    if (!ctx) return NULL;
+    context_lock(ctx);
+    svk_image result = create_image(ctx, width, height, format);
+    context_unlock(ctx);
+    return result;
+}
 
-            writes[write_count] = (VkWriteDescriptorSet){
-                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                .dstSet = pipe->desc_set,
-                .dstBinding = i,
-                .descriptorCount = 1,
-                .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-                .pBufferInfo = &buffer_infos[write_count]
-            };
-            write_count++;
-        }
-    }
+int svk_free_image(svk_context ctx, svk_image img) {
+    if (!ctx) return 0;
+    context_lock(ctx);
+    int result = free_image(ctx, img);
+    context_unlock(ctx);
+    return result;
+}
 
-    if (write_count > 0) {
-        vkUpdateDescriptorSets(ctx->device, write_count, writes, 0, NULL);
-    }
+svk_ticket svk_begin_image_download(svk_context ctx, svk_image img) {
+    if (!ctx) return 0;
+    context_lock(ctx);
+    svk_ticket result = begin_image_download(ctx, img);
+    context_unlock(ctx);
+    return result;
+}
 
-    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipe->layout, 0, 1, &pipe->desc_set, 0, NULL);
+svk_ticket svk_begin_packed_download(svk_context ctx, svk_pipeline pipe, svk_image img, uint32_t pack) {
+    if (!ctx) return 0;
+    context_lock(ctx);
+    svk_ticket result = begin_packed_download(ctx, pipe, img, pack);
+    context_unlock(ctx);
+    return result;
+}
 
-    /* Push constants */
-    if (pipe->push_size > 0) {
-        vkCmdPushConstants(cmd, pipe->layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, pipe->push_size, pipe->push_data);
-    }
+int svk_finish_image_download(svk_context ctx, svk_ticket ticket, void* data) {
+    if (!ctx) return 0;
+    context_lock(ctx);
+    int result = finish_image_download(ctx, ticket, data);
+    context_unlock(ctx);
+    return result;
+}
 
-    /* Dispatch */
-    vkCmdDispatch(cmd, x, y, z);
+svk_shader svk_load_shader_memory(svk_context ctx, const uint32_t* spirv, uint64_t size) {
+    if (!ctx) return NULL;
+    context_lock(ctx);
+    svk_shader result = load_shader_memory(ctx, spirv, size);
+    context_unlock(ctx);
+    return result;
+}
 
-    vkEndCommandBuffer(cmd);
+void svk_free_shader(svk_context ctx, svk_shader shader) {
+    if (!ctx) return;
+    context_lock(ctx);
+    free_shader(ctx, shader);
+    context_unlock(ctx);
+}
 
-    /* Submit */
-    VkSubmitInfo submit_info = {
-        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .commandBufferCount = 1,
-        .pCommandBuffers = &cmd
-    };
+uint32_t svk_shader_module_count(svk_context ctx) {
+    if (!ctx) return 0;
+    context_lock(ctx);
+    uint32_t result = shader_module_count(ctx);
+    context_unlock(ctx);
+    return result;
+}
 
-    vkQueueSubmit(ctx->compute_queue, 1, &submit_info, VK_NULL_HANDLE);
-    vkQueueWaitIdle(ctx->compute_queue);
+uint32_t svk_pipeline_variant_count(svk_context ctx) {
+    if (!ctx) return 0;
+    context_lock(ctx);
+    uint32_t result = pipeline_variant_count(ctx);
+    context_unlock(ctx);
+    return result;
+}
 
-    vkFreeCommandBuffers(ctx->device, ctx->command_pool, 1, &cmd);
+int svk_wait_ticket(svk_context ctx, svk_ticket ticket) {
+    if (!ctx) return 0;
+    context_lock(ctx);
+    int result = wait_ticket(ctx, ticket);
+    context_unlock(ctx);
+    return result;
+}
 
-    return 1;
+int svk_poll_ticket(svk_context ctx, svk_ticket ticket) {
+    if (!ctx) return 0;
+    context_lock(ctx);
+    int result = poll_ticket(ctx, ticket);
+    context_unlock(ctx);
+    return result;
 }
 
 void svk_wait_idle(svk_context ctx) {
-    if (ctx) vkDeviceWaitIdle(ctx->device);
+    if (!ctx) return;
+    context_lock(ctx);
+    wait_idle(ctx);
+    context_unlock(ctx);
 }
 
-void svk_free_pipeline(svk_context ctx, svk_pipeline pipe) {
-    if (!ctx || !pipe) return;
-    vkDestroyPipeline(ctx->device, pipe->pipeline, NULL);
-    vkDestroyPipelineLayout(ctx->device, pipe->layout, NULL);
-    vkDestroyDescriptorSetLayout(ctx->device, pipe->desc_layout, NULL);
-    free(pipe);
+svk_ticket svk_dispatch_async_on(svk_context ctx, svk_pipeline pipe, uint32_t role,
+                                 uint32_t x, uint32_t y, uint32_t z) {
+    if (!ctx) return 0;
+    context_lock(ctx);
+    svk_ticket result = dispatch_on(ctx, pipe, role, NULL, x, y, z);
+    context_unlock(ctx);
+    return result;
 }
 
-/* ============================================================================
- * Image Download (for getting compute results)
- * ============================================================================ */
-
-int svk_download_image(svk_context ctx, svk_image img, void* data) {
-    if (!ctx || !img || !data) return 0;
+svk_ticket svk_dispatch_region_async(svk_context ctx, svk_pipeline pipe,
+                                     uint32_t base_x, uint32_t base_y, uint32_t base_z,
+                                     uint32_t x, uint32_t y, uint32_t z) {
+    uint32_t base[3] = { base_x, base_y, base_z };
+    if (!ctx) return 0;
+    context_lock(ctx);
+    svk_ticket result = dispatch_on(ctx, pipe, SVK_QUEUE_COMPUTE, base, x, y, z);
+    context_unlock(ctx);
+    return result;
+}
 
-    uint64_t pixel_size = (img->format == SVK_FORMAT_RGBA32F) ? 16 : 4;
-    uint64_t image_size = img->width * img->height * pixel_size;
+svk_ticket svk_dispatch_indirect_async_on(svk_context ctx, svk_pipeline pipe, uint32_t role,
+                                          svk_buffer args, uint64_t offset) {
+    if (!ctx) return 0;
+    context_lock(ctx);
+    svk_ticket result = dispatch_indirect_on(ctx, pipe, role, args, offset);
+    context_unlock(ctx);
+    return result;
+}
 
-    /* Create staging buffer if needed */
-    if (ctx->staging_size < image_size) {
-        if (ctx->staging_buffer) {
-            vkDestroyBuffer(ctx->device, ctx->staging_buffer, NULL);
-            vkFreeMemory(ctx->device, ctx->staging_memory, NULL);
-        }
+void svk_free_pipeline(svk_context ctx, svk_pipeline pipe) {
+    if (!ctx) return;
+    context_lock(ctx);
+    free_pipeline(ctx, pipe);
+    context_unlock(ctx);
+}
 
-        VkBufferCreateInfo buffer_info = {
-            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-            .size = image_size,
-            .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-            .sharingMode = VK_SHARING_MODE_EXCLUSIVE
-        };
+svk_ticket svk_render_sdf(svk_context ctx, svk_pipeline pipe,
+                          float cam_x, float cam_y, float cam_z,
+                          float cam_yaw, float cam_pitch, float time) {
+    if (!ctx) return 0;
+    context_lock(ctx);
+    svk_ticket result = render_sdf(ctx, pipe, cam_x, cam_y, cam_z, cam_yaw, cam_pitch, time);
+    context_unlock(ctx);
+    return result;
+}
 
-        vkCreateBuffer(ctx->device, &buffer_info, NULL, &ctx->staging_buffer);
+svk_ticket svk_tiled_sdf_render_async(svk_tiled_sdf sdf, uint32_t width, uint32_t height) {
+    if (!sdf) return 0;
+    svk_context ctx = sdf->ctx;
+    context_lock(ctx);
+    svk_ticket result = tiled_sdf_render(sdf, width, height);
+    context_unlock(ctx);
+    return result;
+}
 
-        VkMemoryRequirements mem_reqs;
-        vkGetBufferMemoryRequirements(ctx->device, ctx->staging_buffer, &mem_reqs);
+svk_ticket svk_reduce_async(svk_algorithms algos, svk_buffer input, uint32_t count, uint32_t type, uint32_t op,
+                            svk_buffer output) {
+    if (!algos) return 0;
+    svk_context ctx = algos->ctx;
+    context_lock(ctx);
+    svk_ticket result = reduce_buffer(algos, input, count, type, op, output);
+    context_unlock(ctx);
+    return result;
+}
 
-        VkMemoryAllocateInfo alloc_info = {
-            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-            .allocationSize = mem_reqs.size,
-            .memoryTypeIndex = find_memory_type(ctx->physical_device, mem_reqs.memoryTypeBits,
-                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
-        };
+svk_ticket svk_scan_async(svk_algorithms algos, svk_buffer input, svk_buffer output, uint32_t count,
+                          uint32_t type, uint32_t op, int inclusive) {
+    if (!algos) return 0;
+    svk_context ctx = algos->ctx;
+    context_lock(ctx);
+    svk_ticket result = scan_buffer(algos, input, output, count, type, op, inclusive);
+    context_unlock(ctx);
+    return result;
+}
 
-        vkAllocateMemory(ctx->device, &alloc_info, NULL, &ctx->staging_memory);
-        vkBindBufferMemory(ctx->device, ctx->staging_buffer, ctx->staging_memory, 0);
-        ctx->staging_size = image_size;
-    }
+svk_ticket svk_sort_async(svk_algorithms algos, svk_buffer keys, svk_buffer values, uint32_t count, uint32_t type) {
+    if (!algos) return 0;
+    svk_context ctx = algos->ctx;
+    context_lock(ctx);
+    svk_ticket result = sort_buffer(algos, keys, values, count, type);
+    context_unlock(ctx);
+    return result;
+}
 
-    /* Copy image to staging buffer */
-    VkCommandBufferAllocateInfo alloc_info = {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-        .commandPool = ctx->command_pool,
-        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-        .commandBufferCount = 1
-    };
+svk_ticket svk_histogram_async(svk_algorithms algos, svk_buffer input, uint32_t count, uint32_t type,
+                               double lo, double hi, uint32_t bins, svk_buffer output) {
+    if (!algos) return 0;
+    svk_context ctx = algos->ctx;
+    context_lock(ctx);
+    svk_ticket result = histogram_buffer(algos, input, count, type, lo, hi, bins, output);
+    context_unlock(ctx);
+    return result;
+}
 
-    VkCommandBuffer cmd;
-    vkAllocateCommandBuffers(ctx->device, &alloc_info, &cmd);
+int svk_cmdlist_begin(svk_cmdlist list) {
+    if (!list) return 0;
+    svk_context ctx = list->ctx;
+    context_lock(ctx);
+    int result = cmdlist_begin(list);
+    context_unlock(ctx);
+    return result;
+}
 
-    VkCommandBufferBeginInfo begin_info = {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
-    };
+int svk_cmd_dispatch(svk_cmdlist list, svk_pipeline pipe, uint32_t x, uint32_t y, uint32_t z) {
+    if (!list) return 0;
+    svk_context ctx = list->ctx;
+    context_lock(ctx);
+    int result = cmd_dispatch(list, pipe, x, y, z);
+    context_unlock(ctx);
+    return result;
+}
 
-    vkBeginCommandBuffer(cmd, &begin_info);
+int svk_cmd_dispatch_indirect(svk_cmdlist list, svk_pipeline pipe, svk_buffer args, uint64_t offset) {
+    if (!list) return 0;
+    svk_context ctx = list->ctx;
+    context_lock(ctx);
+    int result = cmd_dispatch_indirect(list, pipe, args, offset);
+    context_unlock(ctx);
+    return result;
+}
 
-    /* Transition image layout for transfer */
-    VkImageMemoryBarrier barrier = {
-        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-        .oldLayout = VK_IMAGE_LAYOUT_GENERAL,
-        .newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-        .image = img->image,
-        .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 },
-        .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
-        .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT
-    };
+int svk_cmd_copy_buffer(svk_cmdlist list, svk_buffer src, svk_buffer dst,
+                        uint64_t src_offset, uint64_t dst_offset, uint64_t size) {
+    if (!list) return 0;
+    svk_context ctx = list->ctx;
+    context_lock(ctx);
+    int result = cmd_copy_buffer(list, src, dst, src_offset, dst_offset, size);
+    context_unlock(ctx);
+    return result;
+}
 
-    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
-        0, 0, NULL, 0, NULL, 1, &barrier);
+int svk_cmd_fill_buffer(svk_cmdlist list, svk_buffer buf, uint64_t offset, uint64_t size, uint32_t value) {
+    if (!list) return 0;
+    svk_context ctx = list->ctx;
+    context_lock(ctx);
+    int result = cmd_fill_buffer(list, buf, offset, size, value);
+    context_unlock(ctx);
+    return result;
+}
 
-    VkBufferImageCopy region = {
-        .bufferOffset = 0,
-        .bufferRowLength = 0,
-        .bufferImageHeight = 0,
-        .imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 },
-        .imageOffset = { 0, 0, 0 },
-        .imageExtent = { img->width, img->height, 1 }
-    };
+int svk_cmdlist_end(svk_cmdlist list) {
+    if (!list) return 0;
+    svk_context ctx = list->ctx;
+    context_lock(ctx);
+    int result = cmdlist_end(list);
+    context_unlock(ctx);
+    return result;
+}
 
-    vkCmdCopyImageToBuffer(cmd, img->image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, ctx->staging_buffer, 1, &region);
+svk_ticket svk_cmdlist_submit(svk_cmdlist list) {
+    if (!list) return 0;
+    svk_context ctx = list->ctx;
+    context_lock(ctx);
+    svk_ticket result = cmdlist_submit(list);
+    context_unlock(ctx);
+    return result;
+}
 
-    vkEndCommandBuffer(cmd);
+void svk_free_cmdlist(svk_cmdlist list) {
+    if (!list) return;
+    svk_context ctx = list->ctx;
+    context_lock(ctx);
+    free_cmdlist(list);
+    context_unlock(ctx);
+}
 
-    VkSubmitInfo submit_info = {
-        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .commandBufferCount = 1,
-        .pCommandBuffers = &cmd
-    };
+svk_buffer svk_graph_transient_buffer(svk_graph graph, uint64_t size, uint32_t usage) {
+    if (!graph) return NULL;
+    svk_context ctx = graph->ctx;
+    context_lock(ctx);
+    svk_buffer result = graph_transient_buffer(graph, size, usage);
+    context_unlock(ctx);
+    return result;
+}
 
-    vkQueueSubmit(ctx->compute_queue, 1, &submit_info, VK_NULL_HANDLE);
-    vkQueueWaitIdle(ctx->compute_queue);
+svk_image svk_graph_transient_image(svk_graph graph, uint32_t width, uint32_t height, uint32_t format) {
+    if (!graph) return NULL;
+    svk_context ctx = graph->ctx;
+    context_lock(ctx);
+    svk_image result = graph_transient_image(graph, width, height, format);
+    context_unlock(ctx);
+    return result;
+}
 
-    vkFreeCommandBuffers(ctx->device, ctx->command_pool, 1, &cmd);
+int svk_graph_compile(svk_graph graph) {
+    if (!graph) return 0;
+    svk_context ctx = graph->ctx;
+    context_lock(ctx);
+    int result = graph_compile(graph);
+    context_unlock(ctx);
+    return result;
+}
 
-    /* Read from staging buffer */
-    void* mapped;
-    vkMapMemory(ctx->device, ctx->staging_memory, 0, image_size, 0, &mapped);
-    memcpy(data, mapped, image_size);
-    vkUnmapMemory(ctx->device, ctx->staging_memory);
+int svk_graph_run(svk_graph graph) {
+    if (!graph) return 0;
+    svk_context ctx = graph->ctx;
+    context_lock(ctx);
+    int result = graph_run(graph);
+    context_unlock(ctx);
+    return result;
+}
 
-    return 1;
+void svk_free_graph(svk_graph graph) {
+    if (!graph) return;
+    svk_context ctx = graph->ctx;
+    context_lock(ctx);
+    free_graph(graph);
+    context_unlock(ctx);
 }
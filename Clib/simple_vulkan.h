@@ -12,6 +12,12 @@
  *   4. svk_create_pipeline() - Create compute pipeline
  *   5. svk_dispatch() - Execute compute shader
  *   6. svk_cleanup() - Release resources
+ *
+ * Threads: a context, its buffers, images and shaders may be used from
+ * several threads at once. Each thread records into its own command pools
+ * and staging buffers; submission is serialized inside the context, and
+ * blocking waits let other threads proceed. A pipeline, command list,
+ * graph or splitter must be used by one thread at a time.
  */
 
 #ifndef SIMPLE_VULKAN_H
@@ -32,14 +38,68 @@ typedef struct svk_buffer_t* svk_buffer;
 typedef struct svk_shader_t* svk_shader;
 typedef struct svk_pipeline_t* svk_pipeline;
 typedef struct svk_image_t* svk_image;
+typedef struct svk_cmdlist_t* svk_cmdlist;
+typedef struct svk_graph_t* svk_graph;
+typedef struct svk_splitter_t* svk_splitter;
+typedef struct svk_tiled_sdf_t* svk_tiled_sdf;
+typedef struct svk_algorithms_t* svk_algorithms;
+
+/* Submission ticket returned by asynchronous calls (0 = failed) */
+typedef uint64_t svk_ticket;
 
 /* ============================================================================
  * Initialization
  * ============================================================================ */
 
-/* Initialize Vulkan context. Returns NULL on failure. */
+/* Initialize Vulkan context on the best device: discrete over integrated
+ * over the rest, then the one with the most device-local memory. Returns
+ * NULL on failure. */
 svk_context svk_init(void);
 
+/* Device types (same values as VkPhysicalDeviceType) */
+#define SVK_DEVICE_OTHER       0
+#define SVK_DEVICE_INTEGRATED  1
+#define SVK_DEVICE_DISCRETE    2
+#define SVK_DEVICE_VIRTUAL     3
+#define SVK_DEVICE_CPU         4
+
+#define SVK_MAX_HEAPS 16
+#define SVK_ANY_DEVICE 0xFFFFFFFFu
+
+/* A physical device as reported by the driver */
+typedef struct {
+    char name[256];
+    uint32_t type;                      /* SVK_DEVICE_* */
+    uint32_t vendor_id;
+    uint32_t device_id;
+    uint32_t api_version;               /* VK_MAKE_VERSION encoding */
+    int has_compute;                    /* 0: svk_init_device fails for it */
+    uint32_t max_workgroup_size;        /* Invocations per workgroup */
+    uint32_t max_workgroup_count[3];
+    uint32_t max_push_constants_size;
+    uint64_t max_storage_buffer_range;
+    uint32_t max_image_dimension;       /* Width/height of a 2D image */
+    uint32_t heap_count;
+    uint64_t heap_size[SVK_MAX_HEAPS];
+    uint32_t device_local_heaps;        /* Bit per heap that is device-local */
+    uint64_t device_local_bytes;        /* Sum of the device-local heaps */
+} svk_device_info;
+
+/* Number of physical devices (0 without a Vulkan driver). The devices are
+ * enumerated and described once per process, so indices are stable and
+ * later calls are cheap. */
+uint32_t svk_get_device_count(void);
+
+/* Describe device `index` (0 .. svk_get_device_count() - 1) */
+int svk_get_device_info(uint32_t index, svk_device_info* info);
+
+/* Initialize Vulkan context on device `index`. Several contexts may share
+ * one device. Returns NULL on failure. */
+svk_context svk_init_device(uint32_t index);
+
+/* Index of the context's device */
+uint32_t svk_get_device_index(svk_context ctx);
+
 /* Get device name (e.g., "NVIDIA GeForce RTX 5070 Ti") */
 const char* svk_get_device_name(svk_context ctx);
 
@@ -52,9 +112,111 @@ int svk_is_discrete_gpu(svk_context ctx);
 /* Get maximum workgroup size (typically 256-1024) */
 uint32_t svk_get_max_workgroup_size(svk_context ctx);
 
-/* Cleanup and release all resources */
+/* Queue roles. Staged buffer transfers run on the transfer queue; work can
+ * be sent to the async-compute queue with svk_dispatch_async_on. A role the
+ * device has no separate queue for (or any role, when the driver lacks
+ * timeline semaphores) shares the compute queue. */
+#define SVK_QUEUE_COMPUTE        0
+#define SVK_QUEUE_ASYNC_COMPUTE  1
+#define SVK_QUEUE_TRANSFER       2
+
+/* 1 if the role has its own hardware queue, 0 if it shares the compute queue */
+int svk_has_dedicated_queue(svk_context ctx, uint32_t role);
+
+/* Queue family index serving the role (UINT32_MAX on bad arguments) */
+uint32_t svk_get_queue_family(svk_context ctx, uint32_t role);
+
+/* Let another thread reuse the calling thread's command pools and staging
+ * buffers, e.g. before a worker thread exits. Returns 0 while a command
+ * list recorded by this thread is not yet submitted. */
+int svk_release_thread(svk_context ctx);
+
+/* Cleanup and release all resources. No other thread may be using ctx. */
 void svk_cleanup(svk_context ctx);
 
+/* Merge a pipeline cache saved by svk_save_pipeline_cache into the context's
+   cache. Pipelines created afterwards skip driver compilation when cached.
+   Returns 0 (and changes nothing) if the file is missing, corrupt, or was
+   written for a different device, driver version or pipelineCacheUUID. */
+int svk_load_pipeline_cache(svk_context ctx, const char* path);
+
+/* Write the context's pipeline cache to `path` (replaced atomically) */
+int svk_save_pipeline_cache(svk_context ctx, const char* path);
+
+/* ============================================================================
+ * Memory Statistics
+ *
+ * Buffers and images are sub-allocated from large device memory blocks.
+ * ============================================================================ */
+
+typedef struct {
+    uint32_t block_count;         /* VkDeviceMemory allocations (including dedicated) */
+    uint32_t dedicated_count;     /* Blocks holding a single large resource */
+    uint32_t allocation_count;    /* Live buffers/images */
+    uint32_t free_range_count;    /* Free ranges across all blocks */
+    uint64_t bytes_reserved;      /* Device memory allocated from the driver */
+    uint64_t bytes_used;          /* Bytes handed out to buffers/images */
+    uint64_t largest_free_range;  /* Largest contiguous free range */
+    double fragmentation;         /* 1 - largest_free_range / total free bytes */
+} svk_memory_stats;
+
+/* Fill stats for the context's allocator */
+int svk_get_memory_stats(svk_context ctx, svk_memory_stats* stats);
+
+/* Descriptor pool usage. Pools are added as earlier ones fill up and sets
+   are returned when their pipeline is freed. */
+typedef struct {
+    uint32_t pool_count;
+    uint32_t set_capacity;        /* Sets all pools can hold */
+    uint32_t sets_in_use;         /* Sets held by live pipelines */
+    uint64_t sets_allocated;      /* Lifetime total */
+    uint64_t sets_freed;          /* Lifetime total */
+} svk_descriptor_stats;
+
+/* Fill stats for the context's descriptor pools */
+int svk_get_descriptor_stats(svk_context ctx, svk_descriptor_stats* stats);
+
+/* ============================================================================
+ * GPU Profiling
+ * ============================================================================ */
+
+/* Command kinds reported in svk_gpu_sample */
+#define SVK_SAMPLE_DISPATCH 1
+#define SVK_SAMPLE_COPY     2  /* Buffer copies, staged transfers, image downloads */
+#define SVK_SAMPLE_FILL     3
+#define SVK_SAMPLE_GRAPH    4  /* One batch of a task graph run */
+
+/* GPU execution time of one recorded command */
+typedef struct {
+    uint32_t tag;        /* svk_set_profile_tag value when the command was recorded */
+    uint32_t kind;       /* SVK_SAMPLE_* */
+    svk_ticket ticket;   /* Submission that ran the command */
+    uint64_t gpu_ns;     /* Time between the stamps before and after the command */
+} svk_gpu_sample;
+
+/* Bracket every recorded dispatch, copy and fill with GPU timestamps.
+   `max_pending` bounds the commands stamped but not yet collected; beyond
+   that commands run unstamped and are counted by svk_dropped_gpu_samples.
+   Returns 0 if the compute queue has no timestamp support. */
+int svk_enable_profiling(svk_context ctx, uint32_t max_pending);
+
+/* Stop stamping commands and discard uncollected samples (waits for idle) */
+void svk_disable_profiling(svk_context ctx);
+
+/* Tag attached to commands recorded from now on (0 = untagged) */
+void svk_set_profile_tag(svk_context ctx, uint32_t tag);
+
+/* Copy up to `max_samples` finished samples, in recording order, and free
+   their queries. Never blocks; unfinished commands are returned later. */
+uint32_t svk_collect_gpu_samples(svk_context ctx, svk_gpu_sample* samples, uint32_t max_samples);
+
+/* Commands left unstamped because all queries awaited collection */
+uint64_t svk_dropped_gpu_samples(svk_context ctx);
+
+/* Monotonic host clock in nanoseconds, for comparing wall-clock spans
+   with GPU samples */
+uint64_t svk_time_ns(void);
+
 /* ============================================================================
  * Buffer Management
  * ============================================================================ */
@@ -63,21 +225,50 @@ void svk_cleanup(svk_context ctx);
 #define SVK_BUFFER_STORAGE   0x01  /* Shader storage buffer (SSBO) */
 #define SVK_BUFFER_UNIFORM   0x02  /* Uniform buffer */
 #define SVK_BUFFER_TRANSFER  0x04  /* Transfer source/destination */
+#define SVK_BUFFER_INDIRECT  0x08  /* Indirect dispatch arguments */
+
+/* Buffer placement (at most one; none = host-visible, host-coherent) */
+#define SVK_BUFFER_DEVICE_LOCAL   0x10  /* GPU memory; transfers go through a staging ring */
+#define SVK_BUFFER_HOST_UPLOAD    0x20  /* Host-visible, written by CPU, read by GPU */
+#define SVK_BUFFER_HOST_READBACK  0x40  /* Host-visible, cached where available, read by CPU */
+#define SVK_BUFFER_PLACEMENT_MASK 0x70
 
 /* Create GPU buffer. Returns NULL on failure. */
 svk_buffer svk_create_buffer(svk_context ctx, uint64_t size, uint32_t usage);
 
-/* Upload data from CPU to GPU buffer */
+/* Upload data from CPU to GPU buffer.
+ * Host-visible buffers wait for pending GPU work on the buffer, then copy directly.
+ * Device-local buffers are copied through the staging ring; the call returns once
+ * the copies are queued and the data pointer may be reused immediately. */
 int svk_upload_buffer(svk_context ctx, svk_buffer buf, const void* data, uint64_t size, uint64_t offset);
 
-/* Download data from GPU to CPU buffer */
+/* Download data from GPU to CPU buffer (waits for pending GPU work on the buffer) */
 int svk_download_buffer(svk_context ctx, svk_buffer buf, void* data, uint64_t size, uint64_t offset);
 
 /* Get buffer size */
 uint64_t svk_buffer_size(svk_buffer buf);
 
-/* Free buffer */
-void svk_free_buffer(svk_context ctx, svk_buffer buf);
+/* Persistent CPU pointer to the buffer, valid until the buffer is freed.
+ * NULL unless the buffer's memory is host-visible, which device-local
+ * buffers also get on UMA and ReBAR devices. Writes through it must not
+ * overlap pending GPU work on the buffer (see svk_wait_buffer). */
+void* svk_buffer_mapped_pointer(svk_buffer buf);
+
+/* 1 if the buffer's memory is host-coherent (flush/invalidate are no-ops) */
+int svk_buffer_is_coherent(svk_context ctx, svk_buffer buf);
+
+/* Make CPU writes through the mapped pointer visible to the GPU (non-coherent memory) */
+int svk_flush_buffer(svk_context ctx, svk_buffer buf, uint64_t offset, uint64_t size);
+
+/* Make GPU writes visible to CPU reads through the mapped pointer (non-coherent memory) */
+int svk_invalidate_buffer(svk_context ctx, svk_buffer buf, uint64_t offset, uint64_t size);
+
+/* Wait for pending GPU work that uses the buffer */
+int svk_wait_buffer(svk_context ctx, svk_buffer buf);
+
+/* Free buffer. Returns 0, and keeps the buffer, while a command list that
+   recorded it is not yet submitted. */
+int svk_free_buffer(svk_context ctx, svk_buffer buf);
 
 /* ============================================================================
  * Image/Texture Management (for compute shader output)
@@ -90,28 +281,89 @@ void svk_free_buffer(svk_context ctx, svk_buffer buf);
 /* Create GPU image for compute shader output */
 svk_image svk_create_image(svk_context ctx, uint32_t width, uint32_t height, uint32_t format);
 
-/* Download image data to CPU */
+/* Image downloads that can be outstanding at once */
+#define SVK_READBACK_SLOTS 4
+
+/* Download image data to CPU (waits for the copy). Uses a readback slot,
+ * so it fails while SVK_READBACK_SLOTS downloads are uncollected. */
 int svk_download_image(svk_context ctx, svk_image img, void* data);
 
+/* Start copying an image to host memory without waiting.
+ * Returns a ticket (poll it with svk_poll_ticket), or 0 when every
+ * readback slot holds an uncollected download or on failure. */
+svk_ticket svk_begin_image_download(svk_context ctx, svk_image img);
+
+/* Copy a started download into data (width * height * pixel size bytes,
+ * or the packed size for svk_begin_packed_download),
+ * waiting if the copy is still running, and release its slot.
+ * data may be NULL to discard the download. */
+int svk_finish_image_download(svk_context ctx, svk_ticket ticket, void* data);
+
+/* Packed download layouts, converted on the GPU before readback */
+#define SVK_PACK_RGBA8    0x01  /* 4 bytes per pixel, R in the low byte */
+#define SVK_PACK_RGB10A2  0x02  /* 4 bytes per pixel, R in bits 0-9, A in bits 30-31 */
+#define SVK_PACK_RGBA16F  0x03  /* 8 bytes per pixel, half floats R, G, B, A */
+#define SVK_PACK_YUV420   0x04  /* I420: Y plane, then U and V at half resolution
+                                   (BT.709 limited range); width a multiple of 8,
+                                   height even */
+
+/* Create a pipeline packing images of the format its shader reads:
+ * shaders/pack_image.spv for SVK_FORMAT_RGBA32F images,
+ * shaders/pack_image_rgba8.spv for SVK_FORMAT_RGBA8. Free with
+ * svk_free_pipeline. */
+svk_pipeline svk_create_pack_pipeline(svk_context ctx, svk_shader shader);
+
+/* Bytes of `img` packed as `pack`, or 0 if it cannot be */
+uint64_t svk_packed_image_size(svk_image img, uint32_t pack);
+
+/* Like svk_begin_image_download, but the readback slot receives the image
+ * packed as `pack` (svk_packed_image_size bytes) by `pack_pipe`. Collect it
+ * with svk_finish_image_download. */
+svk_ticket svk_begin_packed_download(svk_context ctx, svk_pipeline pack_pipe, svk_image img, uint32_t pack);
+
+/* Download an image packed as `pack`, waiting for it */
+int svk_download_image_packed(svk_context ctx, svk_pipeline pack_pipe, svk_image img, uint32_t pack, void* data);
+
 /* Get image dimensions */
 void svk_image_size(svk_image img, uint32_t* width, uint32_t* height);
 
-/* Free image */
-void svk_free_image(svk_context ctx, svk_image img);
+/* Free image. Returns 0, and keeps the image, while a command list that
+   recorded it is not yet submitted. */
+int svk_free_image(svk_context ctx, svk_image img);
 
 /* ============================================================================
  * Shader Management
  * ============================================================================ */
 
-/* Load compute shader from SPIR-V file */
+/* Load compute shader from SPIR-V file (memory-mapped, not copied) */
 svk_shader svk_load_shader(svk_context ctx, const char* spv_path);
 
-/* Load compute shader from SPIR-V memory */
+/* Load compute shader from SPIR-V memory. Rejects code that is not whole
+   words or lacks the SPIR-V magic number. Identical code already loaded in
+   the context returns the same shared handle with its reference count
+   raised; every load must be matched by one svk_free_shader. The code is
+   not retained: the caller may free it once this returns. */
 svk_shader svk_load_shader_memory(svk_context ctx, const uint32_t* spirv, uint64_t size);
 
-/* Free shader */
+/* Release one reference; the module is destroyed with the last one */
 void svk_free_shader(svk_context ctx, svk_shader shader);
 
+/* Number of distinct shader modules alive in the context */
+uint32_t svk_shader_module_count(svk_context ctx);
+
+/* Shader interface, read from the module by SPIR-V reflection. Modules
+   reflection cannot describe (descriptor sets other than 0, descriptor
+   arrays, samplers, texel buffers) fall back to a generic layout. */
+
+/* Local workgroup size. Returns 0 if the module was not reflected. */
+int svk_shader_local_size(svk_shader shader, uint32_t* x, uint32_t* y, uint32_t* z);
+
+/* SVK_BINDING_* used at binding index, or 0 if unused/not reflected */
+uint32_t svk_shader_binding_type(svk_shader shader, uint32_t binding);
+
+/* Push-constant block size in bytes (128 for unreflected modules) */
+uint32_t svk_shader_push_size(svk_shader shader);
+
 /* ============================================================================
  * Compute Pipeline
  * ============================================================================ */
@@ -120,30 +372,247 @@ void svk_free_shader(svk_context ctx, svk_shader shader);
 #define SVK_MAX_BINDINGS 8
 
 /* Binding type */
-#define SVK_BINDING_BUFFER  0x01
-#define SVK_BINDING_IMAGE   0x02
+#define SVK_BINDING_BUFFER  0x01  /* Storage buffer */
+#define SVK_BINDING_IMAGE   0x02  /* Storage image */
+#define SVK_BINDING_UNIFORM 0x04  /* Uniform buffer */
 
-/* Create compute pipeline from shader */
+/* Create compute pipeline from shader. The descriptor layout and push-constant
+   range come from the shader's reflected interface; unreflected modules get
+   8 storage buffers and a 128-byte push range. */
 svk_pipeline svk_create_pipeline(svk_context ctx, svk_shader shader);
 
-/* Bind buffer to pipeline at binding index */
+/* Create compute pipeline with a SVK_BINDING_* type for each of the first
+   `count` bindings; remaining bindings are storage buffers. Image bindings
+   are storage images accessed in GENERAL layout. */
+svk_pipeline svk_create_pipeline_with_bindings(svk_context ctx, svk_shader shader,
+                                               const uint32_t* binding_types, uint32_t count);
+
+/* Specialization constant: `constant_id` in GLSL, with a 32-bit value
+   (int, uint, bool, or float bits) */
+typedef struct {
+    uint32_t id;
+    uint32_t value;
+} svk_spec_constant;
+
+/* Create compute pipeline with specialization constants folded in by the
+   driver (e.g. march step counts, local_size_x_id). Compiled pipelines are
+   cached on the context per shader and constant set, so creating the same
+   variant again is cheap; the layout comes from reflection as in
+   svk_create_pipeline. At most 64 constants, ids must be unique. */
+svk_pipeline svk_create_pipeline_specialized(svk_context ctx, svk_shader shader,
+                                             const svk_spec_constant* constants, uint32_t count);
+
+/* Number of distinct compiled pipelines alive in the context */
+uint32_t svk_pipeline_variant_count(svk_context ctx);
+
+/* Bind buffer to pipeline at binding index. Rebinding the same resource is
+   free; descriptor sets for recent binding combinations are cached. Storage
+   bindings need SVK_BUFFER_STORAGE, uniform bindings SVK_BUFFER_UNIFORM.
+   Bindings the shader does not declare accept any resource and ignore it. */
 int svk_bind_buffer(svk_pipeline pipe, uint32_t binding, svk_buffer buf);
 
-/* Bind image to pipeline at binding index */
+/* Bind image to pipeline at binding index (a SVK_BINDING_IMAGE slot). On a
+   pipeline whose shader could not be reflected, any binding takes either a
+   storage buffer or an image. */
 int svk_bind_image(svk_pipeline pipe, uint32_t binding, svk_image img);
 
-/* Set push constant data (small, fast-changing uniforms) */
+/* Set push constant data (small, fast-changing uniforms). Fails if `size`
+   exceeds the pipeline's push-constant range. */
 int svk_set_push_constants(svk_pipeline pipe, const void* data, uint32_t size);
 
-/* Dispatch compute shader (workgroup counts) */
+/* Dispatch compute shader (workgroup counts) and wait for completion */
 int svk_dispatch(svk_context ctx, svk_pipeline pipe, uint32_t x, uint32_t y, uint32_t z);
 
+/* Dispatch enough workgroups to cover nx * ny * nz threads and wait.
+   Requires a reflected local size (see svk_pipeline_local_size). */
+int svk_dispatch_threads(svk_context ctx, svk_pipeline pipe, uint32_t nx, uint32_t ny, uint32_t nz);
+
+/* Local workgroup size of the pipeline's shader. Returns 0 if unknown. */
+int svk_pipeline_local_size(svk_pipeline pipe, uint32_t* x, uint32_t* y, uint32_t* z);
+
+/* Submit compute shader without waiting. Returns a ticket, or 0 on failure.
+ * Downloads of bound buffers wait for the submission automatically. */
+svk_ticket svk_dispatch_async(svk_context ctx, svk_pipeline pipe, uint32_t x, uint32_t y, uint32_t z);
+
+/* Same, on the queue of `role` (SVK_QUEUE_COMPUTE or SVK_QUEUE_ASYNC_COMPUTE).
+ * Work on other queues that the bound resources depend on is waited for
+ * on the GPU. */
+svk_ticket svk_dispatch_async_on(svk_context ctx, svk_pipeline pipe, uint32_t role,
+                                 uint32_t x, uint32_t y, uint32_t z);
+
+/* Dispatch workgroups base .. base + count - 1 of a larger grid, on the
+ * compute queue. gl_WorkGroupID and gl_GlobalInvocationID include the base.
+ * A non-zero base needs Vulkan 1.1; the first one compiles a second copy of
+ * the pipeline that allows it. */
+svk_ticket svk_dispatch_region_async(svk_context ctx, svk_pipeline pipe,
+                                     uint32_t base_x, uint32_t base_y, uint32_t base_z,
+                                     uint32_t x, uint32_t y, uint32_t z);
+
+/* Dispatch with workgroup counts the GPU reads from `args` (three uint32 x,
+ * y, z at `offset`, a multiple of 4), so a shader can size the next pass
+ * without a readback. `args` needs SVK_BUFFER_INDIRECT. The _async variants
+ * return a ticket, or 0 on failure; svk_dispatch_indirect waits. */
+int svk_dispatch_indirect(svk_context ctx, svk_pipeline pipe, svk_buffer args, uint64_t offset);
+svk_ticket svk_dispatch_indirect_async(svk_context ctx, svk_pipeline pipe, svk_buffer args, uint64_t offset);
+svk_ticket svk_dispatch_indirect_async_on(svk_context ctx, svk_pipeline pipe, uint32_t role,
+                                          svk_buffer args, uint64_t offset);
+
+/* Block until the submission identified by ticket has finished */
+int svk_wait_ticket(svk_context ctx, svk_ticket ticket);
+
+/* Non-blocking check: 1 if the submission has finished, 0 if still running */
+int svk_poll_ticket(svk_context ctx, svk_ticket ticket);
+
 /* Wait for GPU to finish */
 void svk_wait_idle(svk_context ctx);
 
 /* Free pipeline */
 void svk_free_pipeline(svk_context ctx, svk_pipeline pipe);
 
+/* ============================================================================
+ * Command Lists (many steps, one submission)
+ *
+ * Barriers between dependent steps (compute->compute, compute->transfer,
+ * transfer->compute) are inserted automatically. A pipeline's buffer
+ * bindings cannot change while an unsubmitted list has recorded it.
+ * ============================================================================ */
+
+/* Create an empty command list. Returns NULL on failure. */
+svk_cmdlist svk_create_cmdlist(svk_context ctx);
+
+/* Start recording (discards anything recorded but not submitted) */
+int svk_cmdlist_begin(svk_cmdlist list);
+
+/* Record a dispatch using the pipeline's current bindings and push constants */
+int svk_cmd_dispatch(svk_cmdlist list, svk_pipeline pipe, uint32_t x, uint32_t y, uint32_t z);
+
+/* Record a dispatch whose workgroup counts are read from `args` at `offset`
+ * (see svk_dispatch_indirect). Earlier steps writing `args` are waited for. */
+int svk_cmd_dispatch_indirect(svk_cmdlist list, svk_pipeline pipe, svk_buffer args, uint64_t offset);
+
+/* Record a buffer-to-buffer copy */
+int svk_cmd_copy_buffer(svk_cmdlist list, svk_buffer src, svk_buffer dst,
+                        uint64_t src_offset, uint64_t dst_offset, uint64_t size);
+
+/* Record a fill of a buffer range with a 32-bit value (offset/size multiple of 4) */
+int svk_cmd_fill_buffer(svk_cmdlist list, svk_buffer buf, uint64_t offset, uint64_t size, uint32_t value);
+
+/* Stop recording */
+int svk_cmdlist_end(svk_cmdlist list);
+
+/* Submit an ended list. Returns a ticket, or 0 on failure. The list can be begun again. */
+svk_ticket svk_cmdlist_submit(svk_cmdlist list);
+
+/* Free command list */
+void svk_free_cmdlist(svk_cmdlist list);
+
+/* ============================================================================
+ * Task Graphs (compile once, replay every frame)
+ *
+ * Nodes are added in execution order. A dispatch reads and writes its
+ * pipeline's bindings as they are when the node is added (read-only
+ * bindings are only read); copies and readbacks read their source and write
+ * their target. Consecutive nodes on the same queue form a batch, recorded
+ * once with barriers only between dependent nodes. Batches on different
+ * queues wait for each other on timeline semaphores only where they share
+ * resources. Pipelines and resources must outlive the graph.
+ *
+ * Transient buffers and images are owned by the graph and only get memory
+ * when it is compiled. Transients not used by overlapping ranges of nodes
+ * share memory, so a transient's contents do not survive past its last use
+ * in a run: write it before reading it in every run. Bind them only to the
+ * graph's own pipelines, and never free them; svk_free_graph does.
+ * ============================================================================ */
+
+/* Create an empty graph. Returns NULL on failure. */
+svk_graph svk_create_graph(svk_context ctx);
+
+/* Add a dispatch on SVK_QUEUE_COMPUTE or SVK_QUEUE_ASYNC_COMPUTE with the
+ * pipeline's current bindings and push constants. Returns the node index, or -1. */
+int svk_graph_dispatch(svk_graph graph, svk_pipeline pipe, uint32_t role, uint32_t x, uint32_t y, uint32_t z);
+
+/* Same, with workgroup counts read from `args` at `offset` in every run (see
+ * svk_dispatch_indirect). svk_graph_set_groups does not apply to the node. */
+int svk_graph_dispatch_indirect(svk_graph graph, svk_pipeline pipe, uint32_t role, svk_buffer args, uint64_t offset);
+
+/* Add a buffer-to-buffer copy on any queue role. Returns the node index, or -1. */
+int svk_graph_copy_buffer(svk_graph graph, uint32_t role, svk_buffer src, svk_buffer dst,
+                          uint64_t src_offset, uint64_t dst_offset, uint64_t size);
+
+/* Add a copy of a buffer range or a whole image into host memory owned by
+ * the graph, collected with svk_graph_read. Returns the node index, or -1. */
+int svk_graph_readback_buffer(svk_graph graph, uint32_t role, svk_buffer buf, uint64_t offset, uint64_t size);
+int svk_graph_readback_image(svk_graph graph, uint32_t role, svk_image img);
+
+/* Create a device-local transient buffer or image (SVK_FORMAT_*) before the
+ * graph is compiled. `usage` may not ask for host-visible memory. Returns
+ * NULL on failure. */
+svk_buffer svk_graph_transient_buffer(svk_graph graph, uint64_t size, uint32_t usage);
+svk_image svk_graph_transient_image(svk_graph graph, uint32_t width, uint32_t height, uint32_t format);
+
+/* Place the transients, group the nodes into batches and record them. Nodes
+ * and transients cannot be added afterwards. */
+int svk_graph_compile(svk_graph graph);
+
+/* Submissions per run of a compiled graph */
+uint32_t svk_graph_batch_count(svk_graph graph);
+
+/* Device memory taken by the compiled graph's transients, and what they
+ * would take without aliasing */
+uint64_t svk_graph_transient_bytes(svk_graph graph);
+uint64_t svk_graph_unaliased_bytes(svk_graph graph);
+
+/* Change a dispatch node's push constants or workgroup counts. Only the
+ * node's batch is recorded again, by the next run. */
+int svk_graph_set_push_constants(svk_graph graph, int node, const void* data, uint32_t size);
+int svk_graph_set_groups(svk_graph graph, int node, uint32_t x, uint32_t y, uint32_t z);
+
+/* Submit every batch of a compiled graph without waiting for the GPU */
+int svk_graph_run(svk_graph graph);
+
+/* Has the latest run finished? (non-blocking) */
+int svk_graph_poll(svk_graph graph);
+
+/* Wait for the latest run to finish */
+int svk_graph_wait(svk_graph graph);
+
+/* Copy a readback node's data from the latest run into `data`, waiting for it */
+int svk_graph_read(svk_graph graph, int node, void* data);
+
+/* Free graph (waits for its runs) */
+void svk_free_graph(svk_graph graph);
+
+/* ============================================================================
+ * Multi-Context Splitting (one frame across several GPUs)
+ *
+ * A width x height dispatch is split into horizontal bands, one per target.
+ * A target is a context with a pipeline whose shader covers one invocation
+ * per pixel (bounds-checked against the frame size), writing row-major
+ * pixels of `pixel_size` bytes into `output`. The output buffer is
+ * full-frame and bound to the pipeline by the caller; only the target's
+ * band is written. Targets may be contexts on the same device.
+ * ============================================================================ */
+
+/* Create a splitter for a width x height frame. Returns NULL on failure. */
+svk_splitter svk_create_splitter(uint32_t width, uint32_t height, uint32_t pixel_size);
+
+/* Add a target taking a share of rows proportional to `weight` (> 0).
+ * Returns the target index, or -1. */
+int svk_splitter_add(svk_splitter splitter, svk_context ctx, svk_pipeline pipe, svk_buffer output, float weight);
+
+/* Rebalance a target, e.g. from the measured speed of its device */
+int svk_splitter_set_weight(svk_splitter splitter, int target, float weight);
+
+/* Dispatch every band, then merge them into `merged` (width * height *
+ * pixel_size bytes). Returns 0 if any band failed. */
+int svk_splitter_run(svk_splitter splitter, void* merged);
+
+/* Rows a target rendered in the latest run */
+int svk_splitter_band(svk_splitter splitter, int target, uint32_t* first_row, uint32_t* rows);
+
+/* Free splitter (contexts, pipelines and buffers are the caller's) */
+void svk_free_splitter(svk_splitter splitter);
+
 /* ============================================================================
  * SDF-Specific Helpers (convenience functions for simple_sdf)
  * ============================================================================ */
@@ -157,14 +626,127 @@ typedef struct {
     float _padding[2];  /* Alignment */
 } svk_sdf_push_constants;
 
-/* Create a ready-to-use SDF ray marching pipeline */
+/* Frames an SDF pipeline can keep in flight (each holds a readback slot) */
+#define SVK_SDF_MAX_FRAMES     SVK_READBACK_SLOTS
+#define SVK_SDF_DEFAULT_FRAMES 2
+
+/* Create a ready-to-use SDF ray marching pipeline. The shader must write
+ * binding 0 as an rgba8 storage image and take svk_sdf_push_constants.
+ * Output images are created once; free with svk_free_pipeline. */
 svk_pipeline svk_create_sdf_pipeline(svk_context ctx, const char* shader_path,
                                       uint32_t width, uint32_t height);
 
-/* Render SDF scene to image */
-int svk_render_sdf(svk_context ctx, svk_pipeline pipe,
-                   float cam_x, float cam_y, float cam_z,
-                   float cam_yaw, float cam_pitch, float time);
+/* Same, with 1..SVK_SDF_MAX_FRAMES frames in flight */
+svk_pipeline svk_create_sdf_pipeline_frames(svk_context ctx, const char* shader_path,
+                                            uint32_t width, uint32_t height, uint32_t frames_in_flight);
+
+/* Render the next frame and start copying it to host memory, without
+ * waiting unless all frames are in flight. Returns the frame's ticket for
+ * svk_poll_ticket and svk_read_sdf_frame, or 0 on failure. A frame that is
+ * not read before frames_in_flight newer frames are rendered is dropped. */
+svk_ticket svk_render_sdf(svk_context ctx, svk_pipeline pipe,
+                          float cam_x, float cam_y, float cam_z,
+                          float cam_yaw, float cam_pitch, float time);
+
+/* Copy a rendered frame (width * height * 4 bytes, RGBA8) into data,
+ * waiting for it if needed */
+int svk_read_sdf_frame(svk_context ctx, svk_pipeline pipe, svk_ticket frame, void* data);
+
+/* Output image of an unread frame (to bind as input elsewhere), or NULL */
+svk_image svk_sdf_output_image(svk_pipeline pipe, svk_ticket frame);
+
+/* Tile-culled rendering of a buffer-output SDF shader (binding 0: pixels,
+ * binding 1: camera params with width and height, like
+ * sdf_buffer_output.comp). A classify pass cone-marches each tile_size x
+ * tile_size tile and stores a safe start depth per tile after the pixels;
+ * the march pass starts each pixel there and skips empty tiles. The shader
+ * selects the pass with these specialization constants; `constants` may
+ * carry its others (e.g. quality tiers). */
+#define SVK_SDF_TILE_PASS_ID 3
+#define SVK_SDF_TILE_SIZE_ID 4
+
+svk_tiled_sdf svk_create_tiled_sdf(svk_context ctx, svk_shader shader, const svk_spec_constant* constants,
+                                   uint32_t count, uint32_t tile_size);
+
+/* Bytes the pixel buffer needs: width * height pixels plus one depth per tile */
+uint64_t svk_tiled_sdf_buffer_size(uint32_t width, uint32_t height, uint32_t tile_size);
+
+/* Bind the pixel buffer (at least svk_tiled_sdf_buffer_size) and camera params */
+int svk_tiled_sdf_bind(svk_tiled_sdf sdf, svk_buffer pixels, svk_buffer params);
+
+/* Render both passes in one submission. Returns a ticket, or 0 on failure;
+ * svk_tiled_sdf_render waits. */
+svk_ticket svk_tiled_sdf_render_async(svk_tiled_sdf sdf, uint32_t width, uint32_t height);
+int svk_tiled_sdf_render(svk_tiled_sdf sdf, uint32_t width, uint32_t height);
+
+/* Free both pipelines (bound buffers are the caller's) */
+void svk_free_tiled_sdf(svk_tiled_sdf sdf);
+
+/* ============================================================================
+ * Parallel Primitives (reduce, scan, sort, histogram)
+ *
+ * Buffers hold `count` 32-bit elements of one type. Each call records its
+ * passes into one command list and submits once; the _async variants return
+ * a ticket, or 0 on failure, and the others wait. Scratch buffers are kept
+ * and grown as needed. The kernels use subgroup arithmetic, so creation
+ * fails on devices without it (or with subgroups under 4 invocations).
+ * ============================================================================ */
+
+/* Element types */
+#define SVK_ELEMENT_UINT32  0x01
+#define SVK_ELEMENT_INT32   0x02
+#define SVK_ELEMENT_FLOAT32 0x03
+
+/* Reduce and scan operators */
+#define SVK_REDUCE_SUM 0x01
+#define SVK_REDUCE_MIN 0x02
+#define SVK_REDUCE_MAX 0x03
+
+/* Create from shaders/reduce.spv, scan.spv, radix_sort.spv and histogram.spv.
+ * Returns NULL on failure. The shaders may be freed afterwards. */
+svk_algorithms svk_create_algorithms(svk_context ctx, svk_shader reduce, svk_shader scan,
+                                     svk_shader sort, svk_shader histogram);
+
+/* Combine all of `input` with `op` into the first element of `output`.
+ * Float sums add in a tree, so rounding differs from a sequential sum. */
+int svk_reduce(svk_algorithms algos, svk_buffer input, uint32_t count, uint32_t type, uint32_t op,
+               svk_buffer output);
+svk_ticket svk_reduce_async(svk_algorithms algos, svk_buffer input, uint32_t count, uint32_t type, uint32_t op,
+                            svk_buffer output);
+
+/* Prefix `op` of `input` into `output` (may be the same buffer). Inclusive:
+ * output[i] combines input[0..i]; exclusive: input[0..i-1], identity first. */
+int svk_scan(svk_algorithms algos, svk_buffer input, svk_buffer output, uint32_t count,
+             uint32_t type, uint32_t op, int inclusive);
+svk_ticket svk_scan_async(svk_algorithms algos, svk_buffer input, svk_buffer output, uint32_t count,
+                          uint32_t type, uint32_t op, int inclusive);
+
+/* Stable ascending radix sort of `keys` in place, moving `values` (32-bit,
+ * may be NULL) with them. Float keys order by sign and magnitude, -0 before
+ * +0, NaNs at the ends. */
+int svk_sort(svk_algorithms algos, svk_buffer keys, svk_buffer values, uint32_t count, uint32_t type);
+svk_ticket svk_sort_async(svk_algorithms algos, svk_buffer keys, svk_buffer values, uint32_t count, uint32_t type);
+
+/* Count `input` into `bins` equal bins spanning [lo, hi) and write the
+ * counts to `output` (bins uint32, cleared first). Elements outside are
+ * ignored. Integer bins are a whole number of values wide, rounded up, so
+ * the last bins may lie past `hi`. */
+int svk_histogram(svk_algorithms algos, svk_buffer input, uint32_t count, uint32_t type,
+                  double lo, double hi, uint32_t bins, svk_buffer output);
+svk_ticket svk_histogram_async(svk_algorithms algos, svk_buffer input, uint32_t count, uint32_t type,
+                               double lo, double hi, uint32_t bins, svk_buffer output);
+
+/* CPU versions of the above on host memory, for checking results. Return 1
+ * on success, 0 on bad arguments (or, sorting, when out of memory). */
+int svk_reference_reduce(const void* input, uint32_t count, uint32_t type, uint32_t op, void* result);
+int svk_reference_scan(const void* input, void* output, uint32_t count, uint32_t type, uint32_t op,
+                       int inclusive);
+int svk_reference_sort(void* keys, void* values, uint32_t count, uint32_t type);
+int svk_reference_histogram(const void* input, uint32_t count, uint32_t type, double lo, double hi,
+                            uint32_t bins, uint32_t* output);
+
+/* Free the pipelines and scratch buffers */
+void svk_free_algorithms(svk_algorithms algos);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,473 @@
+/*
+ * svk_bench.c - Benchmark driver for the simple_vulkan C library
+ *
+ * Measures dispatch latency, transfer bandwidth, shader and pipeline
+ * creation time, full-frame SDF render time and the parallel primitives,
+ * and writes the results as JSON. Needs only a Vulkan loader and ICD, so
+ * it also runs on software implementations such as Mesa lavapipe:
+ *
+ *   VK_ICD_FILENAMES=/usr/share/vulkan/icd.d/lvp_icd.x86_64.json ./svk_bench --quick
+ *
+ * Usage: svk_bench [--quick] [--shaders DIR] [--output FILE]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "simple_vulkan.h"
+
+/* ============================================================================
+ * Configuration
+ * ============================================================================ */
+
+typedef struct {
+    int quick;               /* Fewer iterations and smaller transfers for CI */
+    const char* shader_dir;
+    const char* output_path;
+} bench_options;
+
+/* Empty compute kernel (shaders/empty.comp, local_size_x = 64), embedded so
+   the latency test needs no files */
+static const uint32_t empty_kernel[] = {
+    0x07230203, 0x00010000, 0x00000000, 0x00000005, 0x00000000,
+    0x00020011, 0x00000001,                                      /* OpCapability Shader */
+    0x0003000e, 0x00000000, 0x00000001,                          /* OpMemoryModel Logical GLSL450 */
+    0x0005000f, 0x00000005, 0x00000001, 0x6e69616d, 0x00000000,  /* OpEntryPoint GLCompute %1 "main" */
+    0x00060010, 0x00000001, 0x00000011, 0x00000040, 0x00000001, 0x00000001, /* LocalSize 64 1 1 */
+    0x00020013, 0x00000002,                                      /* %2 = OpTypeVoid */
+    0x00030021, 0x00000003, 0x00000002,                          /* %3 = OpTypeFunction %2 */
+    0x00050036, 0x00000002, 0x00000001, 0x00000000, 0x00000003,  /* %1 = OpFunction %2 None %3 */
+    0x000200f8, 0x00000004,                                      /* OpLabel */
+    0x000100fd,                                                  /* OpReturn */
+    0x00010038                                                   /* OpFunctionEnd */
+};
+
+/* ============================================================================
+ * Statistics and JSON Output
+ * ============================================================================ */
+
+typedef struct {
+    double* values;
+    uint32_t count;
+    uint32_t capacity;
+} bench_samples;
+
+typedef struct {
+    double min, median, p99, mean;
+} bench_stats;
+
+static FILE* out;
+static int result_count;
+
+static int samples_init(bench_samples* s, uint32_t capacity) {
+    s->values = (double*)malloc(capacity * sizeof(double));
+    s->count = 0;
+    s->capacity = capacity;
+    return s->values != NULL;
+}
+
+static void samples_add(bench_samples* s, double value) {
+    if (s->count < s->capacity) s->values[s->count++] = value;
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentiles over the sorted samples */
+static bench_stats samples_stats(bench_samples* s) {
+    bench_stats st = { 0 };
+    if (s->count == 0) return st;
+
+    qsort(s->values, s->count, sizeof(double), compare_double);
+    double sum = 0;
+    for (uint32_t i = 0; i < s->count; i++) sum += s->values[i];
+
+    uint32_t p99_rank = (99 * s->count + 99) / 100;
+    st.min = s->values[0];
+    st.median = s->values[(s->count - 1) / 2];
+    st.p99 = s->values[p99_rank > 0 ? p99_rank - 1 : 0];
+    st.mean = sum / s->count;
+    return st;
+}
+
+static double elapsed_us(uint64_t start) {
+    return (double)(svk_time_ns() - start) / 1000.0;
+}
+
+/* One entry of the "results" array. `params` is extra JSON members
+   (e.g. "\"bytes\": 4096") or NULL. */
+static void emit_result(const char* name, const char* params, const char* unit,
+                        bench_samples* samples) {
+    bench_stats st = samples_stats(samples);
+    fprintf(out, "%s\n    {\"name\": \"%s\", ", result_count++ ? "," : "", name);
+    if (params) fprintf(out, "%s, ", params);
+    fprintf(out, "\"unit\": \"%s\", \"samples\": %u, \"min\": %.3f, \"median\": %.3f, "
+                 "\"p99\": %.3f, \"mean\": %.3f}",
+            unit, samples->count, st.min, st.median, st.p99, st.mean);
+}
+
+static void emit_json_string(const char* s) {
+    fputc('"', out);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') fputc('\\', out);
+        if ((unsigned char)*s >= 0x20) fputc(*s, out);
+    }
+    fputc('"', out);
+}
+
+static void warn(const char* what, const char* detail) {
+    fprintf(stderr, "svk_bench: skipped %s (%s)\n", what, detail);
+}
+
+/* ============================================================================
+ * Benchmarks
+ * ============================================================================ */
+
+/* Round trip of an empty dispatch, and the cost of submitting one */
+static void bench_dispatch_latency(svk_context ctx, const bench_options* opt) {
+    uint32_t iterations = opt->quick ? 100 : 1000;
+    svk_shader shader = svk_load_shader_memory(ctx, empty_kernel, sizeof(empty_kernel));
+    svk_pipeline pipe = shader ? svk_create_pipeline(ctx, shader) : NULL;
+    bench_samples round_trip, submit;
+
+    if (!pipe || !samples_init(&round_trip, iterations) || !samples_init(&submit, iterations)) {
+        warn("dispatch_latency", "empty kernel pipeline");
+        svk_free_shader(ctx, shader);
+        return;
+    }
+
+    svk_dispatch(ctx, pipe, 1, 1, 1);  /* Warm up */
+    for (uint32_t i = 0; i < iterations; i++) {
+        uint64_t start = svk_time_ns();
+        svk_ticket ticket = svk_dispatch_async(ctx, pipe, 1, 1, 1);
+        samples_add(&submit, elapsed_us(start));
+        svk_wait_ticket(ctx, ticket);
+        samples_add(&round_trip, elapsed_us(start));
+    }
+
+    emit_result("dispatch_latency", NULL, "us", &round_trip);
+    emit_result("dispatch_submit", NULL, "us", &submit);
+
+    free(round_trip.values);
+    free(submit.values);
+    svk_free_pipeline(ctx, pipe);
+    svk_free_shader(ctx, shader);
+}
+
+/* Upload and download throughput for host-visible and device-local buffers */
+static void bench_bandwidth(svk_context ctx, const bench_options* opt) {
+    static const uint64_t sizes[] = { 4096, 65536, 1 << 20, 16 << 20, 64 << 20 };
+    static const struct { const char* name; uint32_t flags; } placements[] = {
+        { "host", 0 },
+        { "device_local", SVK_BUFFER_DEVICE_LOCAL }
+    };
+    uint32_t size_count = opt->quick ? 4 : 5;
+    uint32_t iterations = opt->quick ? 5 : 20;
+    uint64_t max_size = sizes[size_count - 1];
+    char params[128];
+
+    void* host = malloc(max_size);
+    if (!host) return;
+    memset(host, 0x5a, max_size);
+
+    for (int p = 0; p < 2; p++) {
+        for (uint32_t s = 0; s < size_count; s++) {
+            uint64_t size = sizes[s];
+            svk_buffer buf = svk_create_buffer(ctx, size, SVK_BUFFER_STORAGE | placements[p].flags);
+            bench_samples up, down;
+            if (!buf || !samples_init(&up, iterations) || !samples_init(&down, iterations)) {
+                warn("bandwidth", "buffer creation");
+                svk_free_buffer(ctx, buf);
+                continue;
+            }
+
+            for (uint32_t i = 0; i < iterations; i++) {
+                uint64_t start = svk_time_ns();
+                if (!svk_upload_buffer(ctx, buf, host, size, 0)) break;
+                samples_add(&up, (double)size / (double)(svk_time_ns() - start));  /* bytes/ns = GB/s */
+
+                start = svk_time_ns();
+                if (!svk_download_buffer(ctx, buf, host, size, 0)) break;
+                samples_add(&down, (double)size / (double)(svk_time_ns() - start));
+            }
+
+            snprintf(params, sizeof(params), "\"placement\": \"%s\", \"bytes\": %llu",
+                     placements[p].name, (unsigned long long)size);
+            emit_result("upload_bandwidth", params, "GB/s", &up);
+            emit_result("download_bandwidth", params, "GB/s", &down);
+
+            free(up.values);
+            free(down.values);
+            svk_free_buffer(ctx, buf);
+        }
+    }
+    free(host);
+}
+
+/* Shader module and pipeline creation. Every iteration frees what it made,
+   so each load creates a module and each pipeline is compiled again (the
+   driver's pipeline cache may still help). */
+static void bench_creation(svk_context ctx, const bench_options* opt, const char* spv_path) {
+    uint32_t iterations = opt->quick ? 10 : 50;
+    bench_samples shader_times, pipeline_times;
+
+    if (!samples_init(&shader_times, iterations) || !samples_init(&pipeline_times, iterations)) return;
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        uint64_t start = svk_time_ns();
+        svk_shader shader = svk_load_shader(ctx, spv_path);
+        if (!shader) {
+            warn("shader_create", spv_path);
+            break;
+        }
+        samples_add(&shader_times, elapsed_us(start));
+
+        start = svk_time_ns();
+        svk_pipeline pipe = svk_create_pipeline(ctx, shader);
+        if (pipe) samples_add(&pipeline_times, elapsed_us(start));
+
+        svk_free_pipeline(ctx, pipe);
+        svk_free_shader(ctx, shader);
+    }
+
+    if (shader_times.count) emit_result("shader_create", NULL, "us", &shader_times);
+    if (pipeline_times.count) emit_result("pipeline_create", NULL, "us", &pipeline_times);
+    free(shader_times.values);
+    free(pipeline_times.values);
+}
+
+/* CameraParams block of sdf_buffer_output.comp */
+typedef struct {
+    float cam_x, cam_y, cam_z, cam_yaw, cam_pitch, time;
+    uint32_t width, height;
+} bench_camera;
+
+/* Full frames of the buffer-output SDF renderer: wall-clock round trip and,
+   where the queue supports timestamps, GPU execution time */
+static void bench_sdf_frames(svk_context ctx, const bench_options* opt, const char* spv_path) {
+    static const uint32_t resolutions[][2] = { { 1280, 720 }, { 1920, 1080 }, { 3840, 2160 } };
+    uint32_t frames = opt->quick ? 3 : 20;
+    char params[64];
+
+    svk_shader shader = svk_load_shader(ctx, spv_path);
+    svk_pipeline pipe = shader ? svk_create_pipeline(ctx, shader) : NULL;
+    if (!pipe) {
+        warn("sdf_frame", spv_path);
+        svk_free_shader(ctx, shader);
+        return;
+    }
+
+    for (int r = 0; r < 3; r++) {
+        uint32_t w = resolutions[r][0], h = resolutions[r][1];
+        bench_camera camera = { 0.0f, 1.5f, 5.0f, 0.0f, 0.0f, 0.0f, w, h };
+        svk_buffer pixels = svk_create_buffer(ctx, (uint64_t)w * h * 4, SVK_BUFFER_STORAGE | SVK_BUFFER_DEVICE_LOCAL);
+        svk_buffer params_buf = svk_create_buffer(ctx, sizeof(camera), SVK_BUFFER_STORAGE);
+        bench_samples wall, gpu;
+
+        if (!pixels || !params_buf || !samples_init(&wall, frames) || !samples_init(&gpu, frames) ||
+            !svk_upload_buffer(ctx, params_buf, &camera, sizeof(camera), 0) ||
+            !svk_bind_buffer(pipe, 0, pixels) || !svk_bind_buffer(pipe, 1, params_buf)) {
+            warn("sdf_frame", "buffers");
+            svk_free_buffer(ctx, pixels);
+            svk_free_buffer(ctx, params_buf);
+            continue;
+        }
+
+        svk_dispatch_threads(ctx, pipe, w, h, 1);  /* Warm up */
+        int profiling = svk_enable_profiling(ctx, frames);
+        for (uint32_t i = 0; i < frames; i++) {
+            uint64_t start = svk_time_ns();
+            if (!svk_dispatch_threads(ctx, pipe, w, h, 1)) break;
+            samples_add(&wall, elapsed_us(start) / 1000.0);
+        }
+
+        if (profiling) {
+            svk_gpu_sample samples[64];
+            uint32_t n;
+            while ((n = svk_collect_gpu_samples(ctx, samples, 64)) > 0) {
+                for (uint32_t i = 0; i < n; i++) samples_add(&gpu, (double)samples[i].gpu_ns / 1e6);
+            }
+            svk_disable_profiling(ctx);
+        }
+
+        snprintf(params, sizeof(params), "\"width\": %u, \"height\": %u", w, h);
+        emit_result("sdf_frame", params, "ms", &wall);
+        if (gpu.count) emit_result("sdf_frame_gpu", params, "ms", &gpu);
+
+        free(wall.values);
+        free(gpu.values);
+        svk_free_buffer(ctx, pixels);
+        svk_free_buffer(ctx, params_buf);
+    }
+
+    svk_free_pipeline(ctx, pipe);
+    svk_free_shader(ctx, shader);
+}
+
+/* The same frames rendered tile-culled (svk_create_tiled_sdf, 16x16 tiles) */
+static void bench_tiled_sdf_frames(svk_context ctx, const bench_options* opt, const char* spv_path) {
+    static const uint32_t resolutions[][2] = { { 1280, 720 }, { 1920, 1080 }, { 3840, 2160 } };
+    uint32_t frames = opt->quick ? 3 : 20;
+    char params[64];
+
+    svk_shader shader = svk_load_shader(ctx, spv_path);
+    svk_tiled_sdf sdf = shader ? svk_create_tiled_sdf(ctx, shader, NULL, 0, 16) : NULL;
+    if (!sdf) {
+        warn("sdf_frame_tiled", spv_path);
+        svk_free_shader(ctx, shader);
+        return;
+    }
+
+    for (int r = 0; r < 3; r++) {
+        uint32_t w = resolutions[r][0], h = resolutions[r][1];
+        bench_camera camera = { 0.0f, 1.5f, 5.0f, 0.0f, 0.0f, 0.0f, w, h };
+        svk_buffer pixels = svk_create_buffer(ctx, svk_tiled_sdf_buffer_size(w, h, 16),
+                                              SVK_BUFFER_STORAGE | SVK_BUFFER_DEVICE_LOCAL);
+        svk_buffer params_buf = svk_create_buffer(ctx, sizeof(camera), SVK_BUFFER_STORAGE);
+        bench_samples wall;
+
+        if (!pixels || !params_buf || !samples_init(&wall, frames) ||
+            !svk_upload_buffer(ctx, params_buf, &camera, sizeof(camera), 0) ||
+            !svk_tiled_sdf_bind(sdf, pixels, params_buf)) {
+            warn("sdf_frame_tiled", "buffers");
+            svk_free_buffer(ctx, pixels);
+            svk_free_buffer(ctx, params_buf);
+            continue;
+        }
+
+        svk_tiled_sdf_render(sdf, w, h);  /* Warm up */
+        for (uint32_t i = 0; i < frames; i++) {
+            uint64_t start = svk_time_ns();
+            if (!svk_tiled_sdf_render(sdf, w, h)) break;
+            samples_add(&wall, elapsed_us(start) / 1000.0);
+        }
+
+        snprintf(params, sizeof(params), "\"width\": %u, \"height\": %u", w, h);
+        emit_result("sdf_frame_tiled", params, "ms", &wall);
+
+        free(wall.values);
+        svk_free_buffer(ctx, pixels);
+        svk_free_buffer(ctx, params_buf);
+    }
+
+    svk_free_tiled_sdf(sdf);
+    svk_free_shader(ctx, shader);
+}
+
+/* Reduce, scan, sort and histogram of uint32 elements (svk_create_algorithms) */
+static void bench_algorithms(svk_context ctx, const bench_options* opt) {
+    static const char* kernels[] = { "reduce", "scan", "radix_sort", "histogram" };
+    uint32_t count = opt->quick ? (1u << 20) : (1u << 24);
+    uint32_t iterations = opt->quick ? 3 : 20;
+    svk_shader shaders[4] = { NULL };
+    char path[1024], params[64];
+
+    for (int k = 0; k < 4; k++) {
+        snprintf(path, sizeof(path), "%s/%s.spv", opt->shader_dir, kernels[k]);
+        shaders[k] = svk_load_shader(ctx, path);
+    }
+    svk_algorithms algos = shaders[0] && shaders[1] && shaders[2] && shaders[3]
+        ? svk_create_algorithms(ctx, shaders[0], shaders[1], shaders[2], shaders[3]) : NULL;
+    for (int k = 0; k < 4; k++) svk_free_shader(ctx, shaders[k]);
+    if (!algos) {
+        warn("algorithms", "shaders or subgroup support");
+        return;
+    }
+
+    uint64_t bytes = (uint64_t)count * sizeof(uint32_t);
+    uint32_t* data = (uint32_t*)malloc(bytes);
+    svk_buffer input = svk_create_buffer(ctx, bytes, SVK_BUFFER_STORAGE | SVK_BUFFER_DEVICE_LOCAL);
+    svk_buffer output = svk_create_buffer(ctx, bytes, SVK_BUFFER_STORAGE | SVK_BUFFER_DEVICE_LOCAL);
+    if (data) {
+        uint32_t x = 12345;
+        for (uint32_t i = 0; i < count; i++) data[i] = x = x * 1664525u + 1013904223u;
+    }
+    if (!data || !input || !output || !svk_upload_buffer(ctx, input, data, bytes, 0)) {
+        warn("algorithms", "buffers");
+        free(data);
+        svk_free_buffer(ctx, input);
+        svk_free_buffer(ctx, output);
+        svk_free_algorithms(algos);
+        return;
+    }
+    snprintf(params, sizeof(params), "\"elements\": %u", count);
+
+    /* Each operation once to warm up (and size the scratch), then timed */
+    for (int op = 0; op < 4; op++) {
+        bench_samples wall;
+        if (!samples_init(&wall, iterations)) break;
+
+        for (uint32_t i = 0; i <= iterations; i++) {
+            uint64_t start = svk_time_ns();
+            int ok = op == 0 ? svk_reduce(algos, input, count, SVK_ELEMENT_UINT32, SVK_REDUCE_SUM, output)
+                   : op == 1 ? svk_scan(algos, input, output, count, SVK_ELEMENT_UINT32, SVK_REDUCE_SUM, 0)
+                   : op == 2 ? svk_sort(algos, output, NULL, count, SVK_ELEMENT_UINT32)
+                   : svk_histogram(algos, input, count, SVK_ELEMENT_UINT32, 0.0, 4294967296.0, 256, output);
+            if (!ok) break;
+            if (i > 0) samples_add(&wall, elapsed_us(start) / 1000.0);
+        }
+
+        emit_result(op == 0 ? "reduce" : op == 1 ? "scan" : op == 2 ? "sort" : "histogram", params, "ms", &wall);
+        free(wall.values);
+    }
+
+    free(data);
+    svk_free_buffer(ctx, input);
+    svk_free_buffer(ctx, output);
+    svk_free_algorithms(algos);
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+int main(int argc, char** argv) {
+    bench_options opt = { 0, "shaders", NULL };
+    char spv_path[1024];
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) opt.quick = 1;
+        else if (strcmp(argv[i], "--shaders") == 0 && i + 1 < argc) opt.shader_dir = argv[++i];
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) opt.output_path = argv[++i];
+        else {
+            fprintf(stderr, "usage: %s [--quick] [--shaders DIR] [--output FILE]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    out = opt.output_path ? fopen(opt.output_path, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "svk_bench: cannot write %s\n", opt.output_path);
+        return 2;
+    }
+
+    svk_context ctx = svk_init();
+    if (!ctx) {
+        fprintf(out, "{\"error\": \"no Vulkan device\"}\n");
+        if (out != stdout) fclose(out);
+        return 1;
+    }
+
+    fprintf(out, "{\n  \"driver\": \"c\",\n  \"device\": ");
+    emit_json_string(svk_get_device_name(ctx));
+    fprintf(out, ",\n  \"vendor_id\": %u,\n  \"discrete\": %s,\n  \"quick\": %s,\n  \"results\": [",
+            svk_get_vendor_id(ctx), svk_is_discrete_gpu(ctx) ? "true" : "false",
+            opt.quick ? "true" : "false");
+
+    snprintf(spv_path, sizeof(spv_path), "%s/sdf_buffer_output.spv", opt.shader_dir);
+
+    bench_dispatch_latency(ctx, &opt);
+    bench_bandwidth(ctx, &opt);
+    bench_creation(ctx, &opt, spv_path);
+    bench_sdf_frames(ctx, &opt, spv_path);
+    bench_tiled_sdf_frames(ctx, &opt, spv_path);
+    bench_algorithms(ctx, &opt);
+
+    fprintf(out, "\n  ]\n}\n");
+    if (out != stdout) fclose(out);
+
+    svk_cleanup(ctx);
+    return 0;
+}
@@ -0,0 +1,481 @@
+note
+	description: "[
+		Benchmark application for simple_vulkan library.
+
+		Measures dispatch latency, transfer bandwidth, shader and
+		pipeline creation time, full-frame SDF render time and the
+		parallel primitives through the Eiffel wrappers, and prints the results as JSON in the same
+		shape as the C driver (Clib/svk_bench.c).
+
+		Run from the library root so shaders/ is found:
+			simple_vulkan_benchmarks [--quick]
+	]"
+	author: "Larry Rix"
+	date: "$Date$"
+	revision: "$Revision$"
+
+class
+	BENCHMARK_APP
+
+inherit
+	ARGUMENTS_32
+
+create
+	make
+
+feature {NONE} -- Initialization
+
+	make
+			-- Run benchmarks and print JSON results.
+		do
+			create vk
+			is_quick := argument_count >= 1 and then argument (1).same_string ("--quick")
+			create output.make (4096)
+			context := vk.create_context
+			if context.is_valid then
+				output.append ("{%N  %"driver%": %"eiffel%",%N  %"device%": ")
+				append_json_string (context.device_name)
+				output.append (",%N  %"vendor_id%": " + context.vendor_id.out)
+				output.append (",%N  %"discrete%": " + context.is_discrete_gpu.out.as_lower)
+				output.append (",%N  %"quick%": " + is_quick.out.as_lower)
+				output.append (",%N  %"results%": [")
+				bench_dispatch_latency
+				bench_bandwidth
+				bench_creation
+				bench_sdf_frames
+				bench_tiled_sdf_frames
+				bench_algorithms
+				output.append ("%N  ]%N}%N")
+				context.dispose
+			else
+				output.append ("{%"error%": %"no Vulkan device%"}%N")
+			end
+			print (output)
+		end
+
+feature -- Access
+
+	vk: SIMPLE_VULKAN
+			-- Library facade
+
+	context: VULKAN_CONTEXT
+			-- Context being measured
+
+	is_quick: BOOLEAN
+			-- Fewer iterations and smaller transfers (for CI)
+
+	output: STRING
+			-- JSON document being built
+
+feature -- Benchmarks
+
+	bench_dispatch_latency
+			-- Round trip of an empty dispatch, and the cost of submitting one.
+		local
+			shader: VULKAN_SHADER
+			pipeline: VULKAN_PIPELINE
+			round_trip, submit: ARRAYED_LIST [REAL_64]
+			start: NATURAL_64
+			ticket: NATURAL_64
+			i, n: INTEGER
+			ok: BOOLEAN
+		do
+			shader := vk.load_shader (context, Shader_dir + "empty.spv")
+			if shader.is_valid then
+				pipeline := vk.create_pipeline (context, shader)
+				if pipeline.is_valid then
+					n := iterations (100, 1000)
+					create round_trip.make (n)
+					create submit.make (n)
+					ok := pipeline.dispatch (context, 1, 1, 1)
+					from i := 1 until i > n loop
+						start := vk.host_time_ns
+						ticket := pipeline.dispatch_async (context, 1, 1, 1)
+						submit.extend (microseconds_since (start))
+						if ticket > 0 then
+							ok := pipeline.wait_ticket (context, ticket)
+						end
+						round_trip.extend (microseconds_since (start))
+						i := i + 1
+					end
+					emit ("dispatch_latency", Void, "us", round_trip)
+					emit ("dispatch_submit", Void, "us", submit)
+					pipeline.dispose
+				end
+			else
+				io.error.put_string ("benchmark: skipped dispatch_latency (shaders/empty.spv)%N")
+			end
+			shader.dispose
+		end
+
+	bench_bandwidth
+			-- Upload and download throughput for host-visible and device-local buffers.
+		local
+			sizes: ARRAY [INTEGER]
+			placements: ARRAY [INTEGER]
+			host: MANAGED_POINTER
+			buf: VULKAN_BUFFER
+			up, down: ARRAYED_LIST [REAL_64]
+			start: NATURAL_64
+			p, s, i, n, l_size, l_count: INTEGER
+			params: STRING
+		do
+			sizes := <<4096, 65536, 1048576, 16777216, 67108864>>
+			placements := <<0, vk.Buffer_device_local>>
+			if is_quick then
+				l_count := 4
+			else
+				l_count := 5
+			end
+			n := iterations (5, 20)
+			create host.make (sizes [l_count])
+			from p := 1 until p > 2 loop
+				from s := 1 until s > l_count loop
+					l_size := sizes [s]
+					buf := vk.create_buffer (context, l_size, vk.Buffer_storage | placements [p])
+					if buf.is_valid then
+						create up.make (n)
+						create down.make (n)
+						from i := 1 until i > n loop
+							start := vk.host_time_ns
+							if buf.upload (host.item, l_size, 0) then
+								up.extend (l_size.to_double / (vk.host_time_ns - start).to_real_64)
+							end
+							start := vk.host_time_ns
+							if buf.download (host.item, l_size, 0) then
+								down.extend (l_size.to_double / (vk.host_time_ns - start).to_real_64)
+							end
+							i := i + 1
+						end
+						if p = 1 then
+							params := "%"placement%": %"host%", %"bytes%": " + l_size.out
+						else
+							params := "%"placement%": %"device_local%", %"bytes%": " + l_size.out
+						end
+						emit ("upload_bandwidth", params, "GB/s", up)
+						emit ("download_bandwidth", params, "GB/s", down)
+					end
+					buf.dispose
+					s := s + 1
+				end
+				p := p + 1
+			end
+		end
+
+	bench_creation
+			-- Shader module and pipeline creation; each iteration frees what it made.
+		local
+			shader: VULKAN_SHADER
+			pipeline: VULKAN_PIPELINE
+			shader_times, pipeline_times: ARRAYED_LIST [REAL_64]
+			start: NATURAL_64
+			i, n: INTEGER
+		do
+			n := iterations (10, 50)
+			create shader_times.make (n)
+			create pipeline_times.make (n)
+			from i := 1 until i > n loop
+				start := vk.host_time_ns
+				shader := vk.load_shader (context, Shader_dir + "sdf_buffer_output.spv")
+				if shader.is_valid then
+					shader_times.extend (microseconds_since (start))
+					start := vk.host_time_ns
+					pipeline := vk.create_pipeline (context, shader)
+					if pipeline.is_valid then
+						pipeline_times.extend (microseconds_since (start))
+					end
+					pipeline.dispose
+				end
+				shader.dispose
+				i := i + 1
+			end
+			if not shader_times.is_empty then
+				emit ("shader_create", Void, "us", shader_times)
+				emit ("pipeline_create", Void, "us", pipeline_times)
+			end
+		end
+
+	bench_sdf_frames
+			-- Full frames of the buffer-output SDF renderer at 720p, 1080p and 4K:
+			-- wall-clock round trip and, where supported, GPU execution time.
+		local
+			shader: VULKAN_SHADER
+			pipeline: VULKAN_PIPELINE
+			profiler: VULKAN_PROFILER
+			pixels_buf, params_buf: VULKAN_BUFFER
+			widths, heights: ARRAY [INTEGER]
+			wall: ARRAYED_LIST [REAL_64]
+			start: NATURAL_64
+			r, i, n, w, h: INTEGER
+			params: STRING
+			ok: BOOLEAN
+		do
+			widths := <<1280, 1920, 3840>>
+			heights := <<720, 1080, 2160>>
+			n := iterations (3, 20)
+			shader := vk.load_shader (context, Shader_dir + "sdf_buffer_output.spv")
+			if shader.is_valid then
+				pipeline := vk.create_pipeline (context, shader)
+				if pipeline.is_valid then
+					from r := 1 until r > 3 loop
+						w := widths [r]
+						h := heights [r]
+						pixels_buf := vk.create_buffer (context, w * h * 4, vk.Buffer_storage | vk.Buffer_device_local)
+						params_buf := vk.create_buffer (context, 32, vk.Buffer_storage)
+						ok := pixels_buf.is_valid and params_buf.is_valid
+							and then params_buf.upload (camera_params (w, h).item, 32, 0)
+							and then pipeline.bind_buffer (0, pixels_buf)
+							and then pipeline.bind_buffer (1, params_buf)
+							and then pipeline.dispatch_threads (context, w, h, 1)
+						if ok then
+							create wall.make (n)
+							profiler := vk.create_profiler (context, n)
+							if profiler.is_valid then
+								profiler.set_label ("sdf")
+							end
+							from i := 1 until i > n loop
+								start := vk.host_time_ns
+								if pipeline.dispatch_threads (context, w, h, 1) then
+									wall.extend (microseconds_since (start) / 1000.0)
+								end
+								i := i + 1
+							end
+							params := "%"width%": " + w.out + ", %"height%": " + h.out
+							emit ("sdf_frame", params, "ms", wall)
+							if profiler.is_valid then
+								profiler.collect
+								if profiler.sample_count ("sdf") > 0 then
+									emit_stats ("sdf_frame_gpu", params, "ms", profiler.sample_count ("sdf"),
+										profiler.minimum_ms ("sdf"), profiler.percentile_ms ("sdf", 50),
+										profiler.p99_ms ("sdf"), profiler.average_ms ("sdf"))
+								end
+							end
+							profiler.dispose
+						end
+						pixels_buf.dispose
+						params_buf.dispose
+						r := r + 1
+					end
+					pipeline.dispose
+				end
+			else
+				io.error.put_string ("benchmark: skipped sdf_frame (shaders/sdf_buffer_output.spv)%N")
+			end
+			shader.dispose
+		end
+
+	bench_tiled_sdf_frames
+			-- The same frames rendered tile-culled with 16x16 tiles.
+		local
+			shader: VULKAN_SHADER
+			sdf: VULKAN_TILED_SDF
+			pixels_buf, params_buf: VULKAN_BUFFER
+			widths, heights: ARRAY [INTEGER]
+			wall: ARRAYED_LIST [REAL_64]
+			start: NATURAL_64
+			r, i, n, w, h: INTEGER
+			ok: BOOLEAN
+		do
+			widths := <<1280, 1920, 3840>>
+			heights := <<720, 1080, 2160>>
+			n := iterations (3, 20)
+			shader := vk.load_shader (context, Shader_dir + "sdf_buffer_output.spv")
+			if shader.is_valid then
+				sdf := vk.create_tiled_sdf (context, shader, create {VULKAN_SPEC_CONSTANTS}.make, 16)
+				if sdf.is_valid then
+					from r := 1 until r > 3 loop
+						w := widths [r]
+						h := heights [r]
+						pixels_buf := vk.create_buffer (context, sdf.buffer_size (w, h), vk.Buffer_storage | vk.Buffer_device_local)
+						params_buf := vk.create_buffer (context, 32, vk.Buffer_storage)
+						ok := pixels_buf.is_valid and params_buf.is_valid
+							and then params_buf.upload (camera_params (w, h).item, 32, 0)
+							and then sdf.bind (pixels_buf, params_buf)
+							and then sdf.render (w, h)
+						if ok then
+							create wall.make (n)
+							from i := 1 until i > n loop
+								start := vk.host_time_ns
+								if sdf.render (w, h) then
+									wall.extend (microseconds_since (start) / 1000.0)
+								end
+								i := i + 1
+							end
+							emit ("sdf_frame_tiled", "%"width%": " + w.out + ", %"height%": " + h.out, "ms", wall)
+						end
+						pixels_buf.dispose
+						params_buf.dispose
+						r := r + 1
+					end
+					sdf.dispose
+				end
+			else
+				io.error.put_string ("benchmark: skipped sdf_frame_tiled (shaders/sdf_buffer_output.spv)%N")
+			end
+			shader.dispose
+		end
+
+	bench_algorithms
+			-- Reduce, scan, sort and histogram of NATURAL_32 elements.
+		local
+			algos: VULKAN_ALGORITHMS
+			input_buf, output_buf: VULKAN_BUFFER
+			data: MANAGED_POINTER
+			names: ARRAY [STRING]
+			wall: ARRAYED_LIST [REAL_64]
+			start: NATURAL_64
+			x: NATURAL_32
+			op, i, n, count: INTEGER
+			ok: BOOLEAN
+		do
+			if is_quick then
+				count := 1 |<< 20
+			else
+				count := 1 |<< 24
+			end
+			n := iterations (3, 20)
+			names := <<"reduce", "scan", "sort", "histogram">>
+			algos := vk.create_algorithms (context, "shaders")
+			if algos.is_valid then
+				create data.make (count * 4)
+				x := 12345
+				from i := 0 until i >= count loop
+					x := x * 1664525 + 1013904223
+					data.put_natural_32 (x, i * 4)
+					i := i + 1
+				end
+				input_buf := vk.create_buffer (context, count * 4, vk.Buffer_storage | vk.Buffer_device_local)
+				output_buf := vk.create_buffer (context, count * 4, vk.Buffer_storage | vk.Buffer_device_local)
+				if input_buf.is_valid and output_buf.is_valid and then input_buf.upload (data.item, count * 4, 0) then
+						-- Each operation once to warm up (and size the scratch), then timed
+					from op := 1 until op > 4 loop
+						create wall.make (n)
+						from i := 0 until i > n loop
+							start := vk.host_time_ns
+							inspect op
+							when 1 then
+								ok := algos.reduce (input_buf, count, algos.Element_uint32, algos.Reduce_sum, output_buf)
+							when 2 then
+								ok := algos.scan (input_buf, output_buf, count, algos.Element_uint32, algos.Reduce_sum, False)
+							when 3 then
+								ok := algos.sort (output_buf, count, algos.Element_uint32)
+							else
+								ok := algos.histogram (input_buf, count, algos.Element_uint32, 0.0, 4294967296.0, 256, output_buf)
+							end
+							if ok and i > 0 then
+								wall.extend (microseconds_since (start) / 1000.0)
+							end
+							i := i + 1
+						end
+						emit (names [op], "%"elements%": " + count.out, "ms", wall)
+						op := op + 1
+					end
+				end
+				input_buf.dispose
+				output_buf.dispose
+				algos.dispose
+			else
+				io.error.put_string ("benchmark: skipped algorithms (shaders or subgroup support)%N")
+			end
+		end
+
+feature -- Constants
+
+	Shader_dir: STRING = "shaders/"
+			-- Location of compiled shaders, relative to the working directory
+
+feature {NONE} -- Implementation
+
+	result_count: INTEGER
+			-- Results written so far
+
+	iterations (a_quick, a_full: INTEGER): INTEGER
+			-- `a_quick` in quick mode, otherwise `a_full`
+		do
+			if is_quick then
+				Result := a_quick
+			else
+				Result := a_full
+			end
+		end
+
+	microseconds_since (a_start: NATURAL_64): REAL_64
+			-- Host time elapsed since `a_start`, in microseconds
+		do
+			Result := (vk.host_time_ns - a_start).to_real_64 / 1000.0
+		end
+
+	camera_params (a_width, a_height: INTEGER): MANAGED_POINTER
+			-- CameraParams block for shaders/sdf_buffer_output.spv
+		do
+			create Result.make (32)
+			Result.put_real_32 ({REAL_32} 0.0, 0)
+			Result.put_real_32 ({REAL_32} 1.5, 4)
+			Result.put_real_32 ({REAL_32} 5.0, 8)
+			Result.put_natural_32 (a_width.to_natural_32, 24)
+			Result.put_natural_32 (a_height.to_natural_32, 28)
+		end
+
+	emit (a_name: STRING; a_params: detachable STRING; a_unit: STRING; a_samples: ARRAYED_LIST [REAL_64])
+			-- Append a result with nearest-rank statistics of `a_samples`.
+		local
+			l_sorted: ARRAY [REAL_64]
+			l_sum: REAL_64
+			i, j: INTEGER
+			l_value: REAL_64
+		do
+			create l_sorted.make_filled (0.0, 1, a_samples.count)
+			from i := 1 until i > a_samples.count loop
+					-- Insertion sort; sample counts are small
+				l_value := a_samples [i]
+				l_sum := l_sum + l_value
+				from j := i - 1 until j < 1 or else l_sorted [j] <= l_value loop
+					l_sorted [j + 1] := l_sorted [j]
+					j := j - 1
+				end
+				l_sorted [j + 1] := l_value
+				i := i + 1
+			end
+			if a_samples.is_empty then
+				emit_stats (a_name, a_params, a_unit, 0, 0.0, 0.0, 0.0, 0.0)
+			else
+				emit_stats (a_name, a_params, a_unit, a_samples.count, l_sorted [1],
+					l_sorted [(a_samples.count + 1) // 2],
+					l_sorted [((99 * a_samples.count + 99) // 100).max (1)],
+					l_sum / a_samples.count)
+			end
+		end
+
+	emit_stats (a_name: STRING; a_params: detachable STRING; a_unit: STRING; a_count: INTEGER;
+			a_min, a_median, a_p99, a_mean: REAL_64)
+			-- Append one entry of the "results" array.
+		do
+			if result_count > 0 then
+				output.append (",")
+			end
+			result_count := result_count + 1
+			output.append ("%N    {%"name%": %"" + a_name + "%", ")
+			if attached a_params as l_params then
+				output.append (l_params + ", ")
+			end
+			output.append ("%"unit%": %"" + a_unit + "%", %"samples%": " + a_count.out)
+			output.append (", %"min%": " + a_min.out + ", %"median%": " + a_median.out)
+			output.append (", %"p99%": " + a_p99.out + ", %"mean%": " + a_mean.out + "}")
+		end
+
+	append_json_string (a_text: STRING)
+			-- Append `a_text` as a JSON string literal.
+		do
+			output.append_character ('"')
+			across a_text as c loop
+				if c.item = '"' or c.item = '\' then
+					output.append_character ('\')
+				end
+				if c.item.code >= 32 then
+					output.append_character (c.item)
+				end
+			end
+			output.append_character ('"')
+		end
+
+end
@@ -8,6 +8,8 @@ REM   1. Vulkan SDK installed (download from https://vulkan.lunarg.com/sdk/home)
 REM   2. VULKAN_SDK environment variable set (installer does this automatically)
 REM   3. Visual Studio C++ Build Tools or Visual Studio with C++ workload
 REM
+REM The shaders in shaders\*.spv are rebuilt with the SDK's glslc.
+REM
 REM Usage:
 REM   1. Open "x64 Native Tools Command Prompt for VS 2022" (or your VS version)
 REM   2. Navigate to D:\prod\simple_vulkan
@@ -58,6 +60,47 @@ if errorlevel 1 (
     exit /b 1
 )
 
+echo Building svk_bench.exe...
+cl /O2 /I"%VULKAN_SDK%\Include" svk_bench.c simple_vulkan.lib "%VULKAN_SDK%\Lib\vulkan-1.lib" /Fesvk_bench.exe
+
+if errorlevel 1 (
+    echo ERROR: Benchmark build failed!
+    exit /b 1
+)
+
+echo Compiling shaders...
+cd /d "%~dp0shaders"
+set GLSLC="%VULKAN_SDK%\Bin\glslc.exe"
+
+for %%s in (dispatch_args empty sdf_raymarcher sdf_buffer_output medieval_village) do (
+    %GLSLC% %%s.comp -o %%s.spv
+    if errorlevel 1 (
+        echo ERROR: Shader compilation failed: %%s.comp
+        exit /b 1
+    )
+)
+
+REM Subgroup arithmetic needs Vulkan 1.1 SPIR-V
+for %%s in (reduce scan radix_sort histogram) do (
+    %GLSLC% --target-env=vulkan1.1 %%s.comp -o %%s.spv
+    if errorlevel 1 (
+        echo ERROR: Shader compilation failed: %%s.comp
+        exit /b 1
+    )
+)
+
+REM One packing pipeline per source image format
+%GLSLC% pack_image.comp -o pack_image.spv
+if errorlevel 1 (
+    echo ERROR: Shader compilation failed: pack_image.comp
+    exit /b 1
+)
+%GLSLC% -DSRC_FORMAT=rgba8 pack_image.comp -o pack_image_rgba8.spv
+if errorlevel 1 (
+    echo ERROR: Shader compilation failed: pack_image.comp ^(rgba8^)
+    exit /b 1
+)
+
 echo.
 echo ============================================
 echo   Build successful!
@@ -66,6 +109,8 @@ echo.
 echo Created:
 echo   - Clib\simple_vulkan.obj
 echo   - Clib\simple_vulkan.lib
+echo   - Clib\svk_bench.exe
+echo   - shaders\*.spv
 echo.
 echo You can now compile Eiffel projects that use simple_vulkan.
 echo.
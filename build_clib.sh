@@ -0,0 +1,82 @@
+#!/bin/sh
+# ===========================================================================
+# Build script for simple_vulkan C library (Linux)
+# ===========================================================================
+#
+# Prerequisites:
+#   1. Vulkan headers and loader (e.g. libvulkan-dev), or the Vulkan SDK
+#      with VULKAN_SDK set
+#   2. A C99 compiler (cc/gcc/clang)
+#   3. Optionally glslc (Vulkan SDK or shaderc) to rebuild shaders/*.spv;
+#      set GLSLC to choose one. Without it the committed binaries are kept.
+#
+# For GPU-less machines, install Mesa's software ICD (mesa-vulkan-drivers)
+# and point the loader at lavapipe:
+#   VK_ICD_FILENAMES=/usr/share/vulkan/icd.d/lvp_icd.x86_64.json
+#
+# Usage:
+#   ./build_clib.sh
+#
+# ===========================================================================
+
+set -e
+
+CC=${CC:-cc}
+CFLAGS="-O2 -std=c99 -pthread"
+LDFLAGS=""
+
+if [ -n "$VULKAN_SDK" ]; then
+    CFLAGS="$CFLAGS -I$VULKAN_SDK/include"
+    LDFLAGS="-L$VULKAN_SDK/lib"
+fi
+
+cd "$(dirname "$0")/Clib"
+
+echo "Compiling simple_vulkan.c..."
+$CC $CFLAGS -c simple_vulkan.c -o simple_vulkan.o
+
+echo "Creating libsimple_vulkan.a..."
+ar rcs libsimple_vulkan.a simple_vulkan.o
+
+echo "Building svk_bench..."
+$CC $CFLAGS svk_bench.c libsimple_vulkan.a $LDFLAGS -lvulkan -o svk_bench
+
+if [ -z "$GLSLC" ]; then
+    if [ -n "$VULKAN_SDK" ] && [ -x "$VULKAN_SDK/bin/glslc" ]; then
+        GLSLC="$VULKAN_SDK/bin/glslc"
+    else
+        GLSLC=glslc
+    fi
+fi
+
+SHADERS=""
+if command -v "$GLSLC" >/dev/null 2>&1; then
+    echo "Compiling shaders..."
+    cd ../shaders
+
+    for s in dispatch_args empty sdf_raymarcher sdf_buffer_output medieval_village; do
+        "$GLSLC" $s.comp -o $s.spv
+    done
+
+    # Subgroup arithmetic needs Vulkan 1.1 SPIR-V
+    for s in reduce scan radix_sort histogram; do
+        "$GLSLC" --target-env=vulkan1.1 $s.comp -o $s.spv
+    done
+
+    # One packing pipeline per source image format
+    "$GLSLC" pack_image.comp -o pack_image.spv
+    "$GLSLC" -DSRC_FORMAT=rgba8 pack_image.comp -o pack_image_rgba8.spv
+
+    cd ../Clib
+    SHADERS=1
+else
+    echo "glslc not found: keeping the prebuilt shaders/*.spv"
+fi
+
+echo
+echo "Created:"
+echo "  - Clib/libsimple_vulkan.a"
+echo "  - Clib/svk_bench (run from the library root: Clib/svk_bench --quick)"
+if [ -n "$SHADERS" ]; then
+    echo "  - shaders/*.spv"
+fi
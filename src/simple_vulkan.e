@@ -41,10 +41,39 @@ feature -- Context Factory
 			result_attached: Result /= Void
 		end
 
+	create_context_on_device (a_index: INTEGER): VULKAN_CONTEXT
+			-- Create Vulkan context on physical device `a_index`.
+		require
+			valid_index: a_index >= 0 and a_index < device_count
+		do
+			create Result.make_for_device (a_index)
+		ensure
+			result_attached: Result /= Void
+		end
+
+	device_count: INTEGER
+			-- Physical devices found (0 without a Vulkan driver)
+		do
+			Result := svk_get_device_count.to_integer_32
+		end
+
+	device_info (a_index: INTEGER): VULKAN_DEVICE_INFO
+			-- Description of physical device `a_index`
+		require
+			valid_index: a_index >= 0 and a_index < device_count
+		do
+			create Result.make (a_index)
+		ensure
+			result_attached: Result /= Void
+		end
+
 feature -- Buffer Factory
 
 	create_buffer (a_ctx: VULKAN_CONTEXT; a_size: INTEGER_64; a_usage: INTEGER): VULKAN_BUFFER
 			-- Create GPU buffer with specified size and usage flags.
+			-- Usage may include one placement flag (`Buffer_device_local`,
+			-- `Buffer_host_upload`, `Buffer_host_readback`); without one the
+			-- buffer is host-visible and host-coherent.
 		require
 			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
 			positive_size: a_size > 0
@@ -80,6 +109,142 @@ feature -- Pipeline Factory
 			result_attached: Result /= Void
 		end
 
+	create_pipeline_with_bindings (a_ctx: VULKAN_CONTEXT; a_shader: VULKAN_SHADER; a_types: ARRAY [INTEGER]): VULKAN_PIPELINE
+			-- Create compute pipeline with per-binding types, e.g. <<{VULKAN_PIPELINE}.Binding_image>>
+			-- for a shader writing a storage image at binding 0.
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			shader_valid: a_shader /= Void and then a_shader.is_valid
+			types_attached: a_types /= Void
+		do
+			create Result.make_with_bindings (a_ctx, a_shader, a_types)
+		ensure
+			result_attached: Result /= Void
+		end
+
+	create_specialized_pipeline (a_ctx: VULKAN_CONTEXT; a_shader: VULKAN_SHADER; a_constants: VULKAN_SPEC_CONSTANTS): VULKAN_PIPELINE
+			-- Create compute pipeline with specialization constants folded in.
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			shader_valid: a_shader /= Void and then a_shader.is_valid
+			constants_attached: a_constants /= Void
+		do
+			create Result.make_specialized (a_ctx, a_shader, a_constants)
+		ensure
+			result_attached: Result /= Void
+		end
+
+	create_pack_pipeline (a_ctx: VULKAN_CONTEXT; a_shader: VULKAN_SHADER): VULKAN_PIPELINE
+			-- Create image packing pipeline for {VULKAN_IMAGE}.download_packed
+			-- from shaders/pack_image.spv (RGBA32F images) or pack_image_rgba8.spv.
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			shader_valid: a_shader /= Void and then a_shader.is_valid
+		do
+			create Result.make_packer (a_ctx, a_shader)
+		ensure
+			result_attached: Result /= Void
+		end
+
+feature -- Command List Factory
+
+	create_command_list (a_ctx: VULKAN_CONTEXT): VULKAN_COMMAND_LIST
+			-- Create command list for batching several steps into one submission.
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+		do
+			create Result.make (a_ctx)
+		ensure
+			result_attached: Result /= Void
+		end
+
+feature -- Task Graph Factory
+
+	create_graph (a_ctx: VULKAN_CONTEXT): VULKAN_GRAPH
+			-- Create task graph to compile once and run every frame.
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+		do
+			create Result.make (a_ctx)
+		ensure
+			result_attached: Result /= Void
+		end
+
+feature -- Multi-Context Splitting
+
+	create_splitter (a_width, a_height, a_pixel_size: INTEGER): VULKAN_SPLITTER
+			-- Create splitter rendering `a_width` x `a_height` frames across several contexts.
+		require
+			positive_dimensions: a_width > 0 and a_height > 0
+			positive_pixel_size: a_pixel_size > 0
+		do
+			create Result.make (a_width, a_height, a_pixel_size)
+		ensure
+			result_attached: Result /= Void
+		end
+
+feature -- Tiled SDF Factory
+
+	create_tiled_sdf (a_ctx: VULKAN_CONTEXT; a_shader: VULKAN_SHADER; a_constants: VULKAN_SPEC_CONSTANTS; a_tile_size: INTEGER): VULKAN_TILED_SDF
+			-- Create tile-culled two-pass renderer of buffer-output SDF `a_shader`.
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			shader_valid: a_shader /= Void and then a_shader.is_valid
+			constants_attached: a_constants /= Void
+			positive_tile_size: a_tile_size > 0
+		do
+			create Result.make (a_ctx, a_shader, a_constants, a_tile_size)
+		ensure
+			result_attached: Result /= Void
+		end
+
+feature -- Parallel Primitives Factory
+
+	create_algorithms (a_ctx: VULKAN_CONTEXT; a_shader_dir: STRING): VULKAN_ALGORITHMS
+			-- Create reduce, scan, sort and histogram from the kernels in `a_shader_dir`
+			-- (reduce.spv, scan.spv, radix_sort.spv, histogram.spv).
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			dir_attached: a_shader_dir /= Void and then not a_shader_dir.is_empty
+		do
+			create Result.make_from_directory (a_ctx, a_shader_dir)
+		ensure
+			result_attached: Result /= Void
+		end
+
+feature -- Profiling
+
+	create_profiler (a_ctx: VULKAN_CONTEXT; a_window: INTEGER): VULKAN_PROFILER
+			-- Start measuring GPU time of commands on `a_ctx`, keeping the last `a_window` samples.
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			positive_window: a_window > 0
+		do
+			create Result.make (a_ctx, a_window)
+		ensure
+			result_attached: Result /= Void
+		end
+
+	host_time_ns: NATURAL_64
+			-- Monotonic host clock in nanoseconds, for timing CPU-side spans against GPU samples
+		do
+			Result := svk_time_ns
+		end
+
+feature -- SDF Rendering
+
+	create_sdf_renderer (a_ctx: VULKAN_CONTEXT; a_shader_path: STRING; a_width, a_height: INTEGER): VULKAN_SDF_RENDERER
+			-- Create persistent SDF ray-marching engine rendering `a_width` x `a_height` frames.
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			path_attached: a_shader_path /= Void and then not a_shader_path.is_empty
+			positive_dimensions: a_width > 0 and a_height > 0
+		do
+			create Result.make (a_ctx, a_shader_path, a_width, a_height)
+		ensure
+			result_attached: Result /= Void
+		end
+
 feature -- Image Factory
 
 	create_image (a_ctx: VULKAN_CONTEXT; a_width, a_height: INTEGER; a_format: INTEGER): VULKAN_IMAGE
@@ -104,6 +269,18 @@ feature -- Buffer Usage Flags
 	Buffer_transfer: INTEGER = 0x04
 			-- Transfer source/destination
 
+	Buffer_indirect: INTEGER = 0x08
+			-- Indirect dispatch arguments
+
+	Buffer_device_local: INTEGER = 0x10
+			-- Placement: GPU memory, transfers go through a staging ring
+
+	Buffer_host_upload: INTEGER = 0x20
+			-- Placement: host-visible memory written by CPU, read by GPU
+
+	Buffer_host_readback: INTEGER = 0x40
+			-- Placement: host-visible (cached where available) memory read by CPU
+
 feature -- Image Format
 
 	Format_rgba8: INTEGER = 0x01
@@ -123,4 +300,20 @@ feature -- Vendor IDs
 	Vendor_intel: INTEGER = 0x8086
 			-- Intel vendor ID
 
+feature {NONE} -- C Externals
+
+	svk_time_ns: NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_time_ns();"
+		end
+
+	svk_get_device_count: NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_get_device_count();"
+		end
+
 end
@@ -0,0 +1,451 @@
+note
+	description: "[
+		VULKAN_ALGORITHMS - GPU parallel primitives.
+
+		Reduce, prefix scan, stable radix sort and histogram over
+		buffers of 32-bit elements (NATURAL_32, INTEGER_32 or REAL_32),
+		from the bundled kernels shaders/reduce.spv, scan.spv,
+		radix_sort.spv and histogram.spv. Each call is one submission;
+		scratch buffers are kept between calls and grown as needed.
+
+		The kernels use subgroup arithmetic: `is_valid` is False on
+		devices without it. The `reference_*` features compute the same
+		results on the CPU, for checking GPU output.
+
+		Usage:
+			local
+				algos: VULKAN_ALGORITHMS
+				ok: BOOLEAN
+			do
+				algos := vk.create_algorithms (ctx, "shaders")
+				if algos.is_valid then
+					ok := algos.sort_pairs (keys, values, count, algos.Element_float32)
+						and then algos.reduce (data, count, algos.Element_uint32, algos.Reduce_sum, total)
+					algos.dispose
+				end
+			end
+	]"
+	author: "Larry Rix"
+	date: "$Date$"
+	revision: "$Revision$"
+
+class
+	VULKAN_ALGORITHMS
+
+create
+	make,
+	make_from_directory
+
+feature {NONE} -- Initialization
+
+	make (a_ctx: VULKAN_CONTEXT; a_reduce, a_scan, a_sort, a_histogram: VULKAN_SHADER)
+			-- Create from the four kernels. The shaders may be disposed afterwards.
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			reduce_valid: a_reduce /= Void and then a_reduce.is_valid
+			scan_valid: a_scan /= Void and then a_scan.is_valid
+			sort_valid: a_sort /= Void and then a_sort.is_valid
+			histogram_valid: a_histogram /= Void and then a_histogram.is_valid
+		do
+			context := a_ctx
+			handle := svk_create_algorithms (a_ctx.handle, a_reduce.handle, a_scan.handle,
+				a_sort.handle, a_histogram.handle)
+			is_valid := handle /= default_pointer
+		ensure
+			context_set: context = a_ctx
+		end
+
+	make_from_directory (a_ctx: VULKAN_CONTEXT; a_shader_dir: STRING)
+			-- Create from reduce.spv, scan.spv, radix_sort.spv and histogram.spv in `a_shader_dir`.
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			dir_attached: a_shader_dir /= Void and then not a_shader_dir.is_empty
+		local
+			l_reduce, l_scan, l_sort, l_histogram: VULKAN_SHADER
+		do
+			context := a_ctx
+			create l_reduce.make (a_ctx, a_shader_dir + "/reduce.spv")
+			create l_scan.make (a_ctx, a_shader_dir + "/scan.spv")
+			create l_sort.make (a_ctx, a_shader_dir + "/radix_sort.spv")
+			create l_histogram.make (a_ctx, a_shader_dir + "/histogram.spv")
+			if l_reduce.is_valid and l_scan.is_valid and l_sort.is_valid and l_histogram.is_valid then
+				make (a_ctx, l_reduce, l_scan, l_sort, l_histogram)
+			end
+			l_reduce.dispose
+			l_scan.dispose
+			l_sort.dispose
+			l_histogram.dispose
+		ensure
+			context_set: context = a_ctx
+		end
+
+feature -- Access
+
+	handle: POINTER
+			-- Opaque handle to svk_algorithms
+
+	context: VULKAN_CONTEXT
+			-- Parent context
+
+	is_valid: BOOLEAN
+			-- Were the pipelines created (and are subgroups supported)?
+
+feature -- Element Types
+
+	Element_uint32: INTEGER = 0x01
+			-- NATURAL_32 elements
+	Element_int32: INTEGER = 0x02
+			-- INTEGER_32 elements
+	Element_float32: INTEGER = 0x03
+			-- REAL_32 elements; sorted by sign and magnitude, -0 before +0
+
+	is_valid_element (a_type: INTEGER): BOOLEAN
+			-- Is `a_type` an element type?
+		do
+			Result := a_type >= Element_uint32 and a_type <= Element_float32
+		end
+
+feature -- Operators
+
+	Reduce_sum: INTEGER = 0x01
+			-- Sum (integers wrap around)
+	Reduce_min: INTEGER = 0x02
+			-- Minimum
+	Reduce_max: INTEGER = 0x03
+			-- Maximum
+
+	is_valid_op (a_op: INTEGER): BOOLEAN
+			-- Is `a_op` a reduce/scan operator?
+		do
+			Result := a_op >= Reduce_sum and a_op <= Reduce_max
+		end
+
+feature -- Operations
+
+	reduce (a_input: VULKAN_BUFFER; a_count, a_type, a_op: INTEGER; a_output: VULKAN_BUFFER): BOOLEAN
+			-- Combine the first `a_count` elements of `a_input` with `a_op` into the
+			-- first element of `a_output`, and wait. Float sums add in a tree, so
+			-- their rounding differs from a sequential sum.
+		require
+			valid: is_valid
+			input_valid: a_input /= Void and then a_input.is_valid
+			output_valid: a_output /= Void and then a_output.is_valid
+			positive_count: a_count > 0
+			valid_type: is_valid_element (a_type)
+			valid_op: is_valid_op (a_op)
+		do
+			Result := svk_reduce (handle, a_input.handle, a_count.to_natural_32, a_type.to_natural_32,
+				a_op.to_natural_32, a_output.handle) /= 0
+		end
+
+	reduce_async (a_input: VULKAN_BUFFER; a_count, a_type, a_op: INTEGER; a_output: VULKAN_BUFFER): NATURAL_64
+			-- Submit `reduce` without waiting.
+			-- Returns a ticket for {VULKAN_PIPELINE}.wait_ticket, or 0 on failure.
+		require
+			valid: is_valid
+			input_valid: a_input /= Void and then a_input.is_valid
+			output_valid: a_output /= Void and then a_output.is_valid
+			positive_count: a_count > 0
+			valid_type: is_valid_element (a_type)
+			valid_op: is_valid_op (a_op)
+		do
+			Result := svk_reduce_async (handle, a_input.handle, a_count.to_natural_32, a_type.to_natural_32,
+				a_op.to_natural_32, a_output.handle)
+		end
+
+	scan (a_input, a_output: VULKAN_BUFFER; a_count, a_type, a_op: INTEGER; a_inclusive: BOOLEAN): BOOLEAN
+			-- Prefix `a_op` of `a_input` into `a_output` (may be the same buffer), and wait.
+			-- Inclusive: element i combines inputs 0..i; exclusive: 0..i-1.
+		require
+			valid: is_valid
+			input_valid: a_input /= Void and then a_input.is_valid
+			output_valid: a_output /= Void and then a_output.is_valid
+			positive_count: a_count > 0
+			valid_type: is_valid_element (a_type)
+			valid_op: is_valid_op (a_op)
+		do
+			Result := svk_scan (handle, a_input.handle, a_output.handle, a_count.to_natural_32,
+				a_type.to_natural_32, a_op.to_natural_32, a_inclusive.to_integer) /= 0
+		end
+
+	scan_async (a_input, a_output: VULKAN_BUFFER; a_count, a_type, a_op: INTEGER; a_inclusive: BOOLEAN): NATURAL_64
+			-- Submit `scan` without waiting. Returns a ticket, or 0 on failure.
+		require
+			valid: is_valid
+			input_valid: a_input /= Void and then a_input.is_valid
+			output_valid: a_output /= Void and then a_output.is_valid
+			positive_count: a_count > 0
+			valid_type: is_valid_element (a_type)
+			valid_op: is_valid_op (a_op)
+		do
+			Result := svk_scan_async (handle, a_input.handle, a_output.handle, a_count.to_natural_32,
+				a_type.to_natural_32, a_op.to_natural_32, a_inclusive.to_integer)
+		end
+
+	sort (a_keys: VULKAN_BUFFER; a_count, a_type: INTEGER): BOOLEAN
+			-- Sort the first `a_count` keys in place, ascending, and wait.
+		require
+			valid: is_valid
+			keys_valid: a_keys /= Void and then a_keys.is_valid
+			positive_count: a_count > 0
+			valid_type: is_valid_element (a_type)
+		do
+			Result := svk_sort (handle, a_keys.handle, default_pointer, a_count.to_natural_32,
+				a_type.to_natural_32) /= 0
+		end
+
+	sort_pairs (a_keys, a_values: VULKAN_BUFFER; a_count, a_type: INTEGER): BOOLEAN
+			-- Sort `a_keys` in place, moving the 32-bit `a_values` with them, and wait.
+			-- Stable: equal keys keep their order.
+		require
+			valid: is_valid
+			keys_valid: a_keys /= Void and then a_keys.is_valid
+			values_valid: a_values /= Void and then a_values.is_valid
+			positive_count: a_count > 0
+			valid_type: is_valid_element (a_type)
+		do
+			Result := svk_sort (handle, a_keys.handle, a_values.handle, a_count.to_natural_32,
+				a_type.to_natural_32) /= 0
+		end
+
+	sort_pairs_async (a_keys, a_values: VULKAN_BUFFER; a_count, a_type: INTEGER): NATURAL_64
+			-- Submit `sort_pairs` without waiting. Returns a ticket, or 0 on failure.
+		require
+			valid: is_valid
+			keys_valid: a_keys /= Void and then a_keys.is_valid
+			values_valid: a_values /= Void and then a_values.is_valid
+			positive_count: a_count > 0
+			valid_type: is_valid_element (a_type)
+		do
+			Result := svk_sort_async (handle, a_keys.handle, a_values.handle, a_count.to_natural_32,
+				a_type.to_natural_32)
+		end
+
+	histogram (a_input: VULKAN_BUFFER; a_count, a_type: INTEGER; a_lo, a_hi: REAL_64;
+			a_bins: INTEGER; a_output: VULKAN_BUFFER): BOOLEAN
+			-- Count `a_input` into `a_bins` equal bins over [`a_lo`, `a_hi`), writing
+			-- NATURAL_32 counts to `a_output`, and wait. Integer bins are a whole
+			-- number of values wide.
+		require
+			valid: is_valid
+			input_valid: a_input /= Void and then a_input.is_valid
+			output_valid: a_output /= Void and then a_output.is_valid
+			positive_count: a_count > 0
+			valid_type: is_valid_element (a_type)
+			valid_range: a_lo < a_hi
+			positive_bins: a_bins > 0
+		do
+			Result := svk_histogram (handle, a_input.handle, a_count.to_natural_32, a_type.to_natural_32,
+				a_lo, a_hi, a_bins.to_natural_32, a_output.handle) /= 0
+		end
+
+	histogram_async (a_input: VULKAN_BUFFER; a_count, a_type: INTEGER; a_lo, a_hi: REAL_64;
+			a_bins: INTEGER; a_output: VULKAN_BUFFER): NATURAL_64
+			-- Submit `histogram` without waiting. Returns a ticket, or 0 on failure.
+		require
+			valid: is_valid
+			input_valid: a_input /= Void and then a_input.is_valid
+			output_valid: a_output /= Void and then a_output.is_valid
+			positive_count: a_count > 0
+			valid_type: is_valid_element (a_type)
+			valid_range: a_lo < a_hi
+			positive_bins: a_bins > 0
+		do
+			Result := svk_histogram_async (handle, a_input.handle, a_count.to_natural_32, a_type.to_natural_32,
+				a_lo, a_hi, a_bins.to_natural_32, a_output.handle)
+		end
+
+feature -- CPU Reference
+
+	reference_reduce (a_input: MANAGED_POINTER; a_count, a_type, a_op: INTEGER): NATURAL_32
+			-- Bits of `reduce` computed on the CPU
+		require
+			input_attached: a_input /= Void and then a_input.count >= a_count * 4
+			non_negative_count: a_count >= 0
+			valid_type: is_valid_element (a_type)
+			valid_op: is_valid_op (a_op)
+		local
+			l_result: MANAGED_POINTER
+		do
+			create l_result.make (4)
+			if svk_reference_reduce (a_input.item, a_count.to_natural_32, a_type.to_natural_32,
+				a_op.to_natural_32, l_result.item) /= 0
+			then
+				Result := l_result.read_natural_32 (0)
+			end
+		end
+
+	reference_scan (a_input, a_output: MANAGED_POINTER; a_count, a_type, a_op: INTEGER; a_inclusive: BOOLEAN): BOOLEAN
+			-- `scan` on the CPU
+		require
+			input_attached: a_input /= Void and then a_input.count >= a_count * 4
+			output_attached: a_output /= Void and then a_output.count >= a_count * 4
+			non_negative_count: a_count >= 0
+			valid_type: is_valid_element (a_type)
+			valid_op: is_valid_op (a_op)
+		do
+			Result := svk_reference_scan (a_input.item, a_output.item, a_count.to_natural_32,
+				a_type.to_natural_32, a_op.to_natural_32, a_inclusive.to_integer) /= 0
+		end
+
+	reference_sort (a_keys: MANAGED_POINTER; a_count, a_type: INTEGER): BOOLEAN
+			-- `sort` on the CPU
+		require
+			keys_attached: a_keys /= Void and then a_keys.count >= a_count * 4
+			non_negative_count: a_count >= 0
+			valid_type: is_valid_element (a_type)
+		do
+			Result := svk_reference_sort (a_keys.item, default_pointer, a_count.to_natural_32,
+				a_type.to_natural_32) /= 0
+		end
+
+	reference_sort_pairs (a_keys, a_values: MANAGED_POINTER; a_count, a_type: INTEGER): BOOLEAN
+			-- `sort_pairs` on the CPU
+		require
+			keys_attached: a_keys /= Void and then a_keys.count >= a_count * 4
+			values_attached: a_values /= Void and then a_values.count >= a_count * 4
+			non_negative_count: a_count >= 0
+			valid_type: is_valid_element (a_type)
+		do
+			Result := svk_reference_sort (a_keys.item, a_values.item, a_count.to_natural_32,
+				a_type.to_natural_32) /= 0
+		end
+
+	reference_histogram (a_input: MANAGED_POINTER; a_count, a_type: INTEGER; a_lo, a_hi: REAL_64;
+			a_bins: INTEGER; a_output: MANAGED_POINTER): BOOLEAN
+			-- `histogram` on the CPU
+		require
+			input_attached: a_input /= Void and then a_input.count >= a_count * 4
+			output_attached: a_output /= Void and then a_output.count >= a_bins * 4
+			non_negative_count: a_count >= 0
+			valid_type: is_valid_element (a_type)
+			valid_range: a_lo < a_hi
+			positive_bins: a_bins > 0
+		do
+			Result := svk_reference_histogram (a_input.item, a_count.to_natural_32, a_type.to_natural_32,
+				a_lo, a_hi, a_bins.to_natural_32, a_output.item) /= 0
+		end
+
+feature -- Disposal
+
+	dispose
+			-- Free the pipelines and scratch buffers.
+		do
+			if is_valid and handle /= default_pointer then
+				svk_free_algorithms (handle)
+				handle := default_pointer
+				is_valid := False
+			end
+		ensure
+			disposed: not is_valid
+			handle_cleared: handle = default_pointer
+		end
+
+feature {NONE} -- C Externals
+
+	svk_create_algorithms (ctx, a_reduce, a_scan, a_sort, a_histogram: POINTER): POINTER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_create_algorithms((svk_context)$ctx, (svk_shader)$a_reduce, (svk_shader)$a_scan, (svk_shader)$a_sort, (svk_shader)$a_histogram);"
+		end
+
+	svk_reduce (algos, a_input: POINTER; a_count, a_type, a_op: NATURAL_32; a_output: POINTER): INTEGER
+		external
+			"C blocking inline use <simple_vulkan.h>"
+		alias
+			"return svk_reduce((svk_algorithms)$algos, (svk_buffer)$a_input, (uint32_t)$a_count, (uint32_t)$a_type, (uint32_t)$a_op, (svk_buffer)$a_output);"
+		end
+
+	svk_reduce_async (algos, a_input: POINTER; a_count, a_type, a_op: NATURAL_32; a_output: POINTER): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_reduce_async((svk_algorithms)$algos, (svk_buffer)$a_input, (uint32_t)$a_count, (uint32_t)$a_type, (uint32_t)$a_op, (svk_buffer)$a_output);"
+		end
+
+	svk_scan (algos, a_input, a_output: POINTER; a_count, a_type, a_op: NATURAL_32; a_inclusive: INTEGER): INTEGER
+		external
+			"C blocking inline use <simple_vulkan.h>"
+		alias
+			"return svk_scan((svk_algorithms)$algos, (svk_buffer)$a_input, (svk_buffer)$a_output, (uint32_t)$a_count, (uint32_t)$a_type, (uint32_t)$a_op, (int)$a_inclusive);"
+		end
+
+	svk_scan_async (algos, a_input, a_output: POINTER; a_count, a_type, a_op: NATURAL_32; a_inclusive: INTEGER): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_scan_async((svk_algorithms)$algos, (svk_buffer)$a_input, (svk_buffer)$a_output, (uint32_t)$a_count, (uint32_t)$a_type, (uint32_t)$a_op, (int)$a_inclusive);"
+		end
+
+	svk_sort (algos, a_keys, a_values: POINTER; a_count, a_type: NATURAL_32): INTEGER
+		external
+			"C blocking inline use <simple_vulkan.h>"
+		alias
+			"return svk_sort((svk_algorithms)$algos, (svk_buffer)$a_keys, (svk_buffer)$a_values, (uint32_t)$a_count, (uint32_t)$a_type);"
+		end
+
+	svk_sort_async (algos, a_keys, a_values: POINTER; a_count, a_type: NATURAL_32): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_sort_async((svk_algorithms)$algos, (svk_buffer)$a_keys, (svk_buffer)$a_values, (uint32_t)$a_count, (uint32_t)$a_type);"
+		end
+
+	svk_histogram (algos, a_input: POINTER; a_count, a_type: NATURAL_32; a_lo, a_hi: REAL_64;
+			a_bins: NATURAL_32; a_output: POINTER): INTEGER
+		external
+			"C blocking inline use <simple_vulkan.h>"
+		alias
+			"return svk_histogram((svk_algorithms)$algos, (svk_buffer)$a_input, (uint32_t)$a_count, (uint32_t)$a_type, (double)$a_lo, (double)$a_hi, (uint32_t)$a_bins, (svk_buffer)$a_output);"
+		end
+
+	svk_histogram_async (algos, a_input: POINTER; a_count, a_type: NATURAL_32; a_lo, a_hi: REAL_64;
+			a_bins: NATURAL_32; a_output: POINTER): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_histogram_async((svk_algorithms)$algos, (svk_buffer)$a_input, (uint32_t)$a_count, (uint32_t)$a_type, (double)$a_lo, (double)$a_hi, (uint32_t)$a_bins, (svk_buffer)$a_output);"
+		end
+
+	svk_reference_reduce (a_input: POINTER; a_count, a_type, a_op: NATURAL_32; a_result: POINTER): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_reference_reduce((const void*)$a_input, (uint32_t)$a_count, (uint32_t)$a_type, (uint32_t)$a_op, (void*)$a_result);"
+		end
+
+	svk_reference_scan (a_input, a_output: POINTER; a_count, a_type, a_op: NATURAL_32; a_inclusive: INTEGER): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_reference_scan((const void*)$a_input, (void*)$a_output, (uint32_t)$a_count, (uint32_t)$a_type, (uint32_t)$a_op, (int)$a_inclusive);"
+		end
+
+	svk_reference_sort (a_keys, a_values: POINTER; a_count, a_type: NATURAL_32): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_reference_sort((void*)$a_keys, (void*)$a_values, (uint32_t)$a_count, (uint32_t)$a_type);"
+		end
+
+	svk_reference_histogram (a_input: POINTER; a_count, a_type: NATURAL_32; a_lo, a_hi: REAL_64;
+			a_bins: NATURAL_32; a_output: POINTER): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_reference_histogram((const void*)$a_input, (uint32_t)$a_count, (uint32_t)$a_type, (double)$a_lo, (double)$a_hi, (uint32_t)$a_bins, (uint32_t*)$a_output);"
+		end
+
+	svk_free_algorithms (algos: POINTER)
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"svk_free_algorithms((svk_algorithms)$algos);"
+		end
+
+invariant
+	valid_handle: is_valid implies handle /= default_pointer
+	context_attached: context /= Void
+
+end
@@ -21,6 +21,22 @@ note
 					buf.dispose
 				end
 			end
+
+		Persistently mapped (per-frame parameters without map/unmap):
+			local
+				params: MANAGED_POINTER
+			do
+				create buf.make (ctx, 32, Buffer_storage | Buffer_host_upload)
+				create params.share_from_pointer (buf.mapped_pointer, 32)
+				-- each frame:
+				ok := buf.wait_for_gpu
+				params.put_real_32 (cam_x, 0)
+				ok := buf.flush_range (0, 32)
+			end
+
+		Buffers made by {VULKAN_GRAPH}.new_transient_buffer are
+		transient: the graph owns their memory, which they may share
+		with other transients, and frees them with itself.
 	]"
 	author: "Larry Rix"
 	date: "$Date$"
@@ -32,6 +48,9 @@ class
 create
 	make
 
+create {VULKAN_GRAPH}
+	make_transient
+
 feature {NONE} -- Initialization
 
 	make (a_ctx: VULKAN_CONTEXT; a_size: INTEGER_64; a_usage: INTEGER)
@@ -39,6 +58,7 @@ feature {NONE} -- Initialization
 		require
 			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
 			positive_size: a_size > 0
+			single_placement: (<<0, Buffer_device_local, Buffer_host_upload, Buffer_host_readback>>).has (a_usage & Placement_mask)
 		do
 			context := a_ctx
 			size := a_size
@@ -51,6 +71,23 @@ feature {NONE} -- Initialization
 			usage_set: usage = a_usage
 		end
 
+	make_transient (a_ctx: VULKAN_CONTEXT; a_handle: POINTER; a_size: INTEGER_64; a_usage: INTEGER)
+			-- Wrap graph-owned buffer `a_handle` (default_pointer if its creation failed).
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			positive_size: a_size > 0
+		do
+			context := a_ctx
+			size := a_size
+			usage := a_usage
+			handle := a_handle
+			is_valid := handle /= default_pointer
+			is_transient := True
+		ensure
+			context_set: context = a_ctx
+			transient: is_transient
+		end
+
 feature -- Access
 
 	handle: POINTER
@@ -68,6 +105,21 @@ feature -- Access
 	is_valid: BOOLEAN
 			-- Was buffer creation successful?
 
+	is_transient: BOOLEAN
+			-- Is the buffer owned by a {VULKAN_GRAPH}, which frees it?
+
+	placement: INTEGER
+			-- Placement flag from `usage` (0 = host-visible, host-coherent)
+		do
+			Result := usage & Placement_mask
+		end
+
+	is_device_local: BOOLEAN
+			-- Is the buffer in GPU memory, transferred through staging?
+		do
+			Result := placement = Buffer_device_local
+		end
+
 feature -- Usage Flags
 
 	Buffer_storage: INTEGER = 0x01
@@ -79,10 +131,27 @@ feature -- Usage Flags
 	Buffer_transfer: INTEGER = 0x04
 			-- Transfer source/destination
 
+	Buffer_indirect: INTEGER = 0x08
+			-- Indirect dispatch arguments
+
+	Buffer_device_local: INTEGER = 0x10
+			-- Placement: GPU memory, transfers go through a staging ring
+
+	Buffer_host_upload: INTEGER = 0x20
+			-- Placement: host-visible memory written by CPU, read by GPU
+
+	Buffer_host_readback: INTEGER = 0x40
+			-- Placement: host-visible (cached where available) memory read by CPU
+
+	Placement_mask: INTEGER = 0x70
+			-- Bits holding the placement flag
+
 feature -- Data Transfer
 
 	upload (a_data: POINTER; a_size: INTEGER_64; a_offset: INTEGER_64): BOOLEAN
 			-- Upload data from CPU to GPU buffer.
+			-- Device-local uploads are queued through a staging ring;
+			-- `a_data` may be reused as soon as this returns.
 		require
 			valid: is_valid
 			data_attached: a_data /= default_pointer
@@ -95,6 +164,7 @@ feature -- Data Transfer
 
 	download (a_data: POINTER; a_size: INTEGER_64; a_offset: INTEGER_64): BOOLEAN
 			-- Download data from GPU to CPU buffer.
+			-- Waits for pending GPU work that uses the buffer.
 		require
 			valid: is_valid
 			data_attached: a_data /= default_pointer
@@ -105,13 +175,75 @@ feature -- Data Transfer
 				a_size.to_natural_64, a_offset.to_natural_64) /= 0
 		end
 
+feature -- Mapped Access
+
+	mapped_pointer: POINTER
+			-- Persistent CPU pointer to the buffer's memory, valid until `dispose`.
+			-- `default_pointer` unless the memory is host-visible, which
+			-- device-local buffers also get on UMA and ReBAR devices.
+			-- Writes must not overlap pending GPU work (see `wait_for_gpu`), and
+			-- non-coherent memory needs `flush_range` / `invalidate_range`.
+		require
+			valid: is_valid
+		do
+			Result := svk_buffer_mapped_pointer (handle)
+		end
+
+	is_mapped: BOOLEAN
+			-- Is the buffer directly addressable through `mapped_pointer`?
+		require
+			valid: is_valid
+		do
+			Result := mapped_pointer /= default_pointer
+		end
+
+	is_coherent: BOOLEAN
+			-- Are CPU writes/reads through `mapped_pointer` visible without flush/invalidate?
+		require
+			valid: is_valid
+		do
+			Result := svk_buffer_is_coherent (context.handle, handle) /= 0
+		end
+
+	flush_range (a_offset, a_size: INTEGER_64): BOOLEAN
+			-- Make CPU writes through `mapped_pointer` visible to the GPU.
+		require
+			valid: is_valid
+			mapped: is_mapped
+			valid_size: a_size > 0
+			valid_range: a_offset >= 0 and then a_offset + a_size <= size
+		do
+			Result := svk_flush_buffer (context.handle, handle, a_offset.to_natural_64, a_size.to_natural_64) /= 0
+		end
+
+	invalidate_range (a_offset, a_size: INTEGER_64): BOOLEAN
+			-- Make GPU writes visible to CPU reads through `mapped_pointer`.
+		require
+			valid: is_valid
+			mapped: is_mapped
+			valid_size: a_size > 0
+			valid_range: a_offset >= 0 and then a_offset + a_size <= size
+		do
+			Result := svk_invalidate_buffer (context.handle, handle, a_offset.to_natural_64, a_size.to_natural_64) /= 0
+		end
+
+	wait_for_gpu: BOOLEAN
+			-- Wait for pending GPU work that uses the buffer.
+		require
+			valid: is_valid
+		do
+			Result := svk_wait_buffer (context.handle, handle) /= 0
+		end
+
 feature -- Disposal
 
 	dispose
-			-- Free GPU buffer.
+			-- Free GPU buffer. A transient buffer is only detached.
 		do
 			if is_valid and handle /= default_pointer then
-				svk_free_buffer (context.handle, handle)
+				if not is_transient then
+					svk_free_buffer (context.handle, handle)
+				end
 				handle := default_pointer
 				is_valid := False
 			end
@@ -131,14 +263,14 @@ feature {NONE} -- C Externals
 
 	svk_upload_buffer (ctx, buf, data: POINTER; a_size, a_offset: NATURAL_64): INTEGER
 		external
-			"C inline use <simple_vulkan.h>"
+			"C blocking inline use <simple_vulkan.h>"
 		alias
 			"return svk_upload_buffer((svk_context)$ctx, (svk_buffer)$buf, $data, (uint64_t)$a_size, (uint64_t)$a_offset);"
 		end
 
 	svk_download_buffer (ctx, buf, data: POINTER; a_size, a_offset: NATURAL_64): INTEGER
 		external
-			"C inline use <simple_vulkan.h>"
+			"C blocking inline use <simple_vulkan.h>"
 		alias
 			"return svk_download_buffer((svk_context)$ctx, (svk_buffer)$buf, $data, (uint64_t)$a_size, (uint64_t)$a_offset);"
 		end
@@ -150,6 +282,41 @@ feature {NONE} -- C Externals
 			"return svk_buffer_size((svk_buffer)$buf);"
 		end
 
+	svk_buffer_mapped_pointer (buf: POINTER): POINTER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_buffer_mapped_pointer((svk_buffer)$buf);"
+		end
+
+	svk_buffer_is_coherent (ctx, buf: POINTER): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_buffer_is_coherent((svk_context)$ctx, (svk_buffer)$buf);"
+		end
+
+	svk_flush_buffer (ctx, buf: POINTER; a_offset, a_size: NATURAL_64): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_flush_buffer((svk_context)$ctx, (svk_buffer)$buf, (uint64_t)$a_offset, (uint64_t)$a_size);"
+		end
+
+	svk_invalidate_buffer (ctx, buf: POINTER; a_offset, a_size: NATURAL_64): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_invalidate_buffer((svk_context)$ctx, (svk_buffer)$buf, (uint64_t)$a_offset, (uint64_t)$a_size);"
+		end
+
+	svk_wait_buffer (ctx, buf: POINTER): INTEGER
+		external
+			"C blocking inline use <simple_vulkan.h>"
+		alias
+			"return svk_wait_buffer((svk_context)$ctx, (svk_buffer)$buf);"
+		end
+
 	svk_free_buffer (ctx, buf: POINTER)
 		external
 			"C inline use <simple_vulkan.h>"
@@ -0,0 +1,291 @@
+note
+	description: "[
+		VULKAN_COMMAND_LIST - Batched command recording for Vulkan compute.
+
+		Records several dispatches, copies and fills into one command
+		buffer and submits them together. Memory barriers between
+		dependent steps (compute->compute, compute->transfer,
+		transfer->compute) are inserted automatically. Bindings the
+		shader declares read-only do not count as writes.
+
+		`dispatch_indirect` takes its workgroup counts from a buffer
+		an earlier step wrote, such as shaders/dispatch_args.spv run
+		on an atomic counter, so adaptive passes need no readback.
+
+		Bindings may change between recorded dispatches. A pipeline
+		can hold up to four distinct binding combinations in
+		unsubmitted lists at once; beyond that `dispatch` fails.
+
+		Usage:
+			local
+				list: VULKAN_COMMAND_LIST
+				ticket: NATURAL_64
+				ok: BOOLEAN
+			do
+				create list.make (ctx)
+				if list.is_valid and then list.begin_recording then
+					ok := list.dispatch (render_pipe, 120, 68, 1)
+					ok := list.dispatch (post_pipe, 120, 68, 1)
+					ok := list.copy_buffer (packed, readback, 0, 0, packed.size)
+					ok := list.end_recording
+					ticket := list.submit
+					-- ... prepare next frame ...
+					ok := render_pipe.wait_ticket (ctx, ticket)
+				end
+				list.dispose
+			end
+	]"
+	author: "Larry Rix"
+	date: "$Date$"
+	revision: "$Revision$"
+
+class
+	VULKAN_COMMAND_LIST
+
+create
+	make
+
+feature {NONE} -- Initialization
+
+	make (a_ctx: VULKAN_CONTEXT)
+			-- Create empty command list on `a_ctx`.
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+		do
+			context := a_ctx
+			handle := svk_create_cmdlist (a_ctx.handle)
+			is_valid := handle /= default_pointer
+		ensure
+			context_set: context = a_ctx
+			not_recording: not is_recording
+		end
+
+feature -- Access
+
+	handle: POINTER
+			-- Opaque handle to svk_cmdlist
+
+	context: VULKAN_CONTEXT
+			-- Parent context
+
+	is_valid: BOOLEAN
+			-- Was command list creation successful?
+
+	is_recording: BOOLEAN
+			-- Are commands currently being recorded?
+
+	is_ended: BOOLEAN
+			-- Has recording ended with the list not yet submitted?
+
+feature -- Recording
+
+	begin_recording: BOOLEAN
+			-- Start recording. Discards anything recorded but not submitted.
+		require
+			valid: is_valid
+		do
+			Result := svk_cmdlist_begin (handle) /= 0
+			is_recording := Result
+			is_ended := False
+		ensure
+			recording_on_success: Result implies is_recording
+		end
+
+	dispatch (a_pipeline: VULKAN_PIPELINE; a_x, a_y, a_z: INTEGER): BOOLEAN
+			-- Record a dispatch using the pipeline's current bindings and push constants.
+		require
+			recording: is_recording
+			pipeline_valid: a_pipeline /= Void and then a_pipeline.is_valid
+			positive_counts: a_x > 0 and a_y > 0 and a_z > 0
+		do
+			Result := svk_cmd_dispatch (handle, a_pipeline.handle,
+				a_x.to_natural_32, a_y.to_natural_32, a_z.to_natural_32) /= 0
+		end
+
+	dispatch_threads (a_pipeline: VULKAN_PIPELINE; a_x, a_y, a_z: INTEGER): BOOLEAN
+			-- Record a dispatch covering `a_x` * `a_y` * `a_z` threads.
+		require
+			recording: is_recording
+			pipeline_valid: a_pipeline /= Void and then a_pipeline.is_valid
+			local_size_known: a_pipeline.has_local_size
+			positive_counts: a_x > 0 and a_y > 0 and a_z > 0
+		do
+			Result := dispatch (a_pipeline,
+				a_pipeline.group_count (a_x, a_pipeline.local_size_x),
+				a_pipeline.group_count (a_y, a_pipeline.local_size_y),
+				a_pipeline.group_count (a_z, a_pipeline.local_size_z))
+		end
+
+	dispatch_indirect (a_pipeline: VULKAN_PIPELINE; a_args: VULKAN_BUFFER; a_offset: INTEGER_64): BOOLEAN
+			-- Record a dispatch with the workgroup counts that `a_args` holds at `a_offset`
+			-- (see {VULKAN_PIPELINE}.dispatch_indirect). Earlier steps writing them are waited for.
+		require
+			recording: is_recording
+			pipeline_valid: a_pipeline /= Void and then a_pipeline.is_valid
+			args_valid: a_args /= Void and then a_args.is_valid
+			indirect_usage: (a_args.usage & a_args.Buffer_indirect) /= 0
+			aligned_offset: a_offset >= 0 and a_offset \\ 4 = 0
+			valid_range: a_offset + 12 <= a_args.size
+		do
+			Result := svk_cmd_dispatch_indirect (handle, a_pipeline.handle, a_args.handle, a_offset.to_natural_64) /= 0
+		end
+
+	copy_buffer (a_source, a_target: VULKAN_BUFFER; a_source_offset, a_target_offset, a_size: INTEGER_64): BOOLEAN
+			-- Record a copy of `a_size` bytes from `a_source` to `a_target`.
+		require
+			recording: is_recording
+			source_valid: a_source /= Void and then a_source.is_valid
+			target_valid: a_target /= Void and then a_target.is_valid
+			valid_size: a_size > 0
+			valid_source_range: a_source_offset >= 0 and then a_source_offset + a_size <= a_source.size
+			valid_target_range: a_target_offset >= 0 and then a_target_offset + a_size <= a_target.size
+		do
+			Result := svk_cmd_copy_buffer (handle, a_source.handle, a_target.handle,
+				a_source_offset.to_natural_64, a_target_offset.to_natural_64, a_size.to_natural_64) /= 0
+		end
+
+	fill_buffer (a_buffer: VULKAN_BUFFER; a_offset, a_size: INTEGER_64; a_value: NATURAL_32): BOOLEAN
+			-- Record a fill of `a_size` bytes of `a_buffer` with the 32-bit `a_value`.
+		require
+			recording: is_recording
+			buffer_valid: a_buffer /= Void and then a_buffer.is_valid
+			valid_size: a_size > 0 and a_size \\ 4 = 0
+			aligned_offset: a_offset >= 0 and a_offset \\ 4 = 0
+			valid_range: a_offset + a_size <= a_buffer.size
+		do
+			Result := svk_cmd_fill_buffer (handle, a_buffer.handle,
+				a_offset.to_natural_64, a_size.to_natural_64, a_value) /= 0
+		end
+
+	end_recording: BOOLEAN
+			-- Stop recording.
+		require
+			recording: is_recording
+		do
+			Result := svk_cmdlist_end (handle) /= 0
+			is_recording := False
+			is_ended := Result
+		ensure
+			not_recording: not is_recording
+		end
+
+feature -- Submission
+
+	submit: NATURAL_64
+			-- Submit recorded commands. Returns a ticket, or 0 on failure.
+			-- The list can be recorded again with `begin_recording`.
+		require
+			ended: is_ended
+		do
+			Result := svk_cmdlist_submit (handle)
+			is_ended := False
+		ensure
+			not_ended: not is_ended
+		end
+
+	submit_and_wait: BOOLEAN
+			-- Submit recorded commands and wait for the GPU to finish them.
+		require
+			ended: is_ended
+		local
+			l_ticket: NATURAL_64
+		do
+			l_ticket := submit
+			Result := l_ticket > 0 and then svk_wait_ticket (context.handle, l_ticket) /= 0
+		end
+
+feature -- Disposal
+
+	dispose
+			-- Free command list.
+		do
+			if is_valid and handle /= default_pointer then
+				svk_free_cmdlist (handle)
+				handle := default_pointer
+				is_valid := False
+				is_recording := False
+				is_ended := False
+			end
+		ensure
+			disposed: not is_valid
+			handle_cleared: handle = default_pointer
+		end
+
+feature {NONE} -- C Externals
+
+	svk_create_cmdlist (ctx: POINTER): POINTER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_create_cmdlist((svk_context)$ctx);"
+		end
+
+	svk_cmdlist_begin (list: POINTER): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_cmdlist_begin((svk_cmdlist)$list);"
+		end
+
+	svk_cmd_dispatch (list, pipe: POINTER; x, y, z: NATURAL_32): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_cmd_dispatch((svk_cmdlist)$list, (svk_pipeline)$pipe, (uint32_t)$x, (uint32_t)$y, (uint32_t)$z);"
+		end
+
+	svk_cmd_dispatch_indirect (list, pipe, args: POINTER; a_offset: NATURAL_64): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_cmd_dispatch_indirect((svk_cmdlist)$list, (svk_pipeline)$pipe, (svk_buffer)$args, (uint64_t)$a_offset);"
+		end
+
+	svk_cmd_copy_buffer (list, src, dst: POINTER; src_offset, dst_offset, a_size: NATURAL_64): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_cmd_copy_buffer((svk_cmdlist)$list, (svk_buffer)$src, (svk_buffer)$dst, (uint64_t)$src_offset, (uint64_t)$dst_offset, (uint64_t)$a_size);"
+		end
+
+	svk_cmd_fill_buffer (list, buf: POINTER; a_offset, a_size: NATURAL_64; a_value: NATURAL_32): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_cmd_fill_buffer((svk_cmdlist)$list, (svk_buffer)$buf, (uint64_t)$a_offset, (uint64_t)$a_size, (uint32_t)$a_value);"
+		end
+
+	svk_cmdlist_end (list: POINTER): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_cmdlist_end((svk_cmdlist)$list);"
+		end
+
+	svk_cmdlist_submit (list: POINTER): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_cmdlist_submit((svk_cmdlist)$list);"
+		end
+
+	svk_wait_ticket (ctx: POINTER; a_ticket: NATURAL_64): INTEGER
+		external
+			"C blocking inline use <simple_vulkan.h>"
+		alias
+			"return svk_wait_ticket((svk_context)$ctx, (svk_ticket)$a_ticket);"
+		end
+
+	svk_free_cmdlist (list: POINTER)
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"svk_free_cmdlist((svk_cmdlist)$list);"
+		end
+
+invariant
+	valid_handle: is_valid implies handle /= default_pointer
+	context_attached: context /= Void
+	not_both: not (is_recording and is_ended)
+
+end
@@ -3,18 +3,30 @@ note
 		VULKAN_CONTEXT - Vulkan device context wrapper.
 
 		Represents an initialized Vulkan instance with a selected physical
-		device (GPU) and logical device. Automatically selects the best
-		available discrete GPU, falling back to integrated graphics.
+		device (GPU) and logical device. `make` selects the best available
+		discrete GPU, falling back to integrated graphics; `make_for_device`
+		uses a device chosen from {SIMPLE_VULKAN}.device_info. Several
+		contexts may be created on the same device.
+
+		A context may be shared by several threads. Each thread records
+		into its own command pools; waits for the GPU do not block the
+		other threads. Pipelines, command lists and graphs belong to one
+		thread at a time. A thread that is done with the context calls
+		`release_thread` so its command pools can be reused. Other SCOOP
+		processors reach the context through `make_shared`.
 
 		Usage:
 			local
 				ctx: VULKAN_CONTEXT
+				ok: BOOLEAN
 			do
 				create ctx.make
 				if ctx.is_valid then
 					print (ctx.device_name)
 					print (ctx.is_discrete_gpu)
-					-- ... use context ...
+					ok := ctx.load_pipeline_cache ("render.vkcache")
+					-- ... create pipelines, use context ...
+					ok := ctx.save_pipeline_cache ("render.vkcache")
 					ctx.dispose
 				end
 			end
@@ -27,12 +39,15 @@ class
 	VULKAN_CONTEXT
 
 create
-	make
+	make,
+	make_for_device,
+	make_shared
 
 feature {NONE} -- Initialization
 
 	make
-			-- Initialize Vulkan and select best available GPU.
+			-- Initialize Vulkan and select best available GPU
+			-- (most device-local memory among equals).
 		do
 			handle := svk_init
 			is_valid := handle /= default_pointer
@@ -40,6 +55,31 @@ feature {NONE} -- Initialization
 			valid_implies_handle: is_valid implies handle /= default_pointer
 		end
 
+	make_for_device (a_index: INTEGER)
+			-- Initialize Vulkan on physical device `a_index`.
+		require
+			valid_index: a_index >= 0
+		do
+			handle := svk_init_device (a_index.to_natural_32)
+			is_valid := handle /= default_pointer
+		ensure
+			valid_implies_handle: is_valid implies handle /= default_pointer
+		end
+
+	make_shared (a_handle: POINTER)
+			-- Use the context `a_handle` of another VULKAN_CONTEXT, e.g. on
+			-- another SCOOP processor. `dispose` leaves it to its owner.
+		require
+			handle_exists: a_handle /= default_pointer
+		do
+			handle := a_handle
+			is_valid := True
+			is_shared := True
+		ensure
+			handle_set: handle = a_handle
+			shared: is_shared
+		end
+
 feature -- Access
 
 	handle: POINTER
@@ -48,6 +88,9 @@ feature -- Access
 	is_valid: BOOLEAN
 			-- Was initialization successful?
 
+	is_shared: BOOLEAN
+			-- Is the context owned by another VULKAN_CONTEXT (`make_shared`)?
+
 	device_name: STRING
 			-- GPU device name (e.g., "NVIDIA GeForce RTX 5070 Ti")
 		require
@@ -75,6 +118,14 @@ feature -- Access
 			Result := svk_get_vendor_id (handle).to_integer_32
 		end
 
+	device_index: INTEGER
+			-- Index of the physical device, as used by `make_for_device`
+		require
+			valid: is_valid
+		do
+			Result := svk_get_device_index (handle).to_integer_32
+		end
+
 	is_discrete_gpu: BOOLEAN
 			-- Is this a discrete GPU (vs integrated)?
 		require
@@ -91,6 +142,72 @@ feature -- Access
 			Result := svk_get_max_workgroup_size (handle).to_integer_32
 		end
 
+	shader_module_count: INTEGER
+			-- Number of distinct shader modules loaded (identical SPIR-V is shared)
+		require
+			valid: is_valid
+		do
+			Result := svk_shader_module_count (handle).to_integer_32
+		end
+
+	pipeline_variant_count: INTEGER
+			-- Number of distinct compiled pipelines (same shader and constants are shared)
+		require
+			valid: is_valid
+		do
+			Result := svk_pipeline_variant_count (handle).to_integer_32
+		end
+
+	memory_stats: VULKAN_MEMORY_STATS
+			-- Snapshot of the GPU memory allocator
+		require
+			valid: is_valid
+		do
+			create Result.make (Current)
+		ensure
+			result_attached: Result /= Void
+		end
+
+	descriptor_stats: VULKAN_DESCRIPTOR_STATS
+			-- Snapshot of the descriptor pools
+		require
+			valid: is_valid
+		do
+			create Result.make (Current)
+		ensure
+			result_attached: Result /= Void
+		end
+
+	has_queue (a_role: INTEGER): BOOLEAN
+			-- Does `a_role` (`Queue_async_compute`, `Queue_transfer`) have its own hardware queue?
+			-- When False, its work runs on the compute queue.
+		require
+			valid: is_valid
+			valid_role: a_role = Queue_compute or a_role = Queue_async_compute or a_role = Queue_transfer
+		do
+			Result := svk_has_dedicated_queue (handle, a_role.to_natural_32) /= 0
+		end
+
+	queue_family (a_role: INTEGER): INTEGER
+			-- Vulkan queue family index serving `a_role`
+		require
+			valid: is_valid
+			valid_role: a_role = Queue_compute or a_role = Queue_async_compute or a_role = Queue_transfer
+		do
+			Result := svk_get_queue_family (handle, a_role.to_natural_32).to_integer_32
+		end
+
+feature -- Queue Constants
+
+	Queue_compute: INTEGER = 0
+			-- Main compute queue (dispatches, command lists, image downloads)
+
+	Queue_async_compute: INTEGER = 1
+			-- Second compute queue for {VULKAN_PIPELINE}.dispatch_async_on
+
+	Queue_transfer: INTEGER = 2
+			-- Queue for staged uploads/downloads of device-local buffers
+
 feature -- Vendor Constants
 
 	Vendor_nvidia: INTEGER = 0x10DE
@@ -128,13 +245,55 @@ feature -- Status
 			Result := vendor_id = Vendor_intel
 		end
 
+feature -- Pipeline Cache
+
+	load_pipeline_cache (a_path: STRING): BOOLEAN
+			-- Merge pipelines compiled in an earlier run (saved with `save_pipeline_cache`).
+			-- False if the file is missing, corrupt, or from another device or driver;
+			-- pipelines are then simply compiled from scratch.
+		require
+			valid: is_valid
+			path_attached: a_path /= Void and then not a_path.is_empty
+		local
+			l_c_path: C_STRING
+		do
+			create l_c_path.make (a_path)
+			Result := svk_load_pipeline_cache (handle, l_c_path.item) /= 0
+		end
+
+	save_pipeline_cache (a_path: STRING): BOOLEAN
+			-- Write all pipelines compiled so far to `a_path`.
+		require
+			valid: is_valid
+			path_attached: a_path /= Void and then not a_path.is_empty
+		local
+			l_c_path: C_STRING
+		do
+			create l_c_path.make (a_path)
+			Result := svk_save_pipeline_cache (handle, l_c_path.item) /= 0
+		end
+
+feature -- Threads
+
+	release_thread: BOOLEAN
+			-- Hand the calling thread's command pools to the next thread that uses the context.
+			-- False while a command list of this thread is not yet submitted.
+		require
+			valid: is_valid
+		do
+			Result := svk_release_thread (handle) /= 0
+		end
+
 feature -- Disposal
 
 	dispose
-			-- Release Vulkan resources.
+			-- Release Vulkan resources. No other thread may be using the context.
+			-- A shared context is only detached.
 		do
 			if is_valid and handle /= default_pointer then
-				svk_cleanup (handle)
+				if not is_shared then
+					svk_cleanup (handle)
+				end
 				handle := default_pointer
 				is_valid := False
 			end
@@ -152,6 +311,20 @@ feature {NONE} -- C Externals
 			"return svk_init();"
 		end
 
+	svk_init_device (a_index: NATURAL_32): POINTER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_init_device((uint32_t)$a_index);"
+		end
+
+	svk_get_device_index (ctx: POINTER): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_get_device_index((svk_context)$ctx);"
+		end
+
 	svk_get_device_name (ctx: POINTER): POINTER
 		external
 			"C inline use <simple_vulkan.h>"
@@ -173,6 +346,20 @@ feature {NONE} -- C Externals
 			"return svk_is_discrete_gpu((svk_context)$ctx);"
 		end
 
+	svk_has_dedicated_queue (ctx: POINTER; a_role: NATURAL_32): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_has_dedicated_queue((svk_context)$ctx, (uint32_t)$a_role);"
+		end
+
+	svk_get_queue_family (ctx: POINTER; a_role: NATURAL_32): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_get_queue_family((svk_context)$ctx, (uint32_t)$a_role);"
+		end
+
 	svk_get_max_workgroup_size (ctx: POINTER): NATURAL_32
 		external
 			"C inline use <simple_vulkan.h>"
@@ -180,6 +367,41 @@ feature {NONE} -- C Externals
 			"return svk_get_max_workgroup_size((svk_context)$ctx);"
 		end
 
+	svk_load_pipeline_cache (ctx, path: POINTER): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_load_pipeline_cache((svk_context)$ctx, (const char*)$path);"
+		end
+
+	svk_save_pipeline_cache (ctx, path: POINTER): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_save_pipeline_cache((svk_context)$ctx, (const char*)$path);"
+		end
+
+	svk_shader_module_count (ctx: POINTER): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_shader_module_count((svk_context)$ctx);"
+		end
+
+	svk_pipeline_variant_count (ctx: POINTER): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_pipeline_variant_count((svk_context)$ctx);"
+		end
+
+	svk_release_thread (ctx: POINTER): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_release_thread((svk_context)$ctx);"
+		end
+
 	svk_cleanup (ctx: POINTER)
 		external
 			"C inline use <simple_vulkan.h>"
@@ -0,0 +1,120 @@
+note
+	description: "[
+		VULKAN_DESCRIPTOR_STATS - Snapshot of a context's descriptor pools.
+
+		Descriptor sets come from a chain of pools that grows when the
+		existing pools fill up. Freeing a pipeline returns its sets, so
+		long-running programs that create pipelines per job keep a
+		stable pool count.
+
+		Usage:
+			local
+				stats: VULKAN_DESCRIPTOR_STATS
+			do
+				stats := ctx.descriptor_stats
+				print ("Pools: " + stats.pool_count.out + "%N")
+				print ("Sets: " + stats.sets_in_use.out + " / " + stats.set_capacity.out + "%N")
+			end
+	]"
+	author: "Larry Rix"
+	date: "$Date$"
+	revision: "$Revision$"
+
+class
+	VULKAN_DESCRIPTOR_STATS
+
+create
+	make
+
+feature {NONE} -- Initialization
+
+	make (a_ctx: VULKAN_CONTEXT)
+			-- Take a snapshot of the descriptor pools of `a_ctx`.
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+		local
+			l_stats: MANAGED_POINTER
+		do
+			create l_stats.make (c_stats_size)
+			is_valid := svk_get_descriptor_stats (a_ctx.handle, l_stats.item) /= 0
+			if is_valid then
+				pool_count := c_pool_count (l_stats.item).to_integer_32
+				set_capacity := c_set_capacity (l_stats.item).to_integer_32
+				sets_in_use := c_sets_in_use (l_stats.item).to_integer_32
+				sets_allocated := c_sets_allocated (l_stats.item).to_integer_64
+				sets_freed := c_sets_freed (l_stats.item).to_integer_64
+			end
+		end
+
+feature -- Access
+
+	is_valid: BOOLEAN
+			-- Was the snapshot taken?
+
+	pool_count: INTEGER
+			-- Descriptor pools created so far and still alive
+
+	set_capacity: INTEGER
+			-- Sets all pools can hold together
+
+	sets_in_use: INTEGER
+			-- Sets held by live pipelines
+
+	sets_allocated: INTEGER_64
+			-- Sets allocated over the context's lifetime
+
+	sets_freed: INTEGER_64
+			-- Sets returned over the context's lifetime
+
+feature {NONE} -- C Externals
+
+	svk_get_descriptor_stats (ctx, stats: POINTER): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_get_descriptor_stats((svk_context)$ctx, (svk_descriptor_stats*)$stats);"
+		end
+
+	c_stats_size: INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return (EIF_INTEGER)sizeof(svk_descriptor_stats);"
+		end
+
+	c_pool_count (p: POINTER): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_descriptor_stats*)$p)->pool_count;"
+		end
+
+	c_set_capacity (p: POINTER): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_descriptor_stats*)$p)->set_capacity;"
+		end
+
+	c_sets_in_use (p: POINTER): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_descriptor_stats*)$p)->sets_in_use;"
+		end
+
+	c_sets_allocated (p: POINTER): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_descriptor_stats*)$p)->sets_allocated;"
+		end
+
+	c_sets_freed (p: POINTER): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_descriptor_stats*)$p)->sets_freed;"
+		end
+
+end
@@ -0,0 +1,295 @@
+note
+	description: "[
+		VULKAN_DEVICE_INFO - Description of one physical device (GPU).
+
+		Lists what a device offers before a context is created on it:
+		its type, compute limits and memory heaps. Pass `index` to
+		{VULKAN_CONTEXT}.make_for_device to use the device.
+
+		Usage:
+			local
+				vk: SIMPLE_VULKAN
+				info: VULKAN_DEVICE_INFO
+				i: INTEGER
+			do
+				create vk
+				from i := 0 until i >= vk.device_count loop
+					info := vk.device_info (i)
+					if info.is_valid and info.has_compute then
+						print (info.name + ": " + info.device_local_bytes.out + " bytes%N")
+					end
+					i := i + 1
+				end
+			end
+	]"
+	author: "Larry Rix"
+	date: "$Date$"
+	revision: "$Revision$"
+
+class
+	VULKAN_DEVICE_INFO
+
+create
+	make
+
+feature {NONE} -- Initialization
+
+	make (a_index: INTEGER)
+			-- Describe physical device `a_index`.
+		require
+			valid_index: a_index >= 0
+		local
+			l_info: MANAGED_POINTER
+			l_name: C_STRING
+			i: INTEGER
+		do
+			index := a_index
+			name := ""
+			create heap_sizes.make_filled (0, 1, 0)
+			create l_info.make (c_info_size)
+			is_valid := svk_get_device_info (a_index.to_natural_32, l_info.item) /= 0
+			if is_valid then
+				create l_name.make_by_pointer (c_name (l_info.item))
+				name := l_name.string
+				device_type := c_type (l_info.item).to_integer_32
+				vendor_id := c_vendor_id (l_info.item).to_integer_32
+				device_id := c_device_id (l_info.item).to_integer_32
+				api_version := c_api_version (l_info.item).to_integer_32
+				has_compute := c_has_compute (l_info.item) /= 0
+				max_workgroup_size := c_max_workgroup_size (l_info.item).to_integer_32
+				max_workgroup_count_x := c_max_workgroup_count (l_info.item, 0).to_integer_32
+				max_workgroup_count_y := c_max_workgroup_count (l_info.item, 1).to_integer_32
+				max_workgroup_count_z := c_max_workgroup_count (l_info.item, 2).to_integer_32
+				max_push_constants_size := c_max_push_constants_size (l_info.item).to_integer_32
+				max_storage_buffer_range := c_max_storage_buffer_range (l_info.item).to_integer_64
+				max_image_dimension := c_max_image_dimension (l_info.item).to_integer_32
+				device_local_heaps := c_device_local_heaps (l_info.item).to_integer_32
+				device_local_bytes := c_device_local_bytes (l_info.item).to_integer_64
+				create heap_sizes.make_filled (0, 1, c_heap_count (l_info.item).to_integer_32)
+				from i := 1 until i > heap_sizes.count loop
+					heap_sizes [i] := c_heap_size (l_info.item, i - 1).to_integer_64
+					i := i + 1
+				end
+			end
+		ensure
+			index_set: index = a_index
+		end
+
+feature -- Access
+
+	index: INTEGER
+			-- Physical device index (0 .. {SIMPLE_VULKAN}.device_count - 1)
+
+	is_valid: BOOLEAN
+			-- Was the device found?
+
+	name: STRING
+			-- Device name (e.g., "NVIDIA GeForce RTX 5070 Ti")
+
+	device_type: INTEGER
+			-- One of the Type_* constants
+
+	vendor_id: INTEGER
+			-- GPU vendor ID (0x10DE=NVIDIA, 0x1002=AMD, 0x8086=Intel)
+
+	device_id: INTEGER
+			-- Vendor-specific device ID
+
+	api_version: INTEGER
+			-- Supported Vulkan version (VK_MAKE_VERSION encoding)
+
+	has_compute: BOOLEAN
+			-- Does the device have a compute queue? Contexts need one.
+
+	is_discrete: BOOLEAN
+			-- Is this a dedicated GPU?
+		do
+			Result := device_type = Type_discrete
+		end
+
+feature -- Limits
+
+	max_workgroup_size: INTEGER
+			-- Invocations per workgroup
+
+	max_workgroup_count_x, max_workgroup_count_y, max_workgroup_count_z: INTEGER
+			-- Workgroups per dispatch in each dimension
+
+	max_push_constants_size: INTEGER
+			-- Bytes of push constants
+
+	max_storage_buffer_range: INTEGER_64
+			-- Bytes of a storage buffer binding
+
+	max_image_dimension: INTEGER
+			-- Width or height of a 2D image
+
+feature -- Memory
+
+	heap_count: INTEGER
+			-- Memory heaps
+		do
+			Result := heap_sizes.count
+		end
+
+	heap_size (a_heap: INTEGER): INTEGER_64
+			-- Bytes in heap `a_heap` (0-based)
+		require
+			valid_heap: a_heap >= 0 and a_heap < heap_count
+		do
+			Result := heap_sizes [a_heap + 1]
+		end
+
+	is_heap_device_local (a_heap: INTEGER): BOOLEAN
+			-- Is heap `a_heap` (0-based) GPU memory?
+		require
+			valid_heap: a_heap >= 0 and a_heap < heap_count
+		do
+			Result := (device_local_heaps & (1 |<< a_heap)) /= 0
+		end
+
+	device_local_bytes: INTEGER_64
+			-- Sum of the device-local heaps
+
+feature -- Constants
+
+	Type_other: INTEGER = 0
+	Type_integrated: INTEGER = 1
+	Type_discrete: INTEGER = 2
+	Type_virtual: INTEGER = 3
+	Type_cpu: INTEGER = 4
+
+feature {NONE} -- Implementation
+
+	heap_sizes: ARRAY [INTEGER_64]
+			-- Bytes per heap
+
+	device_local_heaps: INTEGER
+			-- Bit per device-local heap
+
+feature {NONE} -- C Externals
+
+	svk_get_device_info (a_index: NATURAL_32; info: POINTER): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_get_device_info((uint32_t)$a_index, (svk_device_info*)$info);"
+		end
+
+	c_info_size: INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return (EIF_INTEGER)sizeof(svk_device_info);"
+		end
+
+	c_name (p: POINTER): POINTER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_device_info*)$p)->name;"
+		end
+
+	c_type (p: POINTER): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_device_info*)$p)->type;"
+		end
+
+	c_vendor_id (p: POINTER): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_device_info*)$p)->vendor_id;"
+		end
+
+	c_device_id (p: POINTER): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_device_info*)$p)->device_id;"
+		end
+
+	c_api_version (p: POINTER): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_device_info*)$p)->api_version;"
+		end
+
+	c_has_compute (p: POINTER): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_device_info*)$p)->has_compute;"
+		end
+
+	c_max_workgroup_size (p: POINTER): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_device_info*)$p)->max_workgroup_size;"
+		end
+
+	c_max_workgroup_count (p: POINTER; i: INTEGER): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_device_info*)$p)->max_workgroup_count[$i];"
+		end
+
+	c_max_push_constants_size (p: POINTER): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_device_info*)$p)->max_push_constants_size;"
+		end
+
+	c_max_storage_buffer_range (p: POINTER): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_device_info*)$p)->max_storage_buffer_range;"
+		end
+
+	c_max_image_dimension (p: POINTER): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_device_info*)$p)->max_image_dimension;"
+		end
+
+	c_heap_count (p: POINTER): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_device_info*)$p)->heap_count;"
+		end
+
+	c_heap_size (p: POINTER; i: INTEGER): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_device_info*)$p)->heap_size[$i];"
+		end
+
+	c_device_local_heaps (p: POINTER): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_device_info*)$p)->device_local_heaps;"
+		end
+
+	c_device_local_bytes (p: POINTER): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_device_info*)$p)->device_local_bytes;"
+		end
+
+invariant
+	name_attached: name /= Void
+	heaps_attached: heap_sizes /= Void
+
+end
@@ -0,0 +1,474 @@
+note
+	description: "[
+		VULKAN_GRAPH - Compute task graph, compiled once and run every frame.
+
+		Nodes (dispatches, copies and readbacks) are added in execution
+		order. A dispatch reads and writes the pipeline's bindings as
+		they are when the node is added; bindings the shader declares
+		read-only are only read. Copies and readbacks read their source
+		and write their target.
+
+		`compile` groups consecutive nodes on the same queue into
+		batches and records each batch once, with barriers only between
+		dependent nodes. `run` submits the batches without waiting;
+		batches on different queues overlap and wait for each other on
+		the GPU only where they share resources. Changing a node's push
+		constants or workgroup counts re-records just its batch.
+
+		Pipelines, buffers and images used by the graph must outlive it.
+
+		Transient buffers and images (`new_transient_buffer`,
+		`new_transient_image`) belong to the graph and only get memory
+		when it is compiled. Transients whose uses (first to last node)
+		do not overlap share memory, so intermediate targets cost only
+		their peak: write a transient before reading it in every run.
+		Bind transients only to pipelines run by this graph.
+
+		Usage:
+			local
+				graph: VULKAN_GRAPH
+				gbuffer: VULKAN_IMAGE
+				march, shade, rb: INTEGER
+				ok: BOOLEAN
+			do
+				create graph.make (ctx)
+				gbuffer := graph.new_transient_image (3840, 2160, {VULKAN_IMAGE}.Format_rgba32f)
+				ok := march_pipe.bind_image (0, gbuffer) and shade_pipe.bind_image (1, gbuffer)
+				march := graph.add_dispatch (march_pipe, 240, 135, 1)
+				shade := graph.add_dispatch (shade_pipe, 240, 135, 1)
+				rb := graph.add_image_readback_on (ctx.Queue_transfer, frame_image)
+				if graph.compile then
+					ok := graph.set_push_constants (march, camera.item, camera.count)
+						and then graph.run
+					-- ... prepare next frame ...
+					ok := graph.read (rb, pixels.item)
+				end
+				graph.dispose
+			end
+	]"
+	author: "Larry Rix"
+	date: "$Date$"
+	revision: "$Revision$"
+
+class
+	VULKAN_GRAPH
+
+create
+	make
+
+feature {NONE} -- Initialization
+
+	make (a_ctx: VULKAN_CONTEXT)
+			-- Create empty graph on `a_ctx`.
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+		do
+			context := a_ctx
+			handle := svk_create_graph (a_ctx.handle)
+			is_valid := handle /= default_pointer
+		ensure
+			context_set: context = a_ctx
+			empty: node_count = 0
+			not_compiled: not is_compiled
+		end
+
+feature -- Access
+
+	handle: POINTER
+			-- Opaque handle to svk_graph
+
+	context: VULKAN_CONTEXT
+			-- Parent context
+
+	is_valid: BOOLEAN
+			-- Was graph creation successful?
+
+	is_compiled: BOOLEAN
+			-- Has the graph been compiled? (No nodes can be added afterwards.)
+
+	node_count: INTEGER
+			-- Nodes added so far
+
+	batch_count: INTEGER
+			-- Submissions per `run`
+		require
+			compiled: is_compiled
+		do
+			Result := svk_graph_batch_count (handle).to_integer_32
+		end
+
+	transient_bytes: INTEGER_64
+			-- Device memory taken by the transients
+		require
+			compiled: is_compiled
+		do
+			Result := svk_graph_transient_bytes (handle).to_integer_64
+		end
+
+	unaliased_bytes: INTEGER_64
+			-- Device memory the transients would take without sharing
+		require
+			compiled: is_compiled
+		do
+			Result := svk_graph_unaliased_bytes (handle).to_integer_64
+		end
+
+feature -- Building
+
+	add_dispatch (a_pipeline: VULKAN_PIPELINE; a_x, a_y, a_z: INTEGER): INTEGER
+			-- Add a dispatch on the compute queue with the pipeline's current
+			-- bindings and push constants. Returns the node index, or -1.
+		require
+			building: is_valid and not is_compiled
+			pipeline_valid: a_pipeline /= Void and then a_pipeline.is_valid
+			positive_counts: a_x > 0 and a_y > 0 and a_z > 0
+		do
+			Result := add_dispatch_on (context.Queue_compute, a_pipeline, a_x, a_y, a_z)
+		end
+
+	add_dispatch_on (a_queue: INTEGER; a_pipeline: VULKAN_PIPELINE; a_x, a_y, a_z: INTEGER): INTEGER
+			-- As `add_dispatch`, on `a_queue` ({VULKAN_CONTEXT}.Queue_compute or
+			-- Queue_async_compute).
+		require
+			building: is_valid and not is_compiled
+			compute_queue: a_queue = context.Queue_compute or a_queue = context.Queue_async_compute
+			pipeline_valid: a_pipeline /= Void and then a_pipeline.is_valid
+			positive_counts: a_x > 0 and a_y > 0 and a_z > 0
+		do
+			Result := svk_graph_dispatch (handle, a_pipeline.handle, a_queue.to_natural_32,
+				a_x.to_natural_32, a_y.to_natural_32, a_z.to_natural_32)
+			count_node (Result)
+		end
+
+	add_dispatch_indirect_on (a_queue: INTEGER; a_pipeline: VULKAN_PIPELINE; a_args: VULKAN_BUFFER; a_offset: INTEGER_64): INTEGER
+			-- As `add_dispatch_on`, with the workgroup counts that `a_args` holds at
+			-- `a_offset` in each run (see {VULKAN_PIPELINE}.dispatch_indirect).
+		require
+			building: is_valid and not is_compiled
+			compute_queue: a_queue = context.Queue_compute or a_queue = context.Queue_async_compute
+			pipeline_valid: a_pipeline /= Void and then a_pipeline.is_valid
+			args_valid: a_args /= Void and then a_args.is_valid
+			indirect_usage: (a_args.usage & a_args.Buffer_indirect) /= 0
+			aligned_offset: a_offset >= 0 and a_offset \\ 4 = 0
+			valid_range: a_offset + 12 <= a_args.size
+		do
+			Result := svk_graph_dispatch_indirect (handle, a_pipeline.handle, a_queue.to_natural_32,
+				a_args.handle, a_offset.to_natural_64)
+			count_node (Result)
+		end
+
+	add_copy_on (a_queue: INTEGER; a_source, a_target: VULKAN_BUFFER;
+			a_source_offset, a_target_offset, a_size: INTEGER_64): INTEGER
+			-- Add a copy of `a_size` bytes from `a_source` to `a_target` on `a_queue`.
+			-- Returns the node index, or -1.
+		require
+			building: is_valid and not is_compiled
+			valid_queue: a_queue >= context.Queue_compute and a_queue <= context.Queue_transfer
+			source_valid: a_source /= Void and then a_source.is_valid
+			target_valid: a_target /= Void and then a_target.is_valid
+			valid_size: a_size > 0
+			valid_source_range: a_source_offset >= 0 and then a_source_offset + a_size <= a_source.size
+			valid_target_range: a_target_offset >= 0 and then a_target_offset + a_size <= a_target.size
+		do
+			Result := svk_graph_copy_buffer (handle, a_queue.to_natural_32, a_source.handle, a_target.handle,
+				a_source_offset.to_natural_64, a_target_offset.to_natural_64, a_size.to_natural_64)
+			count_node (Result)
+		end
+
+	add_buffer_readback_on (a_queue: INTEGER; a_buffer: VULKAN_BUFFER; a_offset, a_size: INTEGER_64): INTEGER
+			-- Add a copy of `a_size` bytes of `a_buffer` into host memory owned by
+			-- the graph, collected with `read`. Returns the node index, or -1.
+		require
+			building: is_valid and not is_compiled
+			valid_queue: a_queue >= context.Queue_compute and a_queue <= context.Queue_transfer
+			buffer_valid: a_buffer /= Void and then a_buffer.is_valid
+			valid_size: a_size > 0
+			valid_range: a_offset >= 0 and then a_offset + a_size <= a_buffer.size
+		do
+			Result := svk_graph_readback_buffer (handle, a_queue.to_natural_32, a_buffer.handle,
+				a_offset.to_natural_64, a_size.to_natural_64)
+			count_node (Result)
+		end
+
+	add_image_readback_on (a_queue: INTEGER; a_image: VULKAN_IMAGE): INTEGER
+			-- Add a copy of `a_image` into host memory owned by the graph,
+			-- collected with `read`. Returns the node index, or -1.
+		require
+			building: is_valid and not is_compiled
+			valid_queue: a_queue >= context.Queue_compute and a_queue <= context.Queue_transfer
+			image_valid: a_image /= Void and then a_image.is_valid
+		do
+			Result := svk_graph_readback_image (handle, a_queue.to_natural_32, a_image.handle)
+			count_node (Result)
+		end
+
+	new_transient_buffer (a_size: INTEGER_64; a_usage: INTEGER): VULKAN_BUFFER
+			-- New device-local buffer owned by the graph; check `is_valid`.
+		require
+			building: is_valid and not is_compiled
+			positive_size: a_size > 0
+			device_placement: (a_usage & {VULKAN_BUFFER}.Placement_mask) = 0
+				or (a_usage & {VULKAN_BUFFER}.Placement_mask) = {VULKAN_BUFFER}.Buffer_device_local
+		local
+			l_usage: INTEGER
+		do
+			l_usage := a_usage | {VULKAN_BUFFER}.Buffer_device_local
+			create Result.make_transient (context,
+				svk_graph_transient_buffer (handle, a_size.to_natural_64, l_usage.to_natural_32), a_size, l_usage)
+		ensure
+			transient: Result.is_transient
+		end
+
+	new_transient_image (a_width, a_height, a_format: INTEGER): VULKAN_IMAGE
+			-- New image owned by the graph; check `is_valid`.
+		require
+			building: is_valid and not is_compiled
+			positive_dimensions: a_width > 0 and a_height > 0
+		do
+			create Result.make_transient (context, svk_graph_transient_image (handle,
+				a_width.to_natural_32, a_height.to_natural_32, a_format.to_natural_32), a_width, a_height, a_format)
+		ensure
+			transient: Result.is_transient
+		end
+
+	compile: BOOLEAN
+			-- Give transients memory, group nodes into batches and record them.
+		require
+			building: is_valid and not is_compiled
+			has_nodes: node_count > 0
+		do
+			Result := svk_graph_compile (handle) /= 0
+			is_compiled := Result
+		ensure
+			compiled_on_success: Result implies is_compiled
+		end
+
+feature -- Parameters
+
+	set_push_constants (a_node: INTEGER; a_data: POINTER; a_size: INTEGER): BOOLEAN
+			-- Replace the push constants of dispatch node `a_node`.
+			-- Fails if `a_size` exceeds the shader's push-constant block.
+		require
+			valid: is_valid
+			valid_node: a_node >= 0 and a_node < node_count
+			data_attached: a_data /= default_pointer
+			valid_size: a_size > 0 and a_size <= 256
+		do
+			Result := svk_graph_set_push_constants (handle, a_node, a_data, a_size.to_natural_32) /= 0
+		end
+
+	set_workgroups (a_node: INTEGER; a_x, a_y, a_z: INTEGER): BOOLEAN
+			-- Replace the workgroup counts of dispatch node `a_node`.
+			-- Fails for indirect dispatches.
+		require
+			valid: is_valid
+			valid_node: a_node >= 0 and a_node < node_count
+			positive_counts: a_x > 0 and a_y > 0 and a_z > 0
+		do
+			Result := svk_graph_set_groups (handle, a_node,
+				a_x.to_natural_32, a_y.to_natural_32, a_z.to_natural_32) /= 0
+		end
+
+feature -- Execution
+
+	run: BOOLEAN
+			-- Submit every batch without waiting for the GPU.
+		require
+			compiled: is_compiled
+		do
+			Result := svk_graph_run (handle) /= 0
+		end
+
+	is_done: BOOLEAN
+			-- Has the latest run finished?
+		require
+			valid: is_valid
+		do
+			Result := svk_graph_poll (handle) /= 0
+		end
+
+	wait: BOOLEAN
+			-- Block until the latest run has finished.
+		require
+			valid: is_valid
+		do
+			Result := svk_graph_wait (handle) /= 0
+		end
+
+	read (a_node: INTEGER; a_data: POINTER): BOOLEAN
+			-- Copy what readback node `a_node` captured in the latest run into
+			-- `a_data`, waiting for it if needed.
+		require
+			valid: is_valid
+			valid_node: a_node >= 0 and a_node < node_count
+			data_attached: a_data /= default_pointer
+		do
+			Result := svk_graph_read (handle, a_node, a_data) /= 0
+		end
+
+feature -- Disposal
+
+	dispose
+			-- Free graph after its runs have finished.
+		do
+			if is_valid and handle /= default_pointer then
+				svk_free_graph (handle)
+				handle := default_pointer
+				is_valid := False
+			end
+		ensure
+			disposed: not is_valid
+			handle_cleared: handle = default_pointer
+		end
+
+feature {NONE} -- Implementation
+
+	count_node (a_index: INTEGER)
+			-- Record that node `a_index` was added (-1 = not added).
+		do
+			if a_index >= 0 then
+				node_count := a_index + 1
+			end
+		end
+
+feature {NONE} -- C Externals
+
+	svk_create_graph (ctx: POINTER): POINTER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_create_graph((svk_context)$ctx);"
+		end
+
+	svk_graph_dispatch (graph, pipe: POINTER; a_role, x, y, z: NATURAL_32): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_graph_dispatch((svk_graph)$graph, (svk_pipeline)$pipe, (uint32_t)$a_role, (uint32_t)$x, (uint32_t)$y, (uint32_t)$z);"
+		end
+
+	svk_graph_dispatch_indirect (graph, pipe: POINTER; a_role: NATURAL_32; args: POINTER; a_offset: NATURAL_64): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_graph_dispatch_indirect((svk_graph)$graph, (svk_pipeline)$pipe, (uint32_t)$a_role, (svk_buffer)$args, (uint64_t)$a_offset);"
+		end
+
+	svk_graph_copy_buffer (graph: POINTER; a_role: NATURAL_32; src, dst: POINTER; src_offset, dst_offset, a_size: NATURAL_64): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_graph_copy_buffer((svk_graph)$graph, (uint32_t)$a_role, (svk_buffer)$src, (svk_buffer)$dst, (uint64_t)$src_offset, (uint64_t)$dst_offset, (uint64_t)$a_size);"
+		end
+
+	svk_graph_readback_buffer (graph: POINTER; a_role: NATURAL_32; buf: POINTER; a_offset, a_size: NATURAL_64): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_graph_readback_buffer((svk_graph)$graph, (uint32_t)$a_role, (svk_buffer)$buf, (uint64_t)$a_offset, (uint64_t)$a_size);"
+		end
+
+	svk_graph_readback_image (graph: POINTER; a_role: NATURAL_32; img: POINTER): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_graph_readback_image((svk_graph)$graph, (uint32_t)$a_role, (svk_image)$img);"
+		end
+
+	svk_graph_transient_buffer (graph: POINTER; a_size: NATURAL_64; a_usage: NATURAL_32): POINTER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_graph_transient_buffer((svk_graph)$graph, (uint64_t)$a_size, (uint32_t)$a_usage);"
+		end
+
+	svk_graph_transient_image (graph: POINTER; a_width, a_height, a_format: NATURAL_32): POINTER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_graph_transient_image((svk_graph)$graph, (uint32_t)$a_width, (uint32_t)$a_height, (uint32_t)$a_format);"
+		end
+
+	svk_graph_compile (graph: POINTER): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_graph_compile((svk_graph)$graph);"
+		end
+
+	svk_graph_batch_count (graph: POINTER): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_graph_batch_count((svk_graph)$graph);"
+		end
+
+	svk_graph_transient_bytes (graph: POINTER): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_graph_transient_bytes((svk_graph)$graph);"
+		end
+
+	svk_graph_unaliased_bytes (graph: POINTER): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_graph_unaliased_bytes((svk_graph)$graph);"
+		end
+
+	svk_graph_set_push_constants (graph: POINTER; a_node: INTEGER; data: POINTER; a_size: NATURAL_32): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_graph_set_push_constants((svk_graph)$graph, (int)$a_node, $data, (uint32_t)$a_size);"
+		end
+
+	svk_graph_set_groups (graph: POINTER; a_node: INTEGER; x, y, z: NATURAL_32): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_graph_set_groups((svk_graph)$graph, (int)$a_node, (uint32_t)$x, (uint32_t)$y, (uint32_t)$z);"
+		end
+
+	svk_graph_run (graph: POINTER): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_graph_run((svk_graph)$graph);"
+		end
+
+	svk_graph_poll (graph: POINTER): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_graph_poll((svk_graph)$graph);"
+		end
+
+	svk_graph_wait (graph: POINTER): INTEGER
+		external
+			"C blocking inline use <simple_vulkan.h>"
+		alias
+			"return svk_graph_wait((svk_graph)$graph);"
+		end
+
+	svk_graph_read (graph: POINTER; a_node: INTEGER; data: POINTER): INTEGER
+		external
+			"C blocking inline use <simple_vulkan.h>"
+		alias
+			"return svk_graph_read((svk_graph)$graph, (int)$a_node, $data);"
+		end
+
+	svk_free_graph (graph: POINTER)
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"svk_free_graph((svk_graph)$graph);"
+		end
+
+invariant
+	valid_handle: is_valid implies handle /= default_pointer
+	context_attached: context /= Void
+	non_negative_nodes: node_count >= 0
+
+end
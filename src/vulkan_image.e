@@ -6,6 +6,22 @@ note
 		Images can be bound to compute pipelines and their
 		contents downloaded to CPU memory for display.
 
+		For streaming, `begin_download` starts a readback without
+		waiting, so frame N can be copied out while frame N+1 renders;
+		`finish_download` collects the pixels once they have arrived.
+		Up to `Readback_slots` downloads per context can be outstanding.
+
+		`download_packed` and `begin_packed_download` convert the image
+		on the GPU first (RGBA8, RGB10A2, RGBA16F or YUV420, see the
+		`Pack_*` constants) with a pipeline from
+		{VULKAN_PIPELINE}.make_packer, so an RGBA32F frame crosses the
+		bus in a half or an eighth of its size.
+
+		Images are optimally tiled and kept in GENERAL layout, which
+		serves both storage writes and downloads without transitions.
+		Bind them to slots declared `Binding_image` in
+		{VULKAN_PIPELINE}.make_with_bindings.
+
 		Usage:
 			local
 				img: VULKAN_IMAGE
@@ -20,6 +36,10 @@ note
 					img.dispose
 				end
 			end
+
+		Images made by {VULKAN_GRAPH}.new_transient_image are
+		transient: the graph owns their memory, which they may share
+		with other transients, and frees them with itself.
 	]"
 	author: "Larry Rix"
 	date: "$Date$"
@@ -31,6 +51,9 @@ class
 create
 	make
 
+create {VULKAN_GRAPH}
+	make_transient
+
 feature {NONE} -- Initialization
 
 	make (a_ctx: VULKAN_CONTEXT; a_width, a_height: INTEGER; a_format: INTEGER)
@@ -53,6 +76,24 @@ feature {NONE} -- Initialization
 			format_set: format = a_format
 		end
 
+	make_transient (a_ctx: VULKAN_CONTEXT; a_handle: POINTER; a_width, a_height: INTEGER; a_format: INTEGER)
+			-- Wrap graph-owned image `a_handle` (default_pointer if its creation failed).
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			positive_dimensions: a_width > 0 and a_height > 0
+		do
+			context := a_ctx
+			width := a_width
+			height := a_height
+			format := a_format
+			handle := a_handle
+			is_valid := handle /= default_pointer
+			is_transient := True
+		ensure
+			context_set: context = a_ctx
+			transient: is_transient
+		end
+
 feature -- Access
 
 	handle: POINTER
@@ -73,6 +114,9 @@ feature -- Access
 	is_valid: BOOLEAN
 			-- Was image creation successful?
 
+	is_transient: BOOLEAN
+			-- Is the image owned by a {VULKAN_GRAPH}, which frees it?
+
 feature -- Format Constants
 
 	Format_rgba8: INTEGER = 0x01
@@ -81,6 +125,23 @@ feature -- Format Constants
 	Format_rgba32f: INTEGER = 0x02
 			-- 32-bit float RGBA format (16 bytes per pixel)
 
+	Readback_slots: INTEGER = 4
+			-- Downloads per context that can be outstanding at once
+
+feature -- Pack Constants
+
+	Pack_rgba8: INTEGER = 0x01
+			-- One byte per channel (4 bytes per pixel)
+
+	Pack_rgb10a2: INTEGER = 0x02
+			-- 10 bits per color, 2 bits alpha (4 bytes per pixel)
+
+	Pack_rgba16f: INTEGER = 0x03
+			-- Half floats (8 bytes per pixel)
+
+	Pack_yuv420: INTEGER = 0x04
+			-- BT.601 planar I420 (1.5 bytes per pixel); width a multiple of 8, height even
+
 feature -- Computed Properties
 
 	bytes_per_pixel: INTEGER
@@ -106,6 +167,14 @@ feature -- Computed Properties
 			positive: Result > 0
 		end
 
+	packed_bytes (a_pack: INTEGER): INTEGER
+			-- Image size in bytes packed as `a_pack`, or 0 if it cannot be
+		do
+			Result := svk_packed_image_size (handle, a_pack.to_natural_32).to_integer_32
+		ensure
+			non_negative: Result >= 0
+		end
+
 feature -- Data Transfer
 
 	download (a_data: POINTER): BOOLEAN
@@ -118,13 +187,82 @@ feature -- Data Transfer
 			Result := svk_download_image (context.handle, handle, a_data) /= 0
 		end
 
+	begin_download: NATURAL_64
+			-- Start copying the image to host memory without waiting.
+			-- Returns a ticket for `finish_download`, or 0 if `Readback_slots`
+			-- downloads are already outstanding.
+		require
+			valid: is_valid
+		do
+			Result := svk_begin_image_download (context.handle, handle)
+		end
+
+	download_packed (a_packer: VULKAN_PIPELINE; a_pack: INTEGER; a_data: POINTER): BOOLEAN
+			-- Pack the image as `a_pack` with `a_packer` and download it.
+			-- Buffer must be at least `packed_bytes (a_pack)` in size.
+		require
+			valid: is_valid
+			packer_valid: a_packer /= Void and then a_packer.is_valid
+			packable: packed_bytes (a_pack) > 0
+			data_attached: a_data /= default_pointer
+		do
+			Result := svk_download_image_packed (context.handle, a_packer.handle, handle,
+				a_pack.to_natural_32, a_data) /= 0
+		end
+
+	begin_packed_download (a_packer: VULKAN_PIPELINE; a_pack: INTEGER): NATURAL_64
+			-- Start packing the image as `a_pack` with `a_packer` and copying it
+			-- to host memory without waiting. Returns a ticket for `finish_download`,
+			-- or 0 on failure.
+		require
+			valid: is_valid
+			packer_valid: a_packer /= Void and then a_packer.is_valid
+			packable: packed_bytes (a_pack) > 0
+		do
+			Result := svk_begin_packed_download (context.handle, a_packer.handle, handle,
+				a_pack.to_natural_32)
+		end
+
+	is_download_ready (a_ticket: NATURAL_64): BOOLEAN
+			-- Has the download `a_ticket` arrived in host memory?
+		require
+			valid: is_valid
+		do
+			Result := svk_poll_ticket (context.handle, a_ticket) /= 0
+		end
+
+	finish_download (a_ticket: NATURAL_64; a_data: POINTER): BOOLEAN
+			-- Copy download `a_ticket`, started by `begin_download` on this image,
+			-- into `a_data` (at least `total_bytes`, or `packed_bytes` for
+			-- `begin_packed_download`) and release its slot.
+			-- Waits if the copy has not finished.
+		require
+			valid: is_valid
+			started: a_ticket > 0
+			data_attached: a_data /= default_pointer
+		do
+			Result := svk_finish_image_download (context.handle, a_ticket, a_data) /= 0
+		end
+
+	cancel_download (a_ticket: NATURAL_64)
+			-- Release the slot of download `a_ticket` without reading it.
+		require
+			valid: is_valid
+		local
+			l_ok: INTEGER
+		do
+			l_ok := svk_finish_image_download (context.handle, a_ticket, default_pointer)
+		end
+
 feature -- Disposal
 
 	dispose
-			-- Free GPU image.
+			-- Free GPU image. A transient image is only detached.
 		do
 			if is_valid and handle /= default_pointer then
-				svk_free_image (context.handle, handle)
+				if not is_transient then
+					svk_free_image (context.handle, handle)
+				end
 				handle := default_pointer
 				is_valid := False
 			end
@@ -144,11 +282,53 @@ feature {NONE} -- C Externals
 
 	svk_download_image (ctx, img, data: POINTER): INTEGER
 		external
-			"C inline use <simple_vulkan.h>"
+			"C blocking inline use <simple_vulkan.h>"
 		alias
 			"return svk_download_image((svk_context)$ctx, (svk_image)$img, $data);"
 		end
 
+	svk_begin_image_download (ctx, img: POINTER): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_begin_image_download((svk_context)$ctx, (svk_image)$img);"
+		end
+
+	svk_packed_image_size (img: POINTER; a_pack: NATURAL_32): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_packed_image_size((svk_image)$img, (uint32_t)$a_pack);"
+		end
+
+	svk_download_image_packed (ctx, a_packer, img: POINTER; a_pack: NATURAL_32; data: POINTER): INTEGER
+		external
+			"C blocking inline use <simple_vulkan.h>"
+		alias
+			"return svk_download_image_packed((svk_context)$ctx, (svk_pipeline)$a_packer, (svk_image)$img, (uint32_t)$a_pack, $data);"
+		end
+
+	svk_begin_packed_download (ctx, a_packer, img: POINTER; a_pack: NATURAL_32): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_begin_packed_download((svk_context)$ctx, (svk_pipeline)$a_packer, (svk_image)$img, (uint32_t)$a_pack);"
+		end
+
+	svk_finish_image_download (ctx: POINTER; a_ticket: NATURAL_64; data: POINTER): INTEGER
+		external
+			"C blocking inline use <simple_vulkan.h>"
+		alias
+			"return svk_finish_image_download((svk_context)$ctx, (svk_ticket)$a_ticket, $data);"
+		end
+
+	svk_poll_ticket (ctx: POINTER; a_ticket: NATURAL_64): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_poll_ticket((svk_context)$ctx, (svk_ticket)$a_ticket);"
+		end
+
 	svk_free_image (ctx, img: POINTER)
 		external
 			"C inline use <simple_vulkan.h>"
@@ -0,0 +1,159 @@
+note
+	description: "[
+		VULKAN_MEMORY_STATS - Snapshot of a context's GPU memory allocator.
+
+		Buffers and images are sub-allocated from large device memory
+		blocks. This reports how many blocks exist, how much of them is
+		in use and how fragmented the remaining free space is.
+
+		Usage:
+			local
+				stats: VULKAN_MEMORY_STATS
+			do
+				stats := ctx.memory_stats
+				print ("Blocks: " + stats.block_count.out + "%N")
+				print ("Used: " + stats.bytes_used.out + " / " + stats.bytes_reserved.out + "%N")
+				print ("Fragmentation: " + stats.fragmentation.out + "%N")
+			end
+	]"
+	author: "Larry Rix"
+	date: "$Date$"
+	revision: "$Revision$"
+
+class
+	VULKAN_MEMORY_STATS
+
+create
+	make
+
+feature {NONE} -- Initialization
+
+	make (a_ctx: VULKAN_CONTEXT)
+			-- Take a snapshot of the allocator of `a_ctx`.
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+		local
+			l_stats: MANAGED_POINTER
+		do
+			create l_stats.make (c_stats_size)
+			is_valid := svk_get_memory_stats (a_ctx.handle, l_stats.item) /= 0
+			if is_valid then
+				block_count := c_block_count (l_stats.item).to_integer_32
+				dedicated_count := c_dedicated_count (l_stats.item).to_integer_32
+				allocation_count := c_allocation_count (l_stats.item).to_integer_32
+				free_range_count := c_free_range_count (l_stats.item).to_integer_32
+				bytes_reserved := c_bytes_reserved (l_stats.item).to_integer_64
+				bytes_used := c_bytes_used (l_stats.item).to_integer_64
+				largest_free_range := c_largest_free_range (l_stats.item).to_integer_64
+				fragmentation := c_fragmentation (l_stats.item)
+			end
+		end
+
+feature -- Access
+
+	is_valid: BOOLEAN
+			-- Was the snapshot taken?
+
+	block_count: INTEGER
+			-- Device memory allocations, including dedicated ones
+
+	dedicated_count: INTEGER
+			-- Blocks holding a single large resource
+
+	allocation_count: INTEGER
+			-- Live buffers and images
+
+	free_range_count: INTEGER
+			-- Free ranges across all blocks
+
+	bytes_reserved: INTEGER_64
+			-- Device memory allocated from the driver
+
+	bytes_used: INTEGER_64
+			-- Bytes handed out to buffers and images
+
+	largest_free_range: INTEGER_64
+			-- Largest contiguous free range
+
+	fragmentation: REAL_64
+			-- 0.0 when all free space is contiguous, approaching 1.0 when scattered
+
+	bytes_free: INTEGER_64
+			-- Reserved but unused bytes
+		do
+			Result := bytes_reserved - bytes_used
+		end
+
+feature {NONE} -- C Externals
+
+	svk_get_memory_stats (ctx, stats: POINTER): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_get_memory_stats((svk_context)$ctx, (svk_memory_stats*)$stats);"
+		end
+
+	c_stats_size: INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return (EIF_INTEGER)sizeof(svk_memory_stats);"
+		end
+
+	c_block_count (p: POINTER): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_memory_stats*)$p)->block_count;"
+		end
+
+	c_dedicated_count (p: POINTER): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_memory_stats*)$p)->dedicated_count;"
+		end
+
+	c_allocation_count (p: POINTER): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_memory_stats*)$p)->allocation_count;"
+		end
+
+	c_free_range_count (p: POINTER): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_memory_stats*)$p)->free_range_count;"
+		end
+
+	c_bytes_reserved (p: POINTER): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_memory_stats*)$p)->bytes_reserved;"
+		end
+
+	c_bytes_used (p: POINTER): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_memory_stats*)$p)->bytes_used;"
+		end
+
+	c_largest_free_range (p: POINTER): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_memory_stats*)$p)->largest_free_range;"
+		end
+
+	c_fragmentation (p: POINTER): REAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_memory_stats*)$p)->fragmentation;"
+		end
+
+end
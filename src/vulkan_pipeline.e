@@ -6,16 +6,38 @@ note
 		bindings, and push constants. Bind buffers and images to
 		descriptor slots, then dispatch compute workgroups.
 
+		`make` builds the exact descriptor layout and push-constant
+		range the shader declares (see {VULKAN_SHADER}.binding_type),
+		and `dispatch_threads` sizes workgroups from its local size.
+
+		`make_specialized` folds specialization constants into the
+		compiled shader (see {VULKAN_SPEC_CONSTANTS}); pipelines with
+		the same shader and constants share one compiled variant.
+
+		`make_packer` builds a pipeline from shaders/pack_image.spv
+		(or pack_image_rgba8.spv) for {VULKAN_IMAGE}.download_packed.
+
+		Descriptor sets are written only when bindings change, and
+		the last few binding combinations are cached, so alternating
+		between buffer sets (ping-pong) costs no descriptor updates.
+
 		Usage:
 			local
 				pipe: VULKAN_PIPELINE
+				ticket: NATURAL_64
+				ok: BOOLEAN
 			do
 				create pipe.make (ctx, shader)
 				if pipe.is_valid then
 					pipe.bind_buffer (0, input_buffer)
 					pipe.bind_buffer (1, output_buffer)
 					pipe.dispatch (ctx, 64, 64, 1)
+					pipe.dispatch_threads (ctx, 1920, 1080, 1)
 					ctx.wait_idle
+					-- Or overlap CPU work with the GPU:
+					ticket := pipe.dispatch_async (ctx, 64, 64, 1)
+					-- ... prepare next frame ...
+					ok := pipe.wait_ticket (ctx, ticket)
 					pipe.dispose
 				end
 			end
@@ -28,7 +50,10 @@ class
 	VULKAN_PIPELINE
 
 create
-	make
+	make,
+	make_with_bindings,
+	make_specialized,
+	make_packer
 
 feature {NONE} -- Initialization
 
@@ -47,6 +72,70 @@ feature {NONE} -- Initialization
 			shader_set: shader = a_shader
 		end
 
+	make_with_bindings (a_ctx: VULKAN_CONTEXT; a_shader: VULKAN_SHADER; a_types: ARRAY [INTEGER])
+			-- Create compute pipeline whose first bindings have the given types
+			-- (`Binding_buffer`, `Binding_image` or `Binding_uniform`); the rest are buffers.
+			-- Only needed to override what `make` reflects from the shader.
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			shader_valid: a_shader /= Void and then a_shader.is_valid
+			types_attached: a_types /= Void
+			not_too_many: a_types.count <= Max_bindings
+			valid_types: across a_types as t all t.item = Binding_buffer or t.item = Binding_image or t.item = Binding_uniform end
+		local
+			l_types: MANAGED_POINTER
+			i: INTEGER
+		do
+			context := a_ctx
+			shader := a_shader
+			create l_types.make ((a_types.count * 4).max (4))
+			from i := 0 until i >= a_types.count loop
+				l_types.put_natural_32 (a_types [a_types.lower + i].to_natural_32, i * 4)
+				i := i + 1
+			end
+			handle := svk_create_pipeline_with_bindings (a_ctx.handle, a_shader.handle,
+				l_types.item, a_types.count.to_natural_32)
+			is_valid := handle /= default_pointer
+		ensure
+			context_set: context = a_ctx
+			shader_set: shader = a_shader
+		end
+
+	make_specialized (a_ctx: VULKAN_CONTEXT; a_shader: VULKAN_SHADER; a_constants: VULKAN_SPEC_CONSTANTS)
+			-- Create compute pipeline from shader with specialization `a_constants`.
+			-- The local size follows any `local_size_x_id` constants set.
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			shader_valid: a_shader /= Void and then a_shader.is_valid
+			constants_attached: a_constants /= Void
+		do
+			context := a_ctx
+			shader := a_shader
+			handle := svk_create_pipeline_specialized (a_ctx.handle, a_shader.handle,
+				a_constants.data.item, a_constants.count.to_natural_32)
+			is_valid := handle /= default_pointer
+		ensure
+			context_set: context = a_ctx
+			shader_set: shader = a_shader
+		end
+
+	make_packer (a_ctx: VULKAN_CONTEXT; a_shader: VULKAN_SHADER)
+			-- Create image packing pipeline from pack_image shader `a_shader`.
+			-- Invalid unless `a_shader` is a pack shader; it packs images of
+			-- the format it was built for.
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			shader_valid: a_shader /= Void and then a_shader.is_valid
+		do
+			context := a_ctx
+			shader := a_shader
+			handle := svk_create_pack_pipeline (a_ctx.handle, a_shader.handle)
+			is_valid := handle /= default_pointer
+		ensure
+			context_set: context = a_ctx
+			shader_set: shader = a_shader
+		end
+
 feature -- Access
 
 	handle: POINTER
@@ -61,6 +150,49 @@ feature -- Access
 	is_valid: BOOLEAN
 			-- Was pipeline creation successful?
 
+	has_local_size: BOOLEAN
+			-- Is the shader's local workgroup size known?
+		require
+			valid: is_valid
+		do
+			Result := svk_pipeline_local_size (handle, default_pointer, default_pointer, default_pointer) /= 0
+		end
+
+	local_size_x: INTEGER
+			-- Workgroup width declared by the shader (0 if unknown)
+		require
+			valid: is_valid
+		do
+			Result := local_size (0)
+		end
+
+	local_size_y: INTEGER
+			-- Workgroup height declared by the shader (0 if unknown)
+		require
+			valid: is_valid
+		do
+			Result := local_size (1)
+		end
+
+	local_size_z: INTEGER
+			-- Workgroup depth declared by the shader (0 if unknown)
+		require
+			valid: is_valid
+		do
+			Result := local_size (2)
+		end
+
+	group_count (a_threads, a_local_size: INTEGER): INTEGER
+			-- Workgroups needed to cover `a_threads` with groups of `a_local_size`.
+		require
+			positive_threads: a_threads > 0
+			positive_local_size: a_local_size > 0
+		do
+			Result := (a_threads + a_local_size - 1) // a_local_size
+		ensure
+			covers: Result * a_local_size >= a_threads
+		end
+
 feature -- Binding Constants
 
 	Binding_buffer: INTEGER = 0x01
@@ -69,6 +201,9 @@ feature -- Binding Constants
 	Binding_image: INTEGER = 0x02
 			-- Image binding type
 
+	Binding_uniform: INTEGER = 0x04
+			-- Uniform buffer binding type
+
 	Max_bindings: INTEGER = 8
 			-- Maximum bindings per pipeline
 
@@ -76,6 +211,8 @@ feature -- Binding
 
 	bind_buffer (a_binding: INTEGER; a_buffer: VULKAN_BUFFER): BOOLEAN
 			-- Bind buffer to pipeline at binding index.
+			-- Storage bindings need `Buffer_storage` usage, uniform bindings
+			-- `Buffer_uniform`; bindings the shader does not declare ignore it.
 		require
 			valid: is_valid
 			buffer_valid: a_buffer /= Void and then a_buffer.is_valid
@@ -85,7 +222,9 @@ feature -- Binding
 		end
 
 	bind_image (a_binding: INTEGER; a_image: VULKAN_IMAGE): BOOLEAN
-			-- Bind image to pipeline at binding index.
+			-- Bind storage image to pipeline at binding index.
+			-- The binding must be a storage image in the pipeline's layout,
+			-- unless the shader could not be reflected.
 		require
 			valid: is_valid
 			image_valid: a_image /= Void and then a_image.is_valid
@@ -98,7 +237,7 @@ feature -- Push Constants
 
 	set_push_constants (a_data: POINTER; a_size: INTEGER): BOOLEAN
 			-- Set push constant data (small, fast-changing uniforms).
-			-- Maximum size is typically 128-256 bytes (GPU-dependent).
+			-- Fails if `a_size` exceeds the shader's push-constant block.
 		require
 			valid: is_valid
 			data_attached: a_data /= default_pointer
@@ -121,6 +260,105 @@ feature -- Dispatch
 				a_x.to_natural_32, a_y.to_natural_32, a_z.to_natural_32) /= 0
 		end
 
+	dispatch_threads (a_ctx: VULKAN_CONTEXT; a_x, a_y, a_z: INTEGER): BOOLEAN
+			-- Dispatch enough workgroups to cover `a_x` * `a_y` * `a_z` threads.
+			-- The shader must guard against threads past the requested range.
+		require
+			valid: is_valid
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			local_size_known: has_local_size
+			positive_counts: a_x > 0 and a_y > 0 and a_z > 0
+		do
+			Result := svk_dispatch_threads (a_ctx.handle, handle,
+				a_x.to_natural_32, a_y.to_natural_32, a_z.to_natural_32) /= 0
+		end
+
+	dispatch_async (a_ctx: VULKAN_CONTEXT; a_x, a_y, a_z: INTEGER): NATURAL_64
+			-- Submit compute shader without waiting for the GPU.
+			-- Returns a ticket for `wait_ticket` and `is_ticket_complete`, or 0 on failure.
+			-- Downloads of bound buffers wait for the submission automatically.
+		require
+			valid: is_valid
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			positive_counts: a_x > 0 and a_y > 0 and a_z > 0
+		do
+			Result := svk_dispatch_async (a_ctx.handle, handle,
+				a_x.to_natural_32, a_y.to_natural_32, a_z.to_natural_32)
+		end
+
+	dispatch_async_on (a_ctx: VULKAN_CONTEXT; a_queue: INTEGER; a_x, a_y, a_z: INTEGER): NATURAL_64
+			-- As `dispatch_async`, on `a_queue` ({VULKAN_CONTEXT}.Queue_compute or
+			-- Queue_async_compute), so it can overlap work on the other queues.
+			-- Earlier work the bound resources depend on is waited for on the GPU.
+		require
+			valid: is_valid
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			compute_queue: a_queue = a_ctx.Queue_compute or a_queue = a_ctx.Queue_async_compute
+			positive_counts: a_x > 0 and a_y > 0 and a_z > 0
+		do
+			Result := svk_dispatch_async_on (a_ctx.handle, handle, a_queue.to_natural_32,
+				a_x.to_natural_32, a_y.to_natural_32, a_z.to_natural_32)
+		end
+
+	dispatch_region_async (a_ctx: VULKAN_CONTEXT; a_base_x, a_base_y, a_base_z, a_x, a_y, a_z: INTEGER): NATURAL_64
+			-- As `dispatch_async`, for workgroups `a_base_x` .. `a_base_x` + `a_x` - 1 (and likewise
+			-- in y and z) of a larger grid. The shader's workgroup and invocation ids include the base.
+		require
+			valid: is_valid
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			non_negative_base: a_base_x >= 0 and a_base_y >= 0 and a_base_z >= 0
+			positive_counts: a_x > 0 and a_y > 0 and a_z > 0
+		do
+			Result := svk_dispatch_region_async (a_ctx.handle, handle,
+				a_base_x.to_natural_32, a_base_y.to_natural_32, a_base_z.to_natural_32,
+				a_x.to_natural_32, a_y.to_natural_32, a_z.to_natural_32)
+		end
+
+	dispatch_indirect (a_ctx: VULKAN_CONTEXT; a_args: VULKAN_BUFFER; a_offset: INTEGER_64): BOOLEAN
+			-- Dispatch with the workgroup counts (three NATURAL_32: x, y, z) that `a_args`
+			-- holds at `a_offset` when the GPU runs it, and wait. An earlier pass can
+			-- size this one without a readback (see shaders/dispatch_args.comp).
+		require
+			valid: is_valid
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			args_valid: a_args /= Void and then a_args.is_valid
+			indirect_usage: (a_args.usage & a_args.Buffer_indirect) /= 0
+			aligned_offset: a_offset >= 0 and a_offset \\ 4 = 0
+			valid_range: a_offset + 12 <= a_args.size
+		do
+			Result := svk_dispatch_indirect (a_ctx.handle, handle, a_args.handle, a_offset.to_natural_64) /= 0
+		end
+
+	dispatch_indirect_async (a_ctx: VULKAN_CONTEXT; a_args: VULKAN_BUFFER; a_offset: INTEGER_64): NATURAL_64
+			-- As `dispatch_indirect`, without waiting. Returns a ticket, or 0 on failure.
+		require
+			valid: is_valid
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			args_valid: a_args /= Void and then a_args.is_valid
+			indirect_usage: (a_args.usage & a_args.Buffer_indirect) /= 0
+			aligned_offset: a_offset >= 0 and a_offset \\ 4 = 0
+			valid_range: a_offset + 12 <= a_args.size
+		do
+			Result := svk_dispatch_indirect_async_on (a_ctx.handle, handle, a_ctx.Queue_compute.to_natural_32,
+				a_args.handle, a_offset.to_natural_64)
+		end
+
+	dispatch_indirect_async_on (a_ctx: VULKAN_CONTEXT; a_queue: INTEGER; a_args: VULKAN_BUFFER; a_offset: INTEGER_64): NATURAL_64
+			-- As `dispatch_indirect_async`, on `a_queue` ({VULKAN_CONTEXT}.Queue_compute or
+			-- Queue_async_compute).
+		require
+			valid: is_valid
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			compute_queue: a_queue = a_ctx.Queue_compute or a_queue = a_ctx.Queue_async_compute
+			args_valid: a_args /= Void and then a_args.is_valid
+			indirect_usage: (a_args.usage & a_args.Buffer_indirect) /= 0
+			aligned_offset: a_offset >= 0 and a_offset \\ 4 = 0
+			valid_range: a_offset + 12 <= a_args.size
+		do
+			Result := svk_dispatch_indirect_async_on (a_ctx.handle, handle, a_queue.to_natural_32,
+				a_args.handle, a_offset.to_natural_64)
+		end
+
 feature -- Synchronization
 
 	wait_idle (a_ctx: VULKAN_CONTEXT)
@@ -131,6 +369,24 @@ feature -- Synchronization
 			svk_wait_idle (a_ctx.handle)
 		end
 
+	wait_ticket (a_ctx: VULKAN_CONTEXT; a_ticket: NATURAL_64): BOOLEAN
+			-- Block until the submission identified by `a_ticket` has finished.
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			valid_ticket: a_ticket > 0
+		do
+			Result := svk_wait_ticket (a_ctx.handle, a_ticket) /= 0
+		end
+
+	is_ticket_complete (a_ctx: VULKAN_CONTEXT; a_ticket: NATURAL_64): BOOLEAN
+			-- Has the submission identified by `a_ticket` finished? (non-blocking)
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			valid_ticket: a_ticket > 0
+		do
+			Result := svk_poll_ticket (a_ctx.handle, a_ticket) /= 0
+		end
+
 feature -- Disposal
 
 	dispose
@@ -146,6 +402,19 @@ feature -- Disposal
 			handle_cleared: handle = default_pointer
 		end
 
+feature {NONE} -- Implementation
+
+	local_size (a_dimension: INTEGER): INTEGER
+			-- Local size along `a_dimension` (0 = x, 1 = y, 2 = z), or 0 if unknown.
+		local
+			l_sizes: MANAGED_POINTER
+		do
+			create l_sizes.make (12)
+			if svk_pipeline_local_size (handle, l_sizes.item, l_sizes.item + 4, l_sizes.item + 8) /= 0 then
+				Result := l_sizes.read_natural_32 (a_dimension * 4).to_integer_32
+			end
+		end
+
 feature {NONE} -- C Externals
 
 	svk_create_pipeline (ctx, a_shader: POINTER): POINTER
@@ -155,6 +424,41 @@ feature {NONE} -- C Externals
 			"return svk_create_pipeline((svk_context)$ctx, (svk_shader)$a_shader);"
 		end
 
+	svk_create_pipeline_with_bindings (ctx, a_shader, a_types: POINTER; a_count: NATURAL_32): POINTER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_create_pipeline_with_bindings((svk_context)$ctx, (svk_shader)$a_shader, (const uint32_t*)$a_types, (uint32_t)$a_count);"
+		end
+
+	svk_create_pipeline_specialized (ctx, a_shader, a_constants: POINTER; a_count: NATURAL_32): POINTER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_create_pipeline_specialized((svk_context)$ctx, (svk_shader)$a_shader, (const svk_spec_constant*)$a_constants, (uint32_t)$a_count);"
+		end
+
+	svk_create_pack_pipeline (ctx, a_shader: POINTER): POINTER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_create_pack_pipeline((svk_context)$ctx, (svk_shader)$a_shader);"
+		end
+
+	svk_pipeline_local_size (pipe, x, y, z: POINTER): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_pipeline_local_size((svk_pipeline)$pipe, (uint32_t*)$x, (uint32_t*)$y, (uint32_t*)$z);"
+		end
+
+	svk_dispatch_threads (ctx, pipe: POINTER; x, y, z: NATURAL_32): INTEGER
+		external
+			"C blocking inline use <simple_vulkan.h>"
+		alias
+			"return svk_dispatch_threads((svk_context)$ctx, (svk_pipeline)$pipe, (uint32_t)$x, (uint32_t)$y, (uint32_t)$z);"
+		end
+
 	svk_bind_buffer (pipe: POINTER; binding: NATURAL_32; buf: POINTER): INTEGER
 		external
 			"C inline use <simple_vulkan.h>"
@@ -178,14 +482,63 @@ feature {NONE} -- C Externals
 
 	svk_dispatch (ctx, pipe: POINTER; x, y, z: NATURAL_32): INTEGER
 		external
-			"C inline use <simple_vulkan.h>"
+			"C blocking inline use <simple_vulkan.h>"
 		alias
 			"return svk_dispatch((svk_context)$ctx, (svk_pipeline)$pipe, (uint32_t)$x, (uint32_t)$y, (uint32_t)$z);"
 		end
 
-	svk_wait_idle (ctx: POINTER)
+	svk_dispatch_async (ctx, pipe: POINTER; x, y, z: NATURAL_32): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_dispatch_async((svk_context)$ctx, (svk_pipeline)$pipe, (uint32_t)$x, (uint32_t)$y, (uint32_t)$z);"
+		end
+
+	svk_dispatch_async_on (ctx, pipe: POINTER; a_queue, x, y, z: NATURAL_32): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_dispatch_async_on((svk_context)$ctx, (svk_pipeline)$pipe, (uint32_t)$a_queue, (uint32_t)$x, (uint32_t)$y, (uint32_t)$z);"
+		end
+
+	svk_dispatch_region_async (ctx, pipe: POINTER; base_x, base_y, base_z, x, y, z: NATURAL_32): NATURAL_64
 		external
 			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_dispatch_region_async((svk_context)$ctx, (svk_pipeline)$pipe, (uint32_t)$base_x, (uint32_t)$base_y, (uint32_t)$base_z, (uint32_t)$x, (uint32_t)$y, (uint32_t)$z);"
+		end
+
+	svk_dispatch_indirect (ctx, pipe, args: POINTER; a_offset: NATURAL_64): INTEGER
+		external
+			"C blocking inline use <simple_vulkan.h>"
+		alias
+			"return svk_dispatch_indirect((svk_context)$ctx, (svk_pipeline)$pipe, (svk_buffer)$args, (uint64_t)$a_offset);"
+		end
+
+	svk_dispatch_indirect_async_on (ctx, pipe: POINTER; a_queue: NATURAL_32; args: POINTER; a_offset: NATURAL_64): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_dispatch_indirect_async_on((svk_context)$ctx, (svk_pipeline)$pipe, (uint32_t)$a_queue, (svk_buffer)$args, (uint64_t)$a_offset);"
+		end
+
+	svk_wait_ticket (ctx: POINTER; a_ticket: NATURAL_64): INTEGER
+		external
+			"C blocking inline use <simple_vulkan.h>"
+		alias
+			"return svk_wait_ticket((svk_context)$ctx, (svk_ticket)$a_ticket);"
+		end
+
+	svk_poll_ticket (ctx: POINTER; a_ticket: NATURAL_64): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_poll_ticket((svk_context)$ctx, (svk_ticket)$a_ticket);"
+		end
+
+	svk_wait_idle (ctx: POINTER)
+		external
+			"C blocking inline use <simple_vulkan.h>"
 		alias
 			"svk_wait_idle((svk_context)$ctx);"
 		end
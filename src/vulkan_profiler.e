@@ -0,0 +1,370 @@
+note
+	description: "[
+		VULKAN_PROFILER - GPU execution time of dispatches and copies.
+
+		While a profiler is alive, every dispatch, copy and fill the
+		context records is bracketed by GPU timestamps. The measured
+		time is what the GPU spent on the command itself, without
+		submission or queue-idle overhead, so comparing it with
+		wall-clock time shows how much of a frame is API cost.
+
+		Commands are grouped under the label set when they are
+		recorded. `collect` gathers finished measurements into a
+		rolling window of the most recent samples, from which
+		min/avg/p99 are computed per label.
+
+		Usage:
+			local
+				profiler: VULKAN_PROFILER
+				ok: BOOLEAN
+			do
+				create profiler.make (ctx, 1024)
+				if profiler.is_valid then
+					profiler.set_label ("raymarch")
+					ok := raymarch_pipe.dispatch_threads (ctx, 3840, 2160, 1)
+					profiler.set_label ("pack")
+					ok := pack_pipe.dispatch_threads (ctx, 3840, 2160, 1)
+					profiler.collect
+					print (profiler.report)
+				end
+				profiler.dispose
+			end
+	]"
+	author: "Larry Rix"
+	date: "$Date$"
+	revision: "$Revision$"
+
+class
+	VULKAN_PROFILER
+
+create
+	make
+
+feature {NONE} -- Initialization
+
+	make (a_ctx: VULKAN_CONTEXT; a_window: INTEGER)
+			-- Start profiling `a_ctx`, keeping the last `a_window` samples.
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			positive_window: a_window > 0
+		do
+			context := a_ctx
+			window := a_window
+			create labels.make (8)
+			create sample_tags.make_filled (0, 1, a_window)
+			create sample_times.make_filled (0.0, 1, a_window)
+			create batch.make (Batch_size * c_sample_size)
+			is_valid := svk_enable_profiling (a_ctx.handle, Max_pending.to_natural_32) /= 0
+		ensure
+			context_set: context = a_ctx
+			window_set: window = a_window
+			empty: count = 0
+		end
+
+feature -- Access
+
+	context: VULKAN_CONTEXT
+			-- Profiled context
+
+	is_valid: BOOLEAN
+			-- Are commands being timed? (False if the GPU has no timestamp support)
+
+	window: INTEGER
+			-- Maximum samples kept; older ones are overwritten
+
+	count: INTEGER
+			-- Samples currently in the window
+
+	labels: ARRAYED_LIST [STRING]
+			-- Labels used so far
+
+	dropped_count: INTEGER_64
+			-- Commands that ran unmeasured because `collect` was not called often enough
+		require
+			valid: is_valid
+		do
+			Result := svk_dropped_gpu_samples (context.handle).to_integer_64
+		end
+
+feature -- Labeling
+
+	set_label (a_name: STRING)
+			-- Attribute commands recorded from now on to `a_name`.
+		require
+			valid: is_valid
+			name_not_empty: a_name /= Void and then not a_name.is_empty
+		local
+			l_tag: INTEGER
+		do
+			l_tag := tag_of (a_name)
+			if l_tag = 0 then
+				labels.extend (a_name.twin)
+				l_tag := labels.count
+			end
+			svk_set_profile_tag (context.handle, l_tag.to_natural_32)
+		end
+
+	clear_label
+			-- Record commands from now on without a label.
+		require
+			valid: is_valid
+		do
+			svk_set_profile_tag (context.handle, 0)
+		end
+
+feature -- Collection
+
+	collect
+			-- Add the measurements of all finished commands to the window. Never blocks.
+		require
+			valid: is_valid
+		local
+			n, i: INTEGER
+			l_sample: POINTER
+		do
+			from
+				n := Batch_size
+			until
+				n < Batch_size
+			loop
+				n := svk_collect_gpu_samples (context.handle, batch.item, Batch_size.to_natural_32).to_integer_32
+				from i := 0 until i >= n loop
+					l_sample := batch.item + i * c_sample_size
+					add_sample (c_sample_tag (l_sample).to_integer_32, c_sample_ns (l_sample).to_real_64 / 1_000_000.0)
+					i := i + 1
+				end
+			end
+		end
+
+	wipe_out
+			-- Remove all samples from the window.
+		do
+			count := 0
+			next_index := 0
+		ensure
+			empty: count = 0
+		end
+
+feature -- Statistics
+
+	sample_count (a_name: STRING): INTEGER
+			-- Samples in the window for `a_name`
+		require
+			name_attached: a_name /= Void
+		do
+			Result := times_of (a_name).count
+		end
+
+	minimum_ms (a_name: STRING): REAL_64
+			-- Fastest GPU time in milliseconds for `a_name` (0 if no samples)
+		require
+			name_attached: a_name /= Void
+		local
+			l_times: ARRAY [REAL_64]
+		do
+			l_times := times_of (a_name)
+			if not l_times.is_empty then
+				Result := l_times [1]
+			end
+		end
+
+	average_ms (a_name: STRING): REAL_64
+			-- Mean GPU time in milliseconds for `a_name` (0 if no samples)
+		require
+			name_attached: a_name /= Void
+		local
+			l_times: ARRAY [REAL_64]
+			l_sum: REAL_64
+		do
+			l_times := times_of (a_name)
+			if not l_times.is_empty then
+				across l_times as t loop l_sum := l_sum + t.item end
+				Result := l_sum / l_times.count
+			end
+		end
+
+	percentile_ms (a_name: STRING; a_percent: INTEGER): REAL_64
+			-- GPU time in milliseconds below which `a_percent` percent of `a_name` samples fall
+			-- (nearest rank; 0 if no samples)
+		require
+			name_attached: a_name /= Void
+			valid_percent: a_percent > 0 and a_percent <= 100
+		local
+			l_times: ARRAY [REAL_64]
+			l_rank: INTEGER
+		do
+			l_times := times_of (a_name)
+			if not l_times.is_empty then
+				l_rank := (a_percent * l_times.count + 99) // 100
+				Result := l_times [l_rank.max (1)]
+			end
+		end
+
+	p99_ms (a_name: STRING): REAL_64
+			-- 99th percentile GPU time in milliseconds for `a_name`
+		require
+			name_attached: a_name /= Void
+		do
+			Result := percentile_ms (a_name, 99)
+		end
+
+	report: STRING
+			-- One line per label: samples, min, avg and p99 in milliseconds
+		do
+			create Result.make (80 * (labels.count + 1))
+			across labels as l loop
+				if sample_count (l.item) > 0 then
+					Result.append (l.item + ": " + sample_count (l.item).out + " samples, min "
+						+ minimum_ms (l.item).out + " ms, avg " + average_ms (l.item).out
+						+ " ms, p99 " + p99_ms (l.item).out + " ms%N")
+				end
+			end
+		end
+
+feature -- Constants
+
+	Max_pending: INTEGER = 256
+			-- Commands that can be measured between calls to `collect`
+
+feature -- Disposal
+
+	dispose
+			-- Stop profiling the context.
+		do
+			if is_valid and context.is_valid then
+				svk_disable_profiling (context.handle)
+			end
+			is_valid := False
+		ensure
+			stopped: not is_valid
+		end
+
+feature {NONE} -- Implementation
+
+	sample_tags: ARRAY [INTEGER]
+			-- Label index of each sample in the window (0 = unlabeled)
+
+	sample_times: ARRAY [REAL_64]
+			-- GPU time in milliseconds of each sample in the window
+
+	next_index: INTEGER
+			-- Window slot (0-based) the next sample overwrites
+
+	batch: MANAGED_POINTER
+			-- Buffer of svk_gpu_sample records for `collect`
+
+	Batch_size: INTEGER = 64
+			-- Samples fetched per call into the C library
+
+	tag_of (a_name: STRING): INTEGER
+			-- Index of `a_name` in `labels`, or 0
+		local
+			i: INTEGER
+		do
+			from i := 1 until i > labels.count or Result > 0 loop
+				if labels [i].same_string (a_name) then
+					Result := i
+				end
+				i := i + 1
+			end
+		end
+
+	add_sample (a_tag: INTEGER; a_ms: REAL_64)
+			-- Put a sample into the window, overwriting the oldest when full.
+		do
+			sample_tags [next_index + 1] := a_tag
+			sample_times [next_index + 1] := a_ms
+			next_index := (next_index + 1) \\ window
+			count := (count + 1).min (window)
+		end
+
+	times_of (a_name: STRING): ARRAY [REAL_64]
+			-- Window samples of `a_name` in ascending order
+		local
+			l_tag, i, j, n: INTEGER
+			l_value: REAL_64
+		do
+			create Result.make_empty
+			l_tag := tag_of (a_name)
+			if l_tag > 0 then
+				from i := 1 until i > count loop
+					if sample_tags [i] = l_tag then
+							-- Insertion sort; windows are small
+						l_value := sample_times [i]
+						n := Result.count
+						Result.force (l_value, n + 1)
+						from j := n until j < 1 or else Result [j] <= l_value loop
+							Result [j + 1] := Result [j]
+							Result [j] := l_value
+							j := j - 1
+						end
+					end
+					i := i + 1
+				end
+			end
+		end
+
+feature {NONE} -- C Externals
+
+	svk_enable_profiling (ctx: POINTER; a_max_pending: NATURAL_32): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_enable_profiling((svk_context)$ctx, (uint32_t)$a_max_pending);"
+		end
+
+	svk_disable_profiling (ctx: POINTER)
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"svk_disable_profiling((svk_context)$ctx);"
+		end
+
+	svk_set_profile_tag (ctx: POINTER; a_tag: NATURAL_32)
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"svk_set_profile_tag((svk_context)$ctx, (uint32_t)$a_tag);"
+		end
+
+	svk_collect_gpu_samples (ctx, samples: POINTER; a_max: NATURAL_32): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_collect_gpu_samples((svk_context)$ctx, (svk_gpu_sample*)$samples, (uint32_t)$a_max);"
+		end
+
+	svk_dropped_gpu_samples (ctx: POINTER): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_dropped_gpu_samples((svk_context)$ctx);"
+		end
+
+	c_sample_size: INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return (EIF_INTEGER)sizeof(svk_gpu_sample);"
+		end
+
+	c_sample_tag (p: POINTER): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_gpu_sample*)$p)->tag;"
+		end
+
+	c_sample_ns (p: POINTER): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return ((svk_gpu_sample*)$p)->gpu_ns;"
+		end
+
+invariant
+	context_attached: context /= Void
+	labels_attached: labels /= Void
+	count_in_window: count >= 0 and count <= window
+
+end
@@ -0,0 +1,213 @@
+note
+	description: "[
+		VULKAN_SDF_RENDERER - Persistent real-time SDF ray-marching engine.
+
+		Loads an SDF shader once, creates one RGBA8 output image per
+		frame in flight, and renders frames with only a push-constant
+		camera update and one submission each. `render` returns
+		without waiting for the GPU, so the next frame can be
+		prepared while earlier ones render and stream back.
+
+		The shader must write binding 0 as an rgba8 storage image and
+		take the camera as push constants, like shaders/sdf_raymarcher.spv.
+
+		A frame not read before `frames_in_flight` newer frames have
+		been rendered is dropped.
+
+		Usage:
+			local
+				sdf: VULKAN_SDF_RENDERER
+				pixels: MANAGED_POINTER
+				frame: NATURAL_64
+			do
+				create sdf.make (ctx, "shaders/sdf_raymarcher.spv", 3840, 2160)
+				if sdf.is_valid then
+					create pixels.make (sdf.frame_bytes)
+					frame := sdf.render (0.0, 1.5, 5.0, yaw, pitch, time)
+					-- Update scene state while the GPU renders
+					if frame > 0 and then sdf.read_frame (frame, pixels.item) then
+						-- Display pixels
+					end
+					sdf.dispose
+				end
+			end
+	]"
+	author: "Larry Rix"
+	date: "$Date$"
+	revision: "$Revision$"
+
+class
+	VULKAN_SDF_RENDERER
+
+create
+	make,
+	make_with_frames
+
+feature {NONE} -- Initialization
+
+	make (a_ctx: VULKAN_CONTEXT; a_shader_path: STRING; a_width, a_height: INTEGER)
+			-- Create renderer for `a_shader_path` at `a_width` x `a_height`
+			-- with `Default_frames` frames in flight.
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			path_attached: a_shader_path /= Void and then not a_shader_path.is_empty
+			positive_dimensions: a_width > 0 and a_height > 0
+		do
+			make_with_frames (a_ctx, a_shader_path, a_width, a_height, Default_frames)
+		ensure
+			context_set: context = a_ctx
+			frames_set: frames_in_flight = Default_frames
+		end
+
+	make_with_frames (a_ctx: VULKAN_CONTEXT; a_shader_path: STRING; a_width, a_height, a_frames: INTEGER)
+			-- Create renderer keeping up to `a_frames` frames in flight.
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			path_attached: a_shader_path /= Void and then not a_shader_path.is_empty
+			positive_dimensions: a_width > 0 and a_height > 0
+			valid_frames: a_frames >= 1 and a_frames <= Max_frames
+		local
+			l_c_path: C_STRING
+		do
+			context := a_ctx
+			width := a_width
+			height := a_height
+			frames_in_flight := a_frames
+			create l_c_path.make (a_shader_path)
+			handle := svk_create_sdf_pipeline_frames (a_ctx.handle, l_c_path.item,
+				a_width.to_natural_32, a_height.to_natural_32, a_frames.to_natural_32)
+			is_valid := handle /= default_pointer
+		ensure
+			context_set: context = a_ctx
+			width_set: width = a_width
+			height_set: height = a_height
+			frames_set: frames_in_flight = a_frames
+		end
+
+feature -- Access
+
+	handle: POINTER
+			-- Opaque handle to the svk_pipeline
+
+	context: VULKAN_CONTEXT
+			-- Parent context
+
+	width: INTEGER
+			-- Frame width in pixels
+
+	height: INTEGER
+			-- Frame height in pixels
+
+	frames_in_flight: INTEGER
+			-- Frames that can be rendered before the oldest must have finished
+
+	is_valid: BOOLEAN
+			-- Was the renderer created successfully?
+
+	frame_bytes: INTEGER
+			-- Size of one RGBA8 frame in bytes
+		do
+			Result := width * height * 4
+		ensure
+			positive: Result > 0
+		end
+
+feature -- Constants
+
+	Default_frames: INTEGER = 2
+			-- Frames in flight for `make`
+
+	Max_frames: INTEGER = 4
+			-- Upper bound of `frames_in_flight` (one image readback slot each)
+
+feature -- Rendering
+
+	render (a_x, a_y, a_z, a_yaw, a_pitch, a_time: REAL_32): NATURAL_64
+			-- Render the next frame from camera position (`a_x`, `a_y`, `a_z`)
+			-- looking along `a_yaw`/`a_pitch`, at animation time `a_time`.
+			-- Returns a frame ticket for `read_frame`, or 0 on failure.
+			-- Only waits when `frames_in_flight` frames are still rendering.
+		require
+			valid: is_valid
+		do
+			Result := svk_render_sdf (context.handle, handle, a_x, a_y, a_z, a_yaw, a_pitch, a_time)
+		end
+
+	is_frame_ready (a_frame: NATURAL_64): BOOLEAN
+			-- Has frame `a_frame` finished rendering and copying?
+		require
+			valid: is_valid
+		do
+			Result := svk_poll_ticket (context.handle, a_frame) /= 0
+		end
+
+	read_frame (a_frame: NATURAL_64; a_data: POINTER): BOOLEAN
+			-- Copy frame `a_frame` into `a_data` (at least `frame_bytes`),
+			-- waiting if it is not ready. Each frame can be read once.
+		require
+			valid: is_valid
+			started: a_frame > 0
+			data_attached: a_data /= default_pointer
+		do
+			Result := svk_read_sdf_frame (context.handle, handle, a_frame, a_data) /= 0
+		end
+
+feature -- Disposal
+
+	dispose
+			-- Free pipeline and output images.
+		do
+			if is_valid and handle /= default_pointer then
+				svk_free_pipeline (context.handle, handle)
+				handle := default_pointer
+				is_valid := False
+			end
+		ensure
+			disposed: not is_valid
+			handle_cleared: handle = default_pointer
+		end
+
+feature {NONE} -- C Externals
+
+	svk_create_sdf_pipeline_frames (ctx, path: POINTER; a_width, a_height, a_frames: NATURAL_32): POINTER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_create_sdf_pipeline_frames((svk_context)$ctx, (const char*)$path, (uint32_t)$a_width, (uint32_t)$a_height, (uint32_t)$a_frames);"
+		end
+
+	svk_render_sdf (ctx, pipe: POINTER; a_x, a_y, a_z, a_yaw, a_pitch, a_time: REAL_32): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_render_sdf((svk_context)$ctx, (svk_pipeline)$pipe, $a_x, $a_y, $a_z, $a_yaw, $a_pitch, $a_time);"
+		end
+
+	svk_read_sdf_frame (ctx, pipe: POINTER; a_frame: NATURAL_64; data: POINTER): INTEGER
+		external
+			"C blocking inline use <simple_vulkan.h>"
+		alias
+			"return svk_read_sdf_frame((svk_context)$ctx, (svk_pipeline)$pipe, (svk_ticket)$a_frame, $data);"
+		end
+
+	svk_poll_ticket (ctx: POINTER; a_ticket: NATURAL_64): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_poll_ticket((svk_context)$ctx, (svk_ticket)$a_ticket);"
+		end
+
+	svk_free_pipeline (ctx, pipe: POINTER)
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"svk_free_pipeline((svk_context)$ctx, (svk_pipeline)$pipe);"
+		end
+
+invariant
+	valid_handle: is_valid implies handle /= default_pointer
+	context_attached: context /= Void
+	positive_dimensions: width > 0 and height > 0
+	valid_frames: frames_in_flight >= 1 and frames_in_flight <= Max_frames
+
+end
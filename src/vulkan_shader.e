@@ -6,6 +6,16 @@ note
 		pre-compiled to SPIR-V format (.spv files) using glslc or
 		similar tools.
 
+		Files are memory-mapped rather than read into a copy. Loading
+		SPIR-V identical to a shader already loaded in the context
+		shares its module (reference counted), so many pipelines or
+		workers can load the same file cheaply; each instance still
+		calls `dispose`.
+
+		The module is reflected on load: its descriptor bindings,
+		push-constant size and local workgroup size can be queried
+		and are used to build exact pipeline layouts.
+
 		Usage:
 			local
 				shader: VULKAN_SHADER
@@ -71,10 +81,62 @@ feature -- Access
 	is_valid: BOOLEAN
 			-- Was shader loading successful?
 
+feature -- Reflection
+
+	is_reflected: BOOLEAN
+			-- Could the module's interface be read? If not, pipelines
+			-- fall back to 8 storage buffers and 128 bytes of push constants.
+		require
+			valid: is_valid
+		do
+			Result := svk_shader_local_size (handle, default_pointer, default_pointer, default_pointer) /= 0
+		end
+
+	binding_type (a_binding: INTEGER): INTEGER
+			-- Binding type at `a_binding` ({VULKAN_PIPELINE}.Binding_*), or 0 if unused.
+		require
+			valid: is_valid
+			valid_binding: a_binding >= 0 and a_binding < {VULKAN_PIPELINE}.Max_bindings
+		do
+			Result := svk_shader_binding_type (handle, a_binding.to_natural_32).to_integer_32
+		end
+
+	push_constant_size: INTEGER
+			-- Size of the push-constant block in bytes
+		require
+			valid: is_valid
+		do
+			Result := svk_shader_push_size (handle).to_integer_32
+		end
+
+	local_size_x: INTEGER
+			-- Declared workgroup width (0 if not reflected)
+		require
+			valid: is_valid
+		do
+			Result := local_size (0)
+		end
+
+	local_size_y: INTEGER
+			-- Declared workgroup height (0 if not reflected)
+		require
+			valid: is_valid
+		do
+			Result := local_size (1)
+		end
+
+	local_size_z: INTEGER
+			-- Declared workgroup depth (0 if not reflected)
+		require
+			valid: is_valid
+		do
+			Result := local_size (2)
+		end
+
 feature -- Disposal
 
 	dispose
-			-- Free shader resources.
+			-- Release this reference; the module is freed with the last one.
 		do
 			if is_valid and handle /= default_pointer then
 				svk_free_shader (context.handle, handle)
@@ -86,8 +148,42 @@ feature -- Disposal
 			handle_cleared: handle = default_pointer
 		end
 
+feature {NONE} -- Implementation
+
+	local_size (a_dimension: INTEGER): INTEGER
+			-- Local size along `a_dimension` (0 = x, 1 = y, 2 = z), or 0 if not reflected.
+		local
+			l_sizes: MANAGED_POINTER
+		do
+			create l_sizes.make (12)
+			if svk_shader_local_size (handle, l_sizes.item, l_sizes.item + 4, l_sizes.item + 8) /= 0 then
+				Result := l_sizes.read_natural_32 (a_dimension * 4).to_integer_32
+			end
+		end
+
 feature {NONE} -- C Externals
 
+	svk_shader_local_size (shader, x, y, z: POINTER): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_shader_local_size((svk_shader)$shader, (uint32_t*)$x, (uint32_t*)$y, (uint32_t*)$z);"
+		end
+
+	svk_shader_binding_type (shader: POINTER; binding: NATURAL_32): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_shader_binding_type((svk_shader)$shader, (uint32_t)$binding);"
+		end
+
+	svk_shader_push_size (shader: POINTER): NATURAL_32
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_shader_push_size((svk_shader)$shader);"
+		end
+
 	svk_load_shader (ctx, path: POINTER): POINTER
 		external
 			"C inline use <simple_vulkan.h>"
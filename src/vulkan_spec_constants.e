@@ -0,0 +1,172 @@
+note
+	description: "[
+		VULKAN_SPEC_CONSTANTS - Specialization constants for a compute pipeline.
+
+		Collects `constant_id` values for {VULKAN_PIPELINE}.make_specialized.
+		The driver folds them into the compiled shader, so loop bounds
+		and workgroup sizes become compile-time constants. Pipelines
+		created with the same shader and constants share one compiled
+		variant.
+
+		Usage:
+			local
+				constants: VULKAN_SPEC_CONSTANTS
+				pipe: VULKAN_PIPELINE
+			do
+				create constants.make
+				constants.put_integer (constants.Sdf_max_steps_id, 64)
+				constants.put_real (constants.Sdf_surf_dist_id, {REAL_32} 0.002)
+				constants.put_integer (constants.Local_size_x_id, 8)
+				constants.put_integer (constants.Local_size_y_id, 8)
+				create pipe.make_specialized (ctx, shader, constants)
+			end
+	]"
+	author: "Larry Rix"
+	date: "$Date$"
+	revision: "$Revision$"
+
+class
+	VULKAN_SPEC_CONSTANTS
+
+create
+	make
+
+feature {NONE} -- Initialization
+
+	make
+			-- Create empty constant set.
+		do
+			create data.make (Max_constants * Entry_size)
+		ensure
+			empty: count = 0
+		end
+
+feature -- Access
+
+	count: INTEGER
+			-- Number of constants set
+
+	data: MANAGED_POINTER
+			-- Packed {id, value} pairs of 32-bit words (svk_spec_constant)
+
+	has (a_id: INTEGER): BOOLEAN
+			-- Is constant `a_id` set?
+		do
+			Result := index_of (a_id) >= 0
+		end
+
+feature -- Element Change
+
+	put_integer (a_id, a_value: INTEGER)
+			-- Set `int` or `uint` constant `a_id` to `a_value`.
+		require
+			valid_id: a_id >= 0
+			room: has (a_id) or count < Max_constants
+		do
+			put_bits (a_id, a_value.to_natural_32)
+		ensure
+			set: has (a_id)
+		end
+
+	put_real (a_id: INTEGER; a_value: REAL_32)
+			-- Set `float` constant `a_id` to `a_value`.
+		require
+			valid_id: a_id >= 0
+			room: has (a_id) or count < Max_constants
+		local
+			l_bits: MANAGED_POINTER
+		do
+			create l_bits.make (4)
+			l_bits.put_real_32 (a_value, 0)
+			put_bits (a_id, l_bits.read_natural_32 (0))
+		ensure
+			set: has (a_id)
+		end
+
+	put_boolean (a_id: INTEGER; a_value: BOOLEAN)
+			-- Set `bool` constant `a_id` to `a_value`.
+		require
+			valid_id: a_id >= 0
+			room: has (a_id) or count < Max_constants
+		do
+			if a_value then
+				put_bits (a_id, 1)
+			else
+				put_bits (a_id, 0)
+			end
+		ensure
+			set: has (a_id)
+		end
+
+	wipe_out
+			-- Remove all constants.
+		do
+			count := 0
+		ensure
+			empty: count = 0
+		end
+
+feature -- Constant IDs
+
+	Sdf_max_steps_id: INTEGER = 0
+			-- MAX_STEPS in the bundled SDF shaders
+
+	Sdf_max_dist_id: INTEGER = 1
+			-- MAX_DIST in the bundled SDF shaders
+
+	Sdf_surf_dist_id: INTEGER = 2
+			-- SURF_DIST in the bundled SDF shaders
+
+	Sdf_tile_pass_id: INTEGER = 3
+			-- TILE_PASS in the bundled SDF shaders (set by {VULKAN_TILED_SDF})
+
+	Sdf_tile_size_id: INTEGER = 4
+			-- TILE_SIZE in the bundled SDF shaders (set by {VULKAN_TILED_SDF})
+
+	Local_size_x_id: INTEGER = 10
+			-- local_size_x_id in the bundled SDF shaders
+
+	Local_size_y_id: INTEGER = 11
+			-- local_size_y_id in the bundled SDF shaders
+
+	Max_constants: INTEGER = 64
+			-- Maximum constants per pipeline
+
+feature {NONE} -- Implementation
+
+	Entry_size: INTEGER = 8
+			-- Bytes per svk_spec_constant
+
+	index_of (a_id: INTEGER): INTEGER
+			-- Entry holding `a_id`, or -1
+		local
+			i: INTEGER
+		do
+			Result := -1
+			from i := 0 until i >= count or Result >= 0 loop
+				if data.read_natural_32 (i * Entry_size).to_integer_32 = a_id then
+					Result := i
+				end
+				i := i + 1
+			end
+		end
+
+	put_bits (a_id: INTEGER; a_bits: NATURAL_32)
+			-- Set constant `a_id` to the raw 32-bit `a_bits`.
+		local
+			i: INTEGER
+		do
+			i := index_of (a_id)
+			if i < 0 then
+				i := count
+				count := count + 1
+				data.put_natural_32 (a_id.to_natural_32, i * Entry_size)
+			end
+			data.put_natural_32 (a_bits, i * Entry_size + 4)
+		end
+
+invariant
+	data_attached: data /= Void
+	count_in_range: count >= 0 and count <= Max_constants
+
+end
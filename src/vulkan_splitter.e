@@ -0,0 +1,216 @@
+note
+	description: "[
+		VULKAN_SPLITTER - Renders one frame across several contexts.
+
+		The frame is cut into horizontal bands, one per target, sized
+		in proportion to the target weights. A target is a context with
+		a pipeline covering one invocation per pixel of the whole frame
+		(bounds-checked), whose output buffer - full-frame, bound by the
+		caller - receives row-major pixels. `run` dispatches every band
+		before waiting on any, then merges the bands into host memory.
+
+		Give faster devices larger weights, or rebalance with
+		`set_weight` from measured frame times.
+
+		Usage:
+			local
+				split: VULKAN_SPLITTER
+				frame: MANAGED_POINTER
+				ok: BOOLEAN
+			do
+				create split.make (1920, 1080, 4)
+				if split.add_target (gpu0, pipe0, out0, 2.0) >= 0
+					and split.add_target (gpu1, pipe1, out1, 1.0) >= 0
+				then
+					create frame.make (split.frame_bytes)
+					ok := split.run (frame.item)
+				end
+				split.dispose
+			end
+	]"
+	author: "Larry Rix"
+	date: "$Date$"
+	revision: "$Revision$"
+
+class
+	VULKAN_SPLITTER
+
+create
+	make
+
+feature {NONE} -- Initialization
+
+	make (a_width, a_height, a_pixel_size: INTEGER)
+			-- Create splitter for `a_width` x `a_height` frames of `a_pixel_size`-byte pixels.
+		require
+			positive_dimensions: a_width > 0 and a_height > 0
+			positive_pixel_size: a_pixel_size > 0
+		do
+			width := a_width
+			height := a_height
+			pixel_size := a_pixel_size
+			handle := svk_create_splitter (a_width.to_natural_32, a_height.to_natural_32,
+				a_pixel_size.to_natural_32)
+			is_valid := handle /= default_pointer
+		ensure
+			width_set: width = a_width
+			height_set: height = a_height
+			pixel_size_set: pixel_size = a_pixel_size
+		end
+
+feature -- Access
+
+	handle: POINTER
+			-- Opaque handle to the svk_splitter
+
+	width: INTEGER
+			-- Frame width in pixels
+
+	height: INTEGER
+			-- Frame height in pixels
+
+	pixel_size: INTEGER
+			-- Bytes per pixel
+
+	target_count: INTEGER
+			-- Targets added so far
+
+	is_valid: BOOLEAN
+			-- Was the splitter created successfully?
+
+	frame_bytes: INTEGER
+			-- Size of the merged frame in bytes
+		do
+			Result := width * height * pixel_size
+		end
+
+	band_first_row (a_target: INTEGER): INTEGER
+			-- First row `a_target` rendered in the latest `run`
+		require
+			valid: is_valid
+			valid_target: a_target >= 0 and a_target < target_count
+		local
+			l_first, l_rows: NATURAL_32
+		do
+			if svk_splitter_band (handle, a_target, $l_first, $l_rows) /= 0 then
+				Result := l_first.to_integer_32
+			end
+		end
+
+	band_rows (a_target: INTEGER): INTEGER
+			-- Rows `a_target` rendered in the latest `run`
+		require
+			valid: is_valid
+			valid_target: a_target >= 0 and a_target < target_count
+		local
+			l_first, l_rows: NATURAL_32
+		do
+			if svk_splitter_band (handle, a_target, $l_first, $l_rows) /= 0 then
+				Result := l_rows.to_integer_32
+			end
+		end
+
+feature -- Targets
+
+	add_target (a_ctx: VULKAN_CONTEXT; a_pipeline: VULKAN_PIPELINE; a_output: VULKAN_BUFFER; a_weight: REAL_32): INTEGER
+			-- Render a share of the rows proportional to `a_weight` with `a_pipeline` on `a_ctx`
+			-- into `a_output` (at least `frame_bytes`). Returns the target index, or -1.
+		require
+			valid: is_valid
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			pipeline_valid: a_pipeline /= Void and then a_pipeline.is_valid
+			output_valid: a_output /= Void and then a_output.is_valid
+			positive_weight: a_weight > 0
+		do
+			Result := svk_splitter_add (handle, a_ctx.handle, a_pipeline.handle, a_output.handle, a_weight)
+			if Result >= 0 then
+				target_count := Result + 1
+			end
+		end
+
+	set_weight (a_target: INTEGER; a_weight: REAL_32): BOOLEAN
+			-- Change the share of `a_target` from the next `run` on.
+		require
+			valid: is_valid
+			valid_target: a_target >= 0 and a_target < target_count
+			positive_weight: a_weight > 0
+		do
+			Result := svk_splitter_set_weight (handle, a_target, a_weight) /= 0
+		end
+
+feature -- Rendering
+
+	run (a_merged: POINTER): BOOLEAN
+			-- Render one frame on every target and merge it into `a_merged` (at least `frame_bytes`).
+		require
+			valid: is_valid
+			has_targets: target_count > 0
+			merged_attached: a_merged /= default_pointer
+		do
+			Result := svk_splitter_run (handle, a_merged) /= 0
+		end
+
+feature -- Disposal
+
+	dispose
+			-- Free splitter. Contexts, pipelines and buffers stay the caller's.
+		do
+			if is_valid and handle /= default_pointer then
+				svk_free_splitter (handle)
+				handle := default_pointer
+				is_valid := False
+			end
+		ensure
+			disposed: not is_valid
+			handle_cleared: handle = default_pointer
+		end
+
+feature {NONE} -- C Externals
+
+	svk_create_splitter (a_width, a_height, a_pixel_size: NATURAL_32): POINTER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_create_splitter((uint32_t)$a_width, (uint32_t)$a_height, (uint32_t)$a_pixel_size);"
+		end
+
+	svk_splitter_add (split, ctx, pipe, buf: POINTER; a_weight: REAL_32): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_splitter_add((svk_splitter)$split, (svk_context)$ctx, (svk_pipeline)$pipe, (svk_buffer)$buf, (float)$a_weight);"
+		end
+
+	svk_splitter_set_weight (split: POINTER; a_target: INTEGER; a_weight: REAL_32): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_splitter_set_weight((svk_splitter)$split, (int)$a_target, (float)$a_weight);"
+		end
+
+	svk_splitter_run (split, merged: POINTER): INTEGER
+		external
+			"C blocking inline use <simple_vulkan.h>"
+		alias
+			"return svk_splitter_run((svk_splitter)$split, $merged);"
+		end
+
+	svk_splitter_band (split: POINTER; a_target: INTEGER; first_row, rows: POINTER): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_splitter_band((svk_splitter)$split, (int)$a_target, (uint32_t*)$first_row, (uint32_t*)$rows);"
+		end
+
+	svk_free_splitter (split: POINTER)
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"svk_free_splitter((svk_splitter)$split);"
+		end
+
+invariant
+	valid_handle: is_valid implies handle /= default_pointer
+	positive_dimensions: width > 0 and height > 0
+
+end
@@ -0,0 +1,179 @@
+note
+	description: "[
+		VULKAN_TILED_SDF - Tile-culled two-pass SDF rendering.
+
+		Renders a buffer-output SDF shader (sdf_buffer_output.comp,
+		medieval_village.comp) in two passes. A classify pass marches
+		one cone per `tile_size` x `tile_size` tile and stores a safe
+		start depth for its rays; the march pass then starts every
+		pixel from its tile's depth and skips tiles that hit nothing,
+		saving the steps spent approaching the first surface and on
+		empty sky. Both passes are one submission.
+
+		The pixel buffer holds the width x height packed pixels followed
+		by one depth per tile: allocate `buffer_size` bytes.
+
+		Usage:
+			local
+				sdf: VULKAN_TILED_SDF
+				pixels: VULKAN_BUFFER
+				ok: BOOLEAN
+			do
+				create sdf.make (ctx, shader, constants, 16)
+				if sdf.is_valid then
+					create pixels.make (ctx, sdf.buffer_size (3840, 2160), {VULKAN_BUFFER}.Buffer_storage)
+					ok := sdf.bind (pixels, camera_params)
+						and then sdf.render (3840, 2160)
+					sdf.dispose
+				end
+			end
+	]"
+	author: "Larry Rix"
+	date: "$Date$"
+	revision: "$Revision$"
+
+class
+	VULKAN_TILED_SDF
+
+create
+	make
+
+feature {NONE} -- Initialization
+
+	make (a_ctx: VULKAN_CONTEXT; a_shader: VULKAN_SHADER; a_constants: VULKAN_SPEC_CONSTANTS; a_tile_size: INTEGER)
+			-- Create both passes of `a_shader` with `a_constants` (e.g. a quality tier)
+			-- and `a_tile_size` x `a_tile_size` tiles.
+		require
+			ctx_valid: a_ctx /= Void and then a_ctx.is_valid
+			shader_valid: a_shader /= Void and then a_shader.is_valid
+			constants_attached: a_constants /= Void
+			positive_tile_size: a_tile_size > 0
+		do
+			context := a_ctx
+			tile_size := a_tile_size
+			handle := svk_create_tiled_sdf (a_ctx.handle, a_shader.handle,
+				a_constants.data.item, a_constants.count.to_natural_32, a_tile_size.to_natural_32)
+			is_valid := handle /= default_pointer
+		ensure
+			context_set: context = a_ctx
+			tile_size_set: tile_size = a_tile_size
+		end
+
+feature -- Access
+
+	handle: POINTER
+			-- Opaque handle to svk_tiled_sdf
+
+	context: VULKAN_CONTEXT
+			-- Parent context
+
+	tile_size: INTEGER
+			-- Tile width and height in pixels
+
+	is_valid: BOOLEAN
+			-- Were both passes created successfully?
+
+	buffer_size (a_width, a_height: INTEGER): INTEGER_64
+			-- Bytes the pixel buffer needs for `a_width` x `a_height` frames
+		require
+			positive_dimensions: a_width > 0 and a_height > 0
+		do
+			Result := svk_tiled_sdf_buffer_size (a_width.to_natural_32, a_height.to_natural_32,
+				tile_size.to_natural_32).to_integer_64
+		end
+
+feature -- Rendering
+
+	bind (a_pixels, a_params: VULKAN_BUFFER): BOOLEAN
+			-- Render into `a_pixels` (at least `buffer_size`) with camera `a_params`.
+		require
+			valid: is_valid
+			pixels_valid: a_pixels /= Void and then a_pixels.is_valid
+			params_valid: a_params /= Void and then a_params.is_valid
+		do
+			Result := svk_tiled_sdf_bind (handle, a_pixels.handle, a_params.handle) /= 0
+		end
+
+	render (a_width, a_height: INTEGER): BOOLEAN
+			-- Render an `a_width` x `a_height` frame (as set in the camera params) and wait.
+		require
+			valid: is_valid
+			positive_dimensions: a_width > 0 and a_height > 0
+		do
+			Result := svk_tiled_sdf_render (handle, a_width.to_natural_32, a_height.to_natural_32) /= 0
+		end
+
+	render_async (a_width, a_height: INTEGER): NATURAL_64
+			-- Submit an `a_width` x `a_height` frame without waiting.
+			-- Returns a ticket for {VULKAN_PIPELINE}.wait_ticket, or 0 on failure.
+		require
+			valid: is_valid
+			positive_dimensions: a_width > 0 and a_height > 0
+		do
+			Result := svk_tiled_sdf_render_async (handle, a_width.to_natural_32, a_height.to_natural_32)
+		end
+
+feature -- Disposal
+
+	dispose
+			-- Free both passes. Bound buffers stay the caller's.
+		do
+			if is_valid and handle /= default_pointer then
+				svk_free_tiled_sdf (handle)
+				handle := default_pointer
+				is_valid := False
+			end
+		ensure
+			disposed: not is_valid
+			handle_cleared: handle = default_pointer
+		end
+
+feature {NONE} -- C Externals
+
+	svk_create_tiled_sdf (ctx, a_shader, a_constants: POINTER; a_count, a_tile_size: NATURAL_32): POINTER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_create_tiled_sdf((svk_context)$ctx, (svk_shader)$a_shader, (const svk_spec_constant*)$a_constants, (uint32_t)$a_count, (uint32_t)$a_tile_size);"
+		end
+
+	svk_tiled_sdf_buffer_size (a_width, a_height, a_tile_size: NATURAL_32): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_tiled_sdf_buffer_size((uint32_t)$a_width, (uint32_t)$a_height, (uint32_t)$a_tile_size);"
+		end
+
+	svk_tiled_sdf_bind (sdf, a_pixels, a_params: POINTER): INTEGER
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_tiled_sdf_bind((svk_tiled_sdf)$sdf, (svk_buffer)$a_pixels, (svk_buffer)$a_params);"
+		end
+
+	svk_tiled_sdf_render (sdf: POINTER; a_width, a_height: NATURAL_32): INTEGER
+		external
+			"C blocking inline use <simple_vulkan.h>"
+		alias
+			"return svk_tiled_sdf_render((svk_tiled_sdf)$sdf, (uint32_t)$a_width, (uint32_t)$a_height);"
+		end
+
+	svk_tiled_sdf_render_async (sdf: POINTER; a_width, a_height: NATURAL_32): NATURAL_64
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"return svk_tiled_sdf_render_async((svk_tiled_sdf)$sdf, (uint32_t)$a_width, (uint32_t)$a_height);"
+		end
+
+	svk_free_tiled_sdf (sdf: POINTER)
+		external
+			"C inline use <simple_vulkan.h>"
+		alias
+			"svk_free_tiled_sdf((svk_tiled_sdf)$sdf);"
+		end
+
+invariant
+	valid_handle: is_valid implies handle /= default_pointer
+	context_attached: context /= Void
+
+end
@@ -42,11 +42,38 @@ feature -- Execution
 		do
 			test_context_creation
 			test_device_info
+			test_device_enumeration
 			test_buffer_creation
 			test_buffer_upload_download
 			test_image_creation
 			test_shader_loading
+			test_shader_sharing
 			test_pipeline_creation
+			test_shader_reflection
+			test_pipeline_cache
+			test_pipeline_variants
+			test_async_dispatch
+			test_image_dispatch
+			test_async_image_readback
+			test_packed_download
+			test_sdf_renderer
+			test_command_list
+			test_indirect_dispatch
+			test_tiled_sdf
+			test_tiled_sdf_starts
+			test_parallel_primitives
+			test_task_graph
+			test_transient_aliasing
+			test_multi_context_split
+			test_descriptor_ping_pong
+			test_memory_suballocation
+			test_descriptor_pool_recycling
+			test_device_local_transfer
+			test_thread_release
+			test_concurrent_dispatch
+			test_queue_handoff
+			test_mapped_buffer
+			test_gpu_profiler
 
 			print ("%N===============================%N")
 			print ("Results: " + passed.out + " passed, " + failed.out + " failed%N")
@@ -95,6 +122,35 @@ feature -- Individual Tests
 			end
 		end
 
+	test_device_enumeration
+			-- Test listing devices and creating a context on a chosen one.
+		local
+			ctx, chosen: VULKAN_CONTEXT
+			info: VULKAN_DEVICE_INFO
+		do
+			print ("Test: Device enumeration... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				info := vk.device_info (ctx.device_index)
+				chosen := vk.create_context_on_device (ctx.device_index)
+				if vk.device_count > ctx.device_index and info.is_valid and info.has_compute
+					and then info.name.same_string (ctx.device_name)
+					and then info.heap_count > 0
+					and then chosen.is_valid and then chosen.device_index = ctx.device_index
+				then
+					print ("PASS (" + vk.device_count.out + " devices)%N")
+					passed := passed + 1
+				else
+					print ("FAIL (device " + ctx.device_index.out + ")%N")
+					failed := failed + 1
+				end
+				chosen.dispose
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
 	test_buffer_creation
 			-- Test GPU buffer creation.
 		local
@@ -237,6 +293,51 @@ feature -- Individual Tests
 			end
 		end
 
+	test_shader_sharing
+			-- Test that loading the same SPIR-V twice shares one module.
+		local
+			ctx: VULKAN_CONTEXT
+			first, second: VULKAN_SHADER
+			base_count: INTEGER
+		do
+			print ("Test: Shader sharing... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				base_count := ctx.shader_module_count
+				first := vk.load_shader (ctx, "shaders/sdf_raymarcher.spv")
+				if first.is_valid then
+					second := vk.load_shader (ctx, "shaders/sdf_raymarcher.spv")
+					if second.is_valid and then ctx.shader_module_count = base_count + 1 then
+						first.dispose
+						if ctx.shader_module_count = base_count + 1 and then second.push_constant_size = 32 then
+							second.dispose
+							if ctx.shader_module_count = base_count then
+								print ("PASS%N")
+								passed := passed + 1
+							else
+								print ("FAIL (module not released)%N")
+								failed := failed + 1
+							end
+						else
+							print ("FAIL (shared module released early)%N")
+							failed := failed + 1
+							second.dispose
+						end
+					else
+						print ("FAIL (module not shared)%N")
+						failed := failed + 1
+						first.dispose
+						second.dispose
+					end
+				else
+					print ("SKIP (shader not compiled)%N")
+				end
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
 	test_pipeline_creation
 			-- Test compute pipeline creation.
 		local
@@ -270,4 +371,1510 @@ feature -- Individual Tests
 			end
 		end
 
+	test_shader_reflection
+			-- Test bindings, push-constant size and local size read from SPIR-V.
+		local
+			ctx: VULKAN_CONTEXT
+			image_shader, buffer_shader: VULKAN_SHADER
+			pipeline: VULKAN_PIPELINE
+			pixels_buf, params_buf: VULKAN_BUFFER
+			params, pixels: MANAGED_POINTER
+		do
+			print ("Test: Shader reflection... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				image_shader := vk.load_shader (ctx, "shaders/sdf_raymarcher.spv")
+				buffer_shader := vk.load_shader (ctx, "shaders/sdf_buffer_output.spv")
+				if image_shader.is_valid and buffer_shader.is_valid then
+					pipeline := vk.create_pipeline (ctx, buffer_shader)
+					pixels_buf := vk.create_buffer (ctx, 50 * 30 * 4, vk.Buffer_storage)
+					params_buf := vk.create_buffer (ctx, 32, vk.Buffer_storage)
+					params := sdf_camera_params (50, 30)
+					create pixels.make (50 * 30 * 4)
+					if image_shader.is_reflected and buffer_shader.is_reflected
+						and then image_shader.binding_type (0) = {VULKAN_PIPELINE}.Binding_image
+						and then image_shader.binding_type (1) = 0
+						and then image_shader.push_constant_size = 32
+						and then buffer_shader.binding_type (1) = {VULKAN_PIPELINE}.Binding_buffer
+						and then buffer_shader.push_constant_size = 0
+						and then buffer_shader.local_size_x = 16 and then buffer_shader.local_size_y = 16
+						and then pipeline.is_valid and then pipeline.local_size_x = 16
+						and then pipeline.bind_buffer (0, pixels_buf)
+						and then pipeline.bind_buffer (1, params_buf)
+						and then params_buf.upload (params.item, 32, 0)
+						and then pipeline.dispatch_threads (ctx, 50, 30, 1)
+						and then pixels_buf.download (pixels.item, 50 * 30 * 4, 0)
+						and then all_pixels_written (pixels, 50 * 30)
+					then
+						print ("PASS%N")
+						passed := passed + 1
+					else
+						print ("FAIL (reflected interface mismatch)%N")
+						failed := failed + 1
+					end
+					pixels_buf.dispose
+					params_buf.dispose
+					pipeline.dispose
+				else
+					print ("SKIP (shader not compiled)%N")
+				end
+				image_shader.dispose
+				buffer_shader.dispose
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+	test_pipeline_cache
+			-- Test saving the pipeline cache and loading it into a fresh context.
+		local
+			ctx, ctx2: VULKAN_CONTEXT
+			shader: VULKAN_SHADER
+			pipeline: VULKAN_PIPELINE
+			cache_file: RAW_FILE
+			ok: BOOLEAN
+		do
+			print ("Test: Pipeline cache... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				shader := vk.load_shader (ctx, "shaders/sdf_raymarcher.spv")
+				if shader.is_valid then
+					pipeline := vk.create_pipeline (ctx, shader)
+					ok := pipeline.is_valid and then ctx.save_pipeline_cache ("test_pipeline.vkcache")
+					pipeline.dispose
+					shader.dispose
+					ctx.dispose
+					ctx2 := vk.create_context
+					ok := ok and then ctx2.is_valid and then ctx2.load_pipeline_cache ("test_pipeline.vkcache")
+						and then not ctx2.load_pipeline_cache ("missing.vkcache")
+					if ctx2.is_valid then
+						ctx2.dispose
+					end
+					create cache_file.make_with_name ("test_pipeline.vkcache")
+					if cache_file.exists then
+						cache_file.delete
+					end
+					if ok then
+						print ("PASS%N")
+						passed := passed + 1
+					else
+						print ("FAIL (cache round trip)%N")
+						failed := failed + 1
+					end
+				else
+					print ("SKIP (shader not compiled)%N")
+					ctx.dispose
+				end
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+	test_pipeline_variants
+			-- Test that equal specialization constants share one compiled pipeline
+			-- and that different ones take effect.
+		local
+			ctx: VULKAN_CONTEXT
+			shader: VULKAN_SHADER
+			fast_a, fast_b, slow: VULKAN_PIPELINE
+			fast, precise: VULKAN_SPEC_CONSTANTS
+			pixels_buf, params_buf: VULKAN_BUFFER
+			params, pixels, precise_pixels: MANAGED_POINTER
+			base: INTEGER
+		do
+			print ("Test: Pipeline variants... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				shader := vk.load_shader (ctx, "shaders/sdf_buffer_output.spv")
+				if shader.is_valid then
+					base := ctx.pipeline_variant_count
+					create fast.make
+					fast.put_integer (fast.Sdf_max_steps_id, 32)
+					fast.put_real (fast.Sdf_surf_dist_id, {REAL_32} 0.01)
+					create precise.make
+					precise.put_real (precise.Sdf_surf_dist_id, {REAL_32} 0.01)
+					precise.put_integer (precise.Sdf_max_steps_id, 128)
+					precise.put_integer (precise.Local_size_x_id, 8)
+					precise.put_integer (precise.Local_size_y_id, 4)
+					fast_a := vk.create_specialized_pipeline (ctx, shader, fast)
+					fast_b := vk.create_specialized_pipeline (ctx, shader, fast)
+					slow := vk.create_specialized_pipeline (ctx, shader, precise)
+					pixels_buf := vk.create_buffer (ctx, 50 * 30 * 4, vk.Buffer_storage)
+					params_buf := vk.create_buffer (ctx, 32, vk.Buffer_storage)
+					params := sdf_camera_params (50, 30)
+					create pixels.make (50 * 30 * 4)
+					create precise_pixels.make (50 * 30 * 4)
+					-- Rays near the horizon run out of 32 steps but not of 128, so some pixels differ
+					if fast_a.is_valid and fast_b.is_valid and slow.is_valid
+						and then ctx.pipeline_variant_count = base + 2
+						and then fast_b.local_size_x = 16 and fast_b.local_size_y = 16
+						and then slow.local_size_x = 8 and slow.local_size_y = 4
+						and then fast_b.bind_buffer (0, pixels_buf)
+						and then fast_b.bind_buffer (1, params_buf)
+						and then params_buf.upload (params.item, 32, 0)
+						and then fast_b.dispatch_threads (ctx, 50, 30, 1)
+						and then pixels_buf.download (pixels.item, 50 * 30 * 4, 0)
+						and then all_pixels_written (pixels, 50 * 30)
+						and then slow.bind_buffer (0, pixels_buf)
+						and then slow.bind_buffer (1, params_buf)
+						and then pixels_buf.upload (precise_pixels.item, 50 * 30 * 4, 0)
+						and then slow.dispatch_threads (ctx, 50, 30, 1)
+						and then pixels_buf.download (precise_pixels.item, 50 * 30 * 4, 0)
+						and then all_pixels_written (precise_pixels, 50 * 30)
+						and then matching_pixels (pixels, precise_pixels, 50 * 30, 0) < 50 * 30
+					then
+						print ("PASS%N")
+						passed := passed + 1
+					else
+						print ("FAIL (variant count " + ctx.pipeline_variant_count.out
+							+ ", local size " + slow.local_size_x.out + "x" + slow.local_size_y.out + ")%N")
+						failed := failed + 1
+					end
+					pixels_buf.dispose
+					params_buf.dispose
+					fast_a.dispose
+					fast_b.dispose
+					slow.dispose
+				else
+					print ("SKIP (shader not compiled)%N")
+				end
+				shader.dispose
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+	test_async_dispatch
+			-- Test non-blocking dispatch with ticket wait.
+		local
+			ctx: VULKAN_CONTEXT
+			shader: VULKAN_SHADER
+			pipeline: VULKAN_PIPELINE
+			pixels_buf, params_buf: VULKAN_BUFFER
+			params, pixels: MANAGED_POINTER
+			ticket: NATURAL_64
+		do
+			print ("Test: Async dispatch... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				shader := vk.load_shader (ctx, "shaders/sdf_buffer_output.spv")
+				if shader.is_valid then
+					pipeline := vk.create_pipeline (ctx, shader)
+					pixels_buf := vk.create_buffer (ctx, 64 * 64 * 4, vk.Buffer_storage)
+					params_buf := vk.create_buffer (ctx, 32, vk.Buffer_storage)
+					params := sdf_camera_params (64, 64)
+					create pixels.make (64 * 64 * 4)
+					if pipeline.is_valid and pixels_buf.is_valid and params_buf.is_valid
+						and then params_buf.upload (params.item, 32, 0)
+						and then pipeline.bind_buffer (0, pixels_buf)
+						and then pipeline.bind_buffer (1, params_buf)
+					then
+						ticket := pipeline.dispatch_async (ctx, 4, 4, 1)
+						if ticket > 0 and then pipeline.wait_ticket (ctx, ticket)
+							and then pipeline.is_ticket_complete (ctx, ticket)
+							and then pixels_buf.download (pixels.item, 64 * 64 * 4, 0)
+							and then all_pixels_written (pixels, 64 * 64)
+						then
+							print ("PASS%N")
+							passed := passed + 1
+						else
+							print ("FAIL (async dispatch)%N")
+							failed := failed + 1
+						end
+					else
+						print ("FAIL (setup failed)%N")
+						failed := failed + 1
+					end
+					pixels_buf.dispose
+					params_buf.dispose
+					pipeline.dispose
+					shader.dispose
+				else
+					print ("SKIP (shader not compiled)%N")
+				end
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+	test_image_dispatch
+			-- Test rendering into a storage image and downloading it.
+		local
+			ctx: VULKAN_CONTEXT
+			shader: VULKAN_SHADER
+			pipeline: VULKAN_PIPELINE
+			img: VULKAN_IMAGE
+			push, pixels: MANAGED_POINTER
+		do
+			print ("Test: Image dispatch... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				shader := vk.load_shader (ctx, "shaders/sdf_raymarcher.spv")
+				if shader.is_valid then
+					pipeline := vk.create_pipeline_with_bindings (ctx, shader, <<{VULKAN_PIPELINE}.Binding_image>>)
+					img := vk.create_image (ctx, 64, 64, vk.Format_rgba8)
+					create push.make (32)
+					push.put_real_32 ({REAL_32} 1.5, 4)
+					push.put_real_32 ({REAL_32} 5.0, 8)
+					create pixels.make (64 * 64 * 4)
+					if pipeline.is_valid and img.is_valid
+						and then pipeline.bind_image (0, img)
+						and then pipeline.set_push_constants (push.item, 32)
+					then
+						if pipeline.dispatch (ctx, 4, 4, 1)
+							and then img.download (pixels.item)
+							and then all_pixels_written (pixels, 64 * 64)
+							and then pipeline.dispatch (ctx, 4, 4, 1)
+							and then img.download (pixels.item)
+						then
+							print ("PASS%N")
+							passed := passed + 1
+						else
+							print ("FAIL (image dispatch)%N")
+							failed := failed + 1
+						end
+					else
+						print ("FAIL (setup failed)%N")
+						failed := failed + 1
+					end
+					img.dispose
+					pipeline.dispose
+					shader.dispose
+				else
+					print ("SKIP (shader not compiled)%N")
+				end
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+	test_async_image_readback
+			-- Test streaming frames with two image downloads in flight.
+		local
+			ctx: VULKAN_CONTEXT
+			shader: VULKAN_SHADER
+			pipeline: VULKAN_PIPELINE
+			img: VULKAN_IMAGE
+			push, pixels: MANAGED_POINTER
+			tickets: ARRAYED_QUEUE [NATURAL_64]
+			ticket: NATURAL_64
+			frame, collected: INTEGER
+			ok: BOOLEAN
+		do
+			print ("Test: Async image readback... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				shader := vk.load_shader (ctx, "shaders/sdf_raymarcher.spv")
+				if shader.is_valid then
+					pipeline := vk.create_pipeline_with_bindings (ctx, shader, <<{VULKAN_PIPELINE}.Binding_image>>)
+					img := vk.create_image (ctx, 64, 64, vk.Format_rgba8)
+					create push.make (32)
+					push.put_real_32 ({REAL_32} 1.5, 4)
+					push.put_real_32 ({REAL_32} 5.0, 8)
+					create pixels.make (64 * 64 * 4)
+					create tickets.make (2)
+					if pipeline.is_valid and img.is_valid
+						and then pipeline.bind_image (0, img)
+						and then pipeline.set_push_constants (push.item, 32)
+					then
+						ok := True
+						from frame := 1 until frame > 6 or not ok loop
+							if tickets.count = 2 then
+									-- Collect frame N - 2 while frame N renders
+								pixels.item.memory_set (0, pixels.count)
+								ok := img.finish_download (tickets.item, pixels.item)
+									and then all_pixels_written (pixels, 64 * 64)
+								tickets.remove
+								collected := collected + 1
+							end
+							if ok then
+								ticket := 0
+								if pipeline.dispatch_async (ctx, 4, 4, 1) > 0 then
+									ticket := img.begin_download
+								end
+								ok := ticket > 0
+								tickets.extend (ticket)
+							end
+							frame := frame + 1
+						end
+						from until tickets.is_empty loop
+							ok := ok and then img.finish_download (tickets.item, pixels.item)
+								and then all_pixels_written (pixels, 64 * 64)
+							tickets.remove
+							collected := collected + 1
+						end
+						if ok and collected = 6 then
+							print ("PASS%N")
+							passed := passed + 1
+						else
+							print ("FAIL (async image readback)%N")
+							failed := failed + 1
+						end
+					else
+						print ("FAIL (setup failed)%N")
+						failed := failed + 1
+					end
+					img.dispose
+					pipeline.dispose
+					shader.dispose
+				else
+					print ("SKIP (shader not compiled)%N")
+				end
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+	test_packed_download
+			-- Test that a GPU-packed RGBA8 download matches a plain one.
+		local
+			ctx: VULKAN_CONTEXT
+			shader, pack_shader, float_shader: VULKAN_SHADER
+			pipeline, packer, float_packer: VULKAN_PIPELINE
+			img: VULKAN_IMAGE
+			push, plain, packed, yuv: MANAGED_POINTER
+			ok: BOOLEAN
+		do
+			print ("Test: Packed image download... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				shader := vk.load_shader (ctx, "shaders/sdf_raymarcher.spv")
+				pack_shader := vk.load_shader (ctx, "shaders/pack_image_rgba8.spv")
+				float_shader := vk.load_shader (ctx, "shaders/pack_image.spv")
+				if shader.is_valid and pack_shader.is_valid and float_shader.is_valid then
+					pipeline := vk.create_pipeline_with_bindings (ctx, shader, <<{VULKAN_PIPELINE}.Binding_image>>)
+					packer := vk.create_pack_pipeline (ctx, pack_shader)
+					float_packer := vk.create_pack_pipeline (ctx, float_shader)
+					img := vk.create_image (ctx, 64, 64, vk.Format_rgba8)
+					create push.make (32)
+					push.put_real_32 ({REAL_32} 1.5, 4)
+					push.put_real_32 ({REAL_32} 5.0, 8)
+					create plain.make (64 * 64 * 4)
+					create packed.make (64 * 64 * 4)
+					create yuv.make (64 * 64 * 3 // 2)
+					if pipeline.is_valid and packer.is_valid and float_packer.is_valid and img.is_valid
+						and then pipeline.bind_image (0, img)
+						and then pipeline.set_push_constants (push.item, 32)
+					then
+							-- RGBA8 round-trips exactly; an RGBA32F packer refuses RGBA8 images
+						ok := pipeline.dispatch (ctx, 4, 4, 1)
+							and then img.download (plain.item)
+							and then img.download_packed (packer, img.Pack_rgba8, packed.item)
+							and then matching_pixels (plain, packed, 64 * 64, 0) = 64 * 64
+							and then img.packed_bytes (img.Pack_yuv420) = yuv.count
+							and then img.download_packed (packer, img.Pack_yuv420, yuv.item)
+							and then img.begin_packed_download (float_packer, img.Pack_rgba8) = 0
+						if ok then
+							print ("PASS%N")
+							passed := passed + 1
+						else
+							print ("FAIL (packed download differs)%N")
+							failed := failed + 1
+						end
+					else
+						print ("FAIL (setup failed)%N")
+						failed := failed + 1
+					end
+					img.dispose
+					pipeline.dispose
+					packer.dispose
+					float_packer.dispose
+				else
+					print ("SKIP (shader not compiled)%N")
+				end
+				shader.dispose
+				pack_shader.dispose
+				float_shader.dispose
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+	test_sdf_renderer
+			-- Test the SDF engine with frames in flight and a dropped frame.
+		local
+			ctx: VULKAN_CONTEXT
+			sdf: VULKAN_SDF_RENDERER
+			pixels: MANAGED_POINTER
+			first, second, third, fourth: NATURAL_64
+		do
+			print ("Test: SDF renderer... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				sdf := vk.create_sdf_renderer (ctx, "shaders/sdf_raymarcher.spv", 64, 64)
+				if sdf.is_valid then
+					create pixels.make (sdf.frame_bytes)
+					first := sdf.render ({REAL_32} 0.0, {REAL_32} 1.5, {REAL_32} 5.0, {REAL_32} 0.0, {REAL_32} 0.0, {REAL_32} 0.0)
+					second := sdf.render ({REAL_32} 0.0, {REAL_32} 1.5, {REAL_32} 5.0, {REAL_32} 0.1, {REAL_32} 0.0, {REAL_32} 0.1)
+						-- Overwrites the image of `second`, which was never read
+					third := sdf.render ({REAL_32} 0.0, {REAL_32} 1.5, {REAL_32} 5.0, {REAL_32} 0.2, {REAL_32} 0.0, {REAL_32} 0.2)
+					fourth := sdf.render ({REAL_32} 0.0, {REAL_32} 1.5, {REAL_32} 5.0, {REAL_32} 0.3, {REAL_32} 0.0, {REAL_32} 0.3)
+					if first > 0 and second > first and third > second and fourth > third
+						and then not sdf.read_frame (first, pixels.item)
+						and then not sdf.read_frame (second, pixels.item)
+						and then sdf.read_frame (third, pixels.item)
+						and then all_pixels_written (pixels, 64 * 64)
+						and then sdf.read_frame (fourth, pixels.item)
+						and then all_pixels_written (pixels, 64 * 64)
+					then
+						print ("PASS%N")
+						passed := passed + 1
+					else
+						print ("FAIL (sdf renderer)%N")
+						failed := failed + 1
+					end
+				else
+					print ("SKIP (shader not compiled)%N")
+				end
+				sdf.dispose
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+	test_command_list
+			-- Test batched fill + copy in one submission.
+		local
+			ctx: VULKAN_CONTEXT
+			list: VULKAN_COMMAND_LIST
+			src, dst: VULKAN_BUFFER
+			data: MANAGED_POINTER
+			i: INTEGER
+			ok: BOOLEAN
+		do
+			print ("Test: Command list... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				src := vk.create_buffer (ctx, 256, vk.Buffer_storage)
+				dst := vk.create_buffer (ctx, 256, vk.Buffer_storage)
+				list := vk.create_command_list (ctx)
+				create data.make (256)
+				if src.is_valid and dst.is_valid and list.is_valid then
+					ok := list.begin_recording
+						and then list.fill_buffer (src, 0, 256, 0xA5A5A5A5)
+						and then list.copy_buffer (src, dst, 0, 0, 256)
+						and then list.end_recording
+						and then list.submit_and_wait
+						and then dst.download (data.item, 256, 0)
+					from i := 0 until i >= 256 or not ok loop
+						ok := data.read_natural_8 (i) = 0xA5
+						i := i + 1
+					end
+					if ok then
+						print ("PASS%N")
+						passed := passed + 1
+					else
+						print ("FAIL (batched fill/copy)%N")
+						failed := failed + 1
+					end
+				else
+					print ("FAIL (setup failed)%N")
+					failed := failed + 1
+				end
+				list.dispose
+				src.dispose
+				dst.dispose
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+	test_indirect_dispatch
+			-- Test a counter turned into dispatch arguments on the GPU, then an indirect dispatch.
+		local
+			ctx: VULKAN_CONTEXT
+			args_shader, shader: VULKAN_SHADER
+			args_pipe, pipeline: VULKAN_PIPELINE
+			list: VULKAN_COMMAND_LIST
+			counter_buf, args_buf, pixels_buf, params_buf: VULKAN_BUFFER
+			count, push, args, pixels: MANAGED_POINTER
+			ok: BOOLEAN
+		do
+			print ("Test: Indirect dispatch... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				args_shader := vk.load_shader (ctx, "shaders/dispatch_args.spv")
+				shader := vk.load_shader (ctx, "shaders/sdf_buffer_output.spv")
+				if args_shader.is_valid and shader.is_valid then
+					args_pipe := vk.create_pipeline (ctx, args_shader)
+					pipeline := vk.create_pipeline (ctx, shader)
+					list := vk.create_command_list (ctx)
+					counter_buf := vk.create_buffer (ctx, 4, vk.Buffer_storage)
+					args_buf := vk.create_buffer (ctx, 16, vk.Buffer_storage | vk.Buffer_indirect | vk.Buffer_device_local)
+					pixels_buf := vk.create_buffer (ctx, 1024 * 16 * 4, vk.Buffer_storage | vk.Buffer_device_local)
+					params_buf := vk.create_buffer (ctx, 32, vk.Buffer_storage)
+					-- 1024 columns in 16-wide workgroups: (64, 1, 1) covers the 1024 x 16 frame
+					create count.make (4)
+					count.put_natural_32 (1024, 0)
+					create push.make (16)
+					push.put_natural_32 (16, 0)
+					push.put_natural_32 (0, 4)
+					push.put_natural_32 (1, 8)
+					push.put_natural_32 (65535, 12)
+					create args.make (16)
+					create pixels.make (1024 * 16 * 4)
+					if args_pipe.is_valid and pipeline.is_valid and list.is_valid
+						and counter_buf.is_valid and args_buf.is_valid and pixels_buf.is_valid and params_buf.is_valid
+						and then counter_buf.upload (count.item, 4, 0)
+						and then params_buf.upload (sdf_camera_params (1024, 16).item, 32, 0)
+						and then args_pipe.bind_buffer (0, counter_buf)
+						and then args_pipe.bind_buffer (1, args_buf)
+						and then args_pipe.set_push_constants (push.item, 16)
+						and then pipeline.bind_buffer (0, pixels_buf)
+						and then pipeline.bind_buffer (1, params_buf)
+					then
+						ok := list.begin_recording
+							and then list.dispatch (args_pipe, 1, 1, 1)
+							and then list.dispatch_indirect (pipeline, args_buf, 4)
+							and then list.end_recording
+							and then list.submit_and_wait
+							and then args_buf.download (args.item, 16, 0)
+							and then args.read_natural_32 (4) = 64 and args.read_natural_32 (8) = 1
+							and then args.read_natural_32 (12) = 1
+							and then pixels_buf.download (pixels.item, 1024 * 16 * 4, 0)
+							and then all_pixels_written (pixels, 1024 * 16)
+						if ok then
+							print ("PASS%N")
+							passed := passed + 1
+						else
+							print ("FAIL (indirect dispatch)%N")
+							failed := failed + 1
+						end
+					else
+						print ("FAIL (setup failed)%N")
+						failed := failed + 1
+					end
+					list.dispose
+					counter_buf.dispose
+					args_buf.dispose
+					pixels_buf.dispose
+					params_buf.dispose
+					args_pipe.dispose
+					pipeline.dispose
+				else
+					print ("SKIP (shader not compiled)%N")
+				end
+				args_shader.dispose
+				shader.dispose
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+	test_tiled_sdf
+			-- Test that the tile-culled renderer matches a single-pass render.
+		local
+			ctx: VULKAN_CONTEXT
+			shader: VULKAN_SHADER
+			pipeline: VULKAN_PIPELINE
+			sdf: VULKAN_TILED_SDF
+			constants: VULKAN_SPEC_CONSTANTS
+			single_buf, tiled_buf, params_buf: VULKAN_BUFFER
+			single, tiled: MANAGED_POINTER
+			ok: BOOLEAN
+		do
+			print ("Test: Tiled SDF... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				shader := vk.load_shader (ctx, "shaders/sdf_buffer_output.spv")
+				if shader.is_valid then
+					create constants.make
+					pipeline := vk.create_pipeline (ctx, shader)
+					sdf := vk.create_tiled_sdf (ctx, shader, constants, 8)
+					single_buf := vk.create_buffer (ctx, 64 * 64 * 4, vk.Buffer_storage | vk.Buffer_device_local)
+					tiled_buf := vk.create_buffer (ctx, sdf.buffer_size (64, 64), vk.Buffer_storage | vk.Buffer_device_local)
+					params_buf := vk.create_buffer (ctx, 32, vk.Buffer_storage)
+					create single.make (64 * 64 * 4)
+					create tiled.make (64 * 64 * 4)
+					if pipeline.is_valid and sdf.is_valid
+						and single_buf.is_valid and tiled_buf.is_valid and params_buf.is_valid
+						and then params_buf.upload (sdf_camera_params (64, 64).item, 32, 0)
+						and then pipeline.bind_buffer (0, single_buf)
+						and then pipeline.bind_buffer (1, params_buf)
+						and then sdf.bind (tiled_buf, params_buf)
+					then
+						-- Rays that run out of steps may end differently; nearly all must match
+						ok := pipeline.dispatch (ctx, 4, 4, 1)
+							and then sdf.render (64, 64)
+							and then single_buf.download (single.item, 64 * 64 * 4, 0)
+							and then tiled_buf.download (tiled.item, 64 * 64 * 4, 0)
+							and then all_pixels_written (tiled, 64 * 64)
+							and then matching_pixels (single, tiled, 64 * 64, 8) >= 64 * 64 * 99 // 100
+						if ok then
+							print ("PASS%N")
+							passed := passed + 1
+						else
+							print ("FAIL (tiled render differs)%N")
+							failed := failed + 1
+						end
+					else
+						print ("FAIL (setup failed)%N")
+						failed := failed + 1
+					end
+					single_buf.dispose
+					tiled_buf.dispose
+					params_buf.dispose
+					pipeline.dispose
+					sdf.dispose
+				else
+					print ("SKIP (shader not compiled)%N")
+				end
+				shader.dispose
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+	test_tiled_sdf_starts
+			-- Test the start distances the classify pass stores after the pixels.
+		local
+			ctx: VULKAN_CONTEXT
+			shader: VULKAN_SHADER
+			sdf: VULKAN_TILED_SDF
+			constants: VULKAN_SPEC_CONSTANTS
+			pixels_buf, params_buf: VULKAN_BUFFER
+			starts: MANAGED_POINTER
+			max_dist, ground, sky: REAL_32
+			i: INTEGER
+			ok: BOOLEAN
+		do
+			print ("Test: Tiled SDF start distances... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				shader := vk.load_shader (ctx, "shaders/sdf_buffer_output.spv")
+				if shader.is_valid then
+					max_dist := {REAL_32} 50.0
+					create constants.make
+					constants.put_real (constants.Sdf_max_dist_id, max_dist)
+					sdf := vk.create_tiled_sdf (ctx, shader, constants, 8)
+					pixels_buf := vk.create_buffer (ctx, sdf.buffer_size (64, 64), vk.Buffer_storage)
+					params_buf := vk.create_buffer (ctx, 32, vk.Buffer_storage)
+					create starts.make (8 * 8 * 4)
+					if sdf.is_valid and pixels_buf.is_valid and params_buf.is_valid
+						and then params_buf.upload (sdf_camera_params (64, 64).item, 32, 0)
+						and then sdf.bind (pixels_buf, params_buf)
+						and then sdf.render (64, 64)
+						and then pixels_buf.download (starts.item, 8 * 8 * 4, 64 * 64 * 4)
+					then
+						-- 8 x 8 tiles, row by row. The camera looks level along -z: the
+						-- first row's rays point down at the ground, the last row's at the sky.
+						ok := True
+						from i := 0 until i >= 8 loop
+							ground := starts.read_real_32 (i * 4)
+							sky := starts.read_real_32 ((7 * 8 + i) * 4)
+							ok := ok and ground > {REAL_32} 0.0 and ground < max_dist and sky > max_dist
+							i := i + 1
+						end
+						if ok then
+							print ("PASS%N")
+							passed := passed + 1
+						else
+							print ("FAIL (tile starts " + ground.out + ", " + sky.out + ")%N")
+							failed := failed + 1
+						end
+					else
+						print ("FAIL (setup failed)%N")
+						failed := failed + 1
+					end
+					pixels_buf.dispose
+					params_buf.dispose
+					sdf.dispose
+				else
+					print ("SKIP (shader not compiled)%N")
+				end
+				shader.dispose
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+	test_parallel_primitives
+			-- Test GPU reduce, scan, sort and histogram against the CPU references.
+		local
+			ctx: VULKAN_CONTEXT
+			algos: VULKAN_ALGORITHMS
+			data_buf, out_buf, values_buf, floats_buf: VULKAN_BUFFER
+			data, keys, values, expected, actual, floats: MANAGED_POINTER
+			i, n: INTEGER
+			ok: BOOLEAN
+		do
+			print ("Test: Parallel primitives... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				algos := vk.create_algorithms (ctx, "shaders")
+				if algos.is_valid then
+						-- Three tiles of 2048, so scans and sorts take their multi-tile paths
+					n := 5000
+					create data.make (n * 4)
+					create keys.make (n * 4)
+					create values.make (n * 4)
+					create floats.make (n * 4)
+					from i := 0 until i >= n loop
+						data.put_integer_32 ((i * 7919) \\ 10007 - 5000, i * 4)
+						keys.put_integer_32 ((i * 7919) \\ 10007 - 5000, i * 4)
+						values.put_natural_32 (i.to_natural_32, i * 4)
+						floats.put_real_32 (((i * 31) \\ 257 - 128).to_real, i * 4)
+						i := i + 1
+					end
+					create expected.make (n * 4)
+					create actual.make (n * 4)
+					data_buf := vk.create_buffer (ctx, n * 4, vk.Buffer_storage)
+					out_buf := vk.create_buffer (ctx, n * 4, vk.Buffer_storage)
+					values_buf := vk.create_buffer (ctx, n * 4, vk.Buffer_storage)
+					floats_buf := vk.create_buffer (ctx, n * 4, vk.Buffer_storage)
+					if data_buf.is_valid and out_buf.is_valid and values_buf.is_valid and floats_buf.is_valid
+						and then data_buf.upload (data.item, n * 4, 0)
+						and then values_buf.upload (values.item, n * 4, 0)
+						and then floats_buf.upload (floats.item, n * 4, 0)
+					then
+						ok := algos.reduce (data_buf, n, algos.Element_int32, algos.Reduce_sum, out_buf)
+							and then out_buf.download (actual.item, 4, 0)
+							and then actual.read_natural_32 (0) = algos.reference_reduce (data, n, algos.Element_int32, algos.Reduce_sum)
+							and then algos.reduce (floats_buf, n, algos.Element_float32, algos.Reduce_min, out_buf)
+							and then out_buf.download (actual.item, 4, 0)
+							and then actual.read_natural_32 (0) = algos.reference_reduce (floats, n, algos.Element_float32, algos.Reduce_min)
+							and then algos.scan (data_buf, out_buf, n, algos.Element_int32, algos.Reduce_sum, False)
+							and then out_buf.download (actual.item, n * 4, 0)
+							and then algos.reference_scan (data, expected, n, algos.Element_int32, algos.Reduce_sum, False)
+							and then matching_pixels (expected, actual, n, 0) = n
+							and then algos.sort_pairs (data_buf, values_buf, n, algos.Element_int32)
+							and then algos.reference_sort_pairs (keys, values, n, algos.Element_int32)
+							and then data_buf.download (actual.item, n * 4, 0)
+							and then matching_pixels (keys, actual, n, 0) = n
+							and then values_buf.download (actual.item, n * 4, 0)
+							and then matching_pixels (values, actual, n, 0) = n
+							and then algos.histogram (floats_buf, n, algos.Element_float32, -100.0, 100.0, 16, out_buf)
+							and then out_buf.download (actual.item, 16 * 4, 0)
+							and then algos.reference_histogram (floats, n, algos.Element_float32, -100.0, 100.0, 16, expected)
+							and then matching_pixels (expected, actual, 16, 0) = 16
+						if ok then
+							print ("PASS%N")
+							passed := passed + 1
+						else
+							print ("FAIL (GPU result differs from CPU reference)%N")
+							failed := failed + 1
+						end
+					else
+						print ("FAIL (setup failed)%N")
+						failed := failed + 1
+					end
+					data_buf.dispose
+					out_buf.dispose
+					values_buf.dispose
+					floats_buf.dispose
+					algos.dispose
+				else
+					print ("SKIP (shaders not compiled or no subgroup arithmetic)%N")
+				end
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+	test_task_graph
+			-- Test a compiled dispatch -> readback graph run twice, the second time resized.
+		local
+			ctx: VULKAN_CONTEXT
+			shader: VULKAN_SHADER
+			pipeline: VULKAN_PIPELINE
+			graph: VULKAN_GRAPH
+			pixels_buf, params_buf: VULKAN_BUFFER
+			pixels: MANAGED_POINTER
+			march, readback: INTEGER
+			ok: BOOLEAN
+		do
+			print ("Test: Task graph... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				shader := vk.load_shader (ctx, "shaders/sdf_buffer_output.spv")
+				if shader.is_valid then
+					pipeline := vk.create_pipeline (ctx, shader)
+					graph := vk.create_graph (ctx)
+					pixels_buf := vk.create_buffer (ctx, 64 * 64 * 4, vk.Buffer_storage | vk.Buffer_device_local)
+					params_buf := vk.create_buffer (ctx, 32, vk.Buffer_storage)
+					create pixels.make (64 * 64 * 4)
+					if pipeline.is_valid and graph.is_valid and pixels_buf.is_valid and params_buf.is_valid
+						and then params_buf.upload (sdf_camera_params (64, 64).item, 32, 0)
+						and then pipeline.bind_buffer (0, pixels_buf)
+						and then pipeline.bind_buffer (1, params_buf)
+					then
+						march := graph.add_dispatch (pipeline, 2, 4, 1)
+						readback := graph.add_buffer_readback_on (ctx.Queue_transfer, pixels_buf, 0, 64 * 64 * 4)
+						ok := march >= 0 and readback >= 0
+							and then graph.compile
+							and then graph.run
+							and then graph.set_workgroups (march, 4, 4, 1)
+							and then graph.run
+							and then graph.read (readback, pixels.item)
+							and then all_pixels_written (pixels, 64 * 64)
+						if ok then
+							print ("PASS%N")
+							passed := passed + 1
+						else
+							print ("FAIL (graph run)%N")
+							failed := failed + 1
+						end
+					else
+						print ("FAIL (setup failed)%N")
+						failed := failed + 1
+					end
+					graph.dispose
+					pixels_buf.dispose
+					params_buf.dispose
+					pipeline.dispose
+					shader.dispose
+				else
+					print ("SKIP (shader not compiled)%N")
+				end
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+	test_transient_aliasing
+			-- Test two graph stages whose transient targets share memory.
+		local
+			ctx: VULKAN_CONTEXT
+			shader: VULKAN_SHADER
+			pipeline: VULKAN_PIPELINE
+			graph: VULKAN_GRAPH
+			first_buf, copy_buf, second_buf, params_buf: VULKAN_BUFFER
+			pixels: MANAGED_POINTER
+			copied, marched: INTEGER
+			ok: BOOLEAN
+		do
+			print ("Test: Transient aliasing... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				shader := vk.load_shader (ctx, "shaders/sdf_buffer_output.spv")
+				if shader.is_valid then
+					pipeline := vk.create_pipeline (ctx, shader)
+					graph := vk.create_graph (ctx)
+					params_buf := vk.create_buffer (ctx, 32, vk.Buffer_storage)
+					create pixels.make (64 * 64 * 4)
+					if pipeline.is_valid and graph.is_valid and params_buf.is_valid
+						and then params_buf.upload (sdf_camera_params (64, 64).item, 32, 0)
+						and then pipeline.bind_buffer (1, params_buf)
+					then
+							-- `first_buf` and `copy_buf` are dead before `second_buf` is written
+						first_buf := graph.new_transient_buffer (64 * 64 * 4, vk.Buffer_storage)
+						copy_buf := graph.new_transient_buffer (64 * 64 * 4, vk.Buffer_storage)
+						second_buf := graph.new_transient_buffer (64 * 64 * 4, vk.Buffer_storage)
+						ok := first_buf.is_valid and copy_buf.is_valid and second_buf.is_valid
+							and then pipeline.bind_buffer (0, first_buf)
+							and then graph.add_dispatch (pipeline, 4, 4, 1) >= 0
+							and then graph.add_copy_on (ctx.Queue_compute, first_buf, copy_buf, 0, 0, 64 * 64 * 4) >= 0
+						if ok then
+							copied := graph.add_buffer_readback_on (ctx.Queue_compute, copy_buf, 0, 64 * 64 * 4)
+							ok := pipeline.bind_buffer (0, second_buf) and then graph.add_dispatch (pipeline, 4, 4, 1) >= 0
+							marched := graph.add_buffer_readback_on (ctx.Queue_compute, second_buf, 0, 64 * 64 * 4)
+						end
+						ok := ok and copied >= 0 and marched >= 0
+							and then graph.compile
+							and then graph.transient_bytes < graph.unaliased_bytes
+							and then graph.run
+							and then graph.read (copied, pixels.item)
+							and then all_pixels_written (pixels, 64 * 64)
+							and then graph.read (marched, pixels.item)
+							and then all_pixels_written (pixels, 64 * 64)
+						if ok then
+							print ("PASS (" + graph.transient_bytes.out + " of " + graph.unaliased_bytes.out + " bytes)%N")
+							passed := passed + 1
+						else
+							print ("FAIL (aliased graph run)%N")
+							failed := failed + 1
+						end
+					else
+						print ("FAIL (setup failed)%N")
+						failed := failed + 1
+					end
+					graph.dispose
+					params_buf.dispose
+					pipeline.dispose
+					shader.dispose
+				else
+					print ("SKIP (shader not compiled)%N")
+				end
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+	test_multi_context_split
+			-- Test one frame rendered in two bands by two contexts on the same device.
+		local
+			ctx_a, ctx_b: VULKAN_CONTEXT
+			shader_a, shader_b: VULKAN_SHADER
+			pipe_a, pipe_b: VULKAN_PIPELINE
+			out_a, out_b, params_a, params_b: VULKAN_BUFFER
+			split: VULKAN_SPLITTER
+			params, pixels: MANAGED_POINTER
+		do
+			print ("Test: Multi-context split... ")
+			ctx_a := vk.create_context
+			if ctx_a.is_valid then
+				ctx_b := vk.create_context_on_device (ctx_a.device_index)
+				shader_a := vk.load_shader (ctx_a, "shaders/sdf_buffer_output.spv")
+				if shader_a.is_valid and ctx_b.is_valid then
+					shader_b := vk.load_shader (ctx_b, "shaders/sdf_buffer_output.spv")
+					pipe_a := vk.create_pipeline (ctx_a, shader_a)
+					pipe_b := vk.create_pipeline (ctx_b, shader_b)
+					out_a := vk.create_buffer (ctx_a, 64 * 64 * 4, vk.Buffer_storage)
+					out_b := vk.create_buffer (ctx_b, 64 * 64 * 4, vk.Buffer_storage)
+					params_a := vk.create_buffer (ctx_a, 32, vk.Buffer_storage)
+					params_b := vk.create_buffer (ctx_b, 32, vk.Buffer_storage)
+					split := vk.create_splitter (64, 64, 4)
+					params := sdf_camera_params (64, 64)
+					create pixels.make (split.frame_bytes)
+					if pipe_a.is_valid and pipe_b.is_valid and split.is_valid
+						and then params_a.upload (params.item, 32, 0)
+						and then params_b.upload (params.item, 32, 0)
+						and then pipe_a.bind_buffer (0, out_a) and then pipe_a.bind_buffer (1, params_a)
+						and then pipe_b.bind_buffer (0, out_b) and then pipe_b.bind_buffer (1, params_b)
+						and then split.add_target (ctx_a, pipe_a, out_a, {REAL_32} 1.0) = 0
+						and then split.add_target (ctx_b, pipe_b, out_b, {REAL_32} 3.0) = 1
+						and then split.run (pixels.item)
+						and then all_pixels_written (pixels, 64 * 64)
+						and then split.band_first_row (1) = split.band_rows (0)
+						and then split.band_rows (0) + split.band_rows (1) = 64
+						and then split.band_rows (0) < split.band_rows (1)
+					then
+						print ("PASS (rows " + split.band_rows (0).out + " + " + split.band_rows (1).out + ")%N")
+						passed := passed + 1
+					else
+						print ("FAIL (split frame)%N")
+						failed := failed + 1
+					end
+					split.dispose
+					out_a.dispose
+					out_b.dispose
+					params_a.dispose
+					params_b.dispose
+					pipe_a.dispose
+					pipe_b.dispose
+					shader_b.dispose
+				else
+					print ("SKIP (shader not compiled)%N")
+				end
+				shader_a.dispose
+				ctx_b.dispose
+				ctx_a.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+	test_descriptor_ping_pong
+			-- Test alternating buffer bindings within one command list.
+		local
+			ctx: VULKAN_CONTEXT
+			shader: VULKAN_SHADER
+			pipeline: VULKAN_PIPELINE
+			list: VULKAN_COMMAND_LIST
+			out_a, out_b, params_buf: VULKAN_BUFFER
+			params, pixels: MANAGED_POINTER
+			ok: BOOLEAN
+		do
+			print ("Test: Descriptor ping-pong... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				shader := vk.load_shader (ctx, "shaders/sdf_buffer_output.spv")
+				if shader.is_valid then
+					pipeline := vk.create_pipeline (ctx, shader)
+					list := vk.create_command_list (ctx)
+					out_a := vk.create_buffer (ctx, 64 * 64 * 4, vk.Buffer_storage)
+					out_b := vk.create_buffer (ctx, 64 * 64 * 4, vk.Buffer_storage)
+					params_buf := vk.create_buffer (ctx, 32, vk.Buffer_storage)
+					params := sdf_camera_params (64, 64)
+					create pixels.make (64 * 64 * 4)
+					if pipeline.is_valid and list.is_valid and out_a.is_valid and out_b.is_valid and params_buf.is_valid
+						and then params_buf.upload (params.item, 32, 0)
+						and then pipeline.bind_buffer (1, params_buf)
+					then
+						ok := list.begin_recording
+							and then pipeline.bind_buffer (0, out_a) and then list.dispatch (pipeline, 4, 4, 1)
+							and then pipeline.bind_buffer (0, out_b) and then list.dispatch (pipeline, 4, 4, 1)
+							and then pipeline.bind_buffer (0, out_a) and then list.dispatch (pipeline, 4, 4, 1)
+							and then list.end_recording
+							and then list.submit_and_wait
+						ok := ok and then out_a.download (pixels.item, 64 * 64 * 4, 0)
+							and then all_pixels_written (pixels, 64 * 64)
+						ok := ok and then out_b.download (pixels.item, 64 * 64 * 4, 0)
+							and then all_pixels_written (pixels, 64 * 64)
+						if ok then
+							print ("PASS%N")
+							passed := passed + 1
+						else
+							print ("FAIL (alternating bindings)%N")
+							failed := failed + 1
+						end
+					else
+						print ("FAIL (setup failed)%N")
+						failed := failed + 1
+					end
+					list.dispose
+					out_a.dispose
+					out_b.dispose
+					params_buf.dispose
+					pipeline.dispose
+					shader.dispose
+				else
+					print ("SKIP (shader not compiled)%N")
+				end
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+	test_memory_suballocation
+			-- Test that many small buffers share device memory blocks.
+		local
+			ctx: VULKAN_CONTEXT
+			buffers: ARRAYED_LIST [VULKAN_BUFFER]
+			stats: VULKAN_MEMORY_STATS
+			i: INTEGER
+			ok: BOOLEAN
+		do
+			print ("Test: Memory sub-allocation... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				create buffers.make (256)
+				ok := True
+				from i := 1 until i > 256 or not ok loop
+					buffers.extend (vk.create_buffer (ctx, 1024 + i, vk.Buffer_storage))
+					ok := buffers.last.is_valid
+					i := i + 1
+				end
+				stats := ctx.memory_stats
+				ok := ok and stats.is_valid and stats.allocation_count = 256 and stats.block_count < 8
+				across buffers as b loop b.item.dispose end
+				stats := ctx.memory_stats
+				ok := ok and stats.allocation_count = 0 and stats.bytes_used = 0
+				if ok then
+					print ("PASS%N")
+					print ("  Blocks: " + stats.block_count.out + "%N")
+					passed := passed + 1
+				else
+					print ("FAIL (allocator stats)%N")
+					failed := failed + 1
+				end
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+	test_descriptor_pool_recycling
+			-- Test that pools grow past one pool's worth of sets and sets are returned on free.
+		local
+			ctx: VULKAN_CONTEXT
+			shader: VULKAN_SHADER
+			pipelines: ARRAYED_LIST [VULKAN_PIPELINE]
+			pixels_buf, params_buf: VULKAN_BUFFER
+			stats: VULKAN_DESCRIPTOR_STATS
+			round, i: INTEGER
+			ok: BOOLEAN
+		do
+			print ("Test: Descriptor pool recycling... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				shader := vk.load_shader (ctx, "shaders/sdf_buffer_output.spv")
+				if shader.is_valid then
+					pixels_buf := vk.create_buffer (ctx, 16 * 16 * 4, vk.Buffer_storage)
+					params_buf := vk.create_buffer (ctx, 32, vk.Buffer_storage)
+					ok := params_buf.upload (sdf_camera_params (16, 16).item, 32, 0)
+					create pipelines.make (100)
+					from round := 1 until round > 3 or not ok loop
+						from i := 1 until i > 100 or not ok loop
+							pipelines.extend (vk.create_pipeline (ctx, shader))
+							ok := pipelines.last.is_valid
+								and then pipelines.last.bind_buffer (0, pixels_buf)
+								and then pipelines.last.bind_buffer (1, params_buf)
+								and then pipelines.last.dispatch (ctx, 1, 1, 1)
+							i := i + 1
+						end
+						stats := ctx.descriptor_stats
+						ok := ok and stats.sets_in_use = 100 and stats.pool_count > 1
+						across pipelines as p loop p.item.dispose end
+						pipelines.wipe_out
+						round := round + 1
+					end
+					stats := ctx.descriptor_stats
+					ok := ok and stats.is_valid and stats.sets_in_use = 0
+						and stats.sets_allocated = 300 and stats.sets_freed = 300 and stats.pool_count = 1
+					if ok then
+						print ("PASS%N")
+						print ("  Pools: " + stats.pool_count.out + ", capacity: " + stats.set_capacity.out + "%N")
+						passed := passed + 1
+					else
+						print ("FAIL (descriptor pool stats)%N")
+						failed := failed + 1
+					end
+					pixels_buf.dispose
+					params_buf.dispose
+				else
+					print ("SKIP (shader not compiled)%N")
+				end
+				shader.dispose
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+	test_device_local_transfer
+			-- Test staged upload/download of a device-local buffer larger than one staging slot.
+		local
+			ctx: VULKAN_CONTEXT
+			buf: VULKAN_BUFFER
+			upload_data, download_data: MANAGED_POINTER
+			n, i: INTEGER
+			ok: BOOLEAN
+		do
+			print ("Test: Device-local transfer... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				n := 9 * 1024 * 1024 + 12
+				buf := vk.create_buffer (ctx, n, vk.Buffer_storage | vk.Buffer_device_local)
+				if buf.is_valid then
+					create upload_data.make (n)
+					create download_data.make (n)
+					from i := 0 until i >= n loop
+						upload_data.put_natural_8 ((i \\ 251).to_natural_8, i)
+						i := i + 1
+					end
+					ok := buf.upload (upload_data.item, n, 0) and then buf.download (download_data.item, n, 0)
+					ok := ok and then upload_data.item.memory_compare (download_data.item, n)
+					if ok then
+						print ("PASS%N")
+						passed := passed + 1
+					else
+						print ("FAIL (data mismatch)%N")
+						failed := failed + 1
+					end
+					buf.dispose
+				else
+					print ("FAIL (buffer creation failed)%N")
+					failed := failed + 1
+				end
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+	test_thread_release
+			-- Test staged transfers before and after the thread releases its command pools.
+		local
+			ctx: VULKAN_CONTEXT
+			buf: VULKAN_BUFFER
+			upload_data, download_data: MANAGED_POINTER
+			n, i: INTEGER
+			ok: BOOLEAN
+		do
+			print ("Test: Thread release... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				n := 1024 * 1024
+				buf := vk.create_buffer (ctx, n, vk.Buffer_storage | vk.Buffer_device_local)
+				if buf.is_valid then
+					create upload_data.make (n)
+					create download_data.make (n)
+					from i := 0 until i >= n loop
+						upload_data.put_natural_8 ((i \\ 241).to_natural_8, i)
+						i := i + 1
+					end
+					ok := buf.upload (upload_data.item, n, 0) and then ctx.release_thread
+					-- The released pools are picked up again by the next call
+					ok := ok and then buf.download (download_data.item, n, 0)
+						and then upload_data.item.memory_compare (download_data.item, n)
+						and then ctx.release_thread
+					if ok then
+						print ("PASS%N")
+						passed := passed + 1
+					else
+						print ("FAIL (transfer after release)%N")
+						failed := failed + 1
+					end
+					buf.dispose
+				else
+					print ("FAIL (buffer creation failed)%N")
+					failed := failed + 1
+				end
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+	test_concurrent_dispatch
+			-- Test two threads dispatching and downloading on one context at once.
+		local
+			ctx: VULKAN_CONTEXT
+			first, second: separate SCAN_WORKER
+		do
+			print ("Test: Concurrent dispatch... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				create first.make (ctx.handle, 1)
+				create second.make (ctx.handle, 2)
+				start_worker (first)
+				start_worker (second)
+				-- Each query waits for that worker's `run` to finish
+				if worker_succeeded (first) and worker_succeeded (second) then
+					print ("PASS%N")
+					passed := passed + 1
+				elseif worker_skipped (first) then
+					print ("SKIP (shaders not compiled or no subgroup arithmetic)%N")
+				else
+					print ("FAIL (scan differs from CPU reference)%N")
+					failed := failed + 1
+				end
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+	test_queue_handoff
+			-- Test transfer -> async compute -> transfer without host waits in between.
+		local
+			ctx: VULKAN_CONTEXT
+			shader: VULKAN_SHADER
+			pipeline: VULKAN_PIPELINE
+			pixels_buf, params_buf: VULKAN_BUFFER
+			pixels: MANAGED_POINTER
+			ticket: NATURAL_64
+		do
+			print ("Test: Queue handoff... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				shader := vk.load_shader (ctx, "shaders/sdf_buffer_output.spv")
+				if shader.is_valid then
+					pipeline := vk.create_pipeline (ctx, shader)
+					pixels_buf := vk.create_buffer (ctx, 64 * 64 * 4, vk.Buffer_storage | vk.Buffer_device_local)
+					params_buf := vk.create_buffer (ctx, 32, vk.Buffer_storage | vk.Buffer_device_local)
+					create pixels.make (64 * 64 * 4)
+					if pipeline.is_valid and pixels_buf.is_valid and params_buf.is_valid
+						and then params_buf.upload (sdf_camera_params (64, 64).item, 32, 0)
+						and then pipeline.bind_buffer (0, pixels_buf)
+						and then pipeline.bind_buffer (1, params_buf)
+					then
+						ticket := pipeline.dispatch_async_on (ctx, ctx.Queue_async_compute, 4, 4, 1)
+						if ticket > 0
+							and then pixels_buf.download (pixels.item, 64 * 64 * 4, 0)
+							and then all_pixels_written (pixels, 64 * 64)
+						then
+							print ("PASS%N")
+							passed := passed + 1
+						else
+							print ("FAIL (queue handoff)%N")
+							failed := failed + 1
+						end
+					else
+						print ("FAIL (setup failed)%N")
+						failed := failed + 1
+					end
+					pixels_buf.dispose
+					params_buf.dispose
+					pipeline.dispose
+					shader.dispose
+				else
+					print ("SKIP (shader not compiled)%N")
+				end
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+	test_mapped_buffer
+			-- Test writing through the persistent mapped pointer.
+		local
+			ctx: VULKAN_CONTEXT
+			buf: VULKAN_BUFFER
+			view, readback: MANAGED_POINTER
+			ok: BOOLEAN
+		do
+			print ("Test: Mapped buffer... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				buf := vk.create_buffer (ctx, 64, vk.Buffer_storage | vk.Buffer_host_upload)
+				if buf.is_valid and then buf.is_mapped then
+					create view.share_from_pointer (buf.mapped_pointer, 64)
+					create readback.make (64)
+					view.put_natural_32 (0xCAFEF00D, 0)
+					view.put_real_32 ({REAL_32} 1.25, 60)
+					ok := buf.flush_range (0, 64) and then buf.download (readback.item, 64, 0)
+					ok := ok and then readback.read_natural_32 (0) = 0xCAFEF00D and readback.read_real_32 (60) = {REAL_32} 1.25
+					if ok then
+						print ("PASS%N")
+						print ("  Coherent: " + buf.is_coherent.out + "%N")
+						passed := passed + 1
+					else
+						print ("FAIL (mapped data mismatch)%N")
+						failed := failed + 1
+					end
+					buf.dispose
+				else
+					print ("FAIL (buffer not mapped)%N")
+					failed := failed + 1
+				end
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+	test_gpu_profiler
+			-- Test GPU timestamps around labeled dispatches and copies.
+		local
+			ctx: VULKAN_CONTEXT
+			shader: VULKAN_SHADER
+			pipeline: VULKAN_PIPELINE
+			profiler: VULKAN_PROFILER
+			pixels_buf, params_buf, readback: VULKAN_BUFFER
+			list: VULKAN_COMMAND_LIST
+			i: INTEGER
+			ok: BOOLEAN
+		do
+			print ("Test: GPU profiler... ")
+			ctx := vk.create_context
+			if ctx.is_valid then
+				shader := vk.load_shader (ctx, "shaders/sdf_buffer_output.spv")
+				if shader.is_valid then
+					profiler := vk.create_profiler (ctx, 64)
+					if profiler.is_valid then
+						pipeline := vk.create_pipeline (ctx, shader)
+						pixels_buf := vk.create_buffer (ctx, 256 * 256 * 4, vk.Buffer_storage)
+						readback := vk.create_buffer (ctx, 256 * 256 * 4, vk.Buffer_storage)
+						params_buf := vk.create_buffer (ctx, 32, vk.Buffer_storage)
+						list := vk.create_command_list (ctx)
+						ok := pipeline.is_valid and then pipeline.bind_buffer (0, pixels_buf)
+							and then pipeline.bind_buffer (1, params_buf)
+							and then params_buf.upload (sdf_camera_params (256, 256).item, 32, 0)
+						profiler.set_label ("raymarch")
+						from i := 1 until i > 10 or not ok loop
+							ok := pipeline.dispatch_threads (ctx, 256, 256, 1)
+							i := i + 1
+						end
+						profiler.set_label ("copy")
+						ok := ok and then list.begin_recording
+							and then list.copy_buffer (pixels_buf, readback, 0, 0, pixels_buf.size)
+							and then list.end_recording and then list.submit_and_wait
+						profiler.clear_label
+						profiler.collect
+						ok := ok and profiler.sample_count ("raymarch") = 10 and profiler.sample_count ("copy") = 1
+							and profiler.minimum_ms ("raymarch") > 0.0
+							and profiler.minimum_ms ("raymarch") <= profiler.average_ms ("raymarch")
+							and profiler.average_ms ("raymarch") <= profiler.p99_ms ("raymarch")
+						if ok then
+							print ("PASS%N")
+							print (profiler.report)
+							passed := passed + 1
+						else
+							print ("FAIL (timestamp samples)%N")
+							failed := failed + 1
+						end
+						list.dispose
+						pixels_buf.dispose
+						readback.dispose
+						params_buf.dispose
+						pipeline.dispose
+					else
+						print ("SKIP (no timestamp support)%N")
+					end
+					profiler.dispose
+				else
+					print ("SKIP (shader not compiled)%N")
+				end
+				shader.dispose
+				ctx.dispose
+			else
+				print ("SKIP (no Vulkan)%N")
+			end
+		end
+
+feature -- Support
+
+	start_worker (a_worker: separate SCAN_WORKER)
+			-- Start `a_worker` on its own processor.
+		do
+			a_worker.run
+		end
+
+	worker_succeeded (a_worker: separate SCAN_WORKER): BOOLEAN
+			-- Did `a_worker` finish with every result correct?
+		do
+			Result := a_worker.succeeded
+		end
+
+	worker_skipped (a_worker: separate SCAN_WORKER): BOOLEAN
+			-- Did `a_worker` lack the algorithm shaders?
+		do
+			Result := a_worker.skipped
+		end
+
+	sdf_camera_params (a_width, a_height: INTEGER): MANAGED_POINTER
+			-- CameraParams block for shaders/sdf_buffer_output.spv.
+		do
+			create Result.make (32)
+			Result.put_real_32 ({REAL_32} 0.0, 0)
+			Result.put_real_32 ({REAL_32} 1.5, 4)
+			Result.put_real_32 ({REAL_32} 5.0, 8)
+			Result.put_real_32 ({REAL_32} 0.0, 12)
+			Result.put_real_32 ({REAL_32} 0.0, 16)
+			Result.put_real_32 ({REAL_32} 0.0, 20)
+			Result.put_natural_32 (a_width.to_natural_32, 24)
+			Result.put_natural_32 (a_height.to_natural_32, 28)
+		end
+
+	all_pixels_written (a_pixels: MANAGED_POINTER; a_count: INTEGER): BOOLEAN
+			-- Does every packed RGBA pixel in `a_pixels` have a non-zero value?
+		local
+			i: INTEGER
+		do
+			Result := True
+			from i := 0 until i >= a_count or not Result loop
+				Result := a_pixels.read_natural_32 (i * 4) /= 0
+				i := i + 1
+			end
+		end
+
+	matching_pixels (a_left, a_right: MANAGED_POINTER; a_count, a_tolerance: INTEGER): INTEGER
+			-- Number of packed RGBA pixels whose channels differ by at most `a_tolerance`
+		local
+			i, c, l, r: INTEGER
+			close: BOOLEAN
+		do
+			from i := 0 until i >= a_count loop
+				close := True
+				from c := 0 until c >= 4 loop
+					l := a_left.read_natural_8 (i * 4 + c).to_integer_32
+					r := a_right.read_natural_8 (i * 4 + c).to_integer_32
+					close := close and (l - r).abs <= a_tolerance
+					c := c + 1
+				end
+				if close then
+					Result := Result + 1
+				end
+				i := i + 1
+			end
+		end
+
 end
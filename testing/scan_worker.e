@@ -0,0 +1,99 @@
+note
+	description: "[
+		SCAN_WORKER - Runs GPU scans on a context shared with other threads.
+
+		Created as a separate object, so `run` executes on its own SCOOP
+		processor while other workers use the same context. Each worker
+		scans its own data through device-local buffers, so uploads,
+		dispatches and downloads of the workers interleave.
+	]"
+	author: "Larry Rix"
+	date: "$Date$"
+	revision: "$Revision$"
+
+class
+	SCAN_WORKER
+
+create
+	make
+
+feature {NONE} -- Initialization
+
+	make (a_context: POINTER; a_seed: INTEGER)
+			-- Prepare to scan data derived from `a_seed` on context `a_context`.
+		require
+			context_exists: a_context /= default_pointer
+		do
+			context := a_context
+			seed := a_seed
+		end
+
+feature -- Access
+
+	context: POINTER
+			-- Handle of the shared context
+
+	seed: INTEGER
+			-- Varies the input between workers
+
+	succeeded: BOOLEAN
+			-- Did every scan match the CPU reference?
+
+	skipped: BOOLEAN
+			-- Were the algorithm shaders unavailable?
+
+feature -- Execution
+
+	run
+			-- Scan and download `Rounds` times, comparing with the CPU reference.
+		local
+			vk: SIMPLE_VULKAN
+			ctx: VULKAN_CONTEXT
+			algos: VULKAN_ALGORITHMS
+			data_buf, out_buf: VULKAN_BUFFER
+			data, expected, actual: MANAGED_POINTER
+			i, n, round: INTEGER
+		do
+			create vk
+			create ctx.make_shared (context)
+			algos := vk.create_algorithms (ctx, "shaders")
+			if algos.is_valid then
+				n := 5000
+				create data.make (n * 4)
+				create expected.make (n * 4)
+				create actual.make (n * 4)
+				from i := 0 until i >= n loop
+					data.put_integer_32 ((i * 7919 + seed * 104729) \\ 10007 - 5000, i * 4)
+					i := i + 1
+				end
+				data_buf := vk.create_buffer (ctx, n * 4, vk.Buffer_storage | vk.Buffer_device_local)
+				out_buf := vk.create_buffer (ctx, n * 4, vk.Buffer_storage | vk.Buffer_device_local)
+				if data_buf.is_valid and out_buf.is_valid
+					and then data_buf.upload (data.item, n * 4, 0)
+					and then algos.reference_scan (data, expected, n, algos.Element_int32, algos.Reduce_sum, True)
+				then
+					succeeded := True
+					from round := 1 until round > Rounds or not succeeded loop
+						actual.item.memory_set (0, n * 4)
+						succeeded := algos.scan (data_buf, out_buf, n, algos.Element_int32, algos.Reduce_sum, True)
+							and then out_buf.download (actual.item, n * 4, 0)
+							and then actual.item.memory_compare (expected.item, n * 4)
+						round := round + 1
+					end
+				end
+				data_buf.dispose
+				out_buf.dispose
+				algos.dispose
+			else
+				skipped := True
+			end
+			succeeded := ctx.release_thread and succeeded
+			ctx.dispose
+		end
+
+feature -- Constants
+
+	Rounds: INTEGER = 8
+			-- Scans per worker
+
+end